@@ -432,6 +432,7 @@ void TunnelManager::doRegistration(){
 	if (lProxy) {
 		ms_message("TunnelManager: New registration");
 		lProxy->commit = TRUE;
+		linphone_proxy_config_schedule_update(lProxy);
 	}
 }
 
@@ -40,6 +40,8 @@
 #include "c-wrapper/c-wrapper.h"
 #include "auth-info/auth-info.h"
 
+#include <sys/stat.h>
+
 
 // TODO: From coreapi. Remove me later.
 #include "private.h"
@@ -96,14 +98,68 @@ static bool_t check_algorithm_compatibility(const LinphoneAuthInfo *ai, const ch
 	return FALSE;
 }
 
+/*
+ * The auth infos of the core are indexed by username, the only criteria always required by find_auth_info(). Entries
+ * of a same username keep the order of the list. Auth infos are cloned when added, so their username cannot change
+ * while they are indexed.
+ */
+static void auth_info_index_add(LinphoneCore *lc, LinphoneAuthInfo *ai){
+	const char *username = linphone_auth_info_get_username(ai);
+	if (!lc->auth_info_by_username) lc->auth_info_by_username = bctbx_mmap_cchar_new();
+	bctbx_map_cchar_insert_and_delete(lc->auth_info_by_username, (bctbx_pair_t *)bctbx_pair_cchar_new(username ? username : "", ai));
+}
+
+static void auth_info_index_remove(LinphoneCore *lc, const LinphoneAuthInfo *ai){
+	const char *username = linphone_auth_info_get_username(ai);
+	if (!username) username = "";
+	if (!lc->auth_info_by_username) return;
+	bctbx_iterator_t *it = bctbx_map_cchar_find_key(lc->auth_info_by_username, username);
+	bctbx_iterator_t *end = bctbx_map_cchar_end(lc->auth_info_by_username);
+	for (; !bctbx_iterator_cchar_equals(it, end); it = bctbx_iterator_cchar_get_next(it)) {
+		bctbx_pair_t *pair = bctbx_iterator_cchar_get_pair(it);
+		if (strcmp(bctbx_pair_cchar_get_first(reinterpret_cast<bctbx_pair_cchar_t *>(pair)), username) != 0) break;
+		if (bctbx_pair_cchar_get_second(pair) == ai) {
+			bctbx_map_cchar_erase(lc->auth_info_by_username, it);
+			break;
+		}
+	}
+	bctbx_iterator_cchar_delete(it);
+	bctbx_iterator_cchar_delete(end);
+}
+
+static void auth_info_list_append(LinphoneCore *lc, LinphoneAuthInfo *ai){
+	lc->auth_info = bctbx_list_append(lc->auth_info, ai);
+	auth_info_index_add(lc, ai);
+}
+
+/* The update takes the position of the auth info it replaces, so that only its own config section changes. */
+static void auth_info_list_replace(LinphoneCore *lc, LinphoneAuthInfo *old_ai, LinphoneAuthInfo *ai){
+	bctbx_list_t *elem = bctbx_list_find(lc->auth_info, old_ai);
+	auth_info_index_remove(lc, old_ai);
+	elem->data = ai;
+	auth_info_index_add(lc, ai);
+	linphone_auth_info_unref(old_ai);
+}
+
+static void auth_info_list_remove(LinphoneCore *lc, LinphoneAuthInfo *ai){
+	auth_info_index_remove(lc, ai);
+	lc->auth_info = bctbx_list_remove(lc->auth_info, ai);
+	linphone_auth_info_unref(ai);
+}
+
 static const LinphoneAuthInfo *find_auth_info(LinphoneCore *lc, const char *username, const char *realm, const char *domain, const char *algorithm, bool_t ignore_realm){
-	bctbx_list_t *elem;
 	const LinphoneAuthInfo *ret=NULL;
 
-	for (elem=lc->auth_info;elem!=NULL;elem=elem->next) {
-		LinphoneAuthInfo *pinfo = (LinphoneAuthInfo*)elem->data;
+	if (!username || !lc->auth_info_by_username) return NULL;
+
+	bctbx_iterator_t *it = bctbx_map_cchar_find_key(lc->auth_info_by_username, username);
+	bctbx_iterator_t *end = bctbx_map_cchar_end(lc->auth_info_by_username);
+	for (; !bctbx_iterator_cchar_equals(it, end); it = bctbx_iterator_cchar_get_next(it)) {
+		bctbx_pair_t *pair = bctbx_iterator_cchar_get_pair(it);
+		if (strcmp(bctbx_pair_cchar_get_first(reinterpret_cast<bctbx_pair_cchar_t *>(pair)), username) != 0) break;
+		LinphoneAuthInfo *pinfo = (LinphoneAuthInfo*)bctbx_pair_cchar_get_second(pair);
 
-		if (username && linphone_auth_info_get_username(pinfo) && strcmp(username, linphone_auth_info_get_username(pinfo))==0) 
+		if (linphone_auth_info_get_username(pinfo) && strcmp(username, linphone_auth_info_get_username(pinfo))==0) 
 		{
 			
 			if (!check_algorithm_compatibility(pinfo, algorithm)) {
@@ -112,23 +168,29 @@ static const LinphoneAuthInfo *find_auth_info(LinphoneCore *lc, const char *user
 			if (realm && domain){
 				if (linphone_auth_info_get_realm(pinfo) && realm_match(realm, linphone_auth_info_get_realm(pinfo))
 					&& linphone_auth_info_get_domain(pinfo) && strcmp(domain, linphone_auth_info_get_domain(pinfo))==0) {
-					return pinfo;
+					ret=pinfo;
+					break;
 				}
 			} else if (realm) {
 				if (linphone_auth_info_get_realm(pinfo) && realm_match(realm, linphone_auth_info_get_realm(pinfo))) {
 					if (ret!=NULL) {
 						ms_warning("Non unique realm found for %s",username);
-						return NULL;
+						ret=NULL;
+						break;
 					}
 					ret=pinfo;
 				}
 			} else if (domain && linphone_auth_info_get_domain(pinfo) && strcmp(domain,linphone_auth_info_get_domain(pinfo))==0 && (linphone_auth_info_get_ha1(pinfo)==NULL || ignore_realm)) {
-				return pinfo;
+				ret=pinfo;
+				break;
 			} else if (!domain && (linphone_auth_info_get_ha1(pinfo)==NULL || ignore_realm)) {
-				return pinfo;
+				ret=pinfo;
+				break;
 			}
 		}
 	}
+	bctbx_iterator_cchar_delete(it);
+	bctbx_iterator_cchar_delete(end);
 	return ret;
 }
 
@@ -198,25 +260,38 @@ void linphone_core_write_auth_info(LinphoneCore *lc, LinphoneAuthInfo *ai){
 	}
 }
 
-static void write_auth_infos(LinphoneCore *lc){
+/*
+ * Writes the auth infos from the given position of the list, the previous ones being unchanged in the config.
+ * Appending an auth info thus only writes its own section instead of all of them. Sections are numbered without
+ * holes, so only a removal has to shift the following ones.
+ */
+static void write_auth_infos(LinphoneCore *lc, int first_changed){
 	bctbx_list_t *elem;
 	int i;
 
 	if (!linphone_core_ready(lc)) return;
 	if (!lc->sip_conf.save_auth_info) return;
-	for(elem=lc->auth_info,i=0;elem!=NULL;elem=bctbx_list_next(elem),i++){
+	if (first_changed < 0) first_changed = 0;
+	for(elem=bctbx_list_nth_elem(lc->auth_info,first_changed),i=first_changed;elem!=NULL;elem=bctbx_list_next(elem),i++){
 		LinphoneAuthInfo *ai=(LinphoneAuthInfo*)(elem->data);
 		linphone_auth_info_write_config(lc->config,ai,i);
 	}
 	linphone_auth_info_write_config(lc->config,NULL,i); /* mark the end */
 }
 
+static void write_auth_info(LinphoneCore *lc, LinphoneAuthInfo *ai, int index){
+	if (!linphone_core_ready(lc)) return;
+	if (!lc->sip_conf.save_auth_info) return;
+	linphone_auth_info_write_config(lc->config, ai, index);
+}
+
 LinphoneAuthInfo *linphone_core_create_auth_info(LinphoneCore *lc, const char *username, const char *userid, const char *passwd, const char *ha1, const char *realm, const char *domain) {
 	return linphone_auth_info_new(username, userid, passwd, ha1, realm, domain);	
 }
 
 void linphone_core_add_auth_info(LinphoneCore *lc, const LinphoneAuthInfo *info){
 	LinphoneAuthInfo *ai=NULL;
+	LinphoneAuthInfo *added_ai;
 	int restarted_op_count=0;
 	bool_t updating=FALSE;
 
@@ -225,13 +300,17 @@ void linphone_core_add_auth_info(LinphoneCore *lc, const LinphoneAuthInfo *info)
 		return;
 	}
 	/* find if we are attempting to modify an existing auth info */
+	int changed_index = (int)bctbx_list_size(lc->auth_info);
+	added_ai = linphone_auth_info_clone(info);
 	ai=(LinphoneAuthInfo*)linphone_core_find_auth_info(lc,linphone_auth_info_get_realm(info),linphone_auth_info_get_username(info),linphone_auth_info_get_domain(info));
 	if (ai!=NULL && linphone_auth_info_get_domain(ai) && linphone_auth_info_get_domain(info) && strcmp(linphone_auth_info_get_domain(ai), linphone_auth_info_get_domain(info))==0){
-		lc->auth_info=bctbx_list_remove(lc->auth_info,ai);
-		linphone_auth_info_unref(ai);
+		changed_index = bctbx_list_index(lc->auth_info, ai);
+		auth_info_list_replace(lc, ai, added_ai);
+		_linphone_core_clear_tls_credentials_cache(lc);
 		updating=TRUE;
+	} else {
+		auth_info_list_append(lc, added_ai);
 	}
-	lc->auth_info=bctbx_list_append(lc->auth_info,linphone_auth_info_clone(info));
 
 	/* retry pending authentication operations */
 	auto pendingAuths = lc->sal->getPendingAuths();
@@ -248,12 +327,13 @@ void linphone_core_add_auth_info(LinphoneCore *lc, const LinphoneAuthInfo *info)
 			sai.password = (char *) linphone_auth_info_get_passwd(ai);
 			sai.ha1 = (char *)linphone_auth_info_get_ha1(ai);
 			sai.algorithm = (char *)linphone_auth_info_get_algorithm(ai);
+			sai.certificates = NULL;
+			sai.key = NULL;
+			/* The parsed chain and key stay owned by the credentials cache of the core. */
 			if (linphone_auth_info_get_tls_cert(ai) && linphone_auth_info_get_tls_key(ai)) {
-				sal_certificates_chain_parse(&sai, linphone_auth_info_get_tls_cert(ai), SAL_CERTIFICATE_RAW_FORMAT_PEM);
-				sal_signing_key_parse(&sai, linphone_auth_info_get_tls_key(ai), "");
+				_linphone_core_get_tls_credentials(lc, linphone_auth_info_get_tls_cert(ai), linphone_auth_info_get_tls_key(ai), FALSE, &sai.certificates, &sai.key);
 			} else if (linphone_auth_info_get_tls_cert_path(ai) && linphone_auth_info_get_tls_key_path(ai)) {
-				sal_certificates_chain_parse_file(&sai, linphone_auth_info_get_tls_cert_path(ai), SAL_CERTIFICATE_RAW_FORMAT_PEM);
-				sal_signing_key_parse_file(&sai, linphone_auth_info_get_tls_key_path(ai), "");
+				_linphone_core_get_tls_credentials(lc, linphone_auth_info_get_tls_cert_path(ai), linphone_auth_info_get_tls_key_path(ai), TRUE, &sai.certificates, &sai.key);
 			}
 			/*proxy case*/
 			for (proxy=(bctbx_list_t*)linphone_core_get_proxy_config_list(lc);proxy!=NULL;proxy=proxy->next) {
@@ -277,7 +357,8 @@ void linphone_core_add_auth_info(LinphoneCore *lc, const LinphoneAuthInfo *info)
 			linphone_auth_info_get_realm(info) ? linphone_auth_info_get_realm(info) : "",
 			linphone_auth_info_get_domain(info) ? linphone_auth_info_get_domain(info) : "");
 	}
-	write_auth_infos(lc);
+	if (updating) write_auth_info(lc, added_ai, changed_index);
+	else write_auth_infos(lc, changed_index);
 }
 
 void linphone_core_abort_authentication(LinphoneCore *lc,  LinphoneAuthInfo *info){
@@ -287,9 +368,10 @@ void linphone_core_remove_auth_info(LinphoneCore *lc, const LinphoneAuthInfo *in
 	LinphoneAuthInfo *r;
 	r=(LinphoneAuthInfo*)linphone_core_find_auth_info(lc, linphone_auth_info_get_realm(info), linphone_auth_info_get_username(info), linphone_auth_info_get_domain(info));
 	if (r){
-		lc->auth_info=bctbx_list_remove(lc->auth_info,r);
-		linphone_auth_info_unref(r);
-		write_auth_infos(lc);
+		int first_changed = bctbx_list_index(lc->auth_info, r);
+		auth_info_list_remove(lc, r);
+		write_auth_infos(lc, first_changed);
+		_linphone_core_clear_tls_credentials_cache(lc);
 	}
 }
 
@@ -307,6 +389,102 @@ void linphone_core_clear_all_auth_info(LinphoneCore *lc){
 	}
 	bctbx_list_free(lc->auth_info);
 	lc->auth_info=NULL;
+	_linphone_core_release_auth_info_indexes(lc);
+}
+
+void _linphone_core_release_auth_info_indexes(LinphoneCore *lc){
+	if (lc->auth_info_by_username) {
+		bctbx_mmap_cchar_delete(lc->auth_info_by_username);
+		lc->auth_info_by_username = NULL;
+	}
+	_linphone_core_clear_tls_credentials_cache(lc);
+}
+
+/*
+ * Parsing a certificate chain and a signing key from PEM is costly, and it is done each time a server asks for a
+ * client certificate. Parsed ones are cached per core, by content for PEM buffers and by path for files. File entries
+ * are parsed again when one of the files is modified.
+ */
+typedef struct _LinphoneTlsCredentials {
+	belle_sip_certificates_chain_t *chain;
+	belle_sip_signing_key_t *key;
+	time_t chain_mtime;
+	time_t key_mtime;
+} LinphoneTlsCredentials;
+
+static void linphone_tls_credentials_free(LinphoneTlsCredentials *credentials){
+	belle_sip_object_unref(credentials->chain);
+	belle_sip_object_unref(credentials->key);
+	ms_free(credentials);
+}
+
+static time_t get_file_mtime(const char *path){
+	struct stat st;
+	return stat(path, &st) == 0 ? st.st_mtime : 0;
+}
+
+void _linphone_core_clear_tls_credentials_cache(LinphoneCore *lc){
+	if (lc->tls_credentials_cache) {
+		bctbx_mmap_cchar_delete_with_data(lc->tls_credentials_cache, (void (*)(void *))linphone_tls_credentials_free);
+		lc->tls_credentials_cache = NULL;
+	}
+}
+
+bool_t _linphone_core_get_tls_credentials(LinphoneCore *lc, const char *cert, const char *key, bool_t from_files, belle_sip_certificates_chain_t **chain, belle_sip_signing_key_t **signing_key){
+	LinphoneTlsCredentials *credentials = NULL;
+	time_t chain_mtime = 0, key_mtime = 0;
+
+	*chain = NULL;
+	*signing_key = NULL;
+	if (!cert || !key) return FALSE;
+	if (from_files) {
+		chain_mtime = get_file_mtime(cert);
+		key_mtime = get_file_mtime(key);
+	}
+
+	char *cache_key = bctbx_strdup_printf("%s\n%s\n%s", from_files ? "file" : "pem", cert, key);
+	if (!lc->tls_credentials_cache) lc->tls_credentials_cache = bctbx_mmap_cchar_new();
+	bctbx_iterator_t *it = bctbx_map_cchar_find_key(lc->tls_credentials_cache, cache_key);
+	bctbx_iterator_t *end = bctbx_map_cchar_end(lc->tls_credentials_cache);
+	if (!bctbx_iterator_cchar_equals(it, end)) {
+		credentials = (LinphoneTlsCredentials *)bctbx_pair_cchar_get_second(bctbx_iterator_cchar_get_pair(it));
+		if (credentials->chain_mtime != chain_mtime || credentials->key_mtime != key_mtime) {
+			linphone_tls_credentials_free(credentials);
+			bctbx_map_cchar_erase(lc->tls_credentials_cache, it);
+			credentials = NULL;
+		}
+	}
+	bctbx_iterator_cchar_delete(it);
+	bctbx_iterator_cchar_delete(end);
+
+	if (!credentials) {
+		belle_sip_certificates_chain_t *parsed_chain;
+		belle_sip_signing_key_t *parsed_key;
+		if (from_files) {
+			parsed_chain = belle_sip_certificates_chain_parse_file(cert, BELLE_SIP_CERTIFICATE_RAW_FORMAT_PEM);
+			parsed_key = belle_sip_signing_key_parse_file(key, nullptr);
+		} else {
+			parsed_chain = belle_sip_certificates_chain_parse(cert, strlen(cert), BELLE_SIP_CERTIFICATE_RAW_FORMAT_PEM);
+			parsed_key = belle_sip_signing_key_parse(key, strlen(key), nullptr);
+		}
+		if (!parsed_chain || !parsed_key) {
+			if (parsed_chain) belle_sip_object_unref(parsed_chain);
+			if (parsed_key) belle_sip_object_unref(parsed_key);
+			bctbx_free(cache_key);
+			return FALSE;
+		}
+		credentials = ms_new0(LinphoneTlsCredentials, 1);
+		credentials->chain = (belle_sip_certificates_chain_t *)belle_sip_object_ref(parsed_chain);
+		credentials->key = (belle_sip_signing_key_t *)belle_sip_object_ref(parsed_key);
+		credentials->chain_mtime = chain_mtime;
+		credentials->key_mtime = key_mtime;
+		bctbx_map_cchar_insert_and_delete(lc->tls_credentials_cache, (bctbx_pair_t *)bctbx_pair_cchar_new(cache_key, credentials));
+	}
+	bctbx_free(cache_key);
+
+	*chain = credentials->chain;
+	*signing_key = credentials->key;
+	return TRUE;
 }
 
 void linphone_auth_info_fill_belle_sip_event(const LinphoneAuthInfo *auth_info, belle_sip_auth_event *event) {
@@ -372,17 +550,15 @@ void linphone_core_fill_belle_sip_auth_event(LinphoneCore *lc, belle_sip_auth_ev
 				}
 			}
 
+			belle_sip_certificates_chain_t *bs_cert_chain = nullptr;
+			belle_sip_signing_key_t *bs_key = nullptr;
 			if (cert_chain != nullptr && key != nullptr) {
-				belle_sip_certificates_chain_t *bs_cert_chain = belle_sip_certificates_chain_parse(cert_chain, strlen(cert_chain), BELLE_SIP_CERTIFICATE_RAW_FORMAT_PEM);
-				belle_sip_signing_key_t *bs_key = belle_sip_signing_key_parse(key, strlen(key), nullptr);
-				if (bs_cert_chain && bs_key) {
+				if (_linphone_core_get_tls_credentials(lc, cert_chain, key, FALSE, &bs_cert_chain, &bs_key)) {
 					belle_sip_auth_event_set_signing_key(event,  bs_key);
 					belle_sip_auth_event_set_client_certificates_chain(event, bs_cert_chain);
 				}
 			} else if (cert_chain_path != nullptr && key_path != nullptr) {
-				belle_sip_certificates_chain_t *bs_cert_chain = belle_sip_certificates_chain_parse_file(cert_chain_path, BELLE_SIP_CERTIFICATE_RAW_FORMAT_PEM);
-				belle_sip_signing_key_t *bs_key = belle_sip_signing_key_parse_file(key_path, nullptr);
-				if (bs_cert_chain && bs_key) {
+				if (_linphone_core_get_tls_credentials(lc, cert_chain_path, key_path, TRUE, &bs_cert_chain, &bs_key)) {
 					belle_sip_auth_event_set_signing_key(event,  bs_key);
 					belle_sip_auth_event_set_client_certificates_chain(event, bs_cert_chain);
 				}
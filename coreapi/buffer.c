@@ -81,10 +81,25 @@ void linphone_buffer_set_content(LinphoneBuffer *buffer, const uint8_t *content,
 	buffer->size = size;
 	if (buffer->content) belle_sip_free(buffer->content);
 	buffer->content = reinterpret_cast<uint8_t *>(belle_sip_malloc(size + 1));
+	buffer->capacity = size + 1;
 	memcpy(buffer->content, content, size);
     ((char *)buffer->content)[size] = '\0';
 }
 
+bool_t _linphone_buffer_reuse_with_content(LinphoneBuffer *buffer, const uint8_t *content, size_t size) {
+	/* Someone else still reads the current content, it must not change under its feet. */
+	if (buffer->base.ref > 1) return FALSE;
+	if (!buffer->content || buffer->capacity < size + 1) {
+		if (buffer->content) belle_sip_free(buffer->content);
+		buffer->content = reinterpret_cast<uint8_t *>(belle_sip_malloc(size + 1));
+		buffer->capacity = size + 1;
+	}
+	buffer->size = size;
+	memcpy(buffer->content, content, size);
+	((char *)buffer->content)[size] = '\0';
+	return TRUE;
+}
+
 const char * linphone_buffer_get_string_content(const LinphoneBuffer *buffer) {
 	return (const char *)buffer->content;
 }
@@ -93,6 +108,7 @@ void linphone_buffer_set_string_content(LinphoneBuffer *buffer, const char *cont
 	buffer->size = strlen(content);
 	if (buffer->content) belle_sip_free(buffer->content);
 	buffer->content = (uint8_t *)belle_sip_strdup(content);
+	buffer->capacity = buffer->size + 1;
 }
 
 size_t linphone_buffer_get_size(const LinphoneBuffer *buffer) {
@@ -424,13 +424,17 @@ void linphone_core_call_log_storage_init(LinphoneCore *lc) {
 
 	linphone_core_call_log_storage_close(lc);
 
+	linphone_core_startup_phase_begin(lc, "call logs");
 	ret=_linphone_sqlite3_open(lc->logs_db_file, &db);
 	if(ret != SQLITE_OK) {
 		errmsg = sqlite3_errmsg(db);
 		ms_error("Error in the opening call_history_db_file(%s): %s.\n", lc->logs_db_file, errmsg);
 		sqlite3_close(db);
+		linphone_core_startup_phase_end(lc, "call logs");
 		return;
 	}
+	_linphone_core_startup_timeline_watch_db(lc, db);
+	_linphone_sqlite3_apply_profile(lc->config, db);
 
 	linphone_create_call_log_table(db);
 	linphone_update_call_log_table(db);
@@ -438,6 +442,7 @@ void linphone_core_call_log_storage_init(LinphoneCore *lc) {
 
 	// Load the existing call logs
 	linphone_core_get_call_history(lc);
+	linphone_core_startup_phase_end(lc, "call logs");
 }
 
 void linphone_core_call_log_storage_close(LinphoneCore *lc) {
@@ -576,6 +576,17 @@ static void ping_reply(SalOp *op) {
 	L_GET_PRIVATE(sessionRef)->pingReply();
 }
 
+/* Uses the parsed certificate chain and key cached by the core. */
+static bool_t fill_auth_info_with_tls_credentials(LinphoneCore *lc, SalAuthInfo *sai, const char *cert, const char *key, bool_t from_files) {
+	belle_sip_certificates_chain_t *chain;
+	belle_sip_signing_key_t *signing_key;
+	if (!_linphone_core_get_tls_credentials(lc, cert, key, from_files, &chain, &signing_key))
+		return FALSE;
+	sai->certificates = (belle_sip_certificates_chain_t *)belle_sip_object_ref(chain);
+	sai->key = (belle_sip_signing_key_t *)belle_sip_object_ref(signing_key);
+	return TRUE;
+}
+
 static bool_t fill_auth_info_with_client_certificate(LinphoneCore *lc, SalAuthInfo* sai) {
 	const char *chain_file = linphone_core_get_tls_cert_path(lc);
 	const char *key_file = linphone_core_get_tls_key_path(lc);
@@ -593,11 +604,9 @@ static bool_t fill_auth_info_with_client_certificate(LinphoneCore *lc, SalAuthIn
 			return FALSE;
 		}
 #endif
-		sal_certificates_chain_parse_file(sai, chain_file, SAL_CERTIFICATE_RAW_FORMAT_PEM);
-		sal_signing_key_parse_file(sai, key_file, "");
+		fill_auth_info_with_tls_credentials(lc, sai, chain_file, key_file, TRUE);
 	} else if (lc->tls_cert && lc->tls_key) {
-		sal_certificates_chain_parse(sai, lc->tls_cert, SAL_CERTIFICATE_RAW_FORMAT_PEM);
-		sal_signing_key_parse(sai, lc->tls_key, "");
+		fill_auth_info_with_tls_credentials(lc, sai, lc->tls_cert, lc->tls_key, FALSE);
 	}
 	return sai->certificates && sai->key;
 }
@@ -624,11 +633,9 @@ static bool_t fill_auth_info(LinphoneCore *lc, SalAuthInfo* sai) {
 
 		} else if (sai->mode == SalAuthModeTls) {
 			if (linphone_auth_info_get_tls_cert(ai) && linphone_auth_info_get_tls_key(ai)) {
-				sal_certificates_chain_parse(sai, linphone_auth_info_get_tls_cert(ai), SAL_CERTIFICATE_RAW_FORMAT_PEM);
-				sal_signing_key_parse(sai, linphone_auth_info_get_tls_key(ai), "");
+				fill_auth_info_with_tls_credentials(lc, sai, linphone_auth_info_get_tls_cert(ai), linphone_auth_info_get_tls_key(ai), FALSE);
 			} else if (linphone_auth_info_get_tls_cert_path(ai) && linphone_auth_info_get_tls_key_path(ai)) {
-				sal_certificates_chain_parse_file(sai, linphone_auth_info_get_tls_cert_path(ai), SAL_CERTIFICATE_RAW_FORMAT_PEM);
-				sal_signing_key_parse_file(sai, linphone_auth_info_get_tls_key_path(ai), "");
+				fill_auth_info_with_tls_credentials(lc, sai, linphone_auth_info_get_tls_cert_path(ai), linphone_auth_info_get_tls_key_path(ai), TRUE);
 			} else {
 				fill_auth_info_with_client_certificate(lc, sai);
 			}
@@ -215,7 +215,7 @@ end:
 }
 
 static int find_matching_vcard(LinphoneCardDavResponse *response, LinphoneFriend *lf) {
-	if (!response->url || !lf || !lf->vcard || !linphone_vcard_get_url(lf->vcard)) {
+	if (!response->url || !lf || !linphone_friend_get_vcard(lf) || !linphone_vcard_get_url(lf->vcard)) {
 		return 1;
 	}
 	return strcmp(response->url, linphone_vcard_get_url(lf->vcard));
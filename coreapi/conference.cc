@@ -391,6 +391,7 @@ LocalConference::LocalConference (
 
 	setState(ConferenceInterface::State::Instantiated);
 	mMixerSession.reset(new MixerSession(*core.get()));
+	applyAudioMixingPolicy();
 
 	// Update proxy contact address to add conference ID
 	// Do not use myAddress directly as it may lack some parameter like gruu
@@ -839,9 +840,17 @@ bool LocalConference::update(const LinphonePrivate::ConferenceParamsInterface &n
 		removeLocalEndpoint();
 		addLocalEndpoint();
 	}
+	applyAudioMixingPolicy();
 	return ret;
 }
 
+void LocalConference::applyAudioMixingPolicy(){
+	MS2AudioMixer *mixer = dynamic_cast<MS2AudioMixer*>(mMixerSession->getMixerByType(SalAudio));
+	if (mixer){
+		mixer->setMixingPolicy(confParams->getMaxMixedParticipants(), confParams->getAudioGatingThreshold());
+	}
+}
+
 int LocalConference::startRecording (const char *path) {
 	MS2AudioMixer * mixer = dynamic_cast<MS2AudioMixer*> (mMixerSession->getMixerByType(SalAudio));
 	if (mixer){
@@ -211,6 +211,10 @@ public:
 	virtual VideoControlInterface * getVideoControlInterface() const override;
 	virtual AudioStream *getAudioStream() override;
 
+	MixerSession *getMixerSession() const{
+		return mMixerSession.get();
+	}
+
 	void subscribeReceived (LinphoneEvent *event);
 	void subscriptionStateChanged (LinphoneEvent *event, LinphoneSubscriptionState state);
 
@@ -230,6 +234,7 @@ private:
 	void chooseAnotherAdminIfNoneInConference();
 	void addLocalEndpoint();
 	void removeLocalEndpoint();
+	void applyAudioMixingPolicy();
 	std::unique_ptr<MixerSession> mMixerSession;
 	bool mIsIn = false;
 
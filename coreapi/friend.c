@@ -295,6 +295,9 @@ void linphone_core_interpret_friend_uri(LinphoneCore *lc, const char *uri, char
 
 const LinphoneAddress * linphone_friend_get_address(const LinphoneFriend *lf) {
 	if (linphone_core_vcard_supported()) {
+		/* The sip_uri column of a not yet parsed friend is its vCard main address. */
+		if (lf->pending_vcard && lf->uri) return lf->uri;
+		linphone_friend_load_vcard(lf);
 		if (lf->vcard) {
 			const bctbx_list_t *sip_addresses = linphone_vcard_get_sip_addresses(lf->vcard);
 			if (sip_addresses) {
@@ -358,8 +361,131 @@ static void remove_friend_from_list_map_if_already_in_it(LinphoneFriend *lf, con
 	bctbx_iterator_cchar_delete(end);
 }
 
+static void add_friend_uris_into_list_map(LinphoneFriend *lf) {
+	bctbx_list_t *iterator;
+	bctbx_list_t *phone_numbers;
+	const bctbx_list_t *addresses;
+
+	phone_numbers = linphone_friend_get_phone_numbers(lf);
+	iterator = phone_numbers;
+	while (iterator) {
+		const char *number = (const char *)bctbx_list_get_data(iterator);
+		const char *uri = linphone_friend_phone_number_to_sip_uri(lf, number);
+		if (uri) {
+			add_friend_to_list_map_if_not_in_it_yet(lf, uri);
+		}
+		iterator = bctbx_list_next(iterator);
+	}
+
+	addresses = linphone_friend_get_addresses(lf);
+	iterator = (bctbx_list_t *)addresses;
+	while (iterator) {
+		LinphoneAddress *lfaddr = (LinphoneAddress *)bctbx_list_get_data(iterator);
+		char *uri = linphone_address_as_string_uri_only(lfaddr);
+		if (uri) {
+			add_friend_to_list_map_if_not_in_it_yet(lf, uri);
+			ms_free(uri);
+		}
+		iterator = bctbx_list_next(iterator);
+	}
+}
+
+static void add_pending_vcard_property_into_list_map(LinphoneFriend *lf, const std::string &line) {
+	size_t nameEnd = line.find_first_of(";:");
+	size_t colon = line.find(':');
+	if (nameEnd == std::string::npos || colon == std::string::npos) return;
+	/* Skip the group, as in "item1.IMPP". */
+	std::string name = line.substr(0, nameEnd);
+	size_t dot = name.rfind('.');
+	if (dot != std::string::npos) name.erase(0, dot + 1);
+	const char *value = line.c_str() + colon + 1;
+
+	if (strcasecmp(name.c_str(), "IMPP") == 0) {
+		LinphoneAddress *addr = linphone_address_new(value);
+		if (addr) {
+			char *uri = linphone_address_as_string_uri_only(addr);
+			add_friend_to_list_map_if_not_in_it_yet(lf, uri);
+			ms_free(uri);
+			linphone_address_unref(addr);
+		}
+	} else if (strcasecmp(name.c_str(), "TEL") == 0) {
+		const char *uri = linphone_friend_phone_number_to_sip_uri(lf, value);
+		if (uri) add_friend_to_list_map_if_not_in_it_yet(lf, uri);
+	}
+}
+
+/*
+ * Indexes the addresses and phone numbers of a raw vCard with a line scan rather than a belcard parse, so that
+ * lookups on any URI of a friend work without parsing its vCard.
+ */
+static void add_pending_vcard_uris_into_list_map(LinphoneFriend *lf) {
+	std::string line;
+	const char *p = lf->pending_vcard;
+	for (;;) {
+		const char *eol = p + strcspn(p, "\r\n");
+		line.append(p, (size_t)(eol - p));
+		p = eol;
+		if (*p == '\r') p++;
+		if (*p == '\n') p++;
+		/* A line starting with a space or a tab continues the previous one. */
+		if (*p == ' ' || *p == '\t') {
+			p++;
+			continue;
+		}
+		add_pending_vcard_property_into_list_map(lf, line);
+		line.clear();
+		if (*p == '\0') break;
+	}
+}
+
+/*
+ * Friends fetched from the database keep their raw vCard until something needs it: parsing every vCard
+ * with belcard is what made the startup of cores with large address books slow.
+ */
+void linphone_friend_load_vcard(const LinphoneFriend *lf) {
+	LinphoneFriend *fr = (LinphoneFriend *)lf;
+	LinphoneVcardContext *context;
+	LinphoneVcard *vcard;
+
+	if (!fr || !fr->pending_vcard) return;
+
+	context = fr->lc ? fr->lc->vcard_context : linphone_vcard_context_new();
+	vcard = linphone_vcard_context_get_vcard_from_buffer(context, fr->pending_vcard);
+	if (!fr->lc) linphone_vcard_context_destroy(context);
+	if (vcard) {
+		const char *fullname;
+		linphone_vcard_set_etag(vcard, fr->pending_vcard_etag);
+		linphone_vcard_set_url(vcard, fr->pending_vcard_url);
+		fullname = linphone_vcard_get_full_name(vcard);
+		if (fullname && strlen(fullname) > 0) fr->vcard = linphone_vcard_ref(vcard);
+		linphone_vcard_unref(vcard);
+	}
+	ms_free(fr->pending_vcard);
+	fr->pending_vcard = NULL;
+	if (fr->pending_vcard_etag) ms_free(fr->pending_vcard_etag);
+	fr->pending_vcard_etag = NULL;
+	if (fr->pending_vcard_url) ms_free(fr->pending_vcard_url);
+	fr->pending_vcard_url = NULL;
+
+	/* The main address stays in lf->uri: it may have been handed out by linphone_friend_get_address(). */
+	if (!fr->vcard && fr->uri) {
+		/* Same fallback as an eager fetch, which runs before the friend gets its core and list: nothing is saved. */
+		LinphoneCore *lc = fr->lc;
+		LinphoneFriendList *list = fr->friend_list;
+		fr->lc = NULL;
+		fr->friend_list = NULL;
+		linphone_friend_set_address(fr, fr->uri);
+		fr->lc = lc;
+		fr->friend_list = list;
+	}
+
+	/* The URIs were indexed from the raw vCard, this catches what the scan may have missed. */
+	if (fr->friend_list) add_friend_uris_into_list_map(fr);
+}
+
 LinphoneStatus linphone_friend_set_address(LinphoneFriend *lf, const LinphoneAddress *addr) {
 	if (!addr) return -1;
+	linphone_friend_load_vcard(lf);
 	LinphoneAddress *fr = linphone_address_clone(addr);
 	char *address;
 	const LinphoneAddress *mAddr = linphone_friend_get_address(lf);
@@ -394,6 +520,7 @@ void linphone_friend_add_address(LinphoneFriend *lf, const LinphoneAddress *addr
 	LinphoneAddress *fr;
 	char *uri;
 	if (!lf || !addr) return;
+	linphone_friend_load_vcard(lf);
 
 	fr = linphone_address_clone(addr);
 	linphone_address_clean(fr);
@@ -417,6 +544,7 @@ void linphone_friend_add_address(LinphoneFriend *lf, const LinphoneAddress *addr
 
 const bctbx_list_t* linphone_friend_get_addresses(const LinphoneFriend *lf) {
 	if (!lf) return NULL;
+	linphone_friend_load_vcard(lf);
 
 	if (linphone_core_vcard_supported()) {
 		const bctbx_list_t * addresses = linphone_vcard_get_sip_addresses(lf->vcard);
@@ -429,6 +557,7 @@ const bctbx_list_t* linphone_friend_get_addresses(const LinphoneFriend *lf) {
 
 void linphone_friend_remove_address(LinphoneFriend *lf, const LinphoneAddress *addr) {
 	char *address ;
+	linphone_friend_load_vcard(lf);
 	if (!lf || !addr || !lf->vcard) return;
 
 	address = linphone_address_as_string_uri_only(addr);
@@ -444,6 +573,7 @@ void linphone_friend_remove_address(LinphoneFriend *lf, const LinphoneAddress *a
 
 void linphone_friend_add_phone_number(LinphoneFriend *lf, const char *phone) {
 	if (!lf || !phone) return;
+	linphone_friend_load_vcard(lf);
 
 	if (lf->friend_list) {
 		const char *uri = linphone_friend_phone_number_to_sip_uri(lf, phone);
@@ -459,6 +589,7 @@ void linphone_friend_add_phone_number(LinphoneFriend *lf, const char *phone) {
 }
 
 bctbx_list_t* linphone_friend_get_phone_numbers(const LinphoneFriend *lf) {
+	linphone_friend_load_vcard(lf);
 	if (!lf || !lf->vcard) return NULL;
 
 	if (linphone_core_vcard_supported()) {
@@ -501,6 +632,7 @@ bool_t linphone_friend_has_phone_number(const LinphoneFriend *lf, const char *ph
 }
 
 void linphone_friend_remove_phone_number(LinphoneFriend *lf, const char *phone) {
+	linphone_friend_load_vcard(lf);
 	if (!lf || !phone || !lf->vcard) return;
 
 	if (lf->friend_list) {
@@ -516,6 +648,7 @@ void linphone_friend_remove_phone_number(LinphoneFriend *lf, const char *phone)
 }
 
 LinphoneStatus linphone_friend_set_name(LinphoneFriend *lf, const char *name) {
+	linphone_friend_load_vcard(lf);
 	if (linphone_core_vcard_supported()) {
 		if (!lf->vcard) linphone_friend_create_vcard(lf, name);
 		linphone_vcard_set_full_name(lf->vcard, name);
@@ -637,6 +770,9 @@ static void _linphone_friend_destroy(LinphoneFriend *lf){
 	if (lf->uri!=NULL) linphone_address_unref(lf->uri);
 	if (lf->info!=NULL) buddy_info_free(lf->info);
 	if (lf->vcard != NULL) linphone_vcard_unref(lf->vcard);
+	if (lf->pending_vcard != NULL) ms_free(lf->pending_vcard);
+	if (lf->pending_vcard_etag != NULL) ms_free(lf->pending_vcard_etag);
+	if (lf->pending_vcard_url != NULL) ms_free(lf->pending_vcard_url);
 	if (lf->refkey != NULL) ms_free(lf->refkey);
 }
 
@@ -656,11 +792,11 @@ const char * linphone_friend_get_name(const LinphoneFriend *lf) {
 
 	const char *fullname = NULL;
 	if (linphone_core_vcard_supported()) {
-		if (lf->vcard) {
-			fullname = linphone_vcard_get_full_name(lf->vcard);
-		}
+		/* A lazily loaded friend still has the sip_uri column in lf->uri, the vCard must win over it. */
+		linphone_friend_load_vcard(lf);
+		if (lf->vcard) return linphone_vcard_get_full_name(lf->vcard);
 	}
-	if (!fullname && lf->uri) {
+	if (lf->uri) {
 		fullname = linphone_address_get_display_name(lf->uri);
 	}
 	return fullname;
@@ -907,6 +1043,7 @@ void linphone_friend_apply(LinphoneFriend *fr, LinphoneCore *lc) {
 }
 
 void linphone_friend_edit(LinphoneFriend *fr) {
+	linphone_friend_load_vcard(fr);
 	if (fr && linphone_core_vcard_supported() && fr->vcard) {
 		linphone_vcard_compute_md5_hash(fr->vcard);
 	}
@@ -997,6 +1134,35 @@ void linphone_core_send_initial_subscribes(LinphoneCore *lc) {
 	linphone_core_update_friends_subscriptions(lc);
 }
 
+/* Sends the SUBSCRIBEs queued by linphone_friend_list_update_subscriptions() for large lists, a batch per iteration. */
+void linphone_core_process_friends_to_subscribe(LinphoneCore *lc) {
+	bool_t only_when_registered;
+	int batch;
+	int i;
+
+	if (!lc->friends_to_subscribe) return;
+
+	batch = linphone_config_get_int(lc->config, "sip", "friend_subscribes_per_iteration", 100);
+	only_when_registered = linphone_core_should_subscribe_friends_only_when_registered(lc);
+	for (i = 0; lc->friends_to_subscribe && (batch <= 0 || i < batch); i++) {
+		LinphoneFriend *lf = (LinphoneFriend *)bctbx_list_get_data(lc->friends_to_subscribe);
+		lc->friends_to_subscribe = bctbx_list_erase_link(lc->friends_to_subscribe, lc->friends_to_subscribe);
+		lf->subscribe_queued = FALSE;
+		/* The friend may have been removed from its list in the meantime. */
+		if (lf->lc == lc && lf->friend_list && lf->friend_list->enable_subscriptions)
+			linphone_friend_update_subscribes(lf, only_when_registered);
+		linphone_friend_unref(lf);
+	}
+}
+
+void linphone_core_clear_friends_to_subscribe(LinphoneCore *lc) {
+	bctbx_list_t *elem;
+	for (elem = lc->friends_to_subscribe; elem != NULL; elem = bctbx_list_next(elem)) {
+		((LinphoneFriend *)bctbx_list_get_data(elem))->subscribe_queued = FALSE;
+	}
+	lc->friends_to_subscribe = bctbx_list_free_with_data(lc->friends_to_subscribe, (bctbx_list_free_func)linphone_friend_unref);
+}
+
 void linphone_core_invalidate_friend_subscriptions(LinphoneCore *lc) {
 	bctbx_list_t *lists = lc->friends_lists;
 	while (lists) {
@@ -1004,6 +1170,7 @@ void linphone_core_invalidate_friend_subscriptions(LinphoneCore *lc) {
 		linphone_friend_list_invalidate_subscriptions(list);
 		lists = bctbx_list_next(lists);
 	}
+	linphone_core_clear_friends_to_subscribe(lc);
 	lc->initial_subscribes_sent=FALSE;
 }
 
@@ -1208,12 +1375,16 @@ void linphone_friend_destroy(LinphoneFriend *lf) {
 }
 
 LinphoneVcard* linphone_friend_get_vcard(const LinphoneFriend *fr) {
-	if (fr && linphone_core_vcard_supported()) return fr->vcard;
+	if (fr && linphone_core_vcard_supported()) {
+		linphone_friend_load_vcard(fr);
+		return fr->vcard;
+	}
 	return NULL;
 }
 
 void linphone_friend_set_vcard(LinphoneFriend *fr, LinphoneVcard *vcard) {
 	if (!fr || !linphone_core_vcard_supported()) return;
+	linphone_friend_load_vcard(fr);
 
 	const char *fullname = linphone_vcard_get_full_name(vcard);
 	if (!fullname || strlen(fullname) == 0) {
@@ -1239,6 +1410,7 @@ bool_t linphone_friend_create_vcard(LinphoneFriend *fr, const char *name) {
 		ms_warning("VCard support is not builtin");
 		return FALSE;
 	}
+	linphone_friend_load_vcard(fr);
 	if (fr->vcard) {
 		ms_error("Friend already has a VCard");
 		return FALSE;
@@ -1398,19 +1570,25 @@ void linphone_core_friends_storage_init(LinphoneCore *lc) {
 
 	linphone_core_friends_storage_close(lc);
 
+	linphone_core_startup_phase_begin(lc, "friends");
 	ret = _linphone_sqlite3_open(lc->friends_db_file, &db);
 	if (ret != SQLITE_OK) {
 		errmsg = sqlite3_errmsg(db);
 		ms_error("Error in the opening: %s.", errmsg);
 		sqlite3_close(db);
+		linphone_core_startup_phase_end(lc, "friends");
 		return;
 	}
+	_linphone_core_startup_timeline_watch_db(lc, db);
+	_linphone_sqlite3_apply_profile(lc->config, db);
 
 	linphone_create_friends_table(db);
 	if (linphone_update_friends_table(db)) {
 		// After updating schema, database need to be closed/reopenned
 		sqlite3_close(db);
 		_linphone_sqlite3_open(lc->friends_db_file, &db);
+		_linphone_core_startup_timeline_watch_db(lc, db);
+		_linphone_sqlite3_apply_profile(lc->config, db);
 	}
 
 	lc->friends_db = db;
@@ -1427,6 +1605,7 @@ void linphone_core_friends_storage_init(LinphoneCore *lc) {
 		}
 		friends_lists = bctbx_list_free_with_data(friends_lists, (bctbx_list_free_func)linphone_friend_list_unref);
 	}
+	linphone_core_startup_phase_end(lc, "friends");
 }
 
 void linphone_core_friends_storage_close(LinphoneCore *lc) {
@@ -1486,7 +1665,18 @@ static int create_friend(void *data, int argc, char **argv, char **colName) {
 	LinphoneVcard *vcard = NULL;
 	unsigned int storage_id = (unsigned int)atoi(argv[0]);
 
-	vcard = linphone_vcard_context_get_vcard_from_buffer(context, argv[6]);
+	if (linphone_core_vcard_supported() && argv[6] != NULL && argv[2] != NULL) {
+		/* The vCard is kept as is and only the main address is parsed, see linphone_friend_load_vcard(). */
+		LinphoneAddress *addr = linphone_address_new(argv[2]);
+		if (addr) {
+			lf = linphone_friend_new();
+			lf->uri = addr;
+			lf->pending_vcard = ms_strdup(argv[6]);
+			lf->pending_vcard_etag = argv[7] ? ms_strdup(argv[7]) : NULL;
+			lf->pending_vcard_url = argv[8] ? ms_strdup(argv[8]) : NULL;
+		}
+	}
+	if (!lf) vcard = linphone_vcard_context_get_vcard_from_buffer(context, argv[6]);
 	if (vcard) {
 		linphone_vcard_set_etag(vcard, argv[7]);
 		linphone_vcard_set_url(vcard, argv[8]);
@@ -1572,7 +1762,8 @@ void linphone_core_store_friend_in_db(LinphoneCore *lc, LinphoneFriend *lf) {
 			linphone_core_store_friends_list_in_db(lc, lf->friend_list);
 		}
 
-		if (linphone_core_vcard_supported()) vcard = linphone_friend_get_vcard(lf);
+		/* A friend whose vCard was never parsed can't have modified it, its raw vCard is written back as is. */
+		if (linphone_core_vcard_supported() && !lf->pending_vcard) vcard = linphone_friend_get_vcard(lf);
 		addr = linphone_friend_get_address(lf);
 		if (addr != NULL) addr_str = linphone_address_as_string(addr);
 		if (lf->storage_id > 0) {
@@ -1582,9 +1773,9 @@ void linphone_core_store_friend_in_db(LinphoneCore *lc, LinphoneFriend *lf) {
 				lf->pol,
 				lf->subscribe,
 				lf->refkey,
-				vcard ? linphone_vcard_as_vcard4_string(vcard) : NULL,
-				vcard ? linphone_vcard_get_etag(vcard) : NULL,
-				vcard ? linphone_vcard_get_url(vcard): NULL,
+				vcard ? linphone_vcard_as_vcard4_string(vcard) : lf->pending_vcard,
+				vcard ? linphone_vcard_get_etag(vcard) : lf->pending_vcard_etag,
+				vcard ? linphone_vcard_get_url(vcard): lf->pending_vcard_url,
 				lf->presence_received,
 				lf->storage_id
 			);
@@ -1595,9 +1786,9 @@ void linphone_core_store_friend_in_db(LinphoneCore *lc, LinphoneFriend *lf) {
 				lf->pol,
 				lf->subscribe,
 				lf->refkey,
-				vcard ? linphone_vcard_as_vcard4_string(vcard) : NULL,
-				vcard ? linphone_vcard_get_etag(vcard) : NULL,
-				vcard ? linphone_vcard_get_url(vcard) : NULL,
+				vcard ? linphone_vcard_as_vcard4_string(vcard) : lf->pending_vcard,
+				vcard ? linphone_vcard_get_etag(vcard) : lf->pending_vcard_etag,
+				vcard ? linphone_vcard_get_url(vcard) : lf->pending_vcard_url,
 				lf->presence_received
 			);
 		}
@@ -1679,37 +1870,19 @@ void linphone_core_remove_friends_list_from_db(LinphoneCore *lc, LinphoneFriendL
 }
 
 void linphone_friend_add_addresses_and_numbers_into_maps(LinphoneFriend *lf, LinphoneFriendList *list) {
-	bctbx_list_t *iterator;
-	bctbx_list_t *phone_numbers;
-	const bctbx_list_t *addresses;
-
 	if (lf->refkey) {
 		bctbx_pair_t *pair = (bctbx_pair_t*) bctbx_pair_cchar_new(lf->refkey, linphone_friend_ref(lf));
 		bctbx_map_cchar_insert_and_delete(list->friends_map, pair);
 	}
 
-	phone_numbers = linphone_friend_get_phone_numbers(lf);
-	iterator = phone_numbers;
-	while (iterator) {
-		const char *number = (const char *)bctbx_list_get_data(iterator);
-		const char *uri = linphone_friend_phone_number_to_sip_uri(lf, number);
-		if (uri) {
-			add_friend_to_list_map_if_not_in_it_yet(lf, uri);
-		}
-		iterator = bctbx_list_next(iterator);
-	}
-
-	addresses = linphone_friend_get_addresses(lf);
-	iterator = (bctbx_list_t *)addresses;
-	while (iterator) {
-		LinphoneAddress *lfaddr = (LinphoneAddress *)bctbx_list_get_data(iterator);
-		char *uri = linphone_address_as_string_uri_only(lfaddr);
-		if (uri) {
-			add_friend_to_list_map_if_not_in_it_yet(lf, uri);
-			ms_free(uri);
-		}
-		iterator = bctbx_list_next(iterator);
+	if (lf->pending_vcard) {
+		char *uri = linphone_address_as_string_uri_only(lf->uri);
+		add_friend_to_list_map_if_not_in_it_yet(lf, uri);
+		ms_free(uri);
+		add_pending_vcard_uris_into_list_map(lf);
+		return;
 	}
+	add_friend_uris_into_list_map(lf);
 }
 
 bctbx_list_t* linphone_core_fetch_friends_from_db(LinphoneCore *lc, LinphoneFriendList *list) {
@@ -1717,6 +1890,7 @@ bctbx_list_t* linphone_core_fetch_friends_from_db(LinphoneCore *lc, LinphoneFrie
 	uint64_t begin,end;
 	bctbx_list_t *result = NULL;
 	bctbx_list_t *elem = NULL;
+	bool_t lazy;
 
 	if (!lc || lc->friends_db == NULL || list == NULL) {
 		ms_warning("Either lc (or list) is NULL or friends database wasn't initialized with linphone_core_friends_storage_init() yet");
@@ -1733,10 +1907,12 @@ bctbx_list_t* linphone_core_fetch_friends_from_db(LinphoneCore *lc, LinphoneFrie
 	ms_message("%s(): %u results fetched, completed in %i ms",__FUNCTION__, (unsigned int)bctbx_list_size(result), (int)(end-begin));
 	sqlite3_free(buf);
 
+	lazy = !!linphone_config_get_int(lc->config, "misc", "lazy_friends_loading", 1);
 	for (elem = result; elem != NULL; elem = bctbx_list_next(elem)) {
 		LinphoneFriend *lf = (LinphoneFriend *)bctbx_list_get_data(elem);
 		lf->lc = lc;
 		lf->friend_list = list;
+		if (!lazy) linphone_friend_load_vcard(lf);
 		linphone_friend_add_addresses_and_numbers_into_maps(lf, list);
 	}
 	linphone_vcard_context_set_user_data(lc->vcard_context, NULL);
@@ -1114,9 +1114,22 @@ void linphone_friend_list_update_subscriptions(LinphoneFriendList *list) {
 		}
 	} else if (list->enable_subscriptions) {
 		const bctbx_list_t *elem;
-		for (elem = list->friends; elem != NULL; elem = bctbx_list_next(elem)) {
-			LinphoneFriend *lf = (LinphoneFriend *)bctbx_list_get_data(elem);
-			linphone_friend_update_subscribes(lf, only_when_registered);
+		int batch = list->lc ? linphone_config_get_int(list->lc->config, "sip", "friend_subscribes_per_iteration", 100) : 0;
+		if (batch > 0 && bctbx_list_size(list->friends) > (size_t)batch) {
+			/* Large lists are subscribed a batch at a time by linphone_core_iterate() rather than all at once. */
+			bctbx_list_t *queued = NULL;
+			for (elem = list->friends; elem != NULL; elem = bctbx_list_next(elem)) {
+				LinphoneFriend *lf = (LinphoneFriend *)bctbx_list_get_data(elem);
+				if (lf->subscribe_queued) continue;
+				lf->subscribe_queued = TRUE;
+				queued = bctbx_list_prepend(queued, linphone_friend_ref(lf));
+			}
+			list->lc->friends_to_subscribe = bctbx_list_concat(list->lc->friends_to_subscribe, bctbx_list_reverse(queued));
+		} else {
+			for (elem = list->friends; elem != NULL; elem = bctbx_list_next(elem)) {
+				LinphoneFriend *lf = (LinphoneFriend *)bctbx_list_get_data(elem);
+				linphone_friend_update_subscribes(lf, only_when_registered);
+			}
 		}
 	}
 }
@@ -318,6 +318,22 @@ bool_t linphone_conference_params_local_participant_enabled(const LinphoneConfer
 	return ConferenceParams::toCpp(params)->localParticipantEnabled();
 }
 
+void linphone_conference_params_set_max_mixed_participants(LinphoneConferenceParams *params, int max){
+	ConferenceParams::toCpp(params)->setMaxMixedParticipants(max);
+}
+
+int linphone_conference_params_get_max_mixed_participants(const LinphoneConferenceParams *params){
+	return ConferenceParams::toCpp(params)->getMaxMixedParticipants();
+}
+
+void linphone_conference_params_set_audio_gating_threshold(LinphoneConferenceParams *params, float threshold){
+	ConferenceParams::toCpp(params)->setAudioGatingThreshold(threshold);
+}
+
+float linphone_conference_params_get_audio_gating_threshold(const LinphoneConferenceParams *params){
+	return ConferenceParams::toCpp(params)->getAudioGatingThreshold();
+}
+
 const char *linphone_conference_get_ID (const LinphoneConference *conference) {
 	return MediaConference::Conference::toCpp(conference)->getID().c_str();
 }
@@ -1268,6 +1268,11 @@ static void net_config_read(LinphoneCore *lc) {
 	linphone_core_enable_dns_srv(lc, !!tmp);
 	tmp = linphone_config_get_int(lc->config, "net", "dns_search_enabled", 1);
 	linphone_core_enable_dns_search(lc, !!tmp);
+	tmp = linphone_config_get_int(lc->config, "net", "dns_cache_enabled", 1);
+	lc->sal->enableDnsCache(!!tmp);
+	lc->sal->setDnsCacheDefaultTtl(linphone_config_get_int(lc->config, "net", "dns_cache_default_ttl", 300));
+	lc->sal->setDnsCacheNegativeTtl(linphone_config_get_int(lc->config, "net", "dns_cache_negative_ttl", 30));
+	lc->sal->setDnsCacheMaxStale(linphone_config_get_int(lc->config, "net", "dns_cache_max_stale", 3600));
 
 	// Update existing friend list subscribe state, otherwise change won't be applied until next core creation.
 	bool subscribe_enabled = L_GET_CPP_PTR_FROM_C_OBJECT(lc)->isFriendListSubscriptionEnabled();
@@ -1709,6 +1714,10 @@ static void sip_config_read(LinphoneCore *lc) {
 	lc->sip_conf.register_only_when_upnp_is_ok=
 		!!linphone_config_get_int(lc->config,"sip","register_only_when_upnp_is_ok",1);
 	lc->sip_conf.ping_with_options= !!linphone_config_get_int(lc->config,"sip","ping_with_options",0);
+	lc->sip_conf.register_rate_limit = linphone_config_get_int(lc->config, "sip", "register_rate_limit", 0);
+	lc->sip_conf.register_expires_jitter = linphone_config_get_int(lc->config, "sip", "register_expires_jitter", 0);
+	lc->sip_conf.register_tokens = lc->sip_conf.register_rate_limit;
+	lc->sip_conf.register_tokens_time = bctbx_get_cur_time_ms();
 	lc->sip_conf.auto_net_state_mon = !!linphone_config_get_int(lc->config,"sip","auto_net_state_mon",1);
 	lc->sip_conf.keepalive_period = (unsigned int)linphone_config_get_int(lc->config,"sip","keepalive_period",30000);
 	lc->sip_conf.tcp_tls_keepalive = !!linphone_config_get_int(lc->config,"sip","tcp_tls_keepalive",30000);
@@ -2307,6 +2316,10 @@ static void misc_config_read (LinphoneCore *lc) {
 		lc->user_certificates_path = bctbx_strdup(linphone_config_get_string(config, "misc", "user_certificates_path", "."));
 
 	lc->send_call_stats_periodical_updates = !!linphone_config_get_int(config, "misc", "send_call_stats_periodical_updates", 0);
+
+	/* Modifications are coalesced and written at most once per config_sync_delay. */
+	linphone_config_set_sync_delay(config, linphone_config_get_int(config, "misc", "config_sync_delay", 1000));
+	linphone_config_enable_background_sync(config, !!linphone_config_get_int(config, "misc", "config_background_sync", 0));
 }
 
 void linphone_core_reload_ms_plugins(LinphoneCore *lc, const char *path){
@@ -2317,12 +2330,16 @@ void linphone_core_reload_ms_plugins(LinphoneCore *lc, const char *path){
 
 static void _linphone_core_read_config(LinphoneCore * lc) {
 	sip_setup_register_all(lc->factory);
+	linphone_core_startup_phase_begin(lc, "sound config");
 	sound_config_read(lc);
+	linphone_core_startup_phase_end(lc, "sound config");
 	net_config_read(lc);
 	rtp_config_read(lc);
 	codecs_config_read(lc);
 	sip_config_read(lc);
+	linphone_core_startup_phase_begin(lc, "video config");
 	video_config_read(lc);
+	linphone_core_startup_phase_end(lc, "video config");
 	//autoreplier_config_init(&lc->autoreplier_conf);
 	misc_config_read(lc);
 	ui_config_read(lc);
@@ -2350,6 +2367,7 @@ void linphone_core_load_config_from_xml(LinphoneCore *lc, const char * xml_uri)
 }
 
 void linphone_configuring_terminated(LinphoneCore *lc, LinphoneConfiguringState state, const char *message) {
+	linphone_core_startup_phase_end(lc, "configuring");
 	linphone_core_notify_configuring_status(lc, state, message);
 
 	if (state == LinphoneConfiguringSuccessful) {
@@ -2365,8 +2383,11 @@ void linphone_configuring_terminated(LinphoneCore *lc, LinphoneConfiguringState
 		lc->provisioning_http_listener = NULL;
 	}
 
+	linphone_core_startup_phase_begin(lc, "transports");
 	_linphone_core_apply_transports(lc); // This will create SIP sockets.
+	linphone_core_startup_phase_end(lc, "transports");
 	L_GET_PRIVATE_FROM_C_OBJECT(lc)->initEphemeralMessages();
+	linphone_core_startup_timeline_stop(lc);
 	linphone_core_set_state(lc, LinphoneGlobalOn, "On");
 }
 
@@ -2749,6 +2770,18 @@ bool_t linphone_core_is_push_notification_enabled(LinphoneCore *core) {
 void linphone_core_set_auto_iterate_enabled(LinphoneCore *core, bool_t enable) {
 	linphone_config_set_int(core->config, "misc", "auto_iterate", enable);
 	core->auto_iterate_enabled = enable;
+	if (core->state == LinphoneGlobalOn) {
+		if (enable) getPlatformHelpers(core)->startAutoIterate();
+		else getPlatformHelpers(core)->stopAutoIterate();
+	}
+}
+
+void linphone_core_lock(LinphoneCore *core) {
+	getPlatformHelpers(core)->lockCore();
+}
+
+void linphone_core_unlock(LinphoneCore *core) {
+	getPlatformHelpers(core)->unlockCore();
 }
 
 bool_t linphone_core_is_auto_iterate_enabled(LinphoneCore *core) {
@@ -2771,6 +2804,9 @@ static void linphone_core_init(LinphoneCore * lc, LinphoneCoreCbs *cbs, LpConfig
 	lc->config=linphone_config_ref(config);
 	lc->data=userdata;
 
+	linphone_core_startup_timeline_start(lc);
+	linphone_core_startup_phase_begin(lc, "core init");
+
 	// We need the Sal on the Android platform helper init
 	lc->sal=new Sal(NULL);
 	lc->sal->setRefresherRetryAfter(linphone_config_get_int(lc->config, "sip", "refresher_retry_after", 60000));
@@ -2814,7 +2850,9 @@ static void linphone_core_init(LinphoneCore * lc, LinphoneCoreCbs *cbs, LpConfig
 	msplugins_dir = linphone_factory_get_msplugins_dir(lfactory);
 	image_resources_dir = linphone_factory_get_image_resources_dir(lfactory);
 	// MS Factory MUST be created after Android has been set, otherwise no camera will be detected !
+	linphone_core_startup_phase_begin(lc, "media factory"); // Loads the plugins and detects the sound cards and cameras.
 	lc->factory = ms_factory_new_with_voip_and_directories(msplugins_dir, image_resources_dir);
+	linphone_core_startup_phase_end(lc, "media factory");
 	lc->sal->setFactory(lc->factory);
 
 	belr::GrammarLoader::get().addPath(std::string(linphone_factory_get_top_resources_dir(lfactory)).append("/belr/grammars"));
@@ -2887,7 +2925,10 @@ static void linphone_core_init(LinphoneCore * lc, LinphoneCoreCbs *cbs, LpConfig
 	lc->presence_model = linphone_presence_model_new();
 	linphone_presence_model_set_basic_status(lc->presence_model, LinphonePresenceBasicStatusOpen);
 
+	linphone_core_startup_phase_begin(lc, "read config");
 	_linphone_core_read_config(lc);
+	linphone_core_startup_phase_end(lc, "read config");
+	linphone_core_startup_phase_end(lc, "core init");
 	linphone_core_set_state(lc, LinphoneGlobalReady, "Ready");
 
 	if (automatically_start) {
@@ -2918,9 +2959,14 @@ LinphoneStatus linphone_core_start (LinphoneCore *lc) {
 			return -1;
 		}
 
+		/* The timeline begun by linphone_core_init() goes on, a core started again after reaching On records a new one. */
+		if (!lc->startup_recording) linphone_core_startup_timeline_start(lc);
+		linphone_core_startup_phase_begin(lc, "core start");
 		linphone_core_set_state(lc, LinphoneGlobalStartup, "Starting up");
 
+		linphone_core_startup_phase_begin(lc, "storage");
 		L_GET_PRIVATE_FROM_C_OBJECT(lc)->init();
+		linphone_core_startup_phase_end(lc, "storage");
 
 		//to give a chance to change uuid before starting
 		const char* uuid=linphone_config_get_string(lc->config,"misc","uuid",NULL);
@@ -2944,6 +2990,7 @@ LinphoneStatus linphone_core_start (LinphoneCore *lc) {
 
 		linphone_core_set_state(lc, LinphoneGlobalConfiguring, "Configuring");
 
+		linphone_core_startup_phase_begin(lc, "configuring");
 		const char *remote_provisioning_uri = linphone_core_get_provisioning_uri(lc);
 		if (remote_provisioning_uri) {
 			if (linphone_remote_provisioning_download_and_apply(lc, remote_provisioning_uri) == -1)
@@ -2954,7 +3001,11 @@ LinphoneStatus linphone_core_start (LinphoneCore *lc) {
 		/* There should not be further actions below this line.
 		 * Indeed, linphone_configuring_terminated() shall perform the actions that comes after configuration.
 		 * It may be called directly, as above, or asynchronously after the remote provisioning is completed.
+		 * The only exception is the auto iterate thread, which must not run concurrently with the startup.
 		 * */
+		if (lc->auto_iterate_enabled)
+			getPlatformHelpers(lc)->startAutoIterate();
+		linphone_core_startup_phase_end(lc, "core start");
 		return 0;
 	} catch (const CorePrivate::DatabaseConnectionFailure &e) {
 		bctbx_error("%s", e.what());
@@ -3552,6 +3603,7 @@ static void __linphone_core_invalidate_registers(LinphoneCore* lc){
 		if (linphone_proxy_config_register_enabled(cfg)) {
 			/*this will force a re-registration at next iterate*/
 			cfg->commit = TRUE;
+			linphone_proxy_config_schedule_update(cfg);
 		}
 	}
 }
@@ -3822,7 +3874,27 @@ static void notify_network_reachable_change (LinphoneCore *lc) {
 
 static void proxy_update(LinphoneCore *lc){
 	bctbx_list_t *elem,*next;
-	bctbx_list_for_each(lc->sip_conf.proxies,(void (*)(void*))&linphone_proxy_config_update);
+	/* Only visit the proxy configs having a pending register or publish. They are kept until it is done, which may
+	 * take several iterations if they cannot register yet. Updates may schedule other ones, for the next iteration. */
+	bctbx_list_t *updatable = lc->sip_conf.updatable_proxies;
+	int previous_queue_depth = lc->sip_conf.register_queue_depth;
+	lc->sip_conf.updatable_proxies = NULL;
+	lc->sip_conf.updatable_proxies_tail = NULL;
+	lc->sip_conf.register_queue_depth = 0;
+	for (elem = updatable; elem != NULL; elem = elem->next) {
+		LinphoneProxyConfig *cfg = (LinphoneProxyConfig *)elem->data;
+		cfg->update_scheduled = FALSE;
+		if (cfg->deletion_date != 0) continue;
+		linphone_proxy_config_update(cfg);
+		if (cfg->commit || cfg->send_publish) linphone_proxy_config_schedule_update(cfg);
+	}
+	bctbx_list_free_with_data(updatable, (bctbx_list_free_func)linphone_proxy_config_unref);
+	if (lc->sip_conf.register_queue_depth > lc->sip_conf.register_queue_max_depth)
+		lc->sip_conf.register_queue_max_depth = lc->sip_conf.register_queue_depth;
+	if (lc->sip_conf.register_queue_depth > 0 && previous_queue_depth == 0)
+		ms_message("%i registrations postponed by the register rate limit (%i/s)", lc->sip_conf.register_queue_depth, lc->sip_conf.register_rate_limit);
+	else if (lc->sip_conf.register_queue_depth == 0 && previous_queue_depth > 0)
+		ms_message("All postponed registrations have been sent");
 	for(elem=lc->sip_conf.deleted_proxies;elem!=NULL;elem=next){
 		LinphoneProxyConfig* cfg = (LinphoneProxyConfig*)elem->data;
 		next=elem->next;
@@ -3951,6 +4023,10 @@ void linphone_core_iterate(LinphoneCore *lc){
 
 	if (lc->sal) lc->sal->iterate();
 	if (lc->msevq) ms_event_queue_pump(lc->msevq);
+	{
+		auto &mainDb = L_GET_PRIVATE_FROM_C_OBJECT(lc)->mainDb;
+		if (mainDb) mainDb->processAsyncQueriesResults();
+	}
 	if (linphone_core_get_global_state(lc) == LinphoneGlobalConfiguring)
 		// Avoid registration before getting remote configuration results
 		return;
@@ -3978,12 +4054,12 @@ void linphone_core_iterate(LinphoneCore *lc){
 		/*not do that immediately, take your time.*/
 		linphone_core_send_initial_subscribes(lc);
 	}
+	linphone_core_process_friends_to_subscribe(lc);
+
+	linphone_config_sync_if_needed(lc->config);
 
 	if (one_second_elapsed) {
 		bctbx_list_t *elem = NULL;
-		if (linphone_config_needs_commit(lc->config)) {
-			linphone_config_sync(lc->config);
-		}
 		for (elem = lc->friends_lists; elem != NULL; elem = bctbx_list_next(elem)) {
 			LinphoneFriendList *list = (LinphoneFriendList *)elem->data;
 			if (list->dirty_friends_to_update) {
@@ -4093,30 +4169,88 @@ static bctbx_list_t *make_routes_for_proxy(LinphoneProxyConfig *proxy, const Lin
 	return ret;
 }
 
+void linphone_core_invalidate_proxy_index(LinphoneCore *lc){
+	lc->sip_conf.proxy_index_dirty = TRUE;
+}
+
+static char *proxy_identity_index_key(const char *username, const char *domain, int port){
+	return bctbx_strdup_printf("%s@%s:%i", username ? username : "", domain ? domain : "", port);
+}
+
+/*
+ * The domain and identity indexes are multimaps whose entries keep the order of the proxies list, so that the lookups
+ * below choose the same proxy config as a walk of that list would. They are rebuilt once after any add, remove or
+ * identity change.
+ */
+static void linphone_core_update_proxy_index(LinphoneCore *lc){
+	sip_config_t *config = &lc->sip_conf;
+	const bctbx_list_t *elem;
+
+	if (config->proxies_by_domain && !config->proxy_index_dirty) return;
+	if (config->proxies_by_domain) bctbx_mmap_cchar_delete(config->proxies_by_domain);
+	if (config->proxies_by_identity) bctbx_mmap_cchar_delete(config->proxies_by_identity);
+	config->proxies_by_domain = bctbx_mmap_cchar_new();
+	config->proxies_by_identity = bctbx_mmap_cchar_new();
+
+	for (elem = config->proxies; elem != NULL; elem = elem->next) {
+		LinphoneProxyConfig *cfg = (LinphoneProxyConfig *)elem->data;
+		const LinphoneAddress *identity = linphone_proxy_config_get_identity_address(cfg);
+		if (!identity) continue;
+		const char *domain = linphone_address_get_domain(identity);
+		if (domain) bctbx_map_cchar_insert_and_delete(config->proxies_by_domain, (bctbx_pair_t *)bctbx_pair_cchar_new(domain, cfg));
+		char *key = proxy_identity_index_key(linphone_address_get_username(identity), domain, linphone_address_get_port(identity));
+		bctbx_map_cchar_insert_and_delete(config->proxies_by_identity, (bctbx_pair_t *)bctbx_pair_cchar_new(key, cfg));
+		bctbx_free(key);
+	}
+	config->proxy_index_dirty = FALSE;
+}
+
+static bool_t proxy_identity_matches(LinphoneProxyConfig *cfg, const char *username, const char *domain, int port){
+	const LinphoneAddress *identity = linphone_proxy_config_get_identity_address(cfg);
+	const char *cfg_username = linphone_address_get_username(identity);
+	const char *cfg_domain = linphone_address_get_domain(identity);
+	return strcmp(cfg_username ? cfg_username : "", username ? username : "") == 0
+		&& strcmp(cfg_domain ? cfg_domain : "", domain ? domain : "") == 0
+		&& linphone_address_get_port(identity) == port;
+}
+
 /*
  * Returns a proxy config matching the given identity address
  * Prefers registered, then first registering matching, otherwise first matching
  */
 LinphoneProxyConfig * linphone_core_lookup_proxy_by_identity(LinphoneCore *lc, const LinphoneAddress *uri){
+	return linphone_core_lookup_proxy_by_identity_parts(lc, linphone_address_get_username(uri), linphone_address_get_domain(uri), linphone_address_get_port(uri));
+}
+
+LinphoneProxyConfig * linphone_core_lookup_proxy_by_identity_parts(LinphoneCore *lc, const char *username, const char *domain, int port){
 	LinphoneProxyConfig *found_cfg = NULL;
 	LinphoneProxyConfig *found_reg_cfg = NULL;
 	LinphoneProxyConfig *found_noreg_cfg = NULL;
 	LinphoneProxyConfig *default_cfg=lc->default_proxy;
-	const bctbx_list_t *elem;
 
-	for (elem=linphone_core_get_proxy_config_list(lc);elem!=NULL;elem=elem->next){
-		LinphoneProxyConfig *cfg = (LinphoneProxyConfig*)elem->data;
-		if (linphone_address_weak_equal(uri, linphone_proxy_config_get_identity_address(cfg))) {
-			if (linphone_proxy_config_get_state(cfg) == LinphoneRegistrationOk) {
-				found_cfg=cfg;
-				break;
-			} else if (!found_reg_cfg && linphone_proxy_config_register_enabled(cfg)) {
-				found_reg_cfg=cfg;
-			} else if (!found_noreg_cfg) {
-				found_noreg_cfg=cfg;
-			}
+	linphone_core_update_proxy_index(lc);
+	char *key = proxy_identity_index_key(username, domain, port);
+	bctbx_iterator_t *it = bctbx_map_cchar_find_key(lc->sip_conf.proxies_by_identity, key);
+	bctbx_iterator_t *end = bctbx_map_cchar_end(lc->sip_conf.proxies_by_identity);
+	for (; !bctbx_iterator_cchar_equals(it, end); it = bctbx_iterator_cchar_get_next(it)) {
+		bctbx_pair_t *pair = bctbx_iterator_cchar_get_pair(it);
+		if (strcmp(bctbx_pair_cchar_get_first(reinterpret_cast<bctbx_pair_cchar_t *>(pair)), key) != 0) break;
+		LinphoneProxyConfig *cfg = (LinphoneProxyConfig *)bctbx_pair_cchar_get_second(pair);
+		/*the key is ambiguous if the username contains a '@'*/
+		if (!proxy_identity_matches(cfg, username, domain, port)) continue;
+		if (linphone_proxy_config_get_state(cfg) == LinphoneRegistrationOk) {
+			found_cfg=cfg;
+			break;
+		} else if (!found_reg_cfg && linphone_proxy_config_register_enabled(cfg)) {
+			found_reg_cfg=cfg;
+		} else if (!found_noreg_cfg) {
+			found_noreg_cfg=cfg;
 		}
 	}
+	bctbx_iterator_cchar_delete(it);
+	bctbx_iterator_cchar_delete(end);
+	bctbx_free(key);
+
 	if (!found_cfg && found_reg_cfg)    found_cfg = found_reg_cfg;
 	else if (!found_cfg && found_noreg_cfg) found_cfg = found_noreg_cfg;
 	if (!found_cfg) found_cfg=default_cfg; /*when no matching proxy config is found, use the default proxy config*/
@@ -4124,34 +4258,39 @@ LinphoneProxyConfig * linphone_core_lookup_proxy_by_identity(LinphoneCore *lc, c
 }
 
 LinphoneProxyConfig * linphone_core_lookup_known_proxy(LinphoneCore *lc, const LinphoneAddress *uri){
-	const bctbx_list_t *elem;
 	LinphoneProxyConfig *found_cfg=NULL;
 	LinphoneProxyConfig *found_reg_cfg=NULL;
 	LinphoneProxyConfig *found_noreg_cfg=NULL;
 	LinphoneProxyConfig *default_cfg=lc->default_proxy;
+	const char *uri_domain;
 
 	if (!uri) {
 		ms_error("Cannot look for proxy for NULL uri, returning default");
 		return default_cfg;
 	}
-	if (linphone_address_get_domain(uri) == NULL) {
+	uri_domain = linphone_address_get_domain(uri);
+	if (uri_domain == NULL) {
 		ms_message("Cannot look for proxy for uri [%p] that has no domain set, returning default", uri);
 		return default_cfg;
 	}
 	/*return default proxy if it is matching the destination uri*/
 	if (default_cfg){
 		const char *domain=linphone_proxy_config_get_domain(default_cfg);
-		if (domain && !strcmp(domain,linphone_address_get_domain(uri))){
+		if (domain && !strcmp(domain,uri_domain)){
 			found_cfg=default_cfg;
 			goto end;
 		}
 	}
 
 	/*otherwise return first registered, then first registering matching, otherwise first matching */
-	for (elem=linphone_core_get_proxy_config_list(lc);elem!=NULL;elem=elem->next){
-		LinphoneProxyConfig *cfg=(LinphoneProxyConfig*)elem->data;
-		const char *domain=linphone_proxy_config_get_domain(cfg);
-		if (domain!=NULL && strcmp(domain,linphone_address_get_domain(uri))==0){
+	{
+		linphone_core_update_proxy_index(lc);
+		bctbx_iterator_t *it = bctbx_map_cchar_find_key(lc->sip_conf.proxies_by_domain, uri_domain);
+		bctbx_iterator_t *it_end = bctbx_map_cchar_end(lc->sip_conf.proxies_by_domain);
+		for (; !bctbx_iterator_cchar_equals(it, it_end); it = bctbx_iterator_cchar_get_next(it)) {
+			bctbx_pair_t *pair = bctbx_iterator_cchar_get_pair(it);
+			if (strcmp(bctbx_pair_cchar_get_first(reinterpret_cast<bctbx_pair_cchar_t *>(pair)), uri_domain) != 0) break;
+			LinphoneProxyConfig *cfg = (LinphoneProxyConfig *)bctbx_pair_cchar_get_second(pair);
 			if (linphone_proxy_config_get_state(cfg) == LinphoneRegistrationOk ){
 				found_cfg=cfg;
 				break;
@@ -4161,6 +4300,8 @@ LinphoneProxyConfig * linphone_core_lookup_known_proxy(LinphoneCore *lc, const L
 				found_noreg_cfg=cfg;
 			}
 		}
+		bctbx_iterator_cchar_delete(it);
+		bctbx_iterator_cchar_delete(it_end);
 	}
 end:
 	if     ( !found_cfg && found_reg_cfg)    found_cfg = found_reg_cfg;
@@ -6588,6 +6729,17 @@ void sip_config_uninit(LinphoneCore *lc)
 		}
 	}
 
+	config->updatable_proxies = bctbx_list_free_with_data(config->updatable_proxies, (bctbx_list_free_func)linphone_proxy_config_unref);
+	config->updatable_proxies_tail = NULL;
+	if (config->proxies_by_domain) {
+		bctbx_mmap_cchar_delete(config->proxies_by_domain);
+		config->proxies_by_domain = NULL;
+	}
+	if (config->proxies_by_identity) {
+		bctbx_mmap_cchar_delete(config->proxies_by_identity);
+		config->proxies_by_identity = NULL;
+	}
+
 	elem = config->proxies;
 	config->proxies=NULL; /*to make sure proxies cannot be referenced during deletion*/
 	bctbx_list_free_with_data(elem,(void (*)(void*)) _linphone_proxy_config_release);
@@ -6597,6 +6749,7 @@ void sip_config_uninit(LinphoneCore *lc)
 	/*no longuer need to write proxy config if not changed linphone_proxy_config_write_to_config_file(lc->config,NULL,i);*/	/*mark the end */
 
 	lc->auth_info=bctbx_list_free_with_data(lc->auth_info,(void (*)(void*))linphone_auth_info_unref);
+	_linphone_core_release_auth_info_indexes(lc);
 	lc->default_proxy = NULL;
 
 	if (lc->vcard_context) {
@@ -6763,6 +6916,7 @@ static void codecs_config_uninit(LinphoneCore *lc)
 void friends_config_uninit(LinphoneCore* lc)
 {
 	ms_message("Destroying friends.");
+	linphone_core_clear_friends_to_subscribe(lc);
 	lc->friends_lists = bctbx_list_free_with_data(lc->friends_lists, (void (*)(void*))_linphone_friend_list_release);
 	if (lc->subscribers) {
 		lc->subscribers = bctbx_list_free_with_data(lc->subscribers, (void (*)(void *))_linphone_friend_release);
@@ -6944,6 +7098,8 @@ static void _linphone_core_stop(LinphoneCore *lc) {
 		return;
 	}
 
+	/* The core is iterated below by the calling thread. */
+	getPlatformHelpers(lc)->stopAutoIterate();
 	_linphone_core_stop_async_start(lc);
 
 	bool_t is_off = FALSE;
@@ -6977,6 +7133,8 @@ void _linphone_core_uninit(LinphoneCore *lc)
 		_linphone_core_stop(lc);
 	}
 
+	linphone_core_startup_timeline_clear(lc);
+	linphone_reporting_release_buffer(lc);
 	linphone_config_unref(lc->config);
 	lc->config = NULL;
 #ifdef __ANDROID__
@@ -7001,6 +7159,7 @@ static void stop_refreshing_proxy_config(bool_t is_sip_reachable, LinphoneProxyC
 			cfg->commit=TRUE;
 			if (linphone_proxy_config_publish_enabled(cfg))
 				cfg->send_publish=TRUE; /*not sure if really the best place*/
+			linphone_proxy_config_schedule_update(cfg);
 		}
 	}
 }
@@ -7033,6 +7192,8 @@ static void set_sip_network_reachable(LinphoneCore* lc,bool_t is_sip_reachable,
 	if (!lc->sip_network_state.global_state){
 		linphone_core_invalidate_friend_subscriptions(lc);
 		lc->sal->resetTransports();
+		/* The answers may differ on the next network. */
+		lc->sal->clearDnsCache();
 	}
 }
 
@@ -7042,6 +7203,8 @@ static void set_media_network_reachable(LinphoneCore* lc, bool_t is_media_reacha
 
 	ms_message("Media network reachability state is now [%s]",is_media_reachable?"UP":"DOWN");
 	lc->media_network_state.global_state=is_media_reachable;
+	/* The interfaces are likely to have changed. */
+	L_GET_PRIVATE_FROM_C_OBJECT(lc)->invalidateLocalAddresses();
 
 	if (lc->media_network_state.global_state){
 		if (lc->bw_controller){
@@ -7125,6 +7288,10 @@ int linphone_core_get_calls_nb(const LinphoneCore *lc) {
 	return (int)L_GET_CPP_PTR_FROM_C_OBJECT(lc)->getCallCount();
 }
 
+char *linphone_core_get_metrics(LinphoneCore *lc) {
+	return bctbx_strdup(L_GET_PRIVATE_FROM_C_OBJECT(lc)->metrics.toPrometheusText().c_str());
+}
+
 
 void linphone_core_soundcard_hint_check(LinphoneCore* lc) {
 	L_GET_CPP_PTR_FROM_C_OBJECT(lc)->soundcardHintCheck();
@@ -7325,6 +7492,77 @@ int _linphone_sqlite3_open(const char *db_file, sqlite3 **db) {
 	return ret;
 }
 
+bctbx_list_t *_linphone_sqlite3_get_profile_pragmas(LinphoneConfig *config) {
+	bctbx_list_t *pragmas = NULL;
+	const char *profile = linphone_config_get_string(config, "storage", "sqlite_profile", "default");
+	/* The default profile changes nothing, the databases keep the journal mode they were created with. */
+	const char *journal_mode = NULL;
+	const char *synchronous = NULL;
+	const char *temp_store = NULL;
+	int cache_size = 0;
+	int page_size = 0;
+	int mmap_size = -1;
+
+	if (strcmp(profile, "performance") == 0) {
+		journal_mode = "WAL";
+		synchronous = "NORMAL";
+		temp_store = "MEMORY";
+		cache_size = -8192; /* In KiB when negative. */
+	} else if (strcmp(profile, "safe") == 0) {
+		journal_mode = "DELETE";
+		synchronous = "FULL";
+	} else if (strcmp(profile, "default") != 0) {
+		ms_warning("Unknown sqlite profile [%s], using default one.", profile);
+	}
+
+	/* Each setting of the profile can be overridden. */
+	journal_mode = linphone_config_get_string(config, "storage", "sqlite_journal_mode", journal_mode);
+	synchronous = linphone_config_get_string(config, "storage", "sqlite_synchronous", synchronous);
+	temp_store = linphone_config_get_string(config, "storage", "sqlite_temp_store", temp_store);
+	cache_size = linphone_config_get_int(config, "storage", "sqlite_cache_size", cache_size);
+	page_size = linphone_config_get_int(config, "storage", "sqlite_page_size", page_size);
+	mmap_size = linphone_config_get_int(config, "storage", "sqlite_mmap_size", mmap_size);
+
+	/* The page size must be set before the database switches to WAL, it cannot be changed afterwards. */
+	if (page_size > 0)
+		pragmas = bctbx_list_append(pragmas, bctbx_strdup_printf("PRAGMA page_size=%d", page_size));
+	if (journal_mode) {
+		/* The bctbx VFS implements neither file locking nor shared memory. A database in WAL can then only be
+		 * read in the exclusive locking mode, so that sqlite keeps the WAL index in heap memory. The normal
+		 * locking mode is only restored once the database has left WAL. */
+		pragmas = bctbx_list_append(pragmas, bctbx_strdup("PRAGMA locking_mode=EXCLUSIVE"));
+		pragmas = bctbx_list_append(pragmas, bctbx_strdup_printf("PRAGMA journal_mode=%s", journal_mode));
+		if (strcasecmp(journal_mode, "WAL") != 0)
+			pragmas = bctbx_list_append(pragmas, bctbx_strdup("PRAGMA locking_mode=NORMAL"));
+	}
+	if (synchronous)
+		pragmas = bctbx_list_append(pragmas, bctbx_strdup_printf("PRAGMA synchronous=%s", synchronous));
+	if (cache_size != 0)
+		pragmas = bctbx_list_append(pragmas, bctbx_strdup_printf("PRAGMA cache_size=%d", cache_size));
+	if (temp_store)
+		pragmas = bctbx_list_append(pragmas, bctbx_strdup_printf("PRAGMA temp_store=%s", temp_store));
+	/* Only effective with a VFS providing xFetch, the bctbx one silently ignores it. */
+	if (mmap_size >= 0)
+		pragmas = bctbx_list_append(pragmas, bctbx_strdup_printf("PRAGMA mmap_size=%d", mmap_size));
+
+	return pragmas;
+}
+
+void _linphone_sqlite3_apply_profile(LinphoneConfig *config, sqlite3 *db) {
+	bctbx_list_t *pragmas = _linphone_sqlite3_get_profile_pragmas(config);
+	bctbx_list_t *it;
+
+	for (it = pragmas; it != NULL; it = bctbx_list_next(it)) {
+		const char *pragma = (const char *)bctbx_list_get_data(it);
+		char *errmsg = NULL;
+		if (sqlite3_exec(db, pragma, NULL, NULL, &errmsg) != SQLITE_OK) {
+			ms_error("Cannot apply sqlite3 storage profile [%s]: %s.", pragma, errmsg);
+			sqlite3_free(errmsg);
+		}
+	}
+	bctbx_list_free_with_data(pragmas, bctbx_free);
+}
+
 // =============================================================================
 //migration code remove in april 2019, 2 years after switching from xml based zrtp cache to sqlite
 void linphone_core_set_zrtp_secrets_file(LinphoneCore *lc, const char* file){
@@ -7402,6 +7640,7 @@ void linphone_core_zrtp_cache_db_init(LinphoneCore *lc, const char *fileName) {
 		lc->zrtp_cache_db=NULL;
 		goto end;
 	}
+	_linphone_core_startup_timeline_watch_db(lc, db);
 
 	ret = ms_zrtp_initCache((void *)db, &(lc->zrtp_cache_db_mutex)); /* this may perform an update, check return value */
 
@@ -7409,6 +7648,7 @@ void linphone_core_zrtp_cache_db_init(LinphoneCore *lc, const char *fileName) {
 		/* After updating schema, database need to be closed/reopenned */
 		sqlite3_close(db);
 		_linphone_sqlite3_open(fileName, &db);
+		_linphone_core_startup_timeline_watch_db(lc, db);
 	} else if(ret != 0) { /* something went wrong */
 		ms_error("Zrtp cache failed to initialise(returned -%x), run cacheless", -ret);
 		sqlite3_close(db);
@@ -43,6 +43,11 @@
 #include <stdlib.h>
 #include <string.h>
 #include <assert.h>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
 #if !defined(_WIN32_WCE)
 #include <errno.h>
 #include <sys/types.h>
@@ -52,6 +57,12 @@
 #endif
 #endif /*_WIN32_WCE*/
 
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
 #ifdef _MSC_VER
 #ifdef LINPHONE_WINDOWS_DESKTOP
 #include <Shlwapi.h>
@@ -73,6 +84,7 @@
 
 #include "c-wrapper/c-wrapper.h"
 #include "core/paths/paths.h"
+#include "private.h"
 
 typedef struct _LpItem{
 	char *key;
@@ -95,15 +107,42 @@ typedef struct _LpSection{
 	bool_t skip; // If set to true, won't be dumped when converted to xml
 } LpSection;
 
+/* Writes the serialized configuration from a background thread. Only the latest content handed over is written,
+ * intermediate ones are dropped. */
+struct _LpConfigWriter{
+	std::thread thread;
+	std::mutex mutex;
+	std::condition_variable cond;
+	std::string pending;
+	std::string filename;
+	std::string tmpfilename;
+	bctbx_vfs_t *vfs;
+	int error;
+	bool has_pending;
+	bool busy;
+	bool stop;
+};
+
+typedef struct _LpConfigWriter LpConfigWriter;
+
 struct _LpConfig{
 	belle_sip_object_t base;
 	bctbx_vfs_file_t* pFile;
 	char *filename;
 	char *tmpfilename;
 	char *factory_filename;
+	char *snapshot_filename;
 	bctbx_list_t *sections;
 	bool_t modified;
 	bool_t readonly;
+	bool_t has_written_hash;
+	bool_t background_sync;
+	int sync_delay; /* in milliseconds */
+	uint64_t modified_time; /* when the config became modified since the last write */
+	uint64_t written_hash; /* hash of the content last written to disk */
+	uint64_t load_start; /* when the files began to be read, in microseconds on the steady clock */
+	uint64_t load_end;
+	LpConfigWriter *writer;
 	bctbx_vfs_t* g_bctbx_vfs;
 };
 
@@ -122,6 +161,13 @@ char* lp_realpath(const char* file, char* name) {
 #endif
 }
 
+static void lp_config_mark_modified(LpConfig *lpconfig){
+	if (!lpconfig->modified){
+		lpconfig->modified = TRUE;
+		lpconfig->modified_time = bctbx_get_cur_time_ms();
+	}
+}
+
 LpItem * lp_item_new(const char *key, const char *value){
 	LpItem *item=lp_new0(LpItem,1);
 	item->key=ortp_strdup(key);
@@ -435,7 +481,273 @@ LpConfig * linphone_config_new_from_buffer(const char *buffer){
 	return conf;
 }
 
+static int lp_config_write_file(bctbx_vfs_t *vfs, const char *filename, const char *tmpfilename, const std::string &content);
+
+/*
+ * Binary snapshot of the configuration as built from the user and factory config files.
+ * It is only valid for the files it was built from: their paths, sizes and modification times are stored in the
+ * header, so that checking it does not require reading the files. Integers are stored in host byte order, strings as a length followed by the characters and a
+ * terminating null character, so that they can be used directly from the mapped file.
+ */
+#define LP_SNAPSHOT_MAGIC 0x5343504c /* "LPCS" */
+#define LP_SNAPSHOT_VERSION 2
+#define LP_SNAPSHOT_NULL_STRING 0xffffffff
+
+typedef struct _LpFileStamp{
+	int64_t size;
+	int64_t mtime; /*in nanoseconds where the system provides them*/
+	uint32_t present;
+} LpFileStamp;
+
+#ifdef _WIN32
+static bool_t lp_read_whole_file(const char *path, std::string &content){
+	char buffer[MAX_LEN];
+	size_t read_size;
+	FILE *f = fopen(path, "rb");
+	if (f == NULL) return FALSE;
+	while ((read_size = fread(buffer, 1, sizeof(buffer), f)) > 0)
+		content.append(buffer, read_size);
+	fclose(f);
+	return TRUE;
+}
+#endif
+
+static void lp_file_stamp_compute(const char *path, LpFileStamp *stamp){
+	struct stat st;
+
+	memset(stamp, 0, sizeof(*stamp));
+	if (path == NULL || stat(path, &st) != 0) return;
+	stamp->present = 1;
+	stamp->size = (int64_t)st.st_size;
+#if defined(__APPLE__)
+	stamp->mtime = (int64_t)st.st_mtimespec.tv_sec * 1000000000 + st.st_mtimespec.tv_nsec;
+#elif defined(_WIN32)
+	stamp->mtime = (int64_t)st.st_mtime * 1000000000;
+#else
+	stamp->mtime = (int64_t)st.st_mtim.tv_sec * 1000000000 + st.st_mtim.tv_nsec;
+#endif
+}
+
+static void lp_snapshot_append(std::string &out, const void *data, size_t size){
+	out.append((const char *)data, size);
+}
+
+static void lp_snapshot_append_u32(std::string &out, uint32_t value){
+	lp_snapshot_append(out, &value, sizeof(value));
+}
+
+static void lp_snapshot_append_string(std::string &out, const char *value){
+	if (value == NULL){
+		lp_snapshot_append_u32(out, LP_SNAPSHOT_NULL_STRING);
+		return;
+	}
+	size_t size = strlen(value);
+	lp_snapshot_append_u32(out, (uint32_t)size);
+	lp_snapshot_append(out, value, size + 1);
+}
+
+static void lp_snapshot_append_stamp(std::string &out, const LpFileStamp *stamp){
+	lp_snapshot_append(out, &stamp->size, sizeof(stamp->size));
+	lp_snapshot_append(out, &stamp->mtime, sizeof(stamp->mtime));
+	lp_snapshot_append_u32(out, stamp->present);
+}
+
+static void lp_config_write_snapshot(const LpConfig *lpconfig, const LpFileStamp *rc_stamp, const LpFileStamp *factory_stamp){
+	std::string out;
+	const bctbx_list_t *elem, *it;
+
+	lp_snapshot_append_u32(out, LP_SNAPSHOT_MAGIC);
+	lp_snapshot_append_u32(out, LP_SNAPSHOT_VERSION);
+	lp_snapshot_append_string(out, lpconfig->filename);
+	lp_snapshot_append_stamp(out, rc_stamp);
+	lp_snapshot_append_string(out, lpconfig->factory_filename);
+	lp_snapshot_append_stamp(out, factory_stamp);
+	lp_snapshot_append_u32(out, (uint32_t)bctbx_list_size(lpconfig->sections));
+	for (elem = lpconfig->sections; elem != NULL; elem = bctbx_list_next(elem)){
+		const LpSection *sec = (const LpSection *)elem->data;
+		lp_snapshot_append_string(out, sec->name);
+		lp_snapshot_append_u32(out, (uint32_t)bctbx_list_size(sec->params));
+		for (it = sec->params; it != NULL; it = bctbx_list_next(it)){
+			const LpSectionParam *param = (const LpSectionParam *)it->data;
+			lp_snapshot_append_string(out, param->key);
+			lp_snapshot_append_string(out, param->value);
+		}
+		lp_snapshot_append_u32(out, (uint32_t)bctbx_list_size(sec->items));
+		for (it = sec->items; it != NULL; it = bctbx_list_next(it)){
+			const LpItem *item = (const LpItem *)it->data;
+			lp_snapshot_append_u32(out, (uint32_t)item->is_comment);
+			lp_snapshot_append_string(out, item->key);
+			lp_snapshot_append_string(out, item->value);
+		}
+	}
+
+	char *tmpfilename = bctbx_strdup_printf("%s.tmp", lpconfig->snapshot_filename);
+	if (lp_config_write_file(lpconfig->g_bctbx_vfs, lpconfig->snapshot_filename, tmpfilename, out) != 0)
+		ms_warning("Could not write config snapshot %s", lpconfig->snapshot_filename);
+	bctbx_free(tmpfilename);
+}
+
+typedef struct _LpSnapshotReader{
+	const char *pos;
+	const char *end;
+	bool_t error;
+} LpSnapshotReader;
+
+static void lp_snapshot_read(LpSnapshotReader *reader, void *data, size_t size){
+	if (reader->error || (size_t)(reader->end - reader->pos) < size){
+		reader->error = TRUE;
+		memset(data, 0, size);
+		return;
+	}
+	memcpy(data, reader->pos, size);
+	reader->pos += size;
+}
+
+static uint32_t lp_snapshot_read_u32(LpSnapshotReader *reader){
+	uint32_t value;
+	lp_snapshot_read(reader, &value, sizeof(value));
+	return value;
+}
+
+/* Returns a pointer into the snapshot, not to be freed. */
+static const char *lp_snapshot_read_string(LpSnapshotReader *reader){
+	uint32_t size = lp_snapshot_read_u32(reader);
+	const char *value;
+	if (reader->error || size == LP_SNAPSHOT_NULL_STRING) return NULL;
+	if ((size_t)(reader->end - reader->pos) <= size || reader->pos[size] != '\0'){
+		reader->error = TRUE;
+		return NULL;
+	}
+	value = reader->pos;
+	reader->pos += size + 1;
+	return value;
+}
+
+static bool_t lp_snapshot_read_stamp_matches(LpSnapshotReader *reader, const LpFileStamp *expected){
+	LpFileStamp stamp;
+	memset(&stamp, 0, sizeof(stamp));
+	lp_snapshot_read(reader, &stamp.size, sizeof(stamp.size));
+	lp_snapshot_read(reader, &stamp.mtime, sizeof(stamp.mtime));
+	stamp.present = lp_snapshot_read_u32(reader);
+	if (reader->error || stamp.present != expected->present) return FALSE;
+	return !stamp.present || (stamp.size == expected->size && stamp.mtime == expected->mtime);
+}
+
+static bool_t lp_snapshot_strings_equal(const char *a, const char *b){
+	if (a == NULL || b == NULL) return a == b;
+	return strcmp(a, b) == 0;
+}
+
+/* Appends in constant time by keeping track of the last element. */
+static bctbx_list_t *lp_list_append_fast(bctbx_list_t *list, bctbx_list_t **last, void *data){
+	bctbx_list_t *elem = bctbx_list_new(data);
+	if (*last == NULL){
+		list = elem;
+	}else{
+		(*last)->next = elem;
+		elem->prev = *last;
+	}
+	*last = elem;
+	return list;
+}
+
+static bool_t lp_config_parse_snapshot(LpConfig *lpconfig, const char *data, size_t size, const LpFileStamp *rc_stamp, const LpFileStamp *factory_stamp){
+	LpSnapshotReader reader = { data, data + size, FALSE };
+	bctbx_list_t *sections = NULL, *last_section = NULL;
+	uint32_t section_count, count, i, j;
+
+	if (lp_snapshot_read_u32(&reader) != LP_SNAPSHOT_MAGIC || lp_snapshot_read_u32(&reader) != LP_SNAPSHOT_VERSION) return FALSE;
+	if (!lp_snapshot_strings_equal(lp_snapshot_read_string(&reader), lpconfig->filename) || !lp_snapshot_read_stamp_matches(&reader, rc_stamp)) return FALSE;
+	if (!lp_snapshot_strings_equal(lp_snapshot_read_string(&reader), lpconfig->factory_filename) || !lp_snapshot_read_stamp_matches(&reader, factory_stamp)) return FALSE;
+
+	section_count = lp_snapshot_read_u32(&reader);
+	for (i = 0; i < section_count && !reader.error; i++){
+		bctbx_list_t *last = NULL;
+		const char *name = lp_snapshot_read_string(&reader);
+		if (name == NULL){
+			reader.error = TRUE;
+			break;
+		}
+		LpSection *sec = lp_section_new(name);
+		sections = lp_list_append_fast(sections, &last_section, sec);
+
+		count = lp_snapshot_read_u32(&reader);
+		for (j = 0; j < count && !reader.error; j++){
+			const char *key = lp_snapshot_read_string(&reader);
+			const char *value = lp_snapshot_read_string(&reader);
+			if (key == NULL || value == NULL){
+				reader.error = TRUE;
+				break;
+			}
+			sec->params = lp_list_append_fast(sec->params, &last, lp_section_param_new(key, value));
+		}
+		last = NULL;
+		count = lp_snapshot_read_u32(&reader);
+		for (j = 0; j < count && !reader.error; j++){
+			uint32_t is_comment = lp_snapshot_read_u32(&reader);
+			const char *key = lp_snapshot_read_string(&reader);
+			const char *value = lp_snapshot_read_string(&reader);
+			if (reader.error || value == NULL){
+				reader.error = TRUE;
+				break;
+			}
+			LpItem *item = lp_item_new(key, value);
+			item->is_comment = (int)is_comment;
+			sec->items = lp_list_append_fast(sec->items, &last, item);
+		}
+	}
+	if (reader.error || i != section_count || reader.pos != reader.end){
+		ms_warning("Config snapshot %s is corrupted, ignoring it", lpconfig->snapshot_filename);
+		bctbx_list_for_each(sections, (void (*)(void*))lp_section_destroy);
+		bctbx_list_free(sections);
+		return FALSE;
+	}
+	lpconfig->sections = sections;
+	return TRUE;
+}
+
+static bool_t lp_config_load_snapshot(LpConfig *lpconfig, const LpFileStamp *rc_stamp, const LpFileStamp *factory_stamp){
+	bool_t loaded;
+#ifndef _WIN32
+	struct stat st;
+	void *data;
+	int fd = open(lpconfig->snapshot_filename, O_RDONLY);
+	if (fd < 0) return FALSE;
+	if (fstat(fd, &st) != 0 || st.st_size == 0){
+		close(fd);
+		return FALSE;
+	}
+	data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (data == MAP_FAILED) return FALSE;
+	loaded = lp_config_parse_snapshot(lpconfig, (const char *)data, (size_t)st.st_size, rc_stamp, factory_stamp);
+	munmap(data, (size_t)st.st_size);
+#else
+	std::string content;
+	if (!lp_read_whole_file(lpconfig->snapshot_filename, content)) return FALSE;
+	loaded = lp_config_parse_snapshot(lpconfig, content.c_str(), content.size(), rc_stamp, factory_stamp);
+#endif
+	return loaded;
+}
+
+static uint64_t lp_config_now(void){
+	return (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()
+	).count();
+}
+
+void _linphone_config_get_load_interval(const LinphoneConfig *lpconfig, uint64_t *start, uint64_t *end){
+	*start = lpconfig->load_start;
+	*end = lpconfig->load_end;
+}
+
 static int _linphone_config_init_from_files(LinphoneConfig *lpconfig, const char *config_filename, const char *factory_config_filename) {
+	LpFileStamp rc_stamp, factory_stamp;
+
+	lpconfig->load_start = lp_config_now();
+
+	memset(&rc_stamp, 0, sizeof(rc_stamp));
+	memset(&factory_stamp, 0, sizeof(factory_stamp));
 	lpconfig->g_bctbx_vfs = bctbx_vfs_get_default();
 
 	if (config_filename != NULL && config_filename[0] != '\0'){
@@ -464,6 +776,16 @@ static int _linphone_config_init_from_files(LinphoneConfig *lpconfig, const char
 		}
 #endif /*_WIN32*/
 
+		if (lpconfig->snapshot_filename){
+			lp_file_stamp_compute(lpconfig->filename, &rc_stamp);
+			lp_file_stamp_compute(lpconfig->factory_filename, &factory_stamp);
+			if (lp_config_load_snapshot(lpconfig, &rc_stamp, &factory_stamp)){
+				ms_message("Config loaded from snapshot %s", lpconfig->snapshot_filename);
+				lpconfig->load_end = lp_config_now();
+				return 0;
+			}
+		}
+
 		/*open with r+ to check if we can write on it later*/
 		lpconfig->pFile = bctbx_file_open(lpconfig->g_bctbx_vfs,lpconfig->filename, "r+");
 #ifdef RENAME_REQUIRES_NONEXISTENT_NEW_PATH
@@ -482,6 +804,9 @@ static int _linphone_config_init_from_files(LinphoneConfig *lpconfig, const char
 		}
 	}
 	_linphone_config_apply_factory_config(lpconfig);
+	if (lpconfig->filename && lpconfig->snapshot_filename)
+		lp_config_write_snapshot(lpconfig, &rc_stamp, &factory_stamp);
+	lpconfig->load_end = lp_config_now();
 	return 0;
 
 fail:
@@ -500,6 +825,20 @@ LpConfig *linphone_config_new_with_factory(const char *config_filename, const ch
 	}
 }
 
+LinphoneConfig *linphone_config_new_with_snapshot(const char *config_filename, const char *factory_config_filename, const char *snapshot_filename) {
+	LpConfig *lpconfig=belle_sip_object_new(LinphoneConfig);
+	if (factory_config_filename && strcmp(factory_config_filename, "") != 0)
+		lpconfig->factory_filename = bctbx_strdup(factory_config_filename);
+	if (snapshot_filename && strcmp(snapshot_filename, "") != 0)
+		lpconfig->snapshot_filename = bctbx_strdup(snapshot_filename);
+	if (_linphone_config_init_from_files(lpconfig, config_filename, factory_config_filename) == 0) {
+		return lpconfig;
+	} else {
+		linphone_config_unref(lpconfig);
+		return NULL;
+	}
+}
+
 LpConfig *linphone_config_new_for_shared_core(const char *app_group_id, const char* config_filename, const char *factory_path) {
 	std::string path = LinphonePrivate::Paths::getPath(LinphonePrivate::Paths::Config, static_cast<void *>(strdup(app_group_id)));
 	path = path + "/" + config_filename;
@@ -604,10 +943,14 @@ void lp_item_set_value(LpItem *item, const char *value){
 }
 
 
+static void lp_config_writer_destroy(LpConfig *lpconfig);
+
 static void _linphone_config_uninit(LpConfig *lpconfig){
+	if (lpconfig->writer) lp_config_writer_destroy(lpconfig);
 	if (lpconfig->filename!=NULL) ortp_free(lpconfig->filename);
 	if (lpconfig->tmpfilename) ortp_free(lpconfig->tmpfilename);
 	if (lpconfig->factory_filename) bctbx_free(lpconfig->factory_filename);
+	if (lpconfig->snapshot_filename) bctbx_free(lpconfig->snapshot_filename);
 	bctbx_list_for_each(lpconfig->sections,(void (*)(void*))lp_section_destroy);
 	bctbx_list_free(lpconfig->sections);
 }
@@ -787,15 +1130,15 @@ void linphone_config_set_string(LpConfig *lpconfig,const char *section, const ch
 				lp_section_remove_item(sec, item);
 			}
 		}else{
-			if (value!=NULL && value[0] != '\0')
-				lp_section_add_item(sec,lp_item_new(key,value));
+			if (value==NULL || value[0] == '\0') return;
+			lp_section_add_item(sec,lp_item_new(key,value));
 		}
 	}else if (value!=NULL && value[0] != '\0'){
 		sec=lp_section_new(section);
 		linphone_config_add_section(lpconfig,sec);
 		lp_section_add_item(sec,lp_item_new(key,value));
-	}
-	lpconfig->modified = TRUE;
+	}else return;
+	lp_config_mark_modified(lpconfig);
 }
 
 void linphone_config_set_string_list(LpConfig *lpconfig, const char *section, const char *key, const bctbx_list_t *value) {
@@ -889,83 +1232,259 @@ void linphone_config_set_skip_flag_for_section(LpConfig *lpconfig, const char *s
 	}
 }
 
-void lp_item_write(LpItem *item, LpConfig *lpconfig){
-	int ret =-1 ;
+static void lp_item_serialize(const LpItem *item, std::string &out){
 	if (item->is_comment){
-		ret = (int)bctbx_file_fprintf(lpconfig->pFile, 0, "%s\n",item->value);
-
-	}
-	else if (item->value && item->value[0] != '\0' ){
-		ret = (int)bctbx_file_fprintf(lpconfig->pFile, 0, "%s=%s\n",item->key,item->value);
-	}
-
-	else {
+		out.append(item->value);
+		out.append("\n");
+	}else if (item->value && item->value[0] != '\0' ){
+		out.append(item->key);
+		out.append("=");
+		out.append(item->value);
+		out.append("\n");
+	}else{
 		ms_warning("Not writing item %s to file, it is empty", item->key);
 	}
-	if (ret < 0){
-		ms_error("lp_item_write : not writing item to file" );
-	}
 }
 
-void lp_section_param_write(LpSectionParam *param, LpConfig *lpconfig){
+static void lp_section_param_serialize(const LpSectionParam *param, std::string &out){
 	if( param->value && param->value[0] != '\0') {
-		bctbx_file_fprintf(lpconfig->pFile, 0, " %s=%s", param->key, param->value);
-
+		out.append(" ");
+		out.append(param->key);
+		out.append("=");
+		out.append(param->value);
 	} else {
 		ms_warning("Not writing param %s to file, it is empty", param->key);
 	}
 }
 
-void lp_section_write(LpSection *sec,LpConfig *lpconfig){
-
-	if (bctbx_file_fprintf(lpconfig->pFile, 0, "[%s",sec->name) < 0) ms_error("lp_section_write : write error on %s", sec->name);
-	bctbx_list_for_each2(sec->params, (void (*)(void*, void*))lp_section_param_write, (void *)lpconfig);
-
-	if (bctbx_file_fprintf(lpconfig->pFile, 0, "]\n")< 0) ms_error("lp_section_write : write error ");
-	bctbx_list_for_each2(sec->items, (void (*)(void*, void*))lp_item_write, (void *)lpconfig);
-
-	if (bctbx_file_fprintf(lpconfig->pFile, 0, "\n")< 0) ms_error("lp_section_write : write error");
+static void lp_section_serialize(const LpSection *sec, std::string &out){
+	const bctbx_list_t *elem;
+	out.append("[");
+	out.append(sec->name);
+	for (elem = sec->params; elem != NULL; elem = bctbx_list_next(elem))
+		lp_section_param_serialize((const LpSectionParam *)elem->data, out);
+	out.append("]\n");
+	for (elem = sec->items; elem != NULL; elem = bctbx_list_next(elem))
+		lp_item_serialize((const LpItem *)elem->data, out);
+	out.append("\n");
+}
+
+static std::string lp_config_serialize(const LpConfig *lpconfig){
+	std::string out;
+	const bctbx_list_t *elem;
+	for (elem = lpconfig->sections; elem != NULL; elem = bctbx_list_next(elem))
+		lp_section_serialize((const LpSection *)elem->data, out);
+	return out;
+}
 
+/* FNV-1a, only used to detect that the content to write is the one already on disk. */
+static uint64_t lp_config_hash(const char *data, size_t size){
+	uint64_t hash = 14695981039346656037ULL;
+	for (size_t i = 0; i < size; i++){
+		hash ^= (unsigned char)data[i];
+		hash *= 1099511628211ULL;
+	}
+	return hash;
 }
 
-LinphoneStatus linphone_config_sync(LpConfig *lpconfig){
-	bctbx_vfs_file_t *pFile = NULL;
-	if (lpconfig->filename==NULL) return -1;
-	if (lpconfig->readonly) return 0;
+/*
+ * Writes the content in the temporary file then renames it over the config file, so that the config file is never
+ * seen partially written. May be called from the writer thread.
+ * Returns 0 if successful, -1 if the temporary file can't be opened, -2 if the write or the rename failed.
+ */
+static int lp_config_write_file(bctbx_vfs_t *vfs, const char *filename, const char *tmpfilename, const std::string &content){
+	bctbx_vfs_file_t *pFile;
+	int err = 0;
 
 #ifndef _WIN32
 	/* don't create group/world-accessible files */
 	(void) umask(S_IRWXG | S_IRWXO);
 #endif
-	pFile  = bctbx_file_open(lpconfig->g_bctbx_vfs,lpconfig->tmpfilename, "w");
-	lpconfig->pFile = pFile;
-	if (pFile == NULL){
-		ms_warning("Could not write %s ! Maybe it is read-only. Configuration will not be saved.",lpconfig->filename);
-		lpconfig->readonly = TRUE;
-		return -1;
+	pFile = bctbx_file_open(vfs, tmpfilename, "w");
+	if (pFile == NULL) return -1;
+	if (!content.empty() && (int64_t)bctbx_file_write(pFile, content.c_str(), content.size(), 0) != (int64_t)content.size()){
+		ms_error("Cannot write %s", tmpfilename);
+		err = -2;
 	}
-
-	bctbx_list_for_each2(lpconfig->sections,(void (*)(void *,void*))lp_section_write,(void *)lpconfig);
 	bctbx_file_close(pFile);
+	if (err != 0) return err;
 
 #ifdef RENAME_REQUIRES_NONEXISTENT_NEW_PATH
 	/* On windows, rename() does not accept that the newpath is an existing file, while it is accepted on Unix.
 	 * As a result, we are forced to first delete the linphonerc file, and then rename.*/
-	if (remove(lpconfig->filename)!=0){
-		ms_error("Cannot remove %s: %s",lpconfig->filename, strerror(errno));
+	if (remove(filename)!=0){
+		ms_error("Cannot remove %s: %s",filename, strerror(errno));
 	}
 #endif
-	if (rename(lpconfig->tmpfilename,lpconfig->filename)!=0){
-		ms_error("Cannot rename %s into %s: %s",lpconfig->tmpfilename,lpconfig->filename,strerror(errno));
+	if (rename(tmpfilename,filename)!=0){
+		ms_error("Cannot rename %s into %s: %s",tmpfilename,filename,strerror(errno));
+		err = -2;
+	}
+	return err;
+}
+
+static void lp_config_writer_run(LpConfigWriter *writer){
+	std::unique_lock<std::mutex> lock(writer->mutex);
+	while (true){
+		writer->cond.wait(lock, [writer] { return writer->has_pending || writer->stop; });
+		if (!writer->has_pending) break;
+		std::string content = std::move(writer->pending);
+		writer->pending.clear();
+		writer->has_pending = false;
+		writer->busy = true;
+		lock.unlock();
+		int err = lp_config_write_file(writer->vfs, writer->filename.c_str(), writer->tmpfilename.c_str(), content);
+		lock.lock();
+		writer->busy = false;
+		if (err != 0) writer->error = err;
+		writer->cond.notify_all();
+	}
+}
+
+static void lp_config_writer_create(LpConfig *lpconfig){
+	LpConfigWriter *writer = new LpConfigWriter();
+	writer->filename = lpconfig->filename;
+	writer->tmpfilename = lpconfig->tmpfilename;
+	writer->vfs = lpconfig->g_bctbx_vfs;
+	writer->error = 0;
+	writer->has_pending = false;
+	writer->busy = false;
+	writer->stop = false;
+	writer->thread = std::thread(lp_config_writer_run, writer);
+	lpconfig->writer = writer;
+}
+
+/* Takes into account the errors of the previous background writes. */
+static void lp_config_writer_check_error(LpConfig *lpconfig, int error){
+	if (error == -1){
+		ms_warning("Could not write %s ! Maybe it is read-only. Configuration will not be saved.",lpconfig->filename);
+		lpconfig->readonly = TRUE;
+	}else if (error != 0){
+		/* What is on disk is unknown, the next commit has to write. */
+		lpconfig->has_written_hash = FALSE;
 	}
+}
+
+static void lp_config_writer_wait(LpConfig *lpconfig){
+	LpConfigWriter *writer = lpconfig->writer;
+	int error;
+	{
+		std::unique_lock<std::mutex> lock(writer->mutex);
+		writer->cond.wait(lock, [writer] { return !writer->has_pending && !writer->busy; });
+		error = writer->error;
+		writer->error = 0;
+	}
+	lp_config_writer_check_error(lpconfig, error);
+}
+
+static void lp_config_writer_post(LpConfig *lpconfig, std::string &&content){
+	LpConfigWriter *writer = lpconfig->writer;
+	int error;
+	{
+		std::lock_guard<std::mutex> lock(writer->mutex);
+		writer->pending = std::move(content);
+		writer->has_pending = true;
+		error = writer->error;
+		writer->error = 0;
+	}
+	writer->cond.notify_all();
+	lp_config_writer_check_error(lpconfig, error);
+}
+
+static void lp_config_writer_destroy(LpConfig *lpconfig){
+	LpConfigWriter *writer = lpconfig->writer;
+	{
+		std::lock_guard<std::mutex> lock(writer->mutex);
+		writer->stop = true;
+	}
+	writer->cond.notify_all();
+	writer->thread.join(); /* pending content is written before the thread exits */
+	lp_config_writer_check_error(lpconfig, writer->error);
+	delete writer;
+	lpconfig->writer = NULL;
+}
+
+/*
+ * Writes the configuration if its content differs from what was last written.
+ * Returns 1 if the content was written (or handed over to the writer thread), 0 if there was nothing to write,
+ * -1 on error.
+ */
+static int _linphone_config_commit(LpConfig *lpconfig, bool_t background){
+	std::string content;
+	uint64_t hash;
+	int err;
+
+	if (lpconfig->filename==NULL) return -1;
+	if (lpconfig->readonly) return 0;
+
+	content = lp_config_serialize(lpconfig);
+	hash = lp_config_hash(content.c_str(), content.size());
+	if (lpconfig->writer && !background) lp_config_writer_wait(lpconfig);
+	if (lpconfig->readonly) return -1;
+	if (lpconfig->has_written_hash && lpconfig->written_hash == hash){
+		lpconfig->modified = FALSE;
+		return 0;
+	}
+
+	if (background && lpconfig->writer){
+		lp_config_writer_post(lpconfig, std::move(content));
+	}else{
+		err = lp_config_write_file(lpconfig->g_bctbx_vfs, lpconfig->filename, lpconfig->tmpfilename, content);
+		if (err == -1){
+			ms_warning("Could not write %s ! Maybe it is read-only. Configuration will not be saved.",lpconfig->filename);
+			lpconfig->readonly = TRUE;
+			return -1;
+		}
+		if (err != 0){
+			lpconfig->has_written_hash = FALSE;
+			lpconfig->modified = FALSE;
+			return -1;
+		}
+	}
+	lpconfig->written_hash = hash;
+	lpconfig->has_written_hash = TRUE;
 	lpconfig->modified = FALSE;
-	return 0;
+	return 1;
+}
+
+LinphoneStatus linphone_config_sync(LpConfig *lpconfig){
+	return _linphone_config_commit(lpconfig, FALSE) < 0 ? -1 : 0;
+}
+
+bool_t linphone_config_sync_if_needed(LinphoneConfig *lpconfig){
+	if (!lpconfig->modified || lpconfig->filename==NULL || lpconfig->readonly) return FALSE;
+	if (bctbx_get_cur_time_ms() - lpconfig->modified_time < (uint64_t)lpconfig->sync_delay) return FALSE;
+	return _linphone_config_commit(lpconfig, lpconfig->background_sync) == 1;
+}
+
+void linphone_config_set_sync_delay(LinphoneConfig *lpconfig, int delay_ms){
+	lpconfig->sync_delay = delay_ms > 0 ? delay_ms : 0;
+}
+
+int linphone_config_get_sync_delay(const LinphoneConfig *lpconfig){
+	return lpconfig->sync_delay;
+}
+
+void linphone_config_enable_background_sync(LinphoneConfig *lpconfig, bool_t enable){
+	lpconfig->background_sync = enable;
+	if (enable && !lpconfig->writer && lpconfig->filename != NULL){
+		lp_config_writer_create(lpconfig);
+	}else if (!enable && lpconfig->writer){
+		lp_config_writer_destroy(lpconfig);
+	}
+}
+
+bool_t linphone_config_background_sync_enabled(const LinphoneConfig *lpconfig){
+	return lpconfig->background_sync;
 }
 
 void linphone_config_reload(LinphoneConfig *lpconfig) {
+	if (lpconfig->writer) lp_config_writer_wait(lpconfig);
 	bctbx_list_for_each(lpconfig->sections, (void (*)(void*)) lp_section_destroy);
 	bctbx_list_free(lpconfig->sections);
 	lpconfig->sections = NULL;
+	/* The file may have been changed by someone else, the content written last tells nothing about it anymore. */
+	lpconfig->has_written_hash = FALSE;
 	linphone_config_read_file(lpconfig, lpconfig->filename);
 }
 
@@ -1000,8 +1519,8 @@ void linphone_config_clean_section(LpConfig *lpconfig, const char *section){
 	LpSection *sec=linphone_config_find_section(lpconfig,section);
 	if (sec!=NULL){
 		linphone_config_remove_section(lpconfig,sec);
+		lp_config_mark_modified(lpconfig);
 	}
-	lpconfig->modified = TRUE;
 }
 
 bool_t linphone_config_needs_commit(const LpConfig *lpconfig){
@@ -1264,8 +1783,10 @@ void linphone_config_clean_entry(LpConfig *lpconfig, const char *section, const
 	sec=linphone_config_find_section(lpconfig,section);
 	if (sec!=NULL){
 		item=lp_section_find_item(sec,key);
-		if (item!=NULL)
+		if (item!=NULL){
 			lp_section_remove_item(sec,item);
+			lp_config_mark_modified(lpconfig);
+		}
 	}
 	return ;
 }
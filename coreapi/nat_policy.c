@@ -37,24 +37,33 @@ static LinphoneNatPolicy * linphone_nat_policy_new(LinphoneCore *lc) {
 	return _linphone_nat_policy_new_with_ref(lc, ref);
 }
 
+static void linphone_nat_policy_cancel_stun_server_resolution(LinphoneNatPolicy *policy) {
+	if (policy->stun_resolver_context == NULL) return;
+	/* The resolution may be shared with other lookups of the same server, only ours is cancelled. */
+	if (policy->lc && policy->lc->sal) policy->lc->sal->cancelResolve(policy->stun_resolver_context, policy);
+	else belle_sip_resolver_context_cancel(policy->stun_resolver_context);
+	belle_sip_object_unref(policy->stun_resolver_context);
+	policy->stun_resolver_context = NULL;
+}
+
+static void linphone_nat_policy_clear_resolver_results(LinphoneNatPolicy *policy) {
+	if (policy->resolver_results) {
+		belle_sip_object_unref(policy->resolver_results);
+		policy->resolver_results = NULL;
+	}
+}
+
 static void linphone_nat_policy_destroy(LinphoneNatPolicy *policy) {
 	if (policy->ref) belle_sip_free(policy->ref);
 	if (policy->stun_server) belle_sip_free(policy->stun_server);
 	if (policy->stun_server_username) belle_sip_free(policy->stun_server_username);
-	if (policy->resolver_results) belle_sip_object_unref(policy->resolver_results);
-	if (policy->stun_resolver_context) {
-		belle_sip_resolver_context_cancel(policy->stun_resolver_context);
-		belle_sip_object_unref(policy->stun_resolver_context);
-	}
+	linphone_nat_policy_cancel_stun_server_resolution(policy);
+	linphone_nat_policy_clear_resolver_results(policy);
 }
 
 /* Simply cancel pending DNS resoltion, as the core is going to shutdown.*/
 void linphone_nat_policy_release(LinphoneNatPolicy *policy){
-	if (policy->stun_resolver_context) {
-		belle_sip_resolver_context_cancel(policy->stun_resolver_context);
-		belle_sip_object_unref(policy->stun_resolver_context);
-		policy->stun_resolver_context = NULL;
-	}
+	linphone_nat_policy_cancel_stun_server_resolution(policy);
 }
 
 bool_t linphone_nat_policy_stun_server_activated(LinphoneNatPolicy *policy) {
@@ -194,16 +203,8 @@ void linphone_nat_policy_set_stun_server(LinphoneNatPolicy *policy, const char *
 	if (new_stun_server != NULL) {
 		policy->stun_server = new_stun_server;
 	}
-	if (policy->resolver_results) {
-		belle_sip_object_unref(policy->resolver_results);
-		policy->resolver_results = NULL;
-	}
-	if (policy->stun_resolver_context){
-		belle_sip_resolver_context_cancel(policy->stun_resolver_context);
-		belle_sip_object_unref(policy->stun_resolver_context);
-		policy->stun_resolver_context = NULL;
-		
-	}
+	linphone_nat_policy_cancel_stun_server_resolution(policy);
+	linphone_nat_policy_clear_resolver_results(policy);
 	linphone_nat_policy_resolve_stun_server(policy);
 }
 
@@ -222,19 +223,44 @@ void linphone_nat_policy_set_stun_server_username(LinphoneNatPolicy *policy, con
 	if (new_username != NULL) policy->stun_server_username = new_username;
 }
 
+/* Parses the STUN/TURN server to resolve for the policy, returns FALSE if there is none. */
+static bool_t linphone_nat_policy_get_stun_server_lookup(const LinphoneNatPolicy *policy, char *host, size_t host_size, int *port, const char **service, int *family) {
+	if (policy->lc == NULL || policy->lc->sal == NULL || !linphone_nat_policy_stun_server_activated((LinphoneNatPolicy *)policy)) return FALSE;
+
+	if (linphone_nat_policy_turn_enabled(policy)) *service = "turn";
+	else if (linphone_nat_policy_stun_enabled(policy)) *service = "stun";
+	else return FALSE;
+	linphone_parse_host_port(policy->stun_server, host, host_size, port);
+	*family = linphone_core_ipv6_enabled(policy->lc) ? AF_INET6 : AF_INET;
+	return TRUE;
+}
+
+/*
+ * The answers are cached by the SAL of the core, so that the nat policies using the same server share them.
+ * Without a port, the server is looked up through its SRV record.
+ */
+static belle_sip_resolver_results_t *linphone_nat_policy_get_cached_stun_server(const LinphoneNatPolicy *policy, const char *host, int port, const char *service, int family, bool *expired) {
+	if (!policy->lc->sal->dnsCacheEnabled()) {
+		/* Without the cache, the last answer of the policy is used and refreshed at each use. */
+		*expired = true;
+		return policy->resolver_results;
+	}
+	if (port == 0) return policy->lc->sal->getCachedResults(service, "udp", host, 3478, family, expired);
+	return policy->lc->sal->getCachedResultsA(host, port, family, expired);
+}
+
 static void stun_server_resolved(void *data, belle_sip_resolver_results_t *results) {
 	LinphoneNatPolicy *policy = (LinphoneNatPolicy *)data;
 
-	if (policy->resolver_results) {
-		belle_sip_object_unref(policy->resolver_results);
-		policy->resolver_results = NULL;
-	}
-	
 	if (belle_sip_resolver_results_get_addrinfos(results)) {
 		ms_message("Stun server resolution successful.");
-		belle_sip_object_ref(results);
-		policy->resolver_results = results;
+		if (!policy->lc->sal->dnsCacheEnabled()) {
+			belle_sip_object_ref(results);
+			linphone_nat_policy_clear_resolver_results(policy);
+			policy->resolver_results = results;
+		}
 	} else {
+		/* A previous answer, if any, is kept until a resolution succeeds. */
 		ms_warning("Stun server resolution failed.");
 	}
 	if (policy->stun_resolver_context){
@@ -244,26 +270,19 @@ static void stun_server_resolved(void *data, belle_sip_resolver_results_t *resul
 }
 
 void linphone_nat_policy_resolve_stun_server(LinphoneNatPolicy *policy) {
+	char host[NI_MAXHOST];
+	int port = 0, family = AF_INET;
 	const char *service = NULL;
 
-	if (linphone_nat_policy_stun_server_activated(policy) && (policy->lc->sal != NULL) && !policy->stun_resolver_context) {
-		char host[NI_MAXHOST];
-		int port = 0;
-		linphone_parse_host_port(policy->stun_server, host, sizeof(host), &port);
-		if (linphone_nat_policy_turn_enabled(policy)) service = "turn";
-		else if (linphone_nat_policy_stun_enabled(policy)) service = "stun";
-		if (service != NULL) {
-			int family = AF_INET;
-			if (linphone_core_ipv6_enabled(policy->lc) == TRUE) family = AF_INET6;
-			ms_message("Starting stun server resolution [%s]", host);
-			if (port == 0) {
-				port = 3478;
-				policy->stun_resolver_context = policy->lc->sal->resolve(service, "udp", host, port, family, stun_server_resolved, policy);
-			} else {
-				policy->stun_resolver_context = policy->lc->sal->resolveA(host, port, family, stun_server_resolved, policy);
-			}
-			if (policy->stun_resolver_context) belle_sip_object_ref(policy->stun_resolver_context);
+	if (!policy->stun_resolver_context && linphone_nat_policy_get_stun_server_lookup(policy, host, sizeof(host), &port, &service, &family)) {
+		ms_message("Starting stun server resolution [%s]", host);
+		if (port == 0) {
+			port = 3478;
+			policy->stun_resolver_context = policy->lc->sal->resolve(service, "udp", host, port, family, stun_server_resolved, policy);
+		} else {
+			policy->stun_resolver_context = policy->lc->sal->resolveA(host, port, family, stun_server_resolved, policy);
 		}
+		if (policy->stun_resolver_context) belle_sip_object_ref(policy->stun_resolver_context);
 	}
 }
 
@@ -272,23 +291,34 @@ const struct addrinfo * linphone_nat_policy_get_stun_server_addrinfo(LinphoneNat
 	 * It is critical not to block for a long time if it can't be resolved, otherwise this stucks the main thread when making a call.
 	 * On the contrary, a fully asynchronous call initiation is complex to develop.
 	 * The compromise is then:
-	 *  - have a cache of the stun server addrinfo
-	 *  - this cached value is returned when it is non-null
-	 *  - an asynchronous resolution is asked each time this function is called to ensure frequent refreshes of the cached value.
+	 *  - have a cache of the stun server addrinfo, the DNS cache of the SAL shared by the nat policies of the core (or the last
+	 *    answer of the policy when that cache is disabled)
+	 *  - this cached value is returned when it is non-null, even once expired
+	 *  - an asynchronous resolution is asked when the cached value is expired, to refresh it.
 	 *  - if no cached value exists, block for a short time; this case must be unprobable because the resolution will be asked each
 	 *    time the stun server value is changed.
 	 */
-	if (linphone_nat_policy_stun_server_activated(policy) && (policy->resolver_results == NULL)) {
+	char host[NI_MAXHOST];
+	int port = 0, family = AF_INET;
+	const char *service = NULL;
+	bool expired = false;
+	belle_sip_resolver_results_t *results;
+
+	if (!linphone_nat_policy_get_stun_server_lookup(policy, host, sizeof(host), &port, &service, &family)) return NULL;
+	results = linphone_nat_policy_get_cached_stun_server(policy, host, port, service, family, &expired);
+	if (results == NULL) {
 		int wait_ms = 0;
 		int wait_limit = 1000;
 		linphone_nat_policy_resolve_stun_server(policy);
-		while ((policy->resolver_results == NULL) && (policy->stun_resolver_context != NULL) && (wait_ms < wait_limit)) {
+		while (((results = linphone_nat_policy_get_cached_stun_server(policy, host, port, service, family, &expired)) == NULL) && (policy->stun_resolver_context != NULL) && (wait_ms < wait_limit)) {
 			policy->lc->sal->iterate();
 			ms_usleep(50000);
 			wait_ms += 50;
 		}
+	} else if (expired) {
+		linphone_nat_policy_resolve_stun_server(policy);
 	}
-	return policy->resolver_results ? belle_sip_resolver_results_get_addrinfos(policy->resolver_results) : NULL;
+	return results ? belle_sip_resolver_results_get_addrinfos(results) : NULL;
 }
 
 LinphoneNatPolicy * linphone_core_create_nat_policy(LinphoneCore *lc) {
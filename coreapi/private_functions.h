@@ -193,6 +193,9 @@ LinphoneFriend *linphone_core_find_friend_by_inc_subscribe(const LinphoneCore *l
 MSList *linphone_find_friend_by_address(MSList *fl, const LinphoneAddress *addr, LinphoneFriend **lf);
 bool_t linphone_core_should_subscribe_friends_only_when_registered(const LinphoneCore *lc);
 void linphone_core_update_friends_subscriptions(LinphoneCore *lc);
+void linphone_core_process_friends_to_subscribe(LinphoneCore *lc);
+void linphone_core_clear_friends_to_subscribe(LinphoneCore *lc);
+void linphone_friend_load_vcard(const LinphoneFriend *lf);
 void _linphone_friend_list_update_subscriptions(LinphoneFriendList *list, LinphoneProxyConfig *cfg, bool_t only_when_registered);
 void linphone_core_friends_storage_init(LinphoneCore *lc);
 void linphone_core_friends_storage_close(LinphoneCore *lc);
@@ -276,9 +279,16 @@ bool_t linphone_core_media_description_contains_video_stream(const LinphonePriva
 
 void linphone_core_send_initial_subscribes(LinphoneCore *lc);
 
+void _linphone_core_release_auth_info_indexes(LinphoneCore *lc);
+void _linphone_core_clear_tls_credentials_cache(LinphoneCore *lc);
+LINPHONE_PUBLIC bool_t _linphone_core_get_tls_credentials(LinphoneCore *lc, const char *cert, const char *key, bool_t from_files, belle_sip_certificates_chain_t **chain, belle_sip_signing_key_t **signing_key);
+
 void linphone_proxy_config_update(LinphoneProxyConfig *cfg);
-LinphoneProxyConfig * linphone_core_lookup_known_proxy(LinphoneCore *lc, const LinphoneAddress *uri);
-LinphoneProxyConfig * linphone_core_lookup_proxy_by_identity(LinphoneCore *lc, const LinphoneAddress *uri);
+void linphone_proxy_config_schedule_update(LinphoneProxyConfig *cfg);
+void linphone_core_invalidate_proxy_index(LinphoneCore *lc);
+LINPHONE_PUBLIC LinphoneProxyConfig * linphone_core_lookup_known_proxy(LinphoneCore *lc, const LinphoneAddress *uri);
+LINPHONE_PUBLIC LinphoneProxyConfig * linphone_core_lookup_proxy_by_identity(LinphoneCore *lc, const LinphoneAddress *uri);
+LinphoneProxyConfig * linphone_core_lookup_proxy_by_identity_parts(LinphoneCore *lc, const char *username, const char *domain, int port);
 const char *linphone_core_find_best_identity(LinphoneCore *lc, const LinphoneAddress *to);
 LINPHONE_PUBLIC void linphone_core_get_local_ip(LinphoneCore *lc, int af, const char *dest, char *result);
 
@@ -355,6 +365,7 @@ void _linphone_chat_room_clear_callbacks (LinphoneChatRoom *cr);
 
 void _linphone_chat_message_notify_msg_state_changed(LinphoneChatMessage* msg, LinphoneChatMessageState state);
 void _linphone_chat_message_notify_participant_imdn_state_changed(LinphoneChatMessage* msg, const LinphoneParticipantImdnState *state);
+bool_t _linphone_buffer_reuse_with_content(LinphoneBuffer *buffer, const uint8_t *content, size_t size);
 void _linphone_chat_message_notify_file_transfer_recv(LinphoneChatMessage *msg, LinphoneContent* content, const LinphoneBuffer *buffer);
 void _linphone_chat_message_notify_file_transfer_send(LinphoneChatMessage *msg, LinphoneContent* content, size_t offset, size_t size);
 void _linphone_chat_message_notify_file_transfer_send_chunk(LinphoneChatMessage *msg, LinphoneContent* content, size_t offset, size_t size, LinphoneBuffer *buffer);
@@ -431,6 +442,23 @@ int linphone_upnp_init(LinphoneCore *lc);
 void linphone_upnp_destroy(LinphoneCore *lc);
 
 int _linphone_sqlite3_open(const char *db_file, sqlite3 **db);
+/* PRAGMA statements of the sqlite storage profile configured in the [storage] section, to run once a database is opened. */
+bctbx_list_t *_linphone_sqlite3_get_profile_pragmas(LinphoneConfig *config);
+void _linphone_sqlite3_apply_profile(LinphoneConfig *config, sqlite3 *db);
+
+/* Tells when the config files were read, in microseconds on the steady clock, 0 if they were not. */
+void _linphone_config_get_load_interval(const LinphoneConfig *config, uint64_t *start, uint64_t *end);
+
+/* Startup timeline, recorded from linphone_core_init() or linphone_core_start() until the core is On. */
+uint64_t _linphone_startup_timeline_now(void);
+void _linphone_core_count_db_query(void);
+/* Counts the queries of a sqlite database opened by the core while the timeline is recorded. */
+void _linphone_core_startup_timeline_watch_db(LinphoneCore *lc, sqlite3 *db);
+void linphone_core_startup_timeline_start(LinphoneCore *lc);
+void linphone_core_startup_timeline_stop(LinphoneCore *lc);
+void linphone_core_startup_timeline_clear(LinphoneCore *lc);
+void linphone_core_startup_phase_begin(LinphoneCore *lc, const char *name);
+void linphone_core_startup_phase_end(LinphoneCore *lc, const char *name);
 
 LinphoneChatMessageStateChangedCb linphone_chat_message_get_message_state_changed_cb(LinphoneChatMessage* msg);
 void linphone_chat_message_set_message_state_changed_cb(LinphoneChatMessage* msg, LinphoneChatMessageStateChangedCb cb);
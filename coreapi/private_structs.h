@@ -140,6 +140,8 @@ struct _LinphoneProxyConfig
 	char *conference_factory_uri;
 
 	bool_t push_notification_allowed;
+	bool_t update_scheduled; /*the proxy config is in sip_conf.updatable_proxies*/
+	bool_t added; /*the proxy config is in sip_conf.proxies*/
 };
 
 BELLE_SIP_DECLARE_VPTR_NO_EXPORT(LinphoneProxyConfig);
@@ -173,6 +175,10 @@ struct _LinphoneFriend{
 	bool_t initial_subscribes_sent; /*used to know if initial subscribe message was sent or not*/
 	bool_t presence_received;
 	LinphoneVcard *vcard;
+	char *pending_vcard; /*raw vCard read from the database, parsed on first access*/
+	char *pending_vcard_etag;
+	char *pending_vcard_url;
+	bool_t subscribe_queued; /*waiting in the core's incremental subscription queue*/
 	unsigned int storage_id;
 	LinphoneFriendList *friend_list;
 	LinphoneSubscriptionState out_sub_state;
@@ -226,6 +232,17 @@ struct sip_config
 	char *guessed_contact;
 	MSList *proxies;
 	MSList *deleted_proxies;
+	MSList *updatable_proxies; /*proxies with a pending register or publish, the only ones visited by iterate*/
+	MSList *updatable_proxies_tail; /*last element of updatable_proxies, so that scheduling an update does not walk the list*/
+	bctbx_map_t *proxies_by_domain; /*lookup indexes on the proxies list, rebuilt when proxy_index_dirty is set*/
+	bctbx_map_t *proxies_by_identity;
+	bool_t proxy_index_dirty;
+	int register_rate_limit; /*max REGISTERs sent per second when many accounts register at once, 0 for no limit*/
+	int register_expires_jitter; /*percentage by which registration expires are randomly lowered, to spread refreshes*/
+	double register_tokens;
+	uint64_t register_tokens_time;
+	int register_queue_depth; /*registrations postponed by the rate limit during the last iterate*/
+	int register_queue_max_depth;
 	int inc_timeout;	/*timeout after an un-answered incoming call is rejected*/
 	int push_incoming_call_timeout;  /*timeout after push incoming received if stream not received*/
 	int in_call_timeout;	/*timeout after a call is hangup */
@@ -376,6 +393,15 @@ struct _LinphoneTaskList{
 	MSList *hooks;
 };
 
+struct _LinphoneStartupPhase{
+	char *name;
+	uint64_t start; /* in microseconds, on the steady clock */
+	uint64_t end;
+	int64_t heap_usage; /* heap usage when the phase began, then its growth during the phase once ended */
+	uint64_t db_queries; /* query counter when the phase began, then the number of queries once ended */
+	bool_t ended;
+};
+
 struct _LinphoneCoreCbs {
 	belle_sip_object_t base;
 	LinphoneCoreVTable *vtable;
@@ -474,6 +500,7 @@ struct _LinphoneBuffer {
 	void *user_data;
 	uint8_t *content;	/**< A pointer to the buffer content */
 	size_t size;	/**< The size of the buffer content */
+	size_t capacity;	/**< The size of the memory allocated for the content */
 };
 
 BELLE_SIP_DECLARE_VPTR_NO_EXPORT(LinphoneBuffer);
@@ -483,7 +510,7 @@ struct _LinphoneNatPolicy {
 	void *user_data;
 	LinphoneCore *lc;
 	belle_sip_resolver_context_t *stun_resolver_context;
-	belle_sip_resolver_results_t *resolver_results;
+	belle_sip_resolver_results_t *resolver_results; /* Only used when the DNS cache of the SAL is disabled. */
 	char *stun_server;
 	char *stun_server_username;
 	char *ref;
@@ -770,6 +797,8 @@ namespace LinphonePrivate {
 	LinphoneProxyConfig *default_proxy; \
 	MSList *friends_lists; \
 	MSList *auth_info; \
+	bctbx_map_t *auth_info_by_username; /*index of auth_info, in list order*/ \
+	bctbx_map_t *tls_credentials_cache; /*parsed client certificates and keys of auth infos*/ \
 	struct _RingStream *ringstream; \
 	LCCallbackObj preview_finished_cb; \
 	MSList *queued_calls; \
@@ -805,6 +834,7 @@ namespace LinphonePrivate {
 	bool_t use_files; \
 	bool_t apply_nat_settings; \
 	bool_t initial_subscribes_sent; \
+	bctbx_list_t *friends_to_subscribe; /*friends whose SUBSCRIBE is sent a few at a time by iterate*/ \
 	bool_t bl_refresh; \
 	bool_t preview_finished; \
 	bool_t auto_net_state_mon; \
@@ -851,7 +881,12 @@ namespace LinphonePrivate {
 	bool_t sender_name_hidden_in_forward_message; \
 	bool_t is_main_core; \
 	bool_t has_already_started_once; \
-	bool_t send_imdn_if_unregistered;
+	bool_t send_imdn_if_unregistered; \
+	bctbx_list_t *startup_phases; \
+	uint64_t startup_origin; \
+	bool_t startup_recording; \
+	char *quality_report_buffer; /*reused by all the quality reports*/ \
+	size_t quality_report_buffer_size;
 
 #define LINPHONE_CORE_STRUCT_FIELDS \
 	LINPHONE_CORE_STRUCT_BASE_FIELDS \
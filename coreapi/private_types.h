@@ -55,6 +55,8 @@ typedef struct _LinphoneToneDescription LinphoneToneDescription;
 
 typedef struct _LinphoneTaskList LinphoneTaskList;
 
+typedef struct _LinphoneStartupPhase LinphoneStartupPhase;
+
 typedef struct _LCCallbackObj LCCallbackObj;
 
 typedef struct _EcCalibrator EcCalibrator;
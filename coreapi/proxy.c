@@ -311,6 +311,7 @@ void _linphone_proxy_config_destroy(LinphoneProxyConfig *cfg){
 
 void _linphone_proxy_config_release(LinphoneProxyConfig *cfg) {
 	_linphone_proxy_config_release_ops(cfg);
+	cfg->added = FALSE;
 	belle_sip_object_unref(cfg);
 }
 
@@ -360,6 +361,7 @@ LinphoneStatus linphone_proxy_config_set_identity_address(LinphoneProxyConfig *c
 		linphone_address_unref(cfg->identity_address);
 	}
 	cfg->identity_address=linphone_address_clone(addr);
+	if (cfg->lc) linphone_core_invalidate_proxy_index(cfg->lc);
 
 	if (cfg->reg_identity!=NULL) {
 		ms_free(cfg->reg_identity);
@@ -577,6 +579,17 @@ void _linphone_proxy_config_unregister(LinphoneProxyConfig *obj) {
 	}
 }
 
+/*
+ * Registrations made at the same time are refreshed at the same time. Lowering the expires of each of them by a random
+ * part spreads these refreshes.
+ */
+static int linphone_proxy_config_get_register_expires(const LinphoneProxyConfig *cfg){
+	int jitter = cfg->lc->sip_conf.register_expires_jitter;
+	if (cfg->expires <= 0 || jitter <= 0) return cfg->expires;
+	int spread = cfg->expires * MIN(jitter, 50) / 100;
+	return cfg->expires - (int)(bctbx_random() % (unsigned int)(spread + 1));
+}
+
 static void linphone_proxy_config_register(LinphoneProxyConfig *cfg){
 	if (cfg->reg_sendregister) {
 		LinphoneAddress* proxy = linphone_address_new(cfg->reg_proxy);
@@ -604,7 +617,7 @@ static void linphone_proxy_config_register(LinphoneProxyConfig *cfg){
 		if (cfg->op->sendRegister(
 			proxy_string,
 			cfg->reg_identity,
-			cfg->expires,
+			linphone_proxy_config_get_register_expires(cfg),
 			cfg->pending_contact ? L_GET_CPP_PTR_FROM_C_OBJECT(cfg->pending_contact)->getInternalAddress() : NULL
 		)==0) {
 			if (cfg->pending_contact) {
@@ -628,7 +641,7 @@ static void linphone_proxy_config_register(LinphoneProxyConfig *cfg){
 
 void linphone_proxy_config_refresh_register(LinphoneProxyConfig *cfg){
 	if (cfg->reg_sendregister && cfg->op && cfg->state!=LinphoneRegistrationProgress){
-		if (cfg->op->refreshRegister(cfg->expires) == 0) {
+		if (cfg->op->refreshRegister(linphone_proxy_config_get_register_expires(cfg)) == 0) {
 			linphone_proxy_config_set_state(cfg,LinphoneRegistrationProgress, "Refresh registration");
 		}
 	}
@@ -959,6 +972,7 @@ LinphoneStatus linphone_proxy_config_done(LinphoneProxyConfig *cfg)
 	} else {
 		ms_message("Publish params have not changed on proxy config [%p]",cfg);
 	}
+	if (cfg->commit || cfg->send_publish) linphone_proxy_config_schedule_update(cfg);
 	linphone_proxy_config_write_all_to_config_file(cfg->lc);
 	return 0;
 }
@@ -1031,7 +1045,10 @@ int linphone_proxy_config_send_publish(LinphoneProxyConfig *proxy, LinphonePrese
 			bctbx_free(contact);
 		}
 
-	}else proxy->send_publish=TRUE; /*otherwise do not send publish if registration is in progress, this will be done later*/
+	}else{
+		proxy->send_publish=TRUE; /*otherwise do not send publish if registration is in progress, this will be done later*/
+		linphone_proxy_config_schedule_update(proxy);
+	}
 	return err;
 }
 
@@ -1171,8 +1188,18 @@ LinphoneStatus linphone_core_add_proxy_config(LinphoneCore *lc, LinphoneProxyCon
 		ms_warning("ProxyConfig already entered, ignored.");
 		return 0;
 	}
+	bctbx_list_t *deleted = bctbx_list_find(lc->sip_conf.deleted_proxies, cfg);
+	if (deleted) {
+		/*the proxy config is added back before being definitely removed*/
+		lc->sip_conf.deleted_proxies = bctbx_list_erase_link(lc->sip_conf.deleted_proxies, deleted);
+		linphone_proxy_config_unref(cfg);
+		cfg->deletion_date = 0;
+	}
 	lc->sip_conf.proxies=bctbx_list_append(lc->sip_conf.proxies,(void *)linphone_proxy_config_ref(cfg));
+	cfg->added = TRUE;
+	linphone_core_invalidate_proxy_index(lc);
 	linphone_proxy_config_apply(cfg,lc);
+	linphone_proxy_config_schedule_update(cfg);
 	return 0;
 }
 
@@ -1198,6 +1225,15 @@ void linphone_core_remove_proxy_config(LinphoneCore *lc, LinphoneProxyConfig *cf
 		return;
 	}
 	lc->sip_conf.proxies=bctbx_list_remove(lc->sip_conf.proxies,cfg);
+	cfg->added = FALSE;
+	linphone_core_invalidate_proxy_index(lc);
+	if (cfg->update_scheduled) {
+		bctbx_list_t *elem = bctbx_list_find(lc->sip_conf.updatable_proxies, cfg);
+		if (elem == lc->sip_conf.updatable_proxies_tail) lc->sip_conf.updatable_proxies_tail = elem->prev;
+		lc->sip_conf.updatable_proxies = bctbx_list_erase_link(lc->sip_conf.updatable_proxies, elem);
+		cfg->update_scheduled = FALSE;
+		linphone_proxy_config_unref(cfg);
+	}
 	linphone_core_remove_dependent_proxy_config(lc, cfg);
 	/* add to the list of destroyed proxies, so that the possible unREGISTER request can succeed authentication */
 	lc->sip_conf.deleted_proxies=bctbx_list_append(lc->sip_conf.deleted_proxies,cfg);
@@ -1222,6 +1258,14 @@ void linphone_core_remove_proxy_config(LinphoneCore *lc, LinphoneProxyConfig *cf
 	linphone_proxy_config_set_conference_factory_uri(cfg, NULL);
 }
 
+int linphone_core_get_register_queue_depth(const LinphoneCore *lc) {
+	return lc->sip_conf.register_queue_depth;
+}
+
+int linphone_core_get_register_queue_max_depth(const LinphoneCore *lc) {
+	return lc->sip_conf.register_queue_max_depth;
+}
+
 void linphone_core_clear_proxy_config(LinphoneCore *lc) {
 	bctbx_list_t* list=bctbx_list_copy(linphone_core_get_proxy_config_list((const LinphoneCore*)lc));
 	bctbx_list_t* copy=list;
@@ -1262,6 +1306,13 @@ void linphone_core_set_default_proxy_config(LinphoneCore *lc, LinphoneProxyConfi
 		}
 	}
 	lc->default_proxy=config;
+	if (config && config->update_scheduled) {
+		/*move it first in the update queue*/
+		bctbx_list_t *elem = bctbx_list_find(lc->sip_conf.updatable_proxies, config);
+		if (elem == lc->sip_conf.updatable_proxies_tail && elem->prev) lc->sip_conf.updatable_proxies_tail = elem->prev;
+		lc->sip_conf.updatable_proxies = bctbx_list_unlink(lc->sip_conf.updatable_proxies, elem);
+		lc->sip_conf.updatable_proxies = bctbx_list_prepend_link(lc->sip_conf.updatable_proxies, elem);
+	}
 	if (linphone_core_ready(lc)) {
 		linphone_config_set_int(lc->config,"sip","default_proxy",linphone_core_get_default_proxy_config_index(lc));
 		/* Invalidate phone numbers in friends maps when default proxy config changes because the new one may have a different dial prefix */
@@ -1469,6 +1520,26 @@ SipSetup *linphone_proxy_config_get_sip_setup(LinphoneProxyConfig *cfg){
 	return NULL;
 }
 
+/*
+ * Token bucket limiting the REGISTERs sent when many accounts register at once, at startup or when the network comes
+ * back. It allows a burst of one second worth of registrations.
+ */
+static bool_t take_register_token(LinphoneCore *lc){
+	sip_config_t *config = &lc->sip_conf;
+	if (config->register_rate_limit <= 0) return TRUE;
+
+	uint64_t now = bctbx_get_cur_time_ms();
+	config->register_tokens += (double)(now - config->register_tokens_time) * config->register_rate_limit / 1000.;
+	if (config->register_tokens > config->register_rate_limit) config->register_tokens = config->register_rate_limit;
+	config->register_tokens_time = now;
+	if (config->register_tokens < 1.) {
+		config->register_queue_depth++;
+		return FALSE;
+	}
+	config->register_tokens -= 1.;
+	return TRUE;
+}
+
 static bool_t can_register(LinphoneProxyConfig *cfg){
 	LinphoneCore *lc=cfg->lc;
 
@@ -1488,8 +1559,13 @@ void linphone_proxy_config_update(LinphoneProxyConfig *cfg){
 			linphone_proxy_config_activate_sip_setup(cfg);
 		}
 		if (can_register(cfg)){
-			linphone_proxy_config_register(cfg);
-			cfg->commit=FALSE;
+			if (cfg->reg_sendregister && !take_register_token(lc)) {
+				/*retried at next iterate*/
+				linphone_proxy_config_schedule_update(cfg);
+			} else {
+				linphone_proxy_config_register(cfg);
+				cfg->commit=FALSE;
+			}
 		}
 	}
 	if (cfg->send_publish && (cfg->state==LinphoneRegistrationOk || cfg->state==LinphoneRegistrationCleared)){
@@ -1498,6 +1574,28 @@ void linphone_proxy_config_update(LinphoneProxyConfig *cfg){
 	}
 }
 
+/*
+ * Makes the proxy config visited by the next iterations, until it has no pending register nor publish.
+ * Only the proxy configs added to the core are updated by iterate.
+ */
+void linphone_proxy_config_schedule_update(LinphoneProxyConfig *cfg){
+	LinphoneCore *lc = cfg->lc;
+	bctbx_list_t *elem;
+	if (!lc || !cfg->added || cfg->update_scheduled) return;
+	elem = bctbx_list_new(linphone_proxy_config_ref(cfg));
+	/*the default proxy config goes first, so that it is not delayed by the register rate limit*/
+	if (cfg == lc->default_proxy || !lc->sip_conf.updatable_proxies_tail) {
+		lc->sip_conf.updatable_proxies = bctbx_list_prepend_link(lc->sip_conf.updatable_proxies, elem);
+		if (!lc->sip_conf.updatable_proxies_tail) lc->sip_conf.updatable_proxies_tail = elem;
+	} else {
+		/*appended after the tail, bctbx_list_append() would walk the whole queue*/
+		elem->prev = lc->sip_conf.updatable_proxies_tail;
+		lc->sip_conf.updatable_proxies_tail->next = elem;
+		lc->sip_conf.updatable_proxies_tail = elem;
+	}
+	cfg->update_scheduled = TRUE;
+}
+
 void linphone_proxy_config_set_sip_setup(LinphoneProxyConfig *cfg, const char *type){
 	if (cfg->type)
 		ms_free(cfg->type);
@@ -1587,6 +1685,10 @@ void linphone_proxy_config_set_state(LinphoneProxyConfig *cfg, LinphoneRegistrat
 		if (!cfg->dependency) {
 			_linphone_update_dependent_proxy_config(cfg, state, message);
 		}
+		if (cfg->send_publish && (state == LinphoneRegistrationOk || state == LinphoneRegistrationCleared)) {
+			/*a PUBLISH held back by a failed registration can be sent now, iterate only visits the scheduled proxy configs*/
+			linphone_proxy_config_schedule_update(cfg);
+		}
 		if (lc) {
 			linphone_core_notify_registration_state_changed(lc,cfg,state,message);
 		}
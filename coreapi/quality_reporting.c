@@ -52,50 +52,98 @@
 
 using namespace LinphonePrivate;
 
+/*report bodies are written into a buffer of the core, kept from one report to the next so that it is
+already large enough for the following ones*/
+typedef struct reporting_buffer {
+	char *data;
+	size_t size;
+	size_t offset;
+} reporting_buffer_t;
+
+static void reporting_buffer_reserve(reporting_buffer_t *buffer, size_t length) {
+	size_t needed = buffer->offset + length + 1;
+	size_t new_size;
+
+	if (needed <= buffer->size) return;
+	new_size = MAX(buffer->size * 2, needed);
+	/*some compilers complain that size_t cannot be formatted as unsigned long, hence forcing cast*/
+	ms_debug("QualityReporting: Buffer was too small to contain the whole report - increasing its size from %lu to %lu",
+		(unsigned long)buffer->size, (unsigned long)new_size);
+	buffer->data = (char *) ms_realloc(buffer->data, new_size);
+	buffer->size = new_size;
+}
+
+static void append_to_buffer_len(reporting_buffer_t *buffer, const char *str, size_t length) {
+	reporting_buffer_reserve(buffer, length);
+	memcpy(buffer->data + buffer->offset, str, length);
+	buffer->offset += length;
+	buffer->data[buffer->offset] = '\0';
+}
+
+/*NULL strings are written as printf did before*/
+static void append_to_buffer(reporting_buffer_t *buffer, const char *str) {
+	if (str == NULL) str = "(null)";
+	append_to_buffer_len(buffer, str, strlen(str));
+}
+
+static void append_uint_to_buffer(reporting_buffer_t *buffer, unsigned int value) {
+	char digits[16];
+	size_t i = sizeof(digits);
+
+	do {
+		digits[--i] = (char)('0' + value % 10);
+		value /= 10;
+	} while (value != 0);
+	append_to_buffer_len(buffer, digits + i, sizeof(digits) - i);
+}
+
+static void append_int_to_buffer(reporting_buffer_t *buffer, int value) {
+	if (value < 0) {
+		append_to_buffer_len(buffer, "-", 1);
+		append_uint_to_buffer(buffer, 0u - (unsigned int)value);
+	} else {
+		append_uint_to_buffer(buffer, (unsigned int)value);
+	}
+}
+
 /*since printf family functions are LOCALE dependent, float separator may differ
 depending on the user's locale (LC_NUMERIC environment var).*/
-static char * float_to_one_decimal_string(float f) {
+static void append_one_decimal_to_buffer(reporting_buffer_t *buffer, float f) {
 	float rounded_f = floorf(f * 10 + .5f) / 10;
 
 	int floor_part = (int) rounded_f;
 	int one_decimal_part = (int)floorf(10 * (rounded_f - (float)floor_part) + .5f);
 
-	return ms_strdup_printf("%d.%d", floor_part, one_decimal_part);
+	append_int_to_buffer(buffer, floor_part);
+	append_to_buffer_len(buffer, ".", 1);
+	append_int_to_buffer(buffer, one_decimal_part);
 }
 
-static void append_to_buffer_valist(char **buff, size_t *buff_size, size_t *offset, const char *fmt, va_list args) {
-	belle_sip_error_code ret;
-	size_t prevoffset = *offset;
+static void append_field_to_buffer(reporting_buffer_t *buffer, const char *name, const char *value) {
+	append_to_buffer(buffer, name);
+	append_to_buffer(buffer, value);
+}
 
-	#ifndef _WIN32
-		va_list cap;/*copy of our argument list: a va_list cannot be re-used (SIGSEGV on linux 64 bits)*/
-		va_copy(cap,args);
-		ret = belle_sip_snprintf_valist(*buff, *buff_size, offset, fmt, cap);
-		va_end(cap);
-	#else
-		ret = belle_sip_snprintf_valist(*buff, *buff_size, offset, fmt, args);
-	#endif
+static void append_quoted_field_to_buffer(reporting_buffer_t *buffer, const char *name, const char *value) {
+	append_to_buffer(buffer, name);
+	append_to_buffer_len(buffer, "\"", 1);
+	append_to_buffer(buffer, value);
+	append_to_buffer_len(buffer, "\"", 1);
+}
 
-	/*if we are out of memory, we add some size to buffer*/
-	if (ret == BELLE_SIP_BUFFER_OVERFLOW) {
-		/*some compilers complain that size_t cannot be formatted as unsigned long, hence forcing cast*/
-		ms_debug("QualityReporting: Buffer was too small to contain the whole report - increasing its size from %lu to %lu",
-			(unsigned long)*buff_size, (unsigned long)*buff_size + 2048);
-		*buff_size += 2048;
-		*buff = (char *) ms_realloc(*buff, *buff_size);
+static void append_int_field_to_buffer(reporting_buffer_t *buffer, const char *name, int value) {
+	append_to_buffer(buffer, name);
+	append_int_to_buffer(buffer, value);
+}
 
-		*offset = prevoffset;
-		/*recall itself since we did not write all things into the buffer but
-		only a part of it*/
-		append_to_buffer_valist(buff, buff_size, offset, fmt, args);
-	}
+static void append_one_decimal_field_to_buffer(reporting_buffer_t *buffer, const char *name, float value) {
+	append_to_buffer(buffer, name);
+	append_one_decimal_to_buffer(buffer, value);
 }
 
-static void append_to_buffer(char **buff, size_t *buff_size, size_t *offset, const char *fmt, ...) {
-	va_list args;
-	va_start(args, fmt);
-	append_to_buffer_valist(buff, buff_size, offset, fmt, args);
-	va_end(args);
+static void append_line_to_buffer(reporting_buffer_t *buffer, const char *name, const char *value) {
+	append_field_to_buffer(buffer, name, value);
+	append_to_buffer_len(buffer, "\r\n", 2);
 }
 
 static void reset_avg_metrics(reporting_session_report_t * report){
@@ -116,9 +164,11 @@ static void reset_avg_metrics(reporting_session_report_t * report){
 	report->last_report_date = ms_time(NULL);
 }
 
-#define APPEND_IF_NOT_NULL_STR(buffer, size, offset, fmt, arg) if (arg != NULL) append_to_buffer(buffer, size, offset, fmt, arg)
-#define APPEND_IF_NUM_IN_RANGE(buffer, size, offset, fmt, arg, inf, sup) if (inf <= arg && arg <= sup) append_to_buffer(buffer, size, offset, fmt, arg)
-#define APPEND_IF(buffer, size, offset, fmt, arg, cond) if (cond) append_to_buffer(buffer, size, offset, fmt, arg)
+#define APPEND_IF_NOT_NULL_STR(buffer, name, arg) if (arg != NULL) append_field_to_buffer(buffer, name, arg)
+#define APPEND_IF_NOT_NULL_QUOTED_STR(buffer, name, arg) if (arg != NULL) append_quoted_field_to_buffer(buffer, name, arg)
+#define APPEND_LINE_IF_NOT_NULL_STR(buffer, name, arg) if (arg != NULL) append_line_to_buffer(buffer, name, arg)
+#define APPEND_IF_NUM_IN_RANGE(buffer, name, arg, inf, sup) if (inf <= arg && arg <= sup) append_int_field_to_buffer(buffer, name, arg)
+#define APPEND_IF(buffer, name, arg, cond) if (cond) append_int_field_to_buffer(buffer, name, arg)
 #define IF_NUM_IN_RANGE(num, inf, sup, statement) if (inf <= num && num <= sup) statement
 
 #define METRICS_PACKET_LOSS 1 << 0
@@ -184,14 +234,9 @@ static bool_t media_report_enabled(LinphoneCall * call, int stats_type){
 	return (Call::toCpp(call)->getLog()->reporting.reports[stats_type] != NULL);
 }
 
-static void append_metrics_to_buffer(char ** buffer, size_t * size, size_t * offset, const reporting_content_metrics_t *rm) {
+static void append_metrics_to_buffer(reporting_buffer_t *buffer, const reporting_content_metrics_t *rm) {
 	char * timestamps_start_str = NULL;
 	char * timestamps_stop_str = NULL;
-	char * network_packet_loss_rate_str = NULL;
-	char * jitter_buffer_discard_rate_str = NULL;
-	/*char * gap_loss_density_str = NULL;*/
-	char * moslq_str = NULL;
-	char * moscq_str = NULL;
 	uint8_t available_metrics = are_metrics_filled(rm);
 
 	if (rm->timestamps.start > 0)
@@ -199,92 +244,155 @@ static void append_metrics_to_buffer(char ** buffer, size_t * size, size_t * off
 	if (rm->timestamps.stop > 0)
 		timestamps_stop_str = linphone_timestamp_to_rfc3339_string(rm->timestamps.stop);
 
-	append_to_buffer(buffer, size, offset, "Timestamps:");
-		APPEND_IF_NOT_NULL_STR(buffer, size, offset, " START=%s", timestamps_start_str);
-		APPEND_IF_NOT_NULL_STR(buffer, size, offset, " STOP=%s", timestamps_stop_str);
+	append_to_buffer(buffer, "Timestamps:");
+		APPEND_IF_NOT_NULL_STR(buffer, " START=", timestamps_start_str);
+		APPEND_IF_NOT_NULL_STR(buffer, " STOP=", timestamps_stop_str);
 
 	if ((available_metrics & METRICS_SESSION_DESCRIPTION) != 0){
-		append_to_buffer(buffer, size, offset, "\r\nSessionDesc:");
-			APPEND_IF(buffer, size, offset, " PT=%d", rm->session_description.payload_type, rm->session_description.payload_type != -1);
-			APPEND_IF_NOT_NULL_STR(buffer, size, offset, " PD=%s", rm->session_description.payload_desc);
-			APPEND_IF(buffer, size, offset, " SR=%d", rm->session_description.sample_rate, rm->session_description.sample_rate != -1);
-			APPEND_IF(buffer, size, offset, " FD=%d", rm->session_description.frame_duration, rm->session_description.frame_duration != -1);
-			APPEND_IF_NOT_NULL_STR(buffer, size, offset, " FMTP=\"%s\"", rm->session_description.fmtp);
-			APPEND_IF(buffer, size, offset, " PLC=%d", rm->session_description.packet_loss_concealment, rm->session_description.packet_loss_concealment != -1);
+		append_to_buffer(buffer, "\r\nSessionDesc:");
+			APPEND_IF(buffer, " PT=", rm->session_description.payload_type, rm->session_description.payload_type != -1);
+			APPEND_IF_NOT_NULL_STR(buffer, " PD=", rm->session_description.payload_desc);
+			APPEND_IF(buffer, " SR=", rm->session_description.sample_rate, rm->session_description.sample_rate != -1);
+			APPEND_IF(buffer, " FD=", rm->session_description.frame_duration, rm->session_description.frame_duration != -1);
+			APPEND_IF_NOT_NULL_QUOTED_STR(buffer, " FMTP=", rm->session_description.fmtp);
+			APPEND_IF(buffer, " PLC=", rm->session_description.packet_loss_concealment, rm->session_description.packet_loss_concealment != -1);
 	}
 
 	if ((available_metrics & METRICS_JITTER_BUFFER) != 0){
-		append_to_buffer(buffer, size, offset, "\r\nJitterBuffer:");
-			APPEND_IF_NUM_IN_RANGE(buffer, size, offset, " JBA=%d", rm->jitter_buffer.adaptive, 0, 3);
+		append_to_buffer(buffer, "\r\nJitterBuffer:");
+			APPEND_IF_NUM_IN_RANGE(buffer, " JBA=", rm->jitter_buffer.adaptive, 0, 3);
 			if (rm->rtcp_xr_count){
-				APPEND_IF_NUM_IN_RANGE(buffer, size, offset, " JBN=%d", rm->jitter_buffer.nominal/rm->rtcp_xr_count, 0, 65535);
-				APPEND_IF_NUM_IN_RANGE(buffer, size, offset, " JBM=%d", rm->jitter_buffer.max/rm->rtcp_xr_count, 0, 65535);
+				APPEND_IF_NUM_IN_RANGE(buffer, " JBN=", rm->jitter_buffer.nominal/rm->rtcp_xr_count, 0, 65535);
+				APPEND_IF_NUM_IN_RANGE(buffer, " JBM=", rm->jitter_buffer.max/rm->rtcp_xr_count, 0, 65535);
 			}
-			APPEND_IF_NUM_IN_RANGE(buffer, size, offset, " JBX=%d",  rm->jitter_buffer.abs_max, 0, 65535);
-
-		append_to_buffer(buffer, size, offset, "\r\nPacketLoss:");
-			IF_NUM_IN_RANGE(rm->packet_loss.network_packet_loss_rate, 0, 255, network_packet_loss_rate_str = float_to_one_decimal_string(rm->packet_loss.network_packet_loss_rate / 256));
-			IF_NUM_IN_RANGE(rm->packet_loss.jitter_buffer_discard_rate, 0, 255, jitter_buffer_discard_rate_str = float_to_one_decimal_string(rm->packet_loss.jitter_buffer_discard_rate / 256));
+			APPEND_IF_NUM_IN_RANGE(buffer, " JBX=",  rm->jitter_buffer.abs_max, 0, 65535);
 
-			APPEND_IF_NOT_NULL_STR(buffer, size, offset, " NLR=%s", network_packet_loss_rate_str);
-			APPEND_IF_NOT_NULL_STR(buffer, size, offset, " JDR=%s", jitter_buffer_discard_rate_str);
+		append_to_buffer(buffer, "\r\nPacketLoss:");
+			IF_NUM_IN_RANGE(rm->packet_loss.network_packet_loss_rate, 0, 255, append_one_decimal_field_to_buffer(buffer, " NLR=", rm->packet_loss.network_packet_loss_rate / 256));
+			IF_NUM_IN_RANGE(rm->packet_loss.jitter_buffer_discard_rate, 0, 255, append_one_decimal_field_to_buffer(buffer, " JDR=", rm->packet_loss.jitter_buffer_discard_rate / 256));
 	}
 
-		/*append_to_buffer(buffer, size, offset, "\r\nBurstGapLoss:");*/
-			/*IF_NUM_IN_RANGE(rm.burst_gap_loss.gap_loss_density, 0, 10, gap_loss_density_str = float_to_one_decimal_string(rm.burst_gap_loss.gap_loss_density));*/
-		/*	append_to_buffer(buffer, size, offset, " BLD=%d", rm.burst_gap_loss.burst_loss_density);*/
-		/*	append_to_buffer(buffer, size, offset, " BD=%d", rm.burst_gap_loss.burst_duration);*/
-		/*	APPEND_IF_NOT_NULL_STR(buffer, size, offset, " GLD=%s", gap_loss_density_str);*/
-		/*	append_to_buffer(buffer, size, offset, " GD=%d", rm.burst_gap_loss.gap_duration);*/
-		/*	append_to_buffer(buffer, size, offset, " GMIN=%d", rm.burst_gap_loss.min_gap_threshold);*/
+		/*append_to_buffer(buffer, "\r\nBurstGapLoss:");*/
+			/*IF_NUM_IN_RANGE(rm.burst_gap_loss.gap_loss_density, 0, 10, append_one_decimal_field_to_buffer(buffer, " GLD=", rm.burst_gap_loss.gap_loss_density));*/
+		/*	append_int_field_to_buffer(buffer, " BLD=", rm.burst_gap_loss.burst_loss_density);*/
+		/*	append_int_field_to_buffer(buffer, " BD=", rm.burst_gap_loss.burst_duration);*/
+		/*	append_int_field_to_buffer(buffer, " GD=", rm.burst_gap_loss.gap_duration);*/
+		/*	append_int_field_to_buffer(buffer, " GMIN=", rm.burst_gap_loss.min_gap_threshold);*/
 
 	if ((available_metrics & METRICS_DELAY) != 0){
-		append_to_buffer(buffer, size, offset, "\r\nDelay:");
+		append_to_buffer(buffer, "\r\nDelay:");
 			if (rm->rtcp_xr_count+rm->rtcp_sr_count){
-				APPEND_IF_NUM_IN_RANGE(buffer, size, offset, " RTD=%d", rm->delay.round_trip_delay/(rm->rtcp_xr_count+rm->rtcp_sr_count), 0, 65535);
+				APPEND_IF_NUM_IN_RANGE(buffer, " RTD=", rm->delay.round_trip_delay/(rm->rtcp_xr_count+rm->rtcp_sr_count), 0, 65535);
 			}
-			APPEND_IF_NUM_IN_RANGE(buffer, size, offset, " ESD=%d", rm->delay.end_system_delay, 0, 65535);
-			APPEND_IF_NUM_IN_RANGE(buffer, size, offset, " IAJ=%d", rm->delay.interarrival_jitter, 0, 65535);
-			APPEND_IF_NUM_IN_RANGE(buffer, size, offset, " MAJ=%d", rm->delay.mean_abs_jitter, 0, 65535);
+			APPEND_IF_NUM_IN_RANGE(buffer, " ESD=", rm->delay.end_system_delay, 0, 65535);
+			APPEND_IF_NUM_IN_RANGE(buffer, " IAJ=", rm->delay.interarrival_jitter, 0, 65535);
+			APPEND_IF_NUM_IN_RANGE(buffer, " MAJ=", rm->delay.mean_abs_jitter, 0, 65535);
 	}
 
 	if ((available_metrics & METRICS_SIGNAL) != 0){
-		append_to_buffer(buffer, size, offset, "\r\nSignal:");
-			APPEND_IF(buffer, size, offset, " SL=%d", rm->signal.level, rm->signal.level != 127);
-			APPEND_IF(buffer, size, offset, " NL=%d", rm->signal.noise_level, rm->signal.noise_level != 127);
+		append_to_buffer(buffer, "\r\nSignal:");
+			APPEND_IF(buffer, " SL=", rm->signal.level, rm->signal.level != 127);
+			APPEND_IF(buffer, " NL=", rm->signal.noise_level, rm->signal.noise_level != 127);
 	}
 
 	/*if quality estimates metrics are available, rtcp_xr_count should be always not null*/
 	if ((available_metrics & METRICS_QUALITY_ESTIMATES) != 0){
-		IF_NUM_IN_RANGE(rm->quality_estimates.moslq, 1, 5, moslq_str = float_to_one_decimal_string(rm->quality_estimates.moslq));
-		IF_NUM_IN_RANGE(rm->quality_estimates.moscq, 1, 5, moscq_str = float_to_one_decimal_string(rm->quality_estimates.moscq));
-
-		append_to_buffer(buffer, size, offset, "\r\nQualityEst:");
-			APPEND_IF_NOT_NULL_STR(buffer, size, offset, " MOSLQ=%s", moslq_str);
-			APPEND_IF_NOT_NULL_STR(buffer, size, offset, " MOSCQ=%s", moscq_str);
+		append_to_buffer(buffer, "\r\nQualityEst:");
+			IF_NUM_IN_RANGE(rm->quality_estimates.moslq, 1, 5, append_one_decimal_field_to_buffer(buffer, " MOSLQ=", rm->quality_estimates.moslq));
+			IF_NUM_IN_RANGE(rm->quality_estimates.moscq, 1, 5, append_one_decimal_field_to_buffer(buffer, " MOSCQ=", rm->quality_estimates.moscq));
 	}
 
 	if (rm->user_agent!=NULL){
-		append_to_buffer(buffer, size, offset, "\r\nLinphoneExt:");
-			APPEND_IF_NOT_NULL_STR(buffer, size, offset, " UA=\"%s\"", rm->user_agent);
+		append_to_buffer(buffer, "\r\nLinphoneExt:");
+			APPEND_IF_NOT_NULL_QUOTED_STR(buffer, " UA=", rm->user_agent);
 	}
 
-	append_to_buffer(buffer, size, offset, "\r\n");
+	append_to_buffer(buffer, "\r\n");
 
 	ms_free(timestamps_start_str);
 	ms_free(timestamps_stop_str);
-	ms_free(network_packet_loss_rate_str);
-	ms_free(jitter_buffer_discard_rate_str);
-	/*ms_free(gap_loss_density_str);*/
-	ms_free(moslq_str);
-	ms_free(moscq_str);
+}
+
+const char *linphone_reporting_serialize_report(LinphoneCore *lc, const reporting_session_report_t *report, const char *report_event) {
+	reporting_buffer_t buffer;
+
+	buffer.data = lc->quality_report_buffer;
+	buffer.size = lc->quality_report_buffer_size;
+	buffer.offset = 0;
+	if (buffer.data == NULL) {
+		buffer.size = 2048;
+		buffer.data = (char *) ms_malloc(buffer.size);
+	}
+	buffer.data[0] = '\0';
+
+	append_line_to_buffer(&buffer, "", report_event);
+	append_line_to_buffer(&buffer, "CallID: ", report->info.call_id);
+	append_line_to_buffer(&buffer, "LocalID: ", report->info.local_addr.id);
+	append_line_to_buffer(&buffer, "RemoteID: ", report->info.remote_addr.id);
+	append_line_to_buffer(&buffer, "OrigID: ", report->info.orig_id);
+
+	APPEND_LINE_IF_NOT_NULL_STR(&buffer, "LocalGroup: ", report->info.local_addr.group);
+	APPEND_LINE_IF_NOT_NULL_STR(&buffer, "RemoteGroup: ", report->info.remote_addr.group);
+	append_field_to_buffer(&buffer, "LocalAddr: IP=", report->info.local_addr.ip);
+	append_int_field_to_buffer(&buffer, " PORT=", report->info.local_addr.port);
+	append_to_buffer(&buffer, " SSRC=");
+	append_uint_to_buffer(&buffer, report->info.local_addr.ssrc);
+	append_to_buffer(&buffer, "\r\n");
+	APPEND_LINE_IF_NOT_NULL_STR(&buffer, "LocalMAC: ", report->info.local_addr.mac);
+	append_field_to_buffer(&buffer, "RemoteAddr: IP=", report->info.remote_addr.ip);
+	append_int_field_to_buffer(&buffer, " PORT=", report->info.remote_addr.port);
+	append_to_buffer(&buffer, " SSRC=");
+	append_uint_to_buffer(&buffer, report->info.remote_addr.ssrc);
+	append_to_buffer(&buffer, "\r\n");
+	APPEND_LINE_IF_NOT_NULL_STR(&buffer, "RemoteMAC: ", report->info.remote_addr.mac);
+
+	append_to_buffer(&buffer, "LocalMetrics:\r\n");
+	append_metrics_to_buffer(&buffer, &report->local_metrics);
+
+	if (are_metrics_filled(&report->remote_metrics)!=0) {
+		append_to_buffer(&buffer, "RemoteMetrics:\r\n");
+		append_metrics_to_buffer(&buffer, &report->remote_metrics);
+	}
+	APPEND_LINE_IF_NOT_NULL_STR(&buffer, "DialogID: ", report->dialog_id);
+
+	if (report->qos_analyzer.timestamp!=NULL){
+		append_to_buffer(&buffer, "AdaptiveAlg:");
+			APPEND_IF_NOT_NULL_QUOTED_STR(&buffer, " NAME=", report->qos_analyzer.name);
+			APPEND_IF_NOT_NULL_QUOTED_STR(&buffer, " TS=", report->qos_analyzer.timestamp);
+			APPEND_IF_NOT_NULL_QUOTED_STR(&buffer, " IN_LEG=", report->qos_analyzer.input_leg);
+			APPEND_IF_NOT_NULL_QUOTED_STR(&buffer, " IN=", report->qos_analyzer.input);
+			APPEND_IF_NOT_NULL_QUOTED_STR(&buffer, " OUT_LEG=", report->qos_analyzer.output_leg);
+			APPEND_IF_NOT_NULL_QUOTED_STR(&buffer, " OUT=", report->qos_analyzer.output);
+		append_to_buffer(&buffer, "\r\n");
+	}
+
+#if TARGET_OS_IPHONE
+	{
+		size_t namesize;
+		char *machine;
+		sysctlbyname("hw.machine", NULL, &namesize, NULL, 0);
+		machine = reinterpret_cast<char *>(malloc(namesize));
+		sysctlbyname("hw.machine", machine, &namesize, NULL, 0);
+		APPEND_LINE_IF_NOT_NULL_STR(&buffer, "Device: ", machine);
+	}
+#endif
+
+	lc->quality_report_buffer = buffer.data;
+	lc->quality_report_buffer_size = buffer.size;
+	return buffer.data;
+}
+
+void linphone_reporting_release_buffer(LinphoneCore *lc) {
+	if (lc->quality_report_buffer) {
+		ms_free(lc->quality_report_buffer);
+		lc->quality_report_buffer = NULL;
+		lc->quality_report_buffer_size = 0;
+	}
 }
 
 static int send_report(LinphoneCall* call, reporting_session_report_t * report, const char * report_event) {
 	LinphoneContent *content;
-	size_t offset = 0;
-	size_t size = 2048;
-	char * buffer;
+	const char *body;
 	int ret = 0;
 	LinphoneEvent *lev;
 	LinphoneAddress *request_uri;
@@ -313,57 +421,11 @@ static int send_report(LinphoneCall* call, reporting_session_report_t * report,
 		goto end;
 	}
 
-	buffer = (char *) ms_malloc0(size);
+	body = linphone_reporting_serialize_report(linphone_call_get_core(call), report, report_event);
 	content = linphone_content_new();
 	linphone_content_set_type(content, "application");
 	linphone_content_set_subtype(content, "vq-rtcpxr");
-
-	append_to_buffer(&buffer, &size, &offset, "%s\r\n", report_event);
-	append_to_buffer(&buffer, &size, &offset, "CallID: %s\r\n", report->info.call_id);
-	append_to_buffer(&buffer, &size, &offset, "LocalID: %s\r\n", report->info.local_addr.id);
-	append_to_buffer(&buffer, &size, &offset, "RemoteID: %s\r\n", report->info.remote_addr.id);
-	append_to_buffer(&buffer, &size, &offset, "OrigID: %s\r\n", report->info.orig_id);
-
-	APPEND_IF_NOT_NULL_STR(&buffer, &size, &offset, "LocalGroup: %s\r\n", report->info.local_addr.group);
-	APPEND_IF_NOT_NULL_STR(&buffer, &size, &offset, "RemoteGroup: %s\r\n", report->info.remote_addr.group);
-	append_to_buffer(&buffer, &size, &offset, "LocalAddr: IP=%s PORT=%d SSRC=%u\r\n", report->info.local_addr.ip, report->info.local_addr.port, report->info.local_addr.ssrc);
-	APPEND_IF_NOT_NULL_STR(&buffer, &size, &offset, "LocalMAC: %s\r\n", report->info.local_addr.mac);
-	append_to_buffer(&buffer, &size, &offset, "RemoteAddr: IP=%s PORT=%d SSRC=%u\r\n", report->info.remote_addr.ip, report->info.remote_addr.port, report->info.remote_addr.ssrc);
-	APPEND_IF_NOT_NULL_STR(&buffer, &size, &offset, "RemoteMAC: %s\r\n", report->info.remote_addr.mac);
-
-	append_to_buffer(&buffer, &size, &offset, "LocalMetrics:\r\n");
-	append_metrics_to_buffer(&buffer, &size, &offset, &report->local_metrics);
-
-	if (are_metrics_filled(&report->remote_metrics)!=0) {
-		append_to_buffer(&buffer, &size, &offset, "RemoteMetrics:\r\n");
-		append_metrics_to_buffer(&buffer, &size, &offset, &report->remote_metrics);
-	}
-	APPEND_IF_NOT_NULL_STR(&buffer, &size, &offset, "DialogID: %s\r\n", report->dialog_id);
-
-	if (report->qos_analyzer.timestamp!=NULL){
-		append_to_buffer(&buffer, &size, &offset, "AdaptiveAlg:");
-			APPEND_IF_NOT_NULL_STR(&buffer, &size, &offset, " NAME=\"%s\"", report->qos_analyzer.name);
-			APPEND_IF_NOT_NULL_STR(&buffer, &size, &offset, " TS=\"%s\"", report->qos_analyzer.timestamp);
-			APPEND_IF_NOT_NULL_STR(&buffer, &size, &offset, " IN_LEG=\"%s\"", report->qos_analyzer.input_leg);
-			APPEND_IF_NOT_NULL_STR(&buffer, &size, &offset, " IN=\"%s\"", report->qos_analyzer.input);
-			APPEND_IF_NOT_NULL_STR(&buffer, &size, &offset, " OUT_LEG=\"%s\"", report->qos_analyzer.output_leg);
-			APPEND_IF_NOT_NULL_STR(&buffer, &size, &offset, " OUT=\"%s\"", report->qos_analyzer.output);
-		append_to_buffer(&buffer, &size, &offset, "\r\n");
-	}
-
-#if TARGET_OS_IPHONE
-	{
-		size_t namesize;
-		char *machine;
-		sysctlbyname("hw.machine", NULL, &namesize, NULL, 0);
-		machine = reinterpret_cast<char *>(malloc(namesize));
-		sysctlbyname("hw.machine", machine, &namesize, NULL, 0);
-		APPEND_IF_NOT_NULL_STR(&buffer, &size, &offset, "Device: %s\r\n", machine);
-	}
-#endif
-
-	linphone_content_set_buffer(content, (uint8_t *)buffer, strlen(buffer));
-	ms_free(buffer);
+	linphone_content_set_buffer(content, (const uint8_t *)body, strlen(body));
 
 	if (linphone_call_get_call_log(call)->reporting.on_report_sent != NULL) {
 		SalStreamType type = report == linphone_call_get_call_log(call)->reporting.reports[0] ? SalAudio : report == linphone_call_get_call_log(call)->reporting.reports[1] ? SalVideo : SalText;
@@ -209,6 +209,24 @@ void linphone_reporting_call_state_updated(LinphoneCall *call);
  */
 LINPHONE_PUBLIC void linphone_reporting_set_on_report_send(LinphoneCall *call, LinphoneQualityReportingReportSendCb cb);
 
+/**
+ * Write the RTCP-XR body of a report, as sent to the collector.
+ * The body is written into a buffer of the core, reused by the following reports.
+ * @param lc #LinphoneCore owning the buffer
+ * @param report the report to serialize
+ * @param report_event first line of the body, such as "VQIntervalReport"
+ * @return the body, valid until the next report of the core
+ *
+ */
+LINPHONE_PUBLIC const char *linphone_reporting_serialize_report(LinphoneCore *lc, const reporting_session_report_t *report, const char *report_event);
+
+/**
+ * Free the report buffer of the core.
+ * @param lc #LinphoneCore object to consider
+ *
+ */
+void linphone_reporting_release_buffer(LinphoneCore *lc);
+
 #ifdef __cplusplus
 }
 #endif
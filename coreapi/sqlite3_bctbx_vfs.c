@@ -38,6 +38,11 @@ static int sqlite3bctbx_Close(sqlite3_file *p){
 	int ret;
 	sqlite3_bctbx_file_t *pFile = (sqlite3_bctbx_file_t*) p;
 
+	if (pFile->pLock){
+		sqlite3bctbx_Unlock(p, SQLITE_LOCK_NONE);
+		sqlite3bctbx_releaseLock(pFile->pLock);
+		pFile->pLock = NULL;
+	}
 	ret = bctbx_file_close(pFile->pbctbx_file);
 	if (!ret){
 		return SQLITE_OK;
@@ -154,6 +159,164 @@ static int sqlite3bctbx_FileSize(sqlite3_file *p, sqlite_int64 *pSize){
 }
 
 
+/************************ LOCKS ***********************/
+/** The files are not locked on disk, but sqlite requires the locks to be
+arbitrated as soon as a database is opened by several connections, for
+example from different threads. The lock levels are then kept in memory for
+each database file opened by this process, following the rules of the unix VFS. */
+
+struct sqlite3_bctbx_lock_t {
+	char *path;                   /* Path the database was opened with. */
+	int refCount;                 /* Number of file handles opened on it. */
+	int sharedCount;              /* Number of file handles holding at least a SHARED lock. */
+	int eLock;                    /* Highest SQLITE_LOCK_* level held on the file. */
+	sqlite3_bctbx_lock_t *pNext;
+};
+
+static sqlite3_bctbx_lock_t *sqlite3bctbx_locks = NULL;
+
+static sqlite3_mutex *sqlite3bctbx_getLocksMutex(void){
+#ifdef SQLITE_MUTEX_STATIC_VFS1
+	return sqlite3_mutex_alloc(SQLITE_MUTEX_STATIC_VFS1);
+#else
+	return sqlite3_mutex_alloc(SQLITE_MUTEX_STATIC_APP1);
+#endif
+}
+
+/**
+ * Returns the lock state of the database file fName, created if it is not opened yet.
+ * @param  fName  database filename
+ * @return        lock state to release with sqlite3bctbx_releaseLock.
+ */
+static sqlite3_bctbx_lock_t *sqlite3bctbx_acquireLock(const char *fName){
+	sqlite3_mutex *mutex = sqlite3bctbx_getLocksMutex();
+	sqlite3_bctbx_lock_t *pLock;
+
+	sqlite3_mutex_enter(mutex);
+	for (pLock = sqlite3bctbx_locks; pLock != NULL; pLock = pLock->pNext){
+		if (strcmp(pLock->path, fName) == 0) break;
+	}
+	if (pLock == NULL){
+		pLock = (sqlite3_bctbx_lock_t *)bctbx_malloc0(sizeof(sqlite3_bctbx_lock_t));
+		pLock->path = bctbx_strdup(fName);
+		pLock->eLock = SQLITE_LOCK_NONE;
+		pLock->pNext = sqlite3bctbx_locks;
+		sqlite3bctbx_locks = pLock;
+	}
+	pLock->refCount++;
+	sqlite3_mutex_leave(mutex);
+	return pLock;
+}
+
+static void sqlite3bctbx_releaseLock(sqlite3_bctbx_lock_t *pLock){
+	sqlite3_mutex *mutex = sqlite3bctbx_getLocksMutex();
+	sqlite3_bctbx_lock_t **ppLock;
+
+	sqlite3_mutex_enter(mutex);
+	if (--pLock->refCount == 0){
+		for (ppLock = &sqlite3bctbx_locks; *ppLock != pLock; ppLock = &(*ppLock)->pNext);
+		*ppLock = pLock->pNext;
+		bctbx_free(pLock->path);
+		bctbx_free(pLock);
+	}
+	sqlite3_mutex_leave(mutex);
+}
+
+/**
+ * Raises the lock held on the database file to eLock.
+ * A file handle asking for EXCLUSIVE while others still read keeps a PENDING
+ * lock, so that no new reader comes in until the current ones are done.
+ * @param  p      sqlite3_file file handle pointer.
+ * @param  eLock  SQLITE_LOCK_SHARED, SQLITE_LOCK_RESERVED or SQLITE_LOCK_EXCLUSIVE
+ * @return        SQLITE_OK on success, SQLITE_BUSY if another connection holds a conflicting lock.
+ */
+static int sqlite3bctbx_Lock(sqlite3_file *p, int eLock){
+	sqlite3_bctbx_file_t *pFile = (sqlite3_bctbx_file_t*) p;
+	sqlite3_bctbx_lock_t *pLock = pFile->pLock;
+	sqlite3_mutex *mutex;
+	int rc = SQLITE_OK;
+
+	if (pFile->eLock >= eLock) return SQLITE_OK;
+	if (pLock == NULL){
+		pFile->eLock = eLock;
+		return SQLITE_OK;
+	}
+
+	mutex = sqlite3bctbx_getLocksMutex();
+	sqlite3_mutex_enter(mutex);
+	if (pFile->eLock != pLock->eLock && (pLock->eLock >= SQLITE_LOCK_PENDING || eLock > SQLITE_LOCK_SHARED)){
+		/* Another connection is writing, or reserved the right to. */
+		rc = SQLITE_BUSY;
+	} else if (eLock == SQLITE_LOCK_SHARED){
+		pLock->sharedCount++;
+		if (pLock->eLock == SQLITE_LOCK_NONE) pLock->eLock = SQLITE_LOCK_SHARED;
+		pFile->eLock = SQLITE_LOCK_SHARED;
+	} else if (eLock == SQLITE_LOCK_EXCLUSIVE && pLock->sharedCount > 1){
+		pLock->eLock = SQLITE_LOCK_PENDING;
+		pFile->eLock = SQLITE_LOCK_PENDING;
+		rc = SQLITE_BUSY;
+	} else {
+		pLock->eLock = eLock;
+		pFile->eLock = eLock;
+	}
+	sqlite3_mutex_leave(mutex);
+	return rc;
+}
+
+/**
+ * Lowers the lock held on the database file to eLock.
+ * @param  p      sqlite3_file file handle pointer.
+ * @param  eLock  SQLITE_LOCK_NONE or SQLITE_LOCK_SHARED
+ * @return        SQLITE_OK
+ */
+static int sqlite3bctbx_Unlock(sqlite3_file *p, int eLock){
+	sqlite3_bctbx_file_t *pFile = (sqlite3_bctbx_file_t*) p;
+	sqlite3_bctbx_lock_t *pLock = pFile->pLock;
+	sqlite3_mutex *mutex;
+
+	if (pFile->eLock <= eLock) return SQLITE_OK;
+	if (pLock == NULL){
+		pFile->eLock = eLock;
+		return SQLITE_OK;
+	}
+
+	mutex = sqlite3bctbx_getLocksMutex();
+	sqlite3_mutex_enter(mutex);
+	if (pFile->eLock > SQLITE_LOCK_SHARED) pLock->eLock = SQLITE_LOCK_SHARED;
+	if (eLock == SQLITE_LOCK_NONE){
+		if (--pLock->sharedCount == 0) pLock->eLock = SQLITE_LOCK_NONE;
+	}
+	pFile->eLock = eLock;
+	sqlite3_mutex_leave(mutex);
+	return SQLITE_OK;
+}
+
+/**
+ * Checks whether a connection of this process holds a RESERVED lock or higher
+ * on the database file, that is whether its journal is being written.
+ * @param  p        sqlite3_file file handle pointer.
+ * @param  pResOut  set to 1 if such a lock is held, 0 otherwise.
+ * @return          SQLITE_OK
+ */
+static int sqlite3bctbx_CheckReservedLock(sqlite3_file *p, int *pResOut){
+	sqlite3_bctbx_file_t *pFile = (sqlite3_bctbx_file_t*) p;
+	sqlite3_mutex *mutex;
+
+	if (pFile->pLock == NULL){
+		*pResOut = pFile->eLock > SQLITE_LOCK_SHARED;
+		return SQLITE_OK;
+	}
+
+	mutex = sqlite3bctbx_getLocksMutex();
+	sqlite3_mutex_enter(mutex);
+	*pResOut = pFile->pLock->eLock > SQLITE_LOCK_SHARED;
+	sqlite3_mutex_leave(mutex);
+	return SQLITE_OK;
+}
+
+/************************ END OF LOCKS ***********************/
+
+
 /************************ PLACE HOLDER FUNCTIONS ***********************/
 /** These functions were implemented to please the SQLite VFS
 implementation. Some of them are just stubs, some do a very limited job. */
@@ -185,41 +348,6 @@ static int sqlite3bctbx_FileControl(sqlite3_file *p, int op, void *pArg){
 
 }
 
-/**
- * The lock file mechanism is not used with this VFS : checking
- * the reserved lock is always OK.
- * @param  pUnused sqlite3_file file handle pointer.
- * @param  pResOut set to 0 since there is no lock mechanism.
- * @return         SQLITE_OK
- */
-static int sqlite3bctbx_nolockCheckReservedLock(sqlite3_file *pUnused, int *pResOut){
-	*pResOut = 0;
-	return SQLITE_OK;
-}
-
-/**
- * The lock file mechanism is not used with this VFS : locking the file
- * is always OK.
- * @param  pUnused sqlite3_file file handle pointer.
- * @param  unused  unused
- * @return         SQLITE_OK
- */
-static int sqlite3bctbx_nolockLock(sqlite3_file *pUnused, int unused){
-	return SQLITE_OK;
-}
-
-/**
- * The lock file mechanism is not used with this VFS : unlocking the file
-  * is always OK.
- * @param  pUnused sqlite3_file file handle pointer.
- * @param  unused  unused
- * @return         SQLITE_OK
- */
-static int sqlite3bctbx_nolockUnlock(sqlite3_file *pUnused, int unused){
-	return SQLITE_OK;
-}
-
-
 /**
  * Simply sync the file contents given through the file handle p
  * to the persistent media.
@@ -257,9 +385,9 @@ static  int sqlite3bctbx_Open(sqlite3_vfs *pVfs, const char *fName, sqlite3_file
 		sqlite3bctbx_Truncate,					/* xTruncate */
 		sqlite3bctbx_Sync,
 		sqlite3bctbx_FileSize,
-		sqlite3bctbx_nolockLock,
-		sqlite3bctbx_nolockUnlock,
-		sqlite3bctbx_nolockCheckReservedLock,
+		sqlite3bctbx_Lock,
+		sqlite3bctbx_Unlock,
+		sqlite3bctbx_CheckReservedLock,
 		sqlite3bctbx_FileControl,
 		NULL,									/* xSectorSize */
 		sqlite3bctbx_DeviceCharacteristics
@@ -296,6 +424,10 @@ static  int sqlite3bctbx_Open(sqlite3_vfs *pVfs, const char *fName, sqlite3_file
 		return SQLITE_CANTOPEN;
 	}
 
+	/* Only the database itself is locked, its journal is protected by the database lock. */
+	pFile->pLock = (flags & SQLITE_OPEN_MAIN_DB) ? sqlite3bctbx_acquireLock(fName) : NULL;
+	pFile->eLock = SQLITE_LOCK_NONE;
+
 	if( pOutFlags ){
     	*pOutFlags = flags;
   	}
@@ -37,6 +37,11 @@
 #define BCTBX_SQLITE3_VFS "sqlite3bctbx_vfs"
 
 
+/**
+ * Lock state of a database file, shared by the connections of the process that opened it.
+ */
+typedef struct sqlite3_bctbx_lock_t sqlite3_bctbx_lock_t;
+
 /**
  * sqlite3_bctbx_file_t VFS file structure.
  */
@@ -44,6 +49,8 @@ typedef struct sqlite3_bctbx_file_t sqlite3_bctbx_file_t;
 struct sqlite3_bctbx_file_t {
 	sqlite3_file base;              /* Base class. Must be first. */
 	bctbx_vfs_file_t* pbctbx_file;
+	sqlite3_bctbx_lock_t *pLock;    /* Lock state of the database file, NULL for journals and other files. */
+	int eLock;                      /* SQLITE_LOCK_* level held through this file handle. */
 };
 
 
@@ -92,7 +99,8 @@ sqlite3_vfs *sqlite3_bctbx_vfs_create(void);
  * Registers sqlite3bctbx_vfs to SQLite VFS. If makeDefault is 1,
  * the VFS will be used by default.
  * Methods not implemented by sqlite3_bctbx_vfs_t are initialized to the one 
- * used by the unix-none VFS where all locking file operations are no-ops. 
+ * used by the unix-none VFS. Locks are only arbitrated between the connections
+ * of this process, the files are not locked on disk. 
  * @param  makeDefault  set to 1 to make the newly registered VFS be the default one, set to 0 instead.
  */
 void sqlite3_bctbx_vfs_register(int makeDefault);
@@ -0,0 +1,213 @@
+/*
+ * Copyright (c) 2010-2019 Belledonne Communications SARL.
+ *
+ * This file is part of Liblinphone.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <string>
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+#include "linphone/core.h"
+#include "private.h"
+#include "c-wrapper/c-wrapper.h"
+#include "core/core-p.h"
+
+/* Queries run on any database of the process: startups of several cores at the same time are not told apart. */
+static std::atomic<uint64_t> db_query_count(0);
+
+void _linphone_core_count_db_query(void) {
+	db_query_count++;
+}
+
+static int startup_timeline_count_sqlite3_query(unsigned int type, void *context, void *statement, void *sql) {
+	_linphone_core_count_db_query();
+	return 0;
+}
+
+void _linphone_core_startup_timeline_watch_db(LinphoneCore *lc, sqlite3 *db) {
+	if (lc->startup_recording && db) sqlite3_trace_v2(db, SQLITE_TRACE_STMT, startup_timeline_count_sqlite3_query, NULL);
+}
+
+/* The queries are not counted anymore once the core is On. */
+static void startup_timeline_unwatch_dbs(LinphoneCore *lc) {
+	sqlite3 *dbs[] = { lc->zrtp_cache_db, lc->logs_db, lc->friends_db };
+	for (sqlite3 *db : dbs) {
+		if (db) sqlite3_trace_v2(db, 0, NULL, NULL);
+	}
+
+	auto &mainDb = L_GET_PRIVATE_FROM_C_OBJECT(lc)->mainDb;
+	if (mainDb) mainDb->enableQueryCounting(false);
+}
+
+uint64_t _linphone_startup_timeline_now(void) {
+	return (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()
+	).count();
+}
+
+static int64_t startup_timeline_heap_usage(void) {
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+	struct mallinfo2 info = mallinfo2();
+	return (int64_t)(info.uordblks + info.hblkhd);
+#else
+	return 0;
+#endif
+}
+
+static void startup_phase_destroy(LinphoneStartupPhase *phase) {
+	ms_free(phase->name);
+	ms_free(phase);
+}
+
+static void startup_phase_finish(LinphoneStartupPhase *phase, uint64_t end) {
+	phase->end = end;
+	phase->heap_usage = startup_timeline_heap_usage() - phase->heap_usage;
+	phase->db_queries = db_query_count - phase->db_queries;
+	phase->ended = TRUE;
+}
+
+void linphone_core_startup_timeline_clear(LinphoneCore *lc) {
+	lc->startup_phases = bctbx_list_free_with_data(lc->startup_phases, (bctbx_list_free_func)startup_phase_destroy);
+	lc->startup_recording = FALSE;
+}
+
+void linphone_core_startup_timeline_start(LinphoneCore *lc) {
+	uint64_t config_start, config_end;
+
+	linphone_core_startup_timeline_clear(lc);
+	lc->startup_recording = TRUE;
+	lc->startup_origin = _linphone_startup_timeline_now();
+
+	/* The configuration files are usually read right before the core is created. */
+	_linphone_config_get_load_interval(lc->config, &config_start, &config_end);
+	if (config_end != 0 && config_end <= lc->startup_origin && lc->startup_origin - config_end < 1000000) {
+		LinphoneStartupPhase *phase = ms_new0(LinphoneStartupPhase, 1);
+		phase->name = ms_strdup("config");
+		phase->start = config_start;
+		phase->end = config_end;
+		phase->ended = TRUE;
+		lc->startup_phases = bctbx_list_append(lc->startup_phases, phase);
+		lc->startup_origin = config_start;
+	}
+}
+
+void linphone_core_startup_phase_begin(LinphoneCore *lc, const char *name) {
+	if (!lc->startup_recording) return;
+
+	LinphoneStartupPhase *phase = ms_new0(LinphoneStartupPhase, 1);
+	phase->name = ms_strdup(name);
+	phase->db_queries = db_query_count;
+	phase->heap_usage = startup_timeline_heap_usage();
+	phase->start = _linphone_startup_timeline_now();
+	lc->startup_phases = bctbx_list_append(lc->startup_phases, phase);
+}
+
+void linphone_core_startup_phase_end(LinphoneCore *lc, const char *name) {
+	if (!lc->startup_recording) return;
+
+	uint64_t end = _linphone_startup_timeline_now();
+	for (bctbx_list_t *elem = bctbx_list_last_elem(lc->startup_phases); elem != NULL; elem = elem->prev) {
+		LinphoneStartupPhase *phase = (LinphoneStartupPhase *)elem->data;
+		if (!phase->ended && strcmp(phase->name, name) == 0) {
+			startup_phase_finish(phase, end);
+			return;
+		}
+	}
+}
+
+void linphone_core_startup_timeline_stop(LinphoneCore *lc) {
+	if (!lc->startup_recording) return;
+
+	uint64_t end = _linphone_startup_timeline_now();
+	for (bctbx_list_t *elem = lc->startup_phases; elem != NULL; elem = bctbx_list_next(elem)) {
+		LinphoneStartupPhase *phase = (LinphoneStartupPhase *)elem->data;
+		if (!phase->ended) startup_phase_finish(phase, end);
+		ms_message("Startup phase [%s]: %llu ms, %llu database queries", phase->name,
+			(unsigned long long)((phase->end - phase->start) / 1000), (unsigned long long)phase->db_queries);
+	}
+	ms_message("Core [%p] started in %llu ms", lc, (unsigned long long)((end - lc->startup_origin) / 1000));
+	lc->startup_recording = FALSE;
+	startup_timeline_unwatch_dbs(lc);
+}
+
+static const LinphoneStartupPhase *get_startup_phase(const LinphoneCore *lc, int index) {
+	if (index < 0) return NULL;
+	return (const LinphoneStartupPhase *)bctbx_list_nth_data(lc->startup_phases, index);
+}
+
+int linphone_core_get_startup_phases_count(const LinphoneCore *lc) {
+	return (int)bctbx_list_size(lc->startup_phases);
+}
+
+const char *linphone_core_get_startup_phase_name(const LinphoneCore *lc, int index) {
+	const LinphoneStartupPhase *phase = get_startup_phase(lc, index);
+	return phase ? phase->name : NULL;
+}
+
+int64_t linphone_core_get_startup_phase_start(const LinphoneCore *lc, int index) {
+	const LinphoneStartupPhase *phase = get_startup_phase(lc, index);
+	return phase ? (int64_t)(phase->start - lc->startup_origin) : -1;
+}
+
+int64_t linphone_core_get_startup_phase_duration(const LinphoneCore *lc, int index) {
+	const LinphoneStartupPhase *phase = get_startup_phase(lc, index);
+	if (!phase) return -1;
+	return (int64_t)((phase->ended ? phase->end : _linphone_startup_timeline_now()) - phase->start);
+}
+
+int linphone_core_get_startup_phase_db_queries(const LinphoneCore *lc, int index) {
+	const LinphoneStartupPhase *phase = get_startup_phase(lc, index);
+	if (!phase) return -1;
+	return phase->ended ? (int)phase->db_queries : (int)(db_query_count - phase->db_queries);
+}
+
+int64_t linphone_core_get_startup_phase_heap_growth(const LinphoneCore *lc, int index) {
+	const LinphoneStartupPhase *phase = get_startup_phase(lc, index);
+	if (!phase) return 0;
+	return phase->ended ? phase->heap_usage : startup_timeline_heap_usage() - phase->heap_usage;
+}
+
+static void append_json_string(std::string &out, const char *value) {
+	out += '"';
+	for (const char *c = value; *c != '\0'; c++) {
+		if (*c == '"' || *c == '\\') out += '\\';
+		out += *c;
+	}
+	out += '"';
+}
+
+char *linphone_core_get_startup_timeline_json(const LinphoneCore *lc) {
+	std::string json = "{\"traceEvents\":[";
+	int count = linphone_core_get_startup_phases_count(lc);
+
+	for (int i = 0; i < count; i++) {
+		if (i > 0) json += ',';
+		json += "{\"name\":";
+		append_json_string(json, linphone_core_get_startup_phase_name(lc, i));
+		json += ",\"cat\":\"startup\",\"ph\":\"X\",\"pid\":1,\"tid\":1";
+		json += ",\"ts\":" + std::to_string(linphone_core_get_startup_phase_start(lc, i));
+		json += ",\"dur\":" + std::to_string(linphone_core_get_startup_phase_duration(lc, i));
+		json += ",\"args\":{\"db_queries\":" + std::to_string(linphone_core_get_startup_phase_db_queries(lc, i));
+		json += ",\"heap_growth\":" + std::to_string(linphone_core_get_startup_phase_heap_growth(lc, i)) + "}}";
+	}
+	json += "],\"displayTimeUnit\":\"ms\"}";
+	return bctbx_strdup(json.c_str());
+}
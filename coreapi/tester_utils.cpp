@@ -108,6 +108,26 @@ int linphone_friend_list_get_revision(const LinphoneFriendList *lfl) {
 	return lfl->revision;
 }
 
+int linphone_friend_list_get_pending_vcards(const LinphoneFriendList *lfl) {
+	int count = 0;
+	for (const bctbx_list_t *elem = lfl->friends; elem != NULL; elem = bctbx_list_next(elem)) {
+		if (((const LinphoneFriend *)bctbx_list_get_data(elem))->pending_vcard) count++;
+	}
+	return count;
+}
+
+int linphone_core_get_friends_to_subscribe_count(const LinphoneCore *lc) {
+	return (int)bctbx_list_size(lc->friends_to_subscribe);
+}
+
+unsigned int linphone_core_get_local_addresses_fetch_count(LinphoneCore *lc) {
+	return L_GET_PRIVATE_FROM_C_OBJECT(lc)->getLocalAddressesFetchCount();
+}
+
+unsigned int linphone_core_get_auto_iterate_count(LinphoneCore *lc) {
+	return getPlatformHelpers(lc)->getAutoIterateCount();
+}
+
 unsigned int _linphone_call_get_nb_audio_starts (const LinphoneCall *call) {
 	return Call::toCpp(call)->getAudioStartCount();
 }
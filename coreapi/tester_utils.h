@@ -67,6 +67,9 @@ extern "C" {
 LINPHONE_PUBLIC LinphoneVcardContext *linphone_core_get_vcard_context(const LinphoneCore *lc);
 LINPHONE_PUBLIC bool_t linphone_core_rtcp_enabled(const LinphoneCore *lc);
 LINPHONE_PUBLIC void linphone_core_get_local_ip(LinphoneCore *lc, int af, const char *dest, char *result);
+LINPHONE_PUBLIC LinphoneProxyConfig * linphone_core_lookup_known_proxy(LinphoneCore *lc, const LinphoneAddress *uri);
+LINPHONE_PUBLIC LinphoneProxyConfig * linphone_core_lookup_proxy_by_identity(LinphoneCore *lc, const LinphoneAddress *uri);
+LINPHONE_PUBLIC bool_t _linphone_core_get_tls_credentials(LinphoneCore *lc, const char *cert, const char *key, bool_t from_files, belle_sip_certificates_chain_t **chain, belle_sip_signing_key_t **signing_key);
 LINPHONE_PUBLIC int linphone_core_get_local_ip_for(int type, const char *dest, char *result);
 LINPHONE_PUBLIC void linphone_core_enable_forced_ice_relay(LinphoneCore *lc, bool_t enable);
 LINPHONE_PUBLIC void linphone_core_set_zrtp_not_available_simulation(LinphoneCore *lc, bool_t enabled);
@@ -143,6 +146,8 @@ LINPHONE_PUBLIC LinphoneFriendList *linphone_friend_get_friend_list(const Linpho
 LINPHONE_PUBLIC bctbx_list_t **linphone_friend_list_get_friends_attribute(LinphoneFriendList *lfl);
 LINPHONE_PUBLIC const bctbx_list_t *linphone_friend_list_get_dirty_friends_to_update(const LinphoneFriendList *lfl);
 LINPHONE_PUBLIC int linphone_friend_list_get_revision(const LinphoneFriendList *lfl);
+LINPHONE_PUBLIC int linphone_friend_list_get_pending_vcards(const LinphoneFriendList *lfl);
+LINPHONE_PUBLIC int linphone_core_get_friends_to_subscribe_count(const LinphoneCore *lc);
 
 LINPHONE_PUBLIC int linphone_remote_provisioning_load_file( LinphoneCore* lc, const char* file_path);
 
@@ -226,6 +231,8 @@ LINPHONE_PUBLIC bool_t linphone_core_lime_x3dh_is_user_active(LinphoneCore *lc,
 LINPHONE_PUBLIC void linphone_core_set_network_reachable_internal(LinphoneCore *lc, bool_t is_reachable);
 
 LINPHONE_PUBLIC bctbx_list_t *linphone_fetch_local_addresses(void);
+LINPHONE_PUBLIC unsigned int linphone_core_get_local_addresses_fetch_count(LinphoneCore *lc);
+LINPHONE_PUBLIC unsigned int linphone_core_get_auto_iterate_count(LinphoneCore *lc);
 LINPHONE_PUBLIC void linphone_core_reset_shared_core_state(LinphoneCore *lc);
 LINPHONE_PUBLIC void linphone_shared_core_helpers_on_msg_written_in_user_defaults(LinphoneCore *lc);
 LINPHONE_PUBLIC char *linphone_core_get_download_path(LinphoneCore *lc);
@@ -270,6 +277,12 @@ LINPHONE_PUBLIC const char *sal_call_get_remote_tag (SalOp *op);
 LINPHONE_PUBLIC void sal_call_set_replaces (SalOp *op, const char *callId, const char *fromTag, const char *toTag);
 
 LINPHONE_PUBLIC belle_sip_resolver_context_t *sal_resolve_a(Sal *sal, const char *name, int port, int family, belle_sip_resolver_callback_t cb, void *data);
+LINPHONE_PUBLIC void sal_cancel_resolve(Sal *sal, belle_sip_resolver_context_t *context, void *data);
+LINPHONE_PUBLIC unsigned int sal_get_dns_cache_hits(const Sal *sal);
+LINPHONE_PUBLIC unsigned int sal_get_dns_cache_misses(const Sal *sal);
+LINPHONE_PUBLIC void sal_enable_dns_cache(Sal *sal, bool_t value);
+LINPHONE_PUBLIC void sal_set_dns_cache_max_stale(Sal *sal, int value);
+LINPHONE_PUBLIC bool_t sal_has_cached_results_a(const Sal *sal, const char *name, int port, int family, bool_t *expired);
 
 LINPHONE_PUBLIC Sal *sal_op_get_sal(SalOp *op);
 LINPHONE_PUBLIC SalOp *sal_create_refer_op(Sal *sal);
@@ -37,6 +37,7 @@ using namespace std;
 struct _LinphoneVcardContext {
 	shared_ptr<belcard::BelCardParser> parser;
 	void *user_data;
+	unsigned int parsed_vcards_count;
 };
 
 extern "C" {
@@ -172,6 +173,7 @@ LinphoneVcard* linphone_vcard_context_get_vcard_from_buffer(LinphoneVcardContext
 			context->parser = belcard::BelCardParser::getInstance();
 		}
 		shared_ptr<belcard::BelCard> belCard = context->parser->parseOne(buffer);
+		context->parsed_vcards_count++;
 		if (belCard) {
 			vCard = linphone_vcard_new_from_belcard(belCard);
 		} else {
@@ -181,6 +183,10 @@ LinphoneVcard* linphone_vcard_context_get_vcard_from_buffer(LinphoneVcardContext
 	return vCard;
 }
 
+unsigned int linphone_vcard_context_get_parsed_vcards_count(const LinphoneVcardContext *context) {
+	return context ? context->parsed_vcards_count : 0;
+}
+
 const char * linphone_vcard_as_vcard4_string(LinphoneVcard *vCard) {
 	if (!vCard) return NULL;
 
@@ -83,6 +83,13 @@ LINPHONE_PUBLIC bctbx_list_t* linphone_vcard_context_get_vcard_list_from_buffer(
  */
 LINPHONE_PUBLIC LinphoneVcard* linphone_vcard_context_get_vcard_from_buffer(LinphoneVcardContext *context, const char *buffer);
 
+/**
+ * Gets the number of vCards parsed with linphone_vcard_context_get_vcard_from_buffer() since the creation of the context.
+ * @param[in] context the vCard context
+ * @return the number of parsed vCards
+ */
+LINPHONE_PUBLIC unsigned int linphone_vcard_context_get_parsed_vcards_count(const LinphoneVcardContext *context);
+
 
 /**
  * Computes the md5 hash for the vCard
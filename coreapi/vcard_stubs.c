@@ -80,6 +80,10 @@ LinphoneVcard* linphone_vcard_context_get_vcard_from_buffer(LinphoneVcardContext
 	return NULL;
 }
 
+unsigned int linphone_vcard_context_get_parsed_vcards_count(const LinphoneVcardContext *context) {
+	return 0;
+}
+
 const char * linphone_vcard_as_vcard4_string(LinphoneVcard *vCard) {
 	return NULL;
 }
@@ -0,0 +1,44 @@
+/*
+ * Copyright (c) 2010-2019 Belledonne Communications SARL.
+ *
+ * This file is part of Liblinphone.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "event-stats.h"
+
+using namespace std;
+
+EventStatsCommand::EventStatsCommand() :
+		DaemonCommand("event-stats", "event-stats [reset]",
+			"Show how many events were delivered and their latency in milliseconds, from the core callback to the client. "
+			"With 'reset', the statistics are cleared after being displayed.") {
+	addExample(new DaemonCommandExample("event-stats",
+						"Status: Ok\n\n"
+						"Delivered: 12\n"
+						"Queued: 0\n"
+						"Average-latency: 3\n"
+						"Max-latency: 21"));
+}
+
+void EventStatsCommand::exec(Daemon *app, const string& args) {
+	if (!args.empty() && args != "reset") {
+		app->sendResponse(Response("Incorrect parameter(s)."));
+		return;
+	}
+	app->sendResponse(Response(app->getEventStats(), Response::Ok));
+	if (args == "reset")
+		app->resetEventStats();
+}
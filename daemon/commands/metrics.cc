@@ -0,0 +1,40 @@
+/*
+ * Copyright (c) 2010-2019 Belledonne Communications SARL.
+ *
+ * This file is part of Liblinphone.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "metrics.h"
+
+using namespace std;
+
+MetricsCommand::MetricsCommand() :
+		DaemonCommand("metrics", "metrics",
+			"Show the metrics of the core in the Prometheus text format: active calls, RTP loss and jitter, "
+			"registration outcomes, chat messages and database transaction durations.") {
+	addExample(new DaemonCommandExample("metrics",
+						"Status: Ok\n\n"
+						"# HELP linphone_active_calls Number of calls currently handled by the core.\n"
+						"# TYPE linphone_active_calls gauge\n"
+						"linphone_active_calls 1\n"
+						"..."));
+}
+
+void MetricsCommand::exec(Daemon *app, const string& args) {
+	char *metrics = linphone_core_get_metrics(app->getCore());
+	app->sendResponse(Response(metrics, Response::Ok));
+	bctbx_free(metrics);
+}
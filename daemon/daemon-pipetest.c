@@ -31,20 +31,297 @@
 
 static int running=1;
 
+#ifndef _WIN32
+typedef struct _BenchClient {
+	ortp_pipe_t fd;
+	int sent;
+	int received;
+	char input[65536];
+	size_t input_size;
+} BenchClient;
+
+/* Count the framed responses fully received, and drop them from the input buffer. */
+static void bench_parse_responses(BenchClient *client) {
+	for (;;) {
+		char *headers_end;
+		char *length_header;
+		size_t length = 0;
+		size_t frame_size;
+		client->input[client->input_size] = '\0';
+		headers_end = strstr(client->input, "\n\n");
+		if (!headers_end) return;
+		length_header = strstr(client->input, "Content-Length:");
+		if (!length_header || length_header > headers_end || sscanf(length_header, "Content-Length: %zu", &length) != 1) {
+			ortp_error("Unexpected response from daemon");
+			running = 0;
+			return;
+		}
+		frame_size = (size_t)(headers_end + 2 - client->input) + length;
+		if (client->input_size < frame_size) return;
+		memmove(client->input, client->input + frame_size, client->input_size - frame_size);
+		client->input_size -= frame_size;
+		client->received++;
+	}
+}
+
+/*
+ * Send 'count' framed commands from each of the 'nclients' connections, keeping up to 'window' of them in flight
+ * per connection, and report the throughput of the daemon.
+ */
+static int bench(const char *pipename, const char *command, int count, int nclients, int window) {
+	BenchClient *clients = ortp_new0(BenchClient, nclients);
+	struct pollfd *pfds = ortp_new0(struct pollfd, nclients);
+	uint64_t start, elapsed;
+	int done = 0;
+	int i;
+
+	for (i = 0; i < nclients; ++i) {
+		clients[i].fd = ortp_client_pipe_connect(pipename);
+		if (clients[i].fd == (ortp_pipe_t)-1) {
+			ortp_error("Could not connect to control pipe: %s", strerror(errno));
+			while (i-- > 0)
+				ortp_client_pipe_close(clients[i].fd);
+			ortp_free(pfds);
+			ortp_free(clients);
+			return -1;
+		}
+		pfds[i].fd = clients[i].fd;
+	}
+
+	start = ortp_get_cur_time_ms();
+	while (running && done < nclients) {
+		for (i = 0; i < nclients; ++i) {
+			BenchClient *client = &clients[i];
+			/* Pipeline the requests, without waiting for the responses. */
+			while (client->sent < count && client->sent - client->received < window) {
+				char frame[1024];
+				int size = snprintf(frame, sizeof(frame), "Request-Id: %i\nContent-Length: %i\n\n%s", client->sent, (int)strlen(command), command);
+				if (ortp_pipe_write(client->fd, (uint8_t *)frame, size) != size) {
+					ortp_error("Fail to write to unix socket");
+					running = 0;
+					break;
+				}
+				client->sent++;
+			}
+			pfds[i].events = (client->received < count) ? POLLIN : 0;
+		}
+		if (poll(pfds, (nfds_t)nclients, 1000) <= 0) continue;
+		for (i = 0; i < nclients; ++i) {
+			BenchClient *client = &clients[i];
+			ssize_t bytes;
+			if (!(pfds[i].revents & POLLIN)) continue;
+			bytes = read(client->fd, client->input + client->input_size, sizeof(client->input) - client->input_size - 1);
+			if (bytes <= 0) {
+				ortp_error("Daemon closed the connection");
+				running = 0;
+				break;
+			}
+			client->input_size += (size_t)bytes;
+			bench_parse_responses(client);
+			if (client->received == count) done++;
+		}
+	}
+	elapsed = ortp_get_cur_time_ms() - start;
+
+	if (done == nclients) {
+		fprintf(stdout, "%i commands '%s' from %i clients (window %i) in %llu ms: %.0f commands/s\n",
+			count * nclients, command, nclients, window, (unsigned long long)elapsed,
+			elapsed ? (double)count * nclients * 1000.0 / (double)elapsed : 0.0);
+	}
+	for (i = 0; i < nclients; ++i)
+		ortp_client_pipe_close(clients[i].fd);
+	ortp_free(pfds);
+	ortp_free(clients);
+	return done == nclients ? 0 : -1;
+}
+
+/* Wait for the next framed response, and copy its request id and its content. Returns -1 on error. */
+static int burst_read_response(BenchClient *client, int *request_id, char *content, size_t content_size) {
+	for (;;) {
+		char *headers_end;
+		client->input[client->input_size] = '\0';
+		headers_end = strstr(client->input, "\n\n");
+		if (headers_end) {
+			char *length_header = strstr(client->input, "Content-Length:");
+			char *id_header = strstr(client->input, "Request-Id:");
+			size_t length = 0;
+			size_t frame_size;
+			if (!length_header || length_header > headers_end || sscanf(length_header, "Content-Length: %zu", &length) != 1
+				|| !id_header || id_header > headers_end || sscanf(id_header, "Request-Id: %i", request_id) != 1) {
+				ortp_error("Unexpected response from daemon");
+				return -1;
+			}
+			frame_size = (size_t)(headers_end + 2 - client->input) + length;
+			if (client->input_size >= frame_size) {
+				size_t copied = length < content_size - 1 ? length : content_size - 1;
+				memcpy(content, headers_end + 2, copied);
+				content[copied] = '\0';
+				memmove(client->input, client->input + frame_size, client->input_size - frame_size);
+				client->input_size -= frame_size;
+				return 0;
+			}
+		}
+		if (client->input_size >= sizeof(client->input) - 1) {
+			ortp_error("Response from daemon is too large");
+			return -1;
+		} else {
+			ssize_t bytes = read(client->fd, client->input + client->input_size, sizeof(client->input) - client->input_size - 1);
+			if (bytes <= 0) {
+				ortp_error("Daemon closed the connection");
+				return -1;
+			}
+			client->input_size += (size_t)bytes;
+		}
+	}
+}
+
+/* Copy the value of the first 'name' line of the content, returns FALSE if there is none. */
+static bool_t burst_get_field(const char *content, const char *name, char *value, size_t value_size) {
+	const char *field = strstr(content, name);
+	size_t length;
+	if (!field) return FALSE;
+	field += strlen(name);
+	length = strcspn(field, "\n");
+	if (length >= value_size) length = value_size - 1;
+	memcpy(value, field, length);
+	value[length] = '\0';
+	return TRUE;
+}
+
+static int burst_send(BenchClient *client, int request_id, const char *command) {
+	char frame[1024];
+	int size = snprintf(frame, sizeof(frame), "Request-Id: %i\nContent-Length: %i\n\n%s", request_id, (int)strlen(command), command);
+	if (ortp_pipe_write(client->fd, (uint8_t *)frame, size) != size) {
+		ortp_error("Fail to write to unix socket");
+		return -1;
+	}
+	return 0;
+}
+
+/*
+ * Send a burst of 'count' message commands at once, then check that their responses come back in the order of the
+ * commands, and that the events they raised are popped in the same order.
+ */
+static int burst(const char *pipename, const char *uri, int count) {
+	BenchClient *client = ortp_new0(BenchClient, 1);
+	char **message_ids = ortp_new0(char *, count);
+	char content[4096];
+	char value[256];
+	uint64_t start, elapsed;
+	int request_id;
+	int events = 0;
+	int next_request;
+	int err = -1;
+	int i;
+
+	client->fd = ortp_client_pipe_connect(pipename);
+	if (client->fd == (ortp_pipe_t)-1) {
+		ortp_error("Could not connect to control pipe: %s", strerror(errno));
+		ortp_free(message_ids);
+		ortp_free(client);
+		return -1;
+	}
+
+	start = ortp_get_cur_time_ms();
+	for (i = 0; i < count; ++i) {
+		char command[512];
+		snprintf(command, sizeof(command), "message %s burst %i", uri, i);
+		if (burst_send(client, i, command) != 0) goto end;
+	}
+	for (i = 0; i < count; ++i) {
+		if (burst_read_response(client, &request_id, content, sizeof(content)) != 0) goto end;
+		if (request_id != i) {
+			ortp_error("Response to command %i received instead of the one to command %i", request_id, i);
+			goto end;
+		}
+		if (!burst_get_field(content, "Id: ", value, sizeof(value))) {
+			ortp_error("Command %i failed: %s", i, content);
+			goto end;
+		}
+		message_ids[i] = ortp_strdup(value);
+	}
+
+	/* Every message raised its InProgress event while its command ran. Other events are skipped. */
+	for (next_request = count; events < count; ++next_request) {
+		if (burst_send(client, next_request, "pop-event") != 0) goto end;
+		if (burst_read_response(client, &request_id, content, sizeof(content)) != 0) goto end;
+		if (request_id != next_request) {
+			ortp_error("Response to command %i received instead of the one to command %i", request_id, next_request);
+			goto end;
+		}
+		if (!strstr(content, "Event-type:")) {
+			ortp_error("Only %i of the %i message events were queued", events, count);
+			goto end;
+		}
+		if (!strstr(content, "Event-type: message-state-changed") || !strstr(content, "State: LinphoneChatMessageStateInProgress"))
+			continue;
+		if (!burst_get_field(content, "Id: ", value, sizeof(value)) || strcmp(value, message_ids[events]) != 0) {
+			ortp_error("Event of message [%s] popped instead of the one of message %i [%s]", value, events, message_ids[events]);
+			goto end;
+		}
+		events++;
+	}
+	elapsed = ortp_get_cur_time_ms() - start;
+	fprintf(stdout, "Burst of %i commands and their events received in order in %llu ms\n", count, (unsigned long long)elapsed);
+	err = 0;
+
+end:
+	for (i = 0; i < count; ++i) {
+		if (message_ids[i]) ortp_free(message_ids[i]);
+	}
+	ortp_client_pipe_close(client->fd);
+	ortp_free(message_ids);
+	ortp_free(client);
+	return err;
+}
+#endif
+
 int main(int argc, char *argv[]){
 	char buf[32768];
 	ortp_pipe_t fd;
+	const char *pipename = NULL;
+	const char *bench_command = "version";
+	int bench_count = 0;
+	int bench_clients = 1;
+	int bench_window = 16;
+	int burst_count = 0;
+	const char *burst_uri = "sip:pipetest@127.0.0.1";
+	int i;
 
 	/* handle args */
-	if (argc < 2) {
-		ortp_error("Usage: %s pipename", argv[0]);
+	for (i = 1; i < argc; ++i) {
+		if (strcmp(argv[i], "--bench") == 0 && i + 1 < argc) {
+			bench_count = atoi(argv[++i]);
+		} else if (strcmp(argv[i], "--clients") == 0 && i + 1 < argc) {
+			bench_clients = atoi(argv[++i]);
+		} else if (strcmp(argv[i], "--window") == 0 && i + 1 < argc) {
+			bench_window = atoi(argv[++i]);
+		} else if (strcmp(argv[i], "--command") == 0 && i + 1 < argc) {
+			bench_command = argv[++i];
+		} else if (strcmp(argv[i], "--burst") == 0 && i + 1 < argc) {
+			burst_count = atoi(argv[++i]);
+		} else if (strcmp(argv[i], "--burst-uri") == 0 && i + 1 < argc) {
+			burst_uri = argv[++i];
+		} else {
+			pipename = argv[i];
+		}
+	}
+	if (pipename == NULL) {
+		ortp_error("Usage: %s [--bench <count> [--clients <n>] [--window <n>] [--command <command>]] [--burst <count> [--burst-uri <sip uri>]] pipename", argv[0]);
 		return 1;
 	}
 
 	ortp_init();
 	ortp_set_log_level_mask(NULL, ORTP_MESSAGE | ORTP_WARNING | ORTP_ERROR | ORTP_FATAL);
 
-	fd=ortp_client_pipe_connect(argv[1]);
+#ifndef _WIN32
+	if (burst_count > 0)
+		return burst(pipename, burst_uri, burst_count);
+	if (bench_count > 0)
+		return bench(pipename, bench_command, bench_count, bench_clients > 0 ? bench_clients : 1, bench_window > 0 ? bench_window : 1);
+#endif
+
+	fd=ortp_client_pipe_connect(pipename);
 	if (fd==(ortp_pipe_t)-1){
 		ortp_error("Could not connect to control pipe: %s",strerror(errno));
 		return -1;
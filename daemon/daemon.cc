@@ -30,6 +30,7 @@
 #include <algorithm>
 #include <functional>
 #include <limits>
+#include <vector>
 
 #ifdef HAVE_READLINE
 #include <readline/readline.h>
@@ -38,6 +39,10 @@
 
 #ifndef _WIN32
 #include <poll.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
 #endif
 
 #include "daemon.h"
@@ -84,6 +89,8 @@
 #include "commands/version.h"
 #include "commands/play.h"
 #include "commands/message.h"
+#include "commands/event-stats.h"
+#include "commands/metrics.h"
 
 #include "private.h"
 
@@ -117,15 +124,43 @@ const char * const ice_state_str[] = {
 
 void *Daemon::iterateThread(void *arg) {
 	Daemon *daemon = (Daemon *) arg;
+#ifndef _WIN32
+	belle_sip_main_loop_t *mainLoop = belle_sip_stack_get_main_loop((belle_sip_stack_t *)daemon->mLc->sal->getStackImpl());
+	belle_sip_source_t *wakeupSource = belle_sip_fd_source_new(wakeupCb, daemon, daemon->mWakeupFds[0], BELLE_SIP_EVENT_READ, (unsigned int)-1);
+	belle_sip_main_loop_add_source(mainLoop, wakeupSource);
+#endif
 	while (daemon->mRunning) {
-		ms_mutex_lock(&daemon->mMutex);
 		daemon->iterate();
-		ms_mutex_unlock(&daemon->mMutex);
-		usleep(20000);
+#ifndef _WIN32
+		/* Sleep within the core's main loop: SIP traffic, timers and client commands are handled as soon as they arrive. */
+		belle_sip_main_loop_sleep(mainLoop, daemon->getIterateInterval());
+#else
+		usleep(daemon->getIterateInterval() * 1000);
+#endif
 	}
+#ifndef _WIN32
+	belle_sip_main_loop_remove_source(mainLoop, wakeupSource);
+	belle_sip_object_unref(wakeupSource);
+#endif
+	/* Release a client that would still be waiting for the completion of a command. */
+	ms_mutex_lock(&daemon->mMutex);
+	daemon->mExecutedCommands = daemon->mPostedCommands;
+	ms_cond_broadcast(&daemon->mCommandCond);
+	ms_mutex_unlock(&daemon->mMutex);
 	return 0;
 }
 
+int Daemon::wakeupCb(void *data, unsigned int events) {
+	Daemon *daemon = (Daemon *) data;
+#ifndef _WIN32
+	char buf[64];
+	while (read(daemon->mWakeupFds[0], buf, sizeof(buf)) > 0);
+#endif
+	daemon->processPendingCommands();
+	return BELLE_SIP_CONTINUE;
+}
+
+
 CallEvent::CallEvent(Daemon *daemon, LinphoneCall *call, LinphoneCallState state) : Event("call-state-changed") {
 	LinphoneCallLog *callLog = linphone_call_get_call_log(call);
 	const LinphoneAddress *fromAddr = linphone_call_log_get_from_address(callLog);
@@ -301,9 +336,22 @@ bool DaemonCommand::matches(const string& name) const {
 }
 
 Daemon::Daemon(const char *config_path, const char *factory_config_path, const char *log_file, const char *pipe_name, bool display_video, bool capture_video) :
-		mLSD(0), mLogFile(NULL), mAutoVideo(0), mCallIds(0), mProxyIds(0), mAudioStreamIds(0) {
+		mLSD(0), mLogFile(NULL), mAutoVideo(0), mCallIds(0), mProxyIds(0), mAudioStreamIds(0),
+		mClientCount(0), mCurrentRequestFramed(false),
+		mPostedCommands(0), mExecutedCommands(0), mDeliveredEvents(0), mEventLatencySum(0), mEventLatencyMax(0) {
 	ms_mutex_init(&mMutex, NULL);
+	ms_cond_init(&mCommandCond, NULL);
+	mWakeupFds[0] = mWakeupFds[1] = -1;
+#ifndef _WIN32
+	if (pipe(mWakeupFds) == 0) {
+		fcntl(mWakeupFds[0], F_SETFL, fcntl(mWakeupFds[0], F_GETFL) | O_NONBLOCK);
+		fcntl(mWakeupFds[1], F_SETFL, fcntl(mWakeupFds[1], F_GETFL) | O_NONBLOCK);
+	} else {
+		ms_error("Cannot create daemon wakeup pipe: %s", strerror(errno));
+	}
+#endif
 	mServerFd = (ortp_pipe_t)-1;
+	mTcpServerFd = (ortp_pipe_t)-1;
 	mChildFd = (ortp_pipe_t)-1;
 	if (pipe_name == NULL) {
 #ifdef HAVE_READLINE
@@ -318,7 +366,7 @@ Daemon::Daemon(const char *config_path, const char *factory_config_path, const c
 	} else {
 		mServerFd = ortp_server_pipe_create(pipe_name);
 #ifndef _WIN32
-		listen(mServerFd, 2);
+		listen(mServerFd, 16);
 		fprintf(stdout, "Server unix socket created, name=%s fd=%i\n", pipe_name, (int)mServerFd);
 #else
 		fprintf(stdout, "Named pipe  created, name=%s fd=%p\n", pipe_name, mServerFd);
@@ -347,6 +395,10 @@ Daemon::Daemon(const char *config_path, const char *factory_config_path, const c
 		updateProxyId((LinphoneProxyConfig *)bctbx_list_get_data(proxy));
 	}
 
+	/* The core is iterated often while there are media streams, their events are not tied to the SIP main loop. */
+	mIterateInterval = linphone_config_get_int(linphone_core_get_config(mLc), "daemon", "iterate_interval", 20);
+	mIdleIterateInterval = linphone_config_get_int(linphone_core_get_config(mLc), "daemon", "idle_iterate_interval", 200);
+
 	initCommands();
 	mUseStatsEvents=true;
 }
@@ -506,10 +558,15 @@ void Daemon::initCommands() {
 	mCommands.push_back(new IncallPlayerPauseCommand());
 	mCommands.push_back(new IncallPlayerResumeCommand());
 	mCommands.push_back(new MessageCommand());
+	mCommands.push_back(new EventStatsCommand());
+	mCommands.push_back(new MetricsCommand());
 	mCommands.sort(compareCommands);
+	for (DaemonCommand *command : mCommands)
+		mCommandTable[command->getName()] = command;
 }
 
 void Daemon::uninitCommands() {
+	mCommandTable.clear();
 	while (!mCommands.empty()) {
 		delete mCommands.front();
 		mCommands.pop_front();
@@ -519,17 +576,18 @@ void Daemon::uninitCommands() {
 bool Daemon::pullEvent() {
 	bool status = false;
 	ostringstream ostr;
-	size_t size = mEventQueue.size();
+	queue<shared_ptr<Event>> &events = mCurrentClient ? mCurrentClient->getEvents() : mEventQueue;
+	size_t size = events.size();
 	
 	if (size != 0) size--;
 	
 	ostr << "Size: " << size << "\n"; //size is the number items remaining in the queue after popping the event.
 	
-	if (!mEventQueue.empty()) {
-		Event *e = mEventQueue.front();
-		mEventQueue.pop();
+	if (!events.empty()) {
+		shared_ptr<Event> e = events.front();
+		events.pop();
 		ostr << e->toBuf() << "\n";
-		delete e;
+		eventDelivered(e.get());
 		status = true;
 	}
 	
@@ -591,7 +649,7 @@ void Daemon::iterateStreamStats() {
 			OrtpEventType evt=ortp_event_get_type(ev);
 			if (evt == ORTP_EVENT_RTCP_PACKET_RECEIVED || evt == ORTP_EVENT_RTCP_PACKET_EMITTED) {
 				linphone_call_stats_fill(it->second->stats, &it->second->stream->ms, ev);
-				if (mUseStatsEvents) mEventQueue.push(new AudioStreamStatsEvent(this,
+				if (mUseStatsEvents) queueEvent(new AudioStreamStatsEvent(this,
 					it->second->stream, it->second->stats));
 			}
 			ortp_event_destroy(ev);
@@ -600,20 +658,119 @@ void Daemon::iterateStreamStats() {
 }
 
 void Daemon::iterate() {
+	processPendingCommands();
 	linphone_core_iterate(mLc);
 	iterateStreamStats();
-	if (mChildFd == (ortp_pipe_t)-1) {
-		if (!mEventQueue.empty()) {
-			Event *r = mEventQueue.front();
-			mEventQueue.pop();
-			fprintf(stdout, "\n%s\n", r->toBuf().c_str());
-			fflush(stdout);
-			delete r;
+	deliverEvents();
+}
+
+int Daemon::getIterateInterval() {
+	if (linphone_core_get_calls_nb(mLc) > 0 || !mAudioStreams.empty())
+		return mIterateInterval;
+	return mIdleIterateInterval;
+}
+
+void Daemon::deliverEvents() {
+	if (mServerFd != (ortp_pipe_t)-1 || mTcpServerFd != (ortp_pipe_t)-1) {
+		/* Controllers pop the events: every connected client gets them in its own queue, and the ones raised while
+		 * none was connected wait for the next one. */
+		ms_mutex_lock(&mMutex);
+		if (!mClients.empty()) {
+			while (!mEventQueue.empty()) {
+				for (const auto &client : mClients)
+					client->getEvents().push(mEventQueue.front());
+				mEventQueue.pop();
+			}
 		}
+		ms_mutex_unlock(&mMutex);
+		return;
+	}
+	/* In interactive mode, events are written on the standard output as soon as they are queued. */
+	while (!mEventQueue.empty()) {
+		shared_ptr<Event> r = mEventQueue.front();
+		mEventQueue.pop();
+		fprintf(stdout, "\n%s\n", r->toBuf().c_str());
+		eventDelivered(r.get());
 	}
+	fflush(stdout);
+}
+
+void Daemon::eventDelivered(const Event *ev) {
+	uint64_t latency = bctbx_get_cur_time_ms() - ev->getCreationTime();
+	mDeliveredEvents++;
+	mEventLatencySum += latency;
+	if (latency > mEventLatencyMax)
+		mEventLatencyMax = latency;
+}
+
+string Daemon::getEventStats() const {
+	ostringstream ostr;
+	ostr << "Delivered: " << mDeliveredEvents << "\n";
+	ostr << "Queued: " << (mCurrentClient ? mCurrentClient->getEvents().size() : mEventQueue.size()) << "\n";
+	ostr << "Average-latency: " << (mDeliveredEvents ? mEventLatencySum / mDeliveredEvents : 0) << "\n";
+	ostr << "Max-latency: " << mEventLatencyMax;
+	return ostr.str();
+}
+
+void Daemon::resetEventStats() {
+	mDeliveredEvents = 0;
+	mEventLatencySum = 0;
+	mEventLatencyMax = 0;
+}
+
+void Daemon::wakeup() {
+#ifndef _WIN32
+	if (mWakeupFds[1] != -1 && write(mWakeupFds[1], "w", 1) == -1 && errno != EAGAIN)
+		ms_error("Fail to wake up daemon thread: %s", strerror(errno));
+#endif
 }
 
 void Daemon::execCommand(const string &command) {
+	PendingCommand pending;
+	pending.command = command;
+	pending.framed = false;
+	pending.waited = true;
+	postCommand(pending);
+}
+
+void Daemon::postCommand(const PendingCommand &command) {
+	/* The core is only used from the iterate thread: hand the command over, and wait for its completion if requested. */
+	ms_mutex_lock(&mMutex);
+	mPendingCommands.push(command);
+	unsigned long commandNumber = ++mPostedCommands;
+	ms_mutex_unlock(&mMutex);
+	wakeup();
+
+	if (!command.waited)
+		return;
+	ms_mutex_lock(&mMutex);
+	while (mExecutedCommands < commandNumber && mRunning)
+		ms_cond_wait(&mCommandCond, &mMutex);
+	ms_mutex_unlock(&mMutex);
+}
+
+void Daemon::processPendingCommands() {
+	/* A client that just connected must see the events queued before it when it pops them. */
+	deliverEvents();
+	ms_mutex_lock(&mMutex);
+	while (!mPendingCommands.empty()) {
+		PendingCommand command = mPendingCommands.front();
+		mPendingCommands.pop();
+		ms_mutex_unlock(&mMutex);
+		mCurrentClient = command.client;
+		mCurrentRequestId = command.requestId;
+		mCurrentRequestFramed = command.framed;
+		runCommand(command.command);
+		mCurrentClient = nullptr;
+		ms_mutex_lock(&mMutex);
+		mExecutedCommands++;
+		ms_cond_broadcast(&mCommandCond);
+	}
+	ms_mutex_unlock(&mMutex);
+	deliverEvents();
+}
+
+void Daemon::runCommand(const string &command) {
 	istringstream ist(command);
 	string name;
 	ist >> name;
@@ -621,11 +778,9 @@ void Daemon::execCommand(const string &command) {
 	ist.get(argsbuf);
 	string args = argsbuf.str();
 	if (!args.empty() && (args[0] == ' ')) args.erase(0, 1);
-	list<DaemonCommand*>::iterator it = find_if(mCommands.begin(), mCommands.end(), bind2nd(mem_fun(&DaemonCommand::matches), name));
-	if (it != mCommands.end()) {
-		ms_mutex_lock(&mMutex);
-		(*it)->exec(this, args);
-		ms_mutex_unlock(&mMutex);
+	unordered_map<string, DaemonCommand*>::const_iterator it = mCommandTable.find(name);
+	if (it != mCommandTable.end()) {
+		it->second->exec(this, args);
 	} else {
 		sendResponse(Response("Unknown command."));
 	}
@@ -633,7 +788,9 @@ void Daemon::execCommand(const string &command) {
 
 void Daemon::sendResponse(const Response &resp) {
 	string buf = resp.toBuf();
-	if (mChildFd != (ortp_pipe_t)-1) {
+	if (mCurrentClient) {
+		mCurrentClient->write(buf, mCurrentRequestId, mCurrentRequestFramed);
+	} else if (mChildFd != (ortp_pipe_t)-1) {
 		if (ortp_pipe_write(mChildFd, (uint8_t *)buf.c_str(), (int)buf.size()) == -1) {
 			ms_error("Fail to write to pipe: %s", strerror(errno));
 		}
@@ -643,13 +800,14 @@ void Daemon::sendResponse(const Response &resp) {
 }
 
 void Daemon::queueEvent(Event *ev){
-	mEventQueue.push(ev);
+	mEventQueue.push(shared_ptr<Event>(ev));
+	deliverEvents();
 }
 
+#ifdef _WIN32
 string Daemon::readPipe() {
 	char buffer[32768];
 	memset(buffer, '\0', sizeof(buffer));
-#ifdef _WIN32
 	if (mChildFd == (ortp_pipe_t)-1) {
 		mChildFd = ortp_server_pipe_accept_client(mServerFd);
 		ms_message("Client accepted");
@@ -669,54 +827,278 @@ string Daemon::readPipe() {
 			return buffer;
 		}
 	}
-#else
-	struct pollfd pfd[2];
-	int nfds = 1;
-	memset(&pfd[0], 0, sizeof(pfd));
-	if (mServerFd != (ortp_pipe_t)-1) {
-		pfd[0].events = POLLIN;
-		pfd[0].fd = mServerFd;
+	return "";
+}
+#endif
+
+/* Output kept for a client that does not read it, beyond which the client is disconnected. */
+static const size_t DaemonClientMaxOutputSize = 16 * 1024 * 1024;
+
+DaemonClient::DaemonClient(ortp_pipe_t fd) : mFd(fd), mFailed(false) {
+	ms_mutex_init(&mOutputMutex, NULL);
+}
+
+DaemonClient::~DaemonClient() {
+	ortp_server_pipe_close_client(mFd);
+	ms_mutex_destroy(&mOutputMutex);
+}
+
+bool DaemonClient::nextRequest(string &command, string &requestId, bool &framed, bool &error) {
+	static const string requestIdHeader("Request-Id:");
+	static const string contentLengthHeader("Content-Length:");
+	error = false;
+	requestId.clear();
+
+	// Skip the separators left between two requests.
+	size_t begin = mInput.find_first_not_of("\r\n");
+	if (begin == string::npos) {
+		mInput.clear();
+		return false;
 	}
-	if (mChildFd != (ortp_pipe_t)-1) {
-		pfd[1].events = POLLIN;
-		pfd[1].fd = mChildFd;
-		nfds++;
-	}
-	int err = poll(pfd, (nfds_t)nfds, 50);
-	if (err > 0) {
-		if (mServerFd != (ortp_pipe_t)-1 && (pfd[0].revents & POLLIN)) {
-			struct sockaddr_storage addr;
-			socklen_t addrlen = sizeof(addr);
-			int childfd = accept(mServerFd, (struct sockaddr*) &addr, &addrlen);
-			if (childfd != -1) {
-				if (mChildFd != (ortp_pipe_t)-1) {
-					ms_error("Cannot accept two client at the same time");
-					close(childfd);
-				} else {
-					mChildFd = (ortp_pipe_t)childfd;
-					return "";
-				}
-			}
+	mInput.erase(0, begin);
+
+	if (mInput.compare(0, requestIdHeader.size(), requestIdHeader, 0, min(mInput.size(), requestIdHeader.size())) == 0) {
+		if (mInput.size() < requestIdHeader.size())
+			return false; // Beginning of a framed request, wait for the rest.
+		size_t headersEnd = mInput.find("\n\n");
+		if (headersEnd == string::npos) {
+			if (mInput.size() > 1024)
+				error = true;
+			return false;
 		}
-		if (mChildFd != (ortp_pipe_t)-1 && (pfd[1].revents & POLLIN)) {
-			int ret;
-			if ((ret = ortp_pipe_read(mChildFd, (uint8_t *)buffer, sizeof(buffer))) == -1) {
-				ms_error("Fail to read from pipe: %s", strerror(errno));
-			} else {
-				if (ret == 0) {
-					ms_message("Client disconnected");
-					ortp_server_pipe_close_client(mChildFd);
-					mChildFd = (ortp_pipe_t)-1;
-					return "";
-				}
-				buffer[ret] = '\0';
-				return buffer;
+		size_t contentLength = 0;
+		bool hasLength = false;
+		istringstream headers(mInput.substr(0, headersEnd));
+		string header;
+		while (getline(headers, header)) {
+			if (header.compare(0, requestIdHeader.size(), requestIdHeader) == 0) {
+				requestId = header.substr(requestIdHeader.size());
+				requestId.erase(0, requestId.find_first_not_of(' '));
+			} else if (header.compare(0, contentLengthHeader.size(), contentLengthHeader) == 0) {
+				hasLength = (sscanf(header.c_str() + contentLengthHeader.size(), "%zu", &contentLength) == 1);
 			}
 		}
+		if (!hasLength || contentLength > 65536) {
+			error = true;
+			return false;
+		}
+		size_t contentBegin = headersEnd + 2;
+		if (mInput.size() < contentBegin + contentLength)
+			return false;
+		command = mInput.substr(contentBegin, contentLength);
+		mInput.erase(0, contentBegin + contentLength);
+		framed = true;
+		return true;
 	}
+
+	// Line based request, kept until its end of line is received like the framed ones.
+	size_t lineEnd = mInput.find('\n');
+	if (lineEnd == string::npos) {
+		if (mInput.size() > 65536)
+			error = true;
+		return false;
+	}
+	command = mInput.substr(0, lineEnd);
+	mInput.erase(0, lineEnd + 1);
+	if (!command.empty() && command.back() == '\r')
+		command.pop_back();
+	framed = false;
+	return true;
+}
+
+void DaemonClient::write(const string &buf, const string &requestId, bool framed) {
+	string out;
+	if (framed) {
+		ostringstream ostr;
+		ostr << "Request-Id: " << requestId << "\n" << "Content-Length: " << buf.size() << "\n\n";
+		out = ostr.str() + buf;
+	} else
+		out = buf;
+	ms_mutex_lock(&mOutputMutex);
+	if (!mFailed) {
+		mOutput += out;
+		if (mOutput.size() > DaemonClientMaxOutputSize) {
+			ms_error("Client does not read its responses, %zu bytes pending, disconnecting it", mOutput.size());
+			mOutput.clear();
+			mFailed = true;
+		} else if (!flushLocked()) {
+			mFailed = true;
+		}
+	}
+	ms_mutex_unlock(&mOutputMutex);
+}
+
+bool DaemonClient::flush() {
+	ms_mutex_lock(&mOutputMutex);
+	bool ok = flushLocked();
+	ms_mutex_unlock(&mOutputMutex);
+	return ok;
+}
+
+bool DaemonClient::flushLocked() {
+	while (!mOutput.empty()) {
+#ifndef _WIN32
+		ssize_t ret = ::write(mFd, mOutput.data(), mOutput.size());
+		if (ret < 0) {
+			if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)
+				return true; // The rest is sent by the main loop once the socket is writable.
+			ms_error("Fail to write to client: %s", strerror(errno));
+			mOutput.clear();
+			return false;
+		}
+		mOutput.erase(0, (size_t)ret);
+#else
+		if (ortp_pipe_write(mFd, (uint8_t *)mOutput.c_str(), (int)mOutput.size()) == -1) {
+			ms_error("Fail to write to client: %s", strerror(errno));
+			mOutput.clear();
+			return false;
+		}
+		mOutput.clear();
 #endif
-	return "";
+	}
+	return true;
+}
+
+bool DaemonClient::hasPendingOutput() {
+	ms_mutex_lock(&mOutputMutex);
+	bool pending = !mOutput.empty();
+	ms_mutex_unlock(&mOutputMutex);
+	return pending;
+}
+
+#ifndef _WIN32
+void Daemon::acceptClient(ortp_pipe_t serverFd) {
+	struct sockaddr_storage addr;
+	socklen_t addrlen = sizeof(addr);
+	int childfd = accept(serverFd, (struct sockaddr*) &addr, &addrlen);
+	if (childfd == -1) {
+		ms_error("Cannot accept client: %s", strerror(errno));
+		return;
+	}
+	// Responses are written from the iterate thread, which must never wait for a slow client.
+	fcntl(childfd, F_SETFL, fcntl(childfd, F_GETFL) | O_NONBLOCK);
+	ms_mutex_lock(&mMutex);
+	mClients.push_back(make_shared<DaemonClient>((ortp_pipe_t)childfd));
+	mClientCount = (int)mClients.size();
+	ms_mutex_unlock(&mMutex);
+	ms_message("Client accepted, %d connected", (int)mClientCount);
+}
+
+void Daemon::serveClients() {
+	ms_mutex_lock(&mMutex);
+	size_t clientCount = mClients.size();
+	mClients.remove_if([](const shared_ptr<DaemonClient> &client) { return client->hasFailed(); });
+	if (mClients.size() != clientCount) {
+		mClientCount = (int)mClients.size();
+		ms_message("Client disconnected, %d connected", (int)mClientCount);
+	}
+	ms_mutex_unlock(&mMutex);
+
+	vector<struct pollfd> pfds;
+	struct pollfd pfd;
+	memset(&pfd, 0, sizeof(pfd));
+	pfd.events = POLLIN;
+	for (ortp_pipe_t serverFd : { mServerFd, mTcpServerFd }) {
+		if (serverFd == (ortp_pipe_t)-1)
+			continue;
+		pfd.fd = serverFd;
+		pfds.push_back(pfd);
+	}
+	size_t firstClient = pfds.size();
+	for (const auto &client : mClients) {
+		pfd.fd = client->getFd();
+		pfd.events = POLLIN;
+		if (client->hasPendingOutput())
+			pfd.events |= POLLOUT;
+		pfds.push_back(pfd);
+	}
+
+	if (poll(pfds.data(), (nfds_t)pfds.size(), 50) <= 0)
+		return;
+
+	for (size_t i = 0; i < firstClient; ++i) {
+		if (pfds[i].revents & POLLIN)
+			acceptClient(pfds[i].fd);
+	}
+
+	auto it = mClients.begin();
+	for (size_t i = firstClient; i < pfds.size(); ++i) {
+		shared_ptr<DaemonClient> client = *it;
+		if ((pfds[i].revents & POLLOUT) && !client->flush()) {
+			ms_mutex_lock(&mMutex);
+			it = mClients.erase(it);
+			mClientCount = (int)mClients.size();
+			ms_mutex_unlock(&mMutex);
+			ms_message("Client disconnected, %d connected", (int)mClientCount);
+			continue;
+		}
+		if (!(pfds[i].revents & (POLLIN | POLLHUP | POLLERR))) {
+			++it;
+			continue;
+		}
+		char buffer[32768];
+		int ret = ortp_pipe_read(client->getFd(), (uint8_t *)buffer, sizeof(buffer));
+		if (ret == -1 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) {
+			++it;
+			continue;
+		}
+		if (ret <= 0) {
+			if (ret == -1)
+				ms_error("Fail to read from client: %s", strerror(errno));
+			// The socket is closed once the commands still queued for this client are done.
+			ms_mutex_lock(&mMutex);
+			it = mClients.erase(it);
+			mClientCount = (int)mClients.size();
+			ms_mutex_unlock(&mMutex);
+			ms_message("Client disconnected, %d connected", (int)mClientCount);
+			continue;
+		}
+		client->feed(buffer, (size_t)ret);
+
+		// Every complete request is queued at once, the client does not wait for responses before sending more.
+		PendingCommand pending;
+		pending.client = client;
+		pending.waited = false;
+		bool error = false;
+		while (client->nextRequest(pending.command, pending.requestId, pending.framed, error)) {
+			if (!pending.command.empty())
+				postCommand(pending);
+		}
+		if (error) {
+			ms_error("Malformed request, disconnecting client");
+			ms_mutex_lock(&mMutex);
+			it = mClients.erase(it);
+			mClientCount = (int)mClients.size();
+			ms_mutex_unlock(&mMutex);
+			continue;
+		}
+		++it;
+	}
+}
+
+bool Daemon::listenTcp(int port) {
+	int fd = (int)socket(AF_INET, SOCK_STREAM, 0);
+	if (fd == -1) {
+		ms_error("Cannot create TCP socket: %s", strerror(errno));
+		return false;
+	}
+	int on = 1;
+	setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+	struct sockaddr_in addr;
+	memset(&addr, 0, sizeof(addr));
+	addr.sin_family = AF_INET;
+	addr.sin_port = htons((uint16_t)port);
+	addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK); // Controllers are local, never expose the daemon.
+	if (::bind(fd, (struct sockaddr *)&addr, sizeof(addr)) == -1 || listen(fd, 16) == -1) {
+		ms_error("Cannot listen on TCP port %d: %s", port, strerror(errno));
+		close(fd);
+		return false;
+	}
+	mTcpServerFd = (ortp_pipe_t)fd;
+	fprintf(stdout, "Server TCP socket created, port=%i fd=%i\n", port, fd);
+	return true;
 }
+#endif
 
 void Daemon::dumpCommandsHelp() {
 	int cols = 80;
@@ -809,6 +1191,7 @@ static void printHelp() {
 		"\t--dump-commands-help       Dump the help of every available commands." << endl <<
 		"\t--dump-commands-html-help  Dump the help of every available commands." << endl <<
 		"\t--pipe <pipename>          Create an unix server socket in /tmp to receive commands from." << endl <<
+		"\t--listen-port <port>       Accept commands from TCP clients on this port of the loopback interface." << endl <<
 		"\t--log <path>               Supply a file where the log will be saved." << endl <<
 		"\t--factory-config <path>    Supply a readonly linphonerc style config file to start with." << endl <<
 		"\t--config <path>            Supply a linphonerc style config file to start with." << endl <<
@@ -852,7 +1235,7 @@ int Daemon::run() {
 	while (mRunning) {
 		string line;
 		bool eof=false;
-		if (mServerFd == (ortp_pipe_t)-1) {
+		if (mServerFd == (ortp_pipe_t)-1 && mTcpServerFd == (ortp_pipe_t)-1) {
 			line = readLine(prompt, &eof);
 			if (!line.empty()) {
 #ifdef HAVE_READLINE
@@ -860,7 +1243,11 @@ int Daemon::run() {
 #endif
 			}
 		} else {
+#ifdef _WIN32
 			line = readPipe();
+#else
+			serveClients();
+#endif
 		}
 		if (!line.empty()) {
 			execCommand(line);
@@ -909,17 +1296,30 @@ Daemon::~Daemon() {
 
 	enableLSD(false);
 	linphone_core_unref(mLc);
+	mClients.clear();
 	if (mChildFd != (ortp_pipe_t)-1) {
 		ortp_server_pipe_close_client(mChildFd);
 	}
 	if (mServerFd != (ortp_pipe_t)-1) {
 		ortp_server_pipe_close(mServerFd);
 	}
+#ifndef _WIN32
+	if (mTcpServerFd != (ortp_pipe_t)-1) {
+		close(mTcpServerFd);
+	}
+#endif
 	if (mLogFile != NULL) {
 		linphone_core_enable_logs(NULL);
 		fclose(mLogFile);
 	}
 
+#ifndef _WIN32
+	if (mWakeupFds[0] != -1) {
+		close(mWakeupFds[0]);
+		close(mWakeupFds[1]);
+	}
+#endif
+	ms_cond_destroy(&mCommandCond);
 	ms_mutex_destroy(&mMutex);
 
 #ifdef HAVE_READLINE
@@ -942,6 +1342,7 @@ int main(int argc, char *argv[]) {
 	const char *factory_config_path = NULL;
 	const char *pipe_name = NULL;
 	const char *log_file = NULL;
+	int listen_port = -1;
 	bool capture_video = false;
 	bool display_video = false;
 	bool stats_enabled = true;
@@ -968,6 +1369,13 @@ int main(int argc, char *argv[]) {
 			}
 			pipe_name = argv[++i];
 			stats_enabled = false;
+		} else if (strcmp(argv[i], "--listen-port") == 0) {
+			if (i + 1 >= argc) {
+				fprintf(stderr, "no port specify after --listen-port\n");
+				return -1;
+			}
+			listen_port = atoi(argv[++i]);
+			stats_enabled = false;
 		} else if (strcmp(argv[i], "--factory-config") == 0) {
 			if (i + 1 >= argc) {
 				fprintf(stderr, "no file specify after --factory-config\n");
@@ -1008,6 +1416,12 @@ int main(int argc, char *argv[]) {
 	
 	the_app = &app;
 	signal(SIGINT, sighandler);
+#ifndef _WIN32
+	// A controller may disconnect before reading its responses.
+	signal(SIGPIPE, SIG_IGN);
+	if (listen_port != -1 && !app.listenTcp(listen_port))
+		return -1;
+#endif
 	app.enableStatsEvents(stats_enabled);
 	app.enableLSD(lsd_enabled);
 	app.enableAutoAnswer(auto_answer);
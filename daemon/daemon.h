@@ -25,12 +25,16 @@
 #include <mediastreamer2/mediastream.h>
 #include <mediastreamer2/mscommon.h>
 #include <bctoolbox/list.h>
+#include <bctoolbox/port.h>
 
+#include <atomic>
 #include <string>
 #include <list>
+#include <memory>
 #include <queue>
 #include <map>
 #include <sstream>
+#include <unordered_map>
 
 #ifdef HAVE_CONFIG_H
 #include "config.h"
@@ -77,6 +81,9 @@ public:
 	virtual void exec(Daemon *app, const std::string& args)=0;
 	bool matches(const std::string& name) const;
 	const std::string getHelp() const;
+	const std::string &getName() const {
+		return mName;
+	}
 	const std::string &getProto() const {
 		return mProto;
 	}
@@ -148,10 +155,13 @@ private:
 /*Base class for all kind of event poping out of the linphonecore. They are posted to the Daemon's event queue with queueEvent().*/
 class Event{
 public:
-	Event(const std::string &eventType, const std::string &body="") : mEventType(eventType), mBody(body){}
+	Event(const std::string &eventType, const std::string &body="") : mEventType(eventType), mBody(body), mCreationTime(bctbx_get_cur_time_ms()){}
 	const std::string &getBody()const{
 		return mBody;
 	}
+	uint64_t getCreationTime()const{
+		return mCreationTime;
+	}
 	void setBody(const std::string &body){
 		mBody = body;
 	}
@@ -169,6 +179,7 @@ public:
 protected:
 	const std::string mEventType;
 	std::string mBody;
+	uint64_t mCreationTime;
 };
 
 class CallEvent : public Event {
@@ -236,6 +247,52 @@ struct AudioStreamAndOther {
 	}
 };
 
+/*
+ * A controller connected to the daemon's unix socket or TCP port.
+ * Requests are either a single line of text, or framed as:
+ *   Request-Id: <id>
+ *   Content-Length: <size of the command>
+ *   <empty line>
+ *   <command>
+ * in which case the response is framed the same way, with the request id.
+ */
+class DaemonClient {
+public:
+	DaemonClient(ortp_pipe_t fd);
+	~DaemonClient();
+	ortp_pipe_t getFd() const {
+		return mFd;
+	}
+	void feed(const char *data, size_t size) {
+		mInput.append(data, size);
+	}
+	/* Extract the next complete request from the received data, returns false if more data is needed. */
+	bool nextRequest(std::string &command, std::string &requestId, bool &framed, bool &error);
+	/* Queue a response for this client and send what the socket accepts without blocking. */
+	void write(const std::string &buf, const std::string &requestId, bool framed);
+	/* Send the pending output without blocking, returns false if the client cannot be written to anymore. */
+	bool flush();
+	bool hasPendingOutput();
+	/* Set when the client stopped reading or its socket failed, it is then disconnected by the main loop. */
+	bool hasFailed() const {
+		return mFailed;
+	}
+	/* The events not pulled yet by this client, only used from the iterate thread. */
+	std::queue<std::shared_ptr<Event>> &getEvents() {
+		return mEvents;
+	}
+private:
+	bool flushLocked();
+
+	ortp_pipe_t mFd;
+	std::string mInput;
+	std::queue<std::shared_ptr<Event>> mEvents;
+	/* Written from the iterate thread and flushed from the main loop, under mOutputMutex. */
+	std::string mOutput;
+	ms_mutex_t mOutputMutex;
+	std::atomic<bool> mFailed;
+};
+
 class Daemon {
 	friend class DaemonCommand;
 public:
@@ -243,6 +300,7 @@ public:
 	Daemon(const char *config_path, const char *factory_config_path, const char *log_file, const char *pipe_name, bool display_video, bool capture_video);
 	~Daemon();
 	int run();
+	bool listenTcp(int port);
 	void quit();
 	void sendResponse(const Response &resp);
 	void queueEvent(Event *resp);
@@ -269,9 +327,12 @@ public:
 	void callPlayingComplete(int id);
 	void setAutoVideo( bool enabled ){ mAutoVideo = enabled; }
 	inline bool autoVideo(){ return mAutoVideo; }
+	std::string getEventStats() const;
+	void resetEventStats();
 
 private:
 	static void* iterateThread(void *arg);
+	static int wakeupCb(void *data, unsigned int events);
 	static void callStateChanged(LinphoneCore *lc, LinphoneCall *call, LinphoneCallState state, const char *msg);
 	static void callStatsUpdated(LinphoneCore *lc, LinphoneCall *call, const LinphoneCallStats *stats);
 	static void dtmfReceived(LinphoneCore *lc, LinphoneCall *call, int dtmf);
@@ -281,9 +342,26 @@ private:
 	void dtmfReceived(LinphoneCall *call, int dtmf);
 	void messageReceived(LinphoneChatRoom *cr, LinphoneChatMessage *msg);
 	
+	struct PendingCommand {
+		std::string command;
+		std::shared_ptr<DaemonClient> client;
+		std::string requestId;
+		bool framed;
+		bool waited;
+	};
+
 	void execCommand(const std::string &command);
+	void postCommand(const PendingCommand &command);
+	void runCommand(const std::string &command);
+	void processPendingCommands();
+	void wakeup();
+	int getIterateInterval();
+	void deliverEvents();
+	void eventDelivered(const Event *ev);
 	std::string readLine(const std::string&, bool*);
 	std::string readPipe();
+	void serveClients();
+	void acceptClient(ortp_pipe_t serverFd);
 	void iterate();
 	void iterateStreamStats();
 	void startThread();
@@ -293,9 +371,16 @@ private:
 	LinphoneCore *mLc;
 	LinphoneSoundDaemon *mLSD;
 	std::list<DaemonCommand*> mCommands;
-	std::queue<Event*> mEventQueue;
+	std::unordered_map<std::string, DaemonCommand*> mCommandTable;
+	std::queue<std::shared_ptr<Event>> mEventQueue; /* Events for the standard output or the Windows pipe, and the ones waiting for a client to connect. */
 	ortp_pipe_t mServerFd;
+	ortp_pipe_t mTcpServerFd;
 	ortp_pipe_t mChildFd;
+	std::list<std::shared_ptr<DaemonClient>> mClients; /* Modified under mMutex, for the iterate thread to queue events to each client. */
+	std::atomic<int> mClientCount;
+	std::shared_ptr<DaemonClient> mCurrentClient;
+	std::string mCurrentRequestId;
+	bool mCurrentRequestFramed;
 	std::string mHistfile;
 	bool mRunning;
 	bool mUseStatsEvents;
@@ -307,6 +392,16 @@ private:
 	int mAudioStreamIds;
 	ms_thread_t mThread;
 	ms_mutex_t mMutex;
+	ms_cond_t mCommandCond;
+	std::queue<PendingCommand> mPendingCommands;
+	unsigned long mPostedCommands;
+	unsigned long mExecutedCommands;
+	int mWakeupFds[2];
+	int mIterateInterval;
+	int mIdleIterateInterval;
+	uint64_t mDeliveredEvents;
+	uint64_t mEventLatencySum;
+	uint64_t mEventLatencyMax;
 	std::map<int, AudioStreamAndOther*> mAudioStreams;
 };
 
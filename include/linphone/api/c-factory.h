@@ -495,6 +495,22 @@ LINPHONE_PUBLIC void linphone_factory_set_log_collection_path(LinphoneFactory *f
  */
 LINPHONE_PUBLIC void linphone_factory_enable_log_collection(LinphoneFactory *factory, LinphoneLogCollectionState state);
 
+/**
+ * Enables or disables the binary snapshot of the configuration of the cores created from a config file.
+ * When enabled, the configuration is loaded with linphone_config_new_with_snapshot(), the snapshot being stored
+ * next to the config file with a ".snapshot" suffix. Disabled by default.
+ * @param factory the #LinphoneFactory @notnil
+ * @param enable TRUE to use a snapshot of the configuration, FALSE otherwise
+ */
+LINPHONE_PUBLIC void linphone_factory_enable_config_snapshot(LinphoneFactory *factory, bool_t enable);
+
+/**
+ * Indicates if the cores created from a config file use a binary snapshot of their configuration.
+ * @param factory the #LinphoneFactory @notnil
+ * @return TRUE if the snapshot is used, FALSE otherwise
+ */
+LINPHONE_PUBLIC bool_t linphone_factory_is_config_snapshot_enabled(LinphoneFactory *factory);
+
 /**
  * Creates an object #LinphoneTunnelConfig
  * @param factory the #LinphoneFactory @notnil
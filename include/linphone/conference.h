@@ -118,6 +118,38 @@ LINPHONE_PUBLIC void linphone_conference_params_enable_local_participant(Linphon
  */
 LINPHONE_PUBLIC bool_t linphone_conference_params_local_participant_enabled(const LinphoneConferenceParams *params);
 
+/**
+ * Set the maximum number of participants whose audio is mixed at the same time, the loudest ones being chosen.
+ * In large conferences where few participants speak at once, this saves the cost of mixing the silent ones.
+ * The local participant is always mixed. Only applies to conferences hosted locally.
+ * @param params A #LinphoneConferenceParams @notnil
+ * @param max The maximum number of mixed participants, 0 to mix all of them (the default).
+ */
+LINPHONE_PUBLIC void linphone_conference_params_set_max_mixed_participants(LinphoneConferenceParams *params, int max);
+
+/**
+ * Returns the maximum number of participants whose audio is mixed at the same time.
+ * @param params A #LinphoneConferenceParams @notnil
+ * @return The maximum number of mixed participants, 0 if all of them are mixed.
+ */
+LINPHONE_PUBLIC int linphone_conference_params_get_max_mixed_participants(const LinphoneConferenceParams *params);
+
+/**
+ * Set the volume under which the audio of a participant is not mixed.
+ * A participant stays mixed for a short time after going below the threshold, not to cut the end of words.
+ * Only applies to conferences hosted locally.
+ * @param params A #LinphoneConferenceParams @notnil
+ * @param threshold The volume in dB, LINPHONE_VOLUME_DB_LOWEST to mix the participants whatever their volume (the default).
+ */
+LINPHONE_PUBLIC void linphone_conference_params_set_audio_gating_threshold(LinphoneConferenceParams *params, float threshold);
+
+/**
+ * Returns the volume under which the audio of a participant is not mixed.
+ * @param params A #LinphoneConferenceParams @notnil
+ * @return The volume in dB, LINPHONE_VOLUME_DB_LOWEST if there is no gating.
+ */
+LINPHONE_PUBLIC float linphone_conference_params_get_audio_gating_threshold(const LinphoneConferenceParams *params);
+
 
 /**
  * Take a reference on a #LinphoneConference.
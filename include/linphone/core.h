@@ -1788,6 +1788,22 @@ LINPHONE_PUBLIC void linphone_core_remove_proxy_config(LinphoneCore *core, Linph
 **/
 LINPHONE_PUBLIC const bctbx_list_t *linphone_core_get_proxy_config_list(const LinphoneCore *core);
 
+/**
+ * Returns the number of registrations postponed during the last iteration because of the register_rate_limit
+ * setting of the [sip] section.
+ * @param core The #LinphoneCore object @notnil
+ * @return the number of registrations waiting to be sent
+**/
+LINPHONE_PUBLIC int linphone_core_get_register_queue_depth(const LinphoneCore *core);
+
+/**
+ * Returns the highest number of registrations postponed at once because of the register_rate_limit setting
+ * of the [sip] section.
+ * @param core The #LinphoneCore object @notnil
+ * @return the maximum number of registrations that have been waiting to be sent
+**/
+LINPHONE_PUBLIC int linphone_core_get_register_queue_max_depth(const LinphoneCore *core);
+
 LINPHONE_PUBLIC void linphone_core_set_default_proxy_index(LinphoneCore *core, int index);
 
 /**
@@ -5280,8 +5296,11 @@ LINPHONE_PUBLIC bool_t linphone_core_is_push_notification_enabled(LinphoneCore *
 LINPHONE_PUBLIC bool_t linphone_core_is_push_notification_available(LinphoneCore *core);
 
 /**
- * Enable or disable the automatic schedule of #linphone_core_iterate() method on Android & iOS.
- * If enabled, #linphone_core_iterate() will be called on the main thread every 20ms automatically.
+ * Enable or disable the automatic schedule of #linphone_core_iterate() method.
+ * On Android & iOS, if enabled, #linphone_core_iterate() will be called on the main thread every 20ms automatically.
+ * On other platforms, if enabled, the core is iterated by a thread of its own, which sleeps until a SIP socket or a
+ * timer needs it (or every auto_iterate_interval ms of the [misc] section while calls are running). The application
+ * must then surround any use of the core with linphone_core_lock() and linphone_core_unlock().
  * If disabled, it is the application that must do this job.
  * @param core The #LinphoneCore @notnil
  * @param enable TRUE to enable auto iterate, FALSE to disable
@@ -5290,13 +5309,105 @@ LINPHONE_PUBLIC bool_t linphone_core_is_push_notification_available(LinphoneCore
 LINPHONE_PUBLIC void linphone_core_set_auto_iterate_enabled(LinphoneCore *core, bool_t enable);
 
 /**
- * Gets whether auto iterate is enabled or not (Android & iOS only).
+ * Gets whether auto iterate is enabled or not.
  * @param core The #LinphoneCore @notnil
  * @return TRUE if #linphone_core_iterate() is scheduled automatically, FALSE otherwise
  * @ingroup misc
  */
 LINPHONE_PUBLIC bool_t linphone_core_is_auto_iterate_enabled(LinphoneCore *core);
 
+/**
+ * Takes exclusive access to a core iterated by its own thread, see linphone_core_set_auto_iterate_enabled().
+ * The core thread is woken up and paused until linphone_core_unlock() is called.
+ * Calls can be nested in the same thread, the core is released by the linphone_core_unlock() matching the first call.
+ * Calling it from the core callbacks, or when the core is not iterated by its own thread, does nothing.
+ * @param core The #LinphoneCore @notnil
+ * @ingroup misc
+ */
+LINPHONE_PUBLIC void linphone_core_lock(LinphoneCore *core);
+
+/**
+ * Releases the access taken with linphone_core_lock().
+ * @param core The #LinphoneCore @notnil
+ * @ingroup misc
+ */
+LINPHONE_PUBLIC void linphone_core_unlock(LinphoneCore *core);
+
+/**
+ * Returns the number of phases recorded in the startup timeline of the core.
+ * The timeline is recorded from the creation of the core (or its restart) until it reaches the #LinphoneGlobalOn state.
+ * It begins with the loading of the configuration files when the core was created right after it.
+ * Phases may be nested: a phase lasting within another one is part of it.
+ * @param core The #LinphoneCore @notnil
+ * @return the number of recorded phases
+ * @ingroup misc
+ */
+LINPHONE_PUBLIC int linphone_core_get_startup_phases_count(const LinphoneCore *core);
+
+/**
+ * Returns the name of a phase of the startup timeline, see linphone_core_get_startup_phases_count().
+ * @param core The #LinphoneCore @notnil
+ * @param index the index of the phase, phases are ordered by start time
+ * @return the name of the phase, NULL if there is no such phase @maybenil
+ * @ingroup misc
+ */
+LINPHONE_PUBLIC const char *linphone_core_get_startup_phase_name(const LinphoneCore *core, int index);
+
+/**
+ * Returns when a phase of the startup timeline began, see linphone_core_get_startup_phases_count().
+ * @param core The #LinphoneCore @notnil
+ * @param index the index of the phase, phases are ordered by start time
+ * @return the start of the phase in microseconds since the beginning of the timeline, -1 if there is no such phase
+ * @ingroup misc
+ */
+LINPHONE_PUBLIC int64_t linphone_core_get_startup_phase_start(const LinphoneCore *core, int index);
+
+/**
+ * Returns the wall clock duration of a phase of the startup timeline, see linphone_core_get_startup_phases_count().
+ * @param core The #LinphoneCore @notnil
+ * @param index the index of the phase, phases are ordered by start time
+ * @return the duration of the phase in microseconds, -1 if there is no such phase
+ * @ingroup misc
+ */
+LINPHONE_PUBLIC int64_t linphone_core_get_startup_phase_duration(const LinphoneCore *core, int index);
+
+/**
+ * Returns the number of database queries run during a phase of the startup timeline.
+ * @param core The #LinphoneCore @notnil
+ * @param index the index of the phase, phases are ordered by start time
+ * @return the number of queries, -1 if there is no such phase
+ * @ingroup misc
+ */
+LINPHONE_PUBLIC int linphone_core_get_startup_phase_db_queries(const LinphoneCore *core, int index);
+
+/**
+ * Returns how much the heap grew during a phase of the startup timeline.
+ * It is only measured on platforms reporting the heap usage (glibc), it is 0 elsewhere.
+ * @param core The #LinphoneCore @notnil
+ * @param index the index of the phase, phases are ordered by start time
+ * @return the heap growth in bytes, negative if memory was released
+ * @ingroup misc
+ */
+LINPHONE_PUBLIC int64_t linphone_core_get_startup_phase_heap_growth(const LinphoneCore *core, int index);
+
+/**
+ * Dumps the startup timeline of the core in the Chrome trace event format, to be opened with chrome://tracing or Perfetto.
+ * @param core The #LinphoneCore @notnil
+ * @return the timeline as a JSON string, to be freed with bctbx_free() @notnil @tobefreed
+ * @ingroup misc
+ */
+LINPHONE_PUBLIC char *linphone_core_get_startup_timeline_json(const LinphoneCore *core);
+
+/**
+ * Dumps the metrics of the core in the Prometheus text format: active calls, RTP loss and jitter,
+ * registration outcomes, chat messages sent and received, and database transaction durations.
+ * The same text is served on the unix socket set by the "metrics_socket" entry of the [misc] section, if any.
+ * @param core The #LinphoneCore @notnil
+ * @return the metrics, to be freed with bctbx_free() @notnil @tobefreed
+ * @ingroup misc
+ */
+LINPHONE_PUBLIC char *linphone_core_get_metrics(LinphoneCore *core);
+
 /**
  * Returns a list of audio devices, with only the first device for each type
  * To have the list of all audio devices, use #linphone_core_get_extended_audio_devices
@@ -88,6 +88,22 @@ LINPHONE_PUBLIC LinphoneConfig * linphone_config_new_from_buffer(const char *buf
  */
 LINPHONE_PUBLIC LinphoneConfig * linphone_config_new_with_factory(const char *config_filename, const char *factory_config_filename);
 
+/**
+ * Instantiates a #LinphoneConfig object from a user config file and a factory config file, using a binary snapshot
+ * of their content when it is up to date.
+ * The snapshot is only used if it was built from the same files with the same sizes and modification times.
+ * Otherwise the files are parsed as in linphone_config_new_with_factory() and the snapshot is rebuilt, so that the
+ * next instantiation is faster.
+ * The caller of this constructor owns a reference. linphone_config_unref() must be called when this object is no longer needed.
+ * @ingroup misc
+ * @param config_filename the filename of the user config file to read to fill the instantiated #LinphoneConfig @maybenil
+ * @param factory_config_filename the filename of the factory config file to read to fill the instantiated #LinphoneConfig @maybenil
+ * @param snapshot_filename the filename of the snapshot, NULL to not use one @maybenil
+ * @see linphone_config_new_with_factory
+ * @return a #LinphoneConfig object @maybenil
+ */
+LINPHONE_PUBLIC LinphoneConfig * linphone_config_new_with_snapshot(const char *config_filename, const char *factory_config_filename, const char *snapshot_filename);
+
 /**
  * Instantiates a #LinphoneConfig object from a user config file name, group id and a factory config file.
  * The "group id" is the string that identify the "App group" capability of the iOS application.
@@ -299,6 +315,45 @@ LINPHONE_PUBLIC void linphone_config_set_float(LinphoneConfig *config,const char
 **/
 LINPHONE_PUBLIC LinphoneStatus linphone_config_sync(LinphoneConfig *config);
 
+/**
+ * Writes the config file to disk if it has been modified for at least the sync delay, see linphone_config_set_sync_delay().
+ * Nothing is written if the content is the same as the one last written.
+ * When background sync is enabled, the file is written from a separate thread.
+ * @param config The #LinphoneConfig object @notnil
+ * @return TRUE if a write was done or started, FALSE otherwise
+**/
+LINPHONE_PUBLIC bool_t linphone_config_sync_if_needed(LinphoneConfig *config);
+
+/**
+ * Sets the delay during which modifications are accumulated before linphone_config_sync_if_needed() writes them.
+ * @param config The #LinphoneConfig object @notnil
+ * @param delay_ms the delay in milliseconds, 0 to write as soon as possible
+**/
+LINPHONE_PUBLIC void linphone_config_set_sync_delay(LinphoneConfig *config, int delay_ms);
+
+/**
+ * Gets the delay during which modifications are accumulated before linphone_config_sync_if_needed() writes them.
+ * @param config The #LinphoneConfig object @notnil
+ * @return the delay in milliseconds
+**/
+LINPHONE_PUBLIC int linphone_config_get_sync_delay(const LinphoneConfig *config);
+
+/**
+ * Enables writing the config file from a separate thread in linphone_config_sync_if_needed().
+ * The file is written to a temporary file then renamed, so it is never seen partially written.
+ * linphone_config_sync() still writes synchronously, after the pending background write.
+ * @param config The #LinphoneConfig object @notnil
+ * @param enable TRUE to write from a separate thread
+**/
+LINPHONE_PUBLIC void linphone_config_enable_background_sync(LinphoneConfig *config, bool_t enable);
+
+/**
+ * Tells whether the config file is written from a separate thread in linphone_config_sync_if_needed().
+ * @param config The #LinphoneConfig object @notnil
+ * @return TRUE if background sync is enabled
+**/
+LINPHONE_PUBLIC bool_t linphone_config_background_sync_enabled(const LinphoneConfig *config);
+
 /**
  * Reload the config from the file.
  * @param config The #LinphoneConfig object @notnil
@@ -399,6 +399,8 @@ typedef enum _LinphoneRegistrationState {
  * To be able to receive events from the network, you must schedule a call linphone_core_iterate() often, like every 20ms.
  * On Android & iOS linphone_core_is_auto_iterate_enabled() is enabled by default so you don't have to worry about that unless you disable it
  * using linphone_core_set_auto_iterate_enabled() or by setting in the [misc] section of your configuration auto_iterate=0.
+ * On other platforms, enabling it makes the core iterate in a thread of its own: any other thread must then use linphone_core_lock()
+ * and linphone_core_unlock() around its calls to the API.
  * @warning Our API isn't thread-safe but also isn't blocking, so it is strongly recommend to always call our methods from the main thread.
  * 
  * Once you don't need it anymore, call linphone_core_stop() and release the reference on it so it can gracefully shutdown.
@@ -363,6 +363,14 @@ void linphone_factory_enable_log_collection(LinphoneFactory *factory, LinphoneLo
   return Factory::toCpp(factory)->enableLogCollection(state);
 }
 
+void linphone_factory_enable_config_snapshot(LinphoneFactory *factory, bool_t enable) {
+  Factory::toCpp(factory)->enableConfigSnapshot(!!enable);
+}
+
+bool_t linphone_factory_is_config_snapshot_enabled(LinphoneFactory *factory) {
+  return Factory::toCpp(factory)->isConfigSnapshotEnabled();
+}
+
 LinphoneTunnelConfig *linphone_factory_create_tunnel_config(LinphoneFactory *factory) {
   return Factory::toCpp(factory)->createTunnelConfig();
 }
@@ -176,6 +176,31 @@ private:
 		std::terminate();
 	}
 
+	// ---------------------------------------------------------------------------
+	// C list builder, appends in constant time (bctbx_list_append walks the list).
+	// ---------------------------------------------------------------------------
+
+	class CListBuilder {
+	public:
+		inline void append (void *data) {
+			bctbx_list_t *elem = bctbx_list_new(data);
+			if (tail) {
+				tail->next = elem;
+				elem->prev = tail;
+			} else
+				head = elem;
+			tail = elem;
+		}
+
+		inline bctbx_list_t *get () const {
+			return head;
+		}
+
+	private:
+		bctbx_list_t *head = nullptr;
+		bctbx_list_t *tail = nullptr;
+	};
+
 	// ---------------------------------------------------------------------------
 	// Get cpp ptr (shared if BaseObject, not shared if ClonableObject)
 	// from cpp object.
@@ -531,14 +556,22 @@ public:
 	// Get/set user data.
 	// ---------------------------------------------------------------------------
 
-	static inline void *getUserData (const PropertyContainer *propertyContainer) {
-		L_ASSERT(propertyContainer);
-		return propertyContainer->getProperty("LinphonePrivate::Wrapper::userData").getValue<void *>();
+	template<
+		typename CppType,
+		typename = typename std::enable_if<IsCppObject<CppType>::value, CppType>::type
+	>
+	static inline void *getUserData (const CppType *cppObject) {
+		L_ASSERT(cppObject);
+		return cppObject->getCUserData();
 	}
 
-	static inline void setUserData (PropertyContainer *propertyContainer, void *value) {
-		L_ASSERT(propertyContainer);
-		propertyContainer->setProperty("LinphonePrivate::Wrapper::userData", value);
+	template<
+		typename CppType,
+		typename = typename std::enable_if<IsCppObject<CppType>::value, CppType>::type
+	>
+	static inline void setUserData (CppType *cppObject, void *value) {
+		L_ASSERT(cppObject);
+		cppObject->setCUserData(value);
 	}
 
 	// ---------------------------------------------------------------------------
@@ -547,18 +580,18 @@ public:
 
 	template<typename T>
 	static inline bctbx_list_t *getCListFromCppList (const std::list<T> &cppList) {
-		bctbx_list_t *result = nullptr;
+		CListBuilder result;
 		for (const auto &value : cppList)
-			result = bctbx_list_append(result, value);
-		return result;
+			result.append(value);
+		return result.get();
 	}
 
 	//Specialization for string lists
 	static inline bctbx_list_t *getCListFromCppList (const std::list<std::string> &cppList) {
-		bctbx_list_t *result = nullptr;
+		CListBuilder result;
 		for (const auto &value : cppList)
-			result = bctbx_list_append(result, static_cast<void *>(bctbx_strdup(value.c_str())));
-		return result;
+			result.append(static_cast<void *>(bctbx_strdup(value.c_str())));
+		return result.get();
 	}
 
 	template<typename CType, typename CppType>
@@ -586,10 +619,10 @@ public:
 		typename = typename std::enable_if<IsDefinedBaseCppObject<CppType>::value, CppType>::type
 	>
 	static inline bctbx_list_t *getResolvedCListFromCppList (const std::list<std::shared_ptr<CppType>> &cppList) {
-		bctbx_list_t *result = nullptr;
+		CListBuilder result;
 		for (const auto &value : cppList)
-			result = bctbx_list_append(result, belle_sip_object_ref(getCBackPtr(value)));
-		return result;
+			result.append(belle_sip_object_ref(getCBackPtr(value)));
+		return result.get();
 	}
 
 	template<
@@ -597,13 +630,13 @@ public:
 		typename = typename std::enable_if<IsDefinedClonableCppObject<CppType>::value, CppType>::type
 	>
 	static inline bctbx_list_t *getResolvedCListFromCppList (const std::list<CppType> &cppList) {
-		bctbx_list_t *result = nullptr;
+		CListBuilder result;
 		for (const auto &value : cppList) {
 			auto cValue = getCBackPtr(new CppType(value));
 			reinterpret_cast<WrappedClonableObject<CppType> *>(cValue)->owner = WrappedObjectOwner::External;
-			result = bctbx_list_append(result, cValue);
+			result.append(cValue);
 		}
-		return result;
+		return result.get();
 	}
 
 	template<
@@ -611,10 +644,10 @@ public:
 		typename = typename std::enable_if<IsDefinedClonableCppObject<CppType>::value, CppType>::type
 	>
 	static inline bctbx_list_t *getResolvedCListFromCppList (const std::list<CppType *> &cppList) {
-		bctbx_list_t *result = nullptr;
+		CListBuilder result;
 		for (const auto &value : cppList)
-			result = bctbx_list_append(result, getCBackPtr(value));
-		return result;
+			result.append(getCBackPtr(value));
+		return result.get();
 	}
 
 	template<
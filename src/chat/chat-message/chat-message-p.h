@@ -34,6 +34,7 @@
 #include "db/main-db.h"
 #include "event-log/conference/conference-chat-message-event.h"
 #include "object/object-p.h"
+#include "object/object-pool.h"
 #include "sal/sal.h"
 
 // =============================================================================
@@ -47,6 +48,8 @@ class ChatMessagePrivate : public ObjectPrivate {
 	friend class NotificationMessagePrivate;
 
 public:
+	L_USE_OBJECT_POOL
+
 	enum Step {
 		None = 1 << 0,
 		FileUpload = 1 << 1,
@@ -275,6 +278,7 @@ private:
 
 	bool encryptionPrevented = false;
 	mutable bool contentsNotLoadedFromDatabase = false;
+
 	L_DECLARE_PUBLIC(ChatMessage);
 };
 
@@ -30,6 +30,7 @@
 
 #include "core/core-accessor.h"
 #include "object/object.h"
+#include "object/object-pool.h"
 
 // =============================================================================
 
@@ -89,6 +90,8 @@ public:
 
 	virtual ~ChatMessage ();
 
+	L_USE_OBJECT_POOL
+
 	// ----- TODO: Remove me.
 	void cancelFileTransfer ();
 	int putCharacter (uint32_t character);
@@ -65,6 +65,8 @@ void ChatRoomPrivate::onChatMessageSent(const shared_ptr<ChatMessage> &chatMessa
 	L_Q();
 
 	LinphoneChatRoom *cr = getCChatRoom();
+	q->getCore()->getPrivate()->metrics.chatMessagesSent.increment();
+
 	unique_ptr<MainDb> &mainDb = q->getCore()->getPrivate()->mainDb;
 	shared_ptr<EventLog> eventLog = mainDb->getEvent(mainDb, chatMessage->getStorageId());
 	
@@ -271,6 +273,9 @@ void ChatRoomPrivate::sendDisplayNotification (const shared_ptr<ChatMessage> &ch
 void ChatRoomPrivate::notifyChatMessageReceived (const shared_ptr<ChatMessage> &chatMessage) {
 	L_Q();
 	LinphoneChatRoom *cr = getCChatRoom();
+	const ContentType &contentType = chatMessage->getPrivate()->getContentType();
+	if (contentType != ContentType::Imdn && contentType != ContentType::ImIsComposing)
+		q->getCore()->getPrivate()->metrics.chatMessagesReceived.increment();
 	if (!chatMessage->getPrivate()->getText().empty()) {
 		/* Legacy API */
 		LinphoneAddress *fromAddress = linphone_address_new(chatMessage->getFromAddress().asString().c_str());
@@ -18,6 +18,7 @@
  */
 
 #include "linphone/api/c-content.h"
+#include "linphone/utils/utils.h"
 
 #include "address/address.h"
 #include "bctoolbox/crypto.h"
@@ -38,6 +39,10 @@ using namespace std;
 
 LINPHONE_BEGIN_NAMESPACE
 
+// App data of the file transfer content recording the partial file left by an interrupted download.
+static constexpr char ResumeOffsetAppDataKey[] = "file-transfer-resume-offset";
+static constexpr char ResumePathAppDataKey[] = "file-transfer-resume-path";
+
 FileTransferChatMessageModifier::FileTransferChatMessageModifier (belle_http_provider_t *prov) : provider(prov) {
 	bgTask.setName("File transfer upload");
 }
@@ -194,7 +199,7 @@ int FileTransferChatMessageModifier::onSendBody (
 	EncryptionEngine *imee = message->getCore()->getEncryptionEngine();
 	if (imee) {
 		size_t max_size = *size;
-		uint8_t *encrypted_buffer = (uint8_t *)ms_malloc0(max_size);
+		uint8_t *encrypted_buffer = getCryptoBuffer(max_size);
 		retval = imee->uploadingFile(L_GET_CPP_PTR_FROM_C_OBJECT(msg), offset, buffer, size, encrypted_buffer, currentFileTransferContent);
 		if (retval == 0) {
 			if (*size > max_size) {
@@ -203,7 +208,6 @@ int FileTransferChatMessageModifier::onSendBody (
 			}
 			memcpy(buffer, encrypted_buffer, *size);
 		}
-		ms_free(encrypted_buffer);
 	}
 
 	return retval <= 0 && *size != 0 ? BELLE_SIP_CONTINUE : BELLE_SIP_STOP;
@@ -277,7 +281,7 @@ belle_sip_body_handler_t *FileTransferChatMessageModifier::prepare_upload_body_h
 				EncryptionEngine *imee = message->getCore()->getEncryptionEngine();
 				if (imee) {
 					size_t max_size = buf_size;
-					uint8_t *encrypted_buffer = (uint8_t *)ms_malloc0(max_size);
+					uint8_t *encrypted_buffer = getCryptoBuffer(max_size);
 					int retval = imee->uploadingFile(message, 0, buf, &max_size, encrypted_buffer, currentFileTransferContent);
 					if (retval == 0) {
 						if (max_size > buf_size) {
@@ -288,7 +292,9 @@ belle_sip_body_handler_t *FileTransferChatMessageModifier::prepare_upload_body_h
 						// Call it once more to compute the authentication tag
 						imee->uploadingFile(message, 0, nullptr, 0, nullptr, currentFileTransferContent);
 					}
-					ms_free(encrypted_buffer);
+					// The whole content went through the scratch buffer at once, do not keep it around.
+					cryptoBuffer.clear();
+					cryptoBuffer.shrink_to_fit();
 				}
 
 				first_part_bh = (belle_sip_body_handler_t *)belle_sip_memory_body_handler_new_from_buffer(
@@ -561,6 +567,11 @@ int FileTransferChatMessageModifier::startHttpTransfer (const string &url, const
 		lWarning() << "Could not create http request for uri " << url;
 		goto error;
 	}
+	if (action == "GET" && resumeOffset > 0) {
+		ostringstream range;
+		range << "bytes=" << resumeOffset << "-";
+		belle_sip_message_add_header(BELLE_SIP_MESSAGE(httpRequest), belle_http_header_create("Range", range.str().c_str()));
+	}
 	if (bh) belle_sip_message_set_body_handler(BELLE_SIP_MESSAGE(httpRequest), BELLE_SIP_BODY_HANDLER(bh));
 	// keep a reference to the http request to be able to cancel it during upload
 	belle_sip_object_ref(httpRequest);
@@ -794,6 +805,17 @@ static void _chat_message_on_recv_body (belle_sip_user_body_handler_t *bh, belle
 	d->onRecvBody(bh, m, offset, buffer, size);
 }
 
+LinphoneBuffer *FileTransferChatMessageModifier::getRecvBuffer (const uint8_t *data, size_t size) {
+	// The same buffer carries every chunk of the transfer, unless the application kept a reference on it.
+	if (recvBuffer && !_linphone_buffer_reuse_with_content(recvBuffer, data, size)) {
+		linphone_buffer_unref(recvBuffer);
+		recvBuffer = nullptr;
+	}
+	if (!recvBuffer)
+		recvBuffer = linphone_buffer_new_from_data(data, size);
+	return recvBuffer;
+}
+
 void FileTransferChatMessageModifier::onRecvBody (belle_sip_user_body_handler_t *bh, belle_sip_message_t *m, size_t offset, uint8_t *buffer, size_t size) {
 	shared_ptr<ChatMessage> message = chatMessage.lock();
 	if (!httpRequest || belle_http_request_is_cancelled(httpRequest)) {
@@ -812,20 +834,31 @@ void FileTransferChatMessageModifier::onRecvBody (belle_sip_user_body_handler_t
 	int retval = -1;
 	EncryptionEngine *imee = message->getCore()->getEncryptionEngine();
 	if (imee) {
-		uint8_t *decrypted_buffer = (uint8_t *)ms_malloc0(size);
+		uint8_t *decrypted_buffer = getCryptoBuffer(size);
 		retval = imee->downloadingFile(message, offset, buffer, size, decrypted_buffer, currentFileTransferContent);
 		if (retval == 0) {
-			memcpy(buffer, decrypted_buffer, size);
+			// The file body handler writes the chunk from its own buffer once we return, otherwise the
+			// decrypted data can be handed to the application directly from the scratch buffer.
+			if (!currentFileContentToTransfer->getFilePath().empty())
+				memcpy(buffer, decrypted_buffer, size);
+			else
+				buffer = decrypted_buffer;
 		}
-		ms_free(decrypted_buffer);
 	}
 
 	if (retval == 0 || retval == -1) {
-		if (currentFileContentToTransfer->getFilePath().empty()) {
+		if (resumeFile) {
+			ssize_t written = bctbx_file_write(resumeFile, buffer, size, (off_t)(resumeOffset + offset));
+			if (written < 0 || (size_t)written != size) {
+				lError() << "Cannot append resumed download chunk to " << currentFileContentToTransfer->getFilePath();
+				closeResumeFile();
+				resumeFailed = true;
+			}
+		} else if (currentFileContentToTransfer->getFilePath().empty()) {
 			LinphoneChatMessage *msg = L_GET_C_BACK_PTR(message);
 			LinphoneChatMessageCbs *cbs = linphone_chat_message_get_callbacks(msg);
 			LinphoneContent *content = L_GET_C_BACK_PTR((Content *)currentFileContentToTransfer);
-			LinphoneBuffer *lb = linphone_buffer_new_from_data(buffer, size);
+			LinphoneBuffer *lb = getRecvBuffer(buffer, size);
 			// Deprecated: use list of callbacks now
 			if (linphone_chat_message_cbs_get_file_transfer_recv(cbs)) {
 				linphone_chat_message_cbs_get_file_transfer_recv(cbs)(msg, content, lb);
@@ -834,7 +867,6 @@ void FileTransferChatMessageModifier::onRecvBody (belle_sip_user_body_handler_t
 				linphone_core_notify_file_transfer_recv(message->getCore()->getCCore(), msg, content, (const char *)buffer, size);
 			}
 			_linphone_chat_message_notify_file_transfer_recv(msg, content, lb);
-			linphone_buffer_unref(lb);
 		}
 	} else {
 		lWarning() << "File transfer decrypt failed with code -" << hex <<(int)(-retval);
@@ -860,6 +892,27 @@ void FileTransferChatMessageModifier::onRecvEnd (belle_sip_user_body_handler_t *
 		retval = imee->downloadingFile(message, 0, nullptr, 0, nullptr, currentFileTransferContent);
 	}
 
+	if (resumeFile || resumeFailed) {
+		// A resumed download has no authentication tag to rely on, at least check that the pieces add up.
+		int64_t fileSize = resumeFile ? bctbx_file_size(resumeFile) : -1;
+		closeResumeFile();
+		size_t expectedSize = currentFileTransferContent ? currentFileTransferContent->getFileSize() : 0;
+		if (resumeFailed || fileSize < 0 || (expectedSize > 0 && (size_t)fileSize != expectedSize)) {
+			const string &filePath = currentFileContentToTransfer->getFilePath();
+			lError() << "Resumed download of " << filePath << " has size " << fileSize << " instead of " << expectedSize
+				<< ", deleting it";
+			// The next attempt must not append to a file that is already wrong.
+			int result = unlink(filePath.c_str());
+			if (result != 0)
+				lError() << "Couldn't delete file " << filePath << ", errno is " << result;
+			setResumeMarker(message, currentFileTransferContent, 0);
+			message->getPrivate()->setState(ChatMessage::State::FileTransferError);
+			releaseHttpRequest();
+			currentFileTransferContent = nullptr;
+			return;
+		}
+	}
+
 	if (retval == 0 || retval == -1) {
 		if (currentFileContentToTransfer->getFilePath().empty()) {
 			LinphoneChatMessage *msg = L_GET_C_BACK_PTR(message);
@@ -949,6 +1002,39 @@ void FileTransferChatMessageModifier::processResponseHeadersFromGetFile (const b
 		// if not done, belle-sip will create a memory body handler, the default
 		belle_sip_message_t *response = BELLE_SIP_MESSAGE(event->response);
 
+		if (resumeOffset > 0) {
+			if (code == 206) {
+				if (!isContentRangeResumingAtOffset(response)) {
+					// This body is some other part of the file, it cannot be used for a full download either.
+					lWarning() << "Content-Range of the resumed download does not start at offset " << resumeOffset
+						<< ", restarting download from scratch";
+					restartDownload(message);
+					return;
+				}
+				resumeFile = bctbx_file_open(bctbx_vfs_get_default(), currentFileContentToTransfer->getFilePath().c_str(), "r+");
+				if (!resumeFile)
+					lWarning() << "Cannot reopen " << currentFileContentToTransfer->getFilePath() << " to resume download, restarting from scratch";
+			} else {
+				lInfo() << "Server did not honour the Range request (code " << code << "), restarting download from scratch";
+			}
+			if (resumeFile) {
+				belle_sip_header_content_length_t *content_length_hdr = BELLE_SIP_HEADER_CONTENT_LENGTH(belle_sip_message_get_header(response, "Content-Length"));
+				size_t remaining = content_length_hdr ? belle_sip_header_content_length_get_content_length(content_length_hdr) : 0;
+				currentFileContentToTransfer->setFileSize(resumeOffset + remaining);
+				lInfo() << "Resuming download of " << currentFileContentToTransfer->getFilePath() << " at offset " << resumeOffset
+					<< ", " << remaining << " bytes remaining";
+				belle_sip_body_handler_t *body_handler = (belle_sip_body_handler_t *)belle_sip_user_body_handler_new(
+					remaining, _chat_message_file_transfer_on_progress,
+					nullptr, _chat_message_on_recv_body,
+					nullptr, _chat_message_on_recv_end, this);
+				belle_sip_message_set_body_handler(response, body_handler);
+				return;
+			}
+			resumeOffset = 0;
+			setResumeMarker(message, currentFileTransferContent, 0);
+			truncateTargetFile();
+		}
+
 		if (currentFileContentToTransfer) {
 			belle_sip_header_content_length_t *content_length_hdr = BELLE_SIP_HEADER_CONTENT_LENGTH(belle_sip_message_get_header(response, "Content-Length"));
 			currentFileContentToTransfer->setFileSize(belle_sip_header_content_length_get_content_length(content_length_hdr));
@@ -995,6 +1081,7 @@ void FileTransferChatMessageModifier::onDownloadFailed() {
 	shared_ptr<ChatMessage> message = chatMessage.lock();
 	if (!message)
 		return;
+	saveResumeMarker(message);
 	if (message->getPrivate()->isAutoFileTransferDownloadInProgress()) {
 		lError() << "Auto download failed for message [" << message << "]";
 		message->getPrivate()->doNotRetryAutoDownload();
@@ -1050,7 +1137,7 @@ void FileTransferChatMessageModifier::processResponseFromGetFile (const belle_ht
 		if (code >= 400 && code < 500) {
 			lWarning() << "File transfer failed with code " << code;
 			onDownloadFailed();
-		} else if (code != 200) {
+		} else if (code != 200 && code != 206) {
 			lWarning() << "Unhandled HTTP code response " << code << " for file transfer";
 		}
 	}
@@ -1086,6 +1173,13 @@ bool FileTransferChatMessageModifier::downloadFile (
 
 	lInfo() << "Downloading file transfer content [" << fileTransferContent << "], removing it to keep only the file content [" << fileContent << "]";
 
+	resumeOffset = computeResumeOffset(message, fileTransferContent);
+	if (resumeOffset == 0) {
+		// Whatever is at the target path was not written by an interrupted download of this very content.
+		setResumeMarker(message, fileTransferContent, 0);
+		truncateTargetFile();
+	}
+
 	belle_http_request_listener_callbacks_t cbs = { 0 };
 	cbs.process_response_headers = _chat_process_response_headers_from_get_file;
 	cbs.process_response = _chat_message_process_response_from_get_file;
@@ -1128,7 +1222,142 @@ bool FileTransferChatMessageModifier::isFileTransferInProgressAndValid () const
 	return httpRequest && !belle_http_request_is_cancelled(httpRequest);
 }
 
+size_t FileTransferChatMessageModifier::computeResumeOffset (
+	const shared_ptr<ChatMessage> &message,
+	FileTransferContent *fileTransferContent
+) const {
+	const string &filePath = currentFileContentToTransfer->getFilePath();
+	if (filePath.empty())
+		return 0;
+	// The encryption engine decrypts the file as a single stream, it cannot pick it up in the middle.
+	if (fileTransferContent->getFileKeySize() > 0)
+		return 0;
+	if (!linphone_config_get_bool(linphone_core_get_config(message->getCore()->getCCore()), "misc", "file_transfer_resume_enabled", TRUE))
+		return 0;
+	size_t expectedSize = fileTransferContent->getFileSize();
+	if (expectedSize == 0)
+		return 0;
+
+	// Only the partial file recorded when the previous attempt failed is resumed, and only if nobody touched it since.
+	const string &savedOffset = fileTransferContent->getAppData(ResumeOffsetAppDataKey);
+	if (savedOffset.empty() || fileTransferContent->getAppData(ResumePathAppDataKey) != filePath)
+		return 0;
+	size_t offset = (size_t)Utils::stoull(savedOffset);
+	if (offset == 0 || offset >= expectedSize)
+		return 0;
+	int64_t partialSize = getFileSizeOnDisk(filePath);
+	if (partialSize < 0 || (size_t)partialSize != offset) {
+		lInfo() << "Partial file " << filePath << " has size " << partialSize << " instead of the recorded " << offset
+			<< ", not resuming its download";
+		return 0;
+	}
+	return offset;
+}
+
+int64_t FileTransferChatMessageModifier::getFileSizeOnDisk (const string &filePath) {
+	if (filePath.empty() || bctbx_file_exist(filePath.c_str()) != 0)
+		return -1;
+	bctbx_vfs_file_t *fp = bctbx_file_open(bctbx_vfs_get_default(), filePath.c_str(), "r");
+	if (!fp)
+		return -1;
+	int64_t size = bctbx_file_size(fp);
+	bctbx_file_close(fp);
+	return size;
+}
+
+void FileTransferChatMessageModifier::saveResumeMarker (const shared_ptr<ChatMessage> &message) {
+	if (!currentFileTransferContent || !currentFileContentToTransfer)
+		return;
+	int64_t partialSize = -1;
+	// A file whose last chunk could not be written or an encrypted stream cannot be resumed.
+	if (!resumeFailed && currentFileTransferContent->getFileKeySize() == 0)
+		partialSize = getFileSizeOnDisk(currentFileContentToTransfer->getFilePath());
+	setResumeMarker(message, currentFileTransferContent, partialSize > 0 ? (size_t)partialSize : 0);
+}
+
+void FileTransferChatMessageModifier::setResumeMarker (
+	const shared_ptr<ChatMessage> &message,
+	FileTransferContent *fileTransferContent,
+	size_t offset
+) {
+	if (!fileTransferContent)
+		return;
+	const string savedOffset = offset > 0 ? Utils::toString(offset) : string();
+	const string filePath = offset > 0 ? currentFileContentToTransfer->getFilePath() : string();
+	if (fileTransferContent->getAppData(ResumeOffsetAppDataKey) == savedOffset
+		&& fileTransferContent->getAppData(ResumePathAppDataKey) == filePath)
+		return;
+	fileTransferContent->setAppData(ResumeOffsetAppDataKey, savedOffset);
+	fileTransferContent->setAppData(ResumePathAppDataKey, filePath);
+	// The marker must survive a restart of the application, like the partial file does.
+	if (message->isValid())
+		message->getPrivate()->updateInDb();
+}
+
+void FileTransferChatMessageModifier::truncateTargetFile () const {
+	const string &filePath = currentFileContentToTransfer->getFilePath();
+	if (filePath.empty() || bctbx_file_exist(filePath.c_str()) != 0)
+		return;
+	bctbx_vfs_file_t *fp = bctbx_file_open(bctbx_vfs_get_default(), filePath.c_str(), "r+");
+	if (!fp || bctbx_file_truncate(fp, 0) < 0)
+		lWarning() << "Cannot truncate " << filePath << " before downloading it from scratch";
+	if (fp)
+		bctbx_file_close(fp);
+}
+
+bool FileTransferChatMessageModifier::isContentRangeResumingAtOffset (belle_sip_message_t *response) const {
+	belle_sip_header_t *contentRange = belle_sip_message_get_header(response, "Content-Range");
+	if (!contentRange)
+		return false;
+	// Content-Range: bytes <first>-<last>/<complete length or *>
+	unsigned long long first = 0, last = 0;
+	const char *value = belle_sip_header_get_unparsed_value(contentRange);
+	if (!value || sscanf(value, "bytes %llu-%llu", &first, &last) != 2)
+		return false;
+	return first == resumeOffset && last >= first;
+}
+
+void FileTransferChatMessageModifier::restartDownload (const shared_ptr<ChatMessage> &message) {
+	FileTransferContent *fileTransferContent = currentFileTransferContent;
+	resumeOffset = 0;
+	setResumeMarker(message, fileTransferContent, 0);
+	weak_ptr<ChatMessage> weakMessage(message);
+	// The request cannot be cancelled from its own response callback, nor a new one started while it is set.
+	message->getCore()->doLater([this, weakMessage, fileTransferContent]() {
+		shared_ptr<ChatMessage> message = weakMessage.lock();
+		if (!message || currentFileTransferContent != fileTransferContent)
+			return;
+		if (httpRequest && !belle_http_request_is_cancelled(httpRequest))
+			belle_http_provider_cancel_request(provider, httpRequest);
+		releaseHttpRequest();
+		if (!downloadFile(message, fileTransferContent))
+			onDownloadFailed();
+	});
+}
+
+void FileTransferChatMessageModifier::closeResumeFile () {
+	if (resumeFile) {
+		bctbx_file_close(resumeFile);
+		resumeFile = nullptr;
+	}
+}
+
+uint8_t *FileTransferChatMessageModifier::getCryptoBuffer (size_t size) {
+	if (cryptoBuffer.size() < size)
+		cryptoBuffer.resize(size);
+	return cryptoBuffer.data();
+}
+
 void FileTransferChatMessageModifier::releaseHttpRequest () {
+	if (recvBuffer) {
+		linphone_buffer_unref(recvBuffer);
+		recvBuffer = nullptr;
+	}
+	closeResumeFile();
+	resumeOffset = 0;
+	resumeFailed = false;
+	cryptoBuffer.clear();
+	cryptoBuffer.shrink_to_fit();
 	if (httpRequest) {
 		belle_sip_object_unref(httpRequest);
 		httpRequest = nullptr;
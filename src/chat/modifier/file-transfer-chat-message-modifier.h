@@ -20,7 +20,12 @@
 #ifndef _L_FILE_TRANSFER_CHAT_MESSAGE_MODIFIER_H_
 #define _L_FILE_TRANSFER_CHAT_MESSAGE_MODIFIER_H_
 
+#include <vector>
+
 #include <belle-sip/belle-sip.h>
+#include <bctoolbox/vfs.h>
+
+#include "linphone/types.h"
 
 #include "chat-message-modifier.h"
 #include "utils/background-task.h"
@@ -75,6 +80,24 @@ private:
 
 	void onDownloadFailed ();
 	void releaseHttpRequest ();
+
+	// Returns the number of bytes already present in the target file of an interrupted plain download, 0 if it cannot be resumed.
+	size_t computeResumeOffset (const std::shared_ptr<ChatMessage> &message, FileTransferContent *fileTransferContent) const;
+	// Records with the message the size of the partial file left by the failed download, the only one it may resume.
+	void saveResumeMarker (const std::shared_ptr<ChatMessage> &message);
+	void setResumeMarker (const std::shared_ptr<ChatMessage> &message, FileTransferContent *fileTransferContent, size_t offset);
+	void truncateTargetFile () const;
+	bool isContentRangeResumingAtOffset (belle_sip_message_t *response) const;
+	// Drops the current resumed request and downloads the whole file again.
+	void restartDownload (const std::shared_ptr<ChatMessage> &message);
+	void closeResumeFile ();
+
+	static int64_t getFileSizeOnDisk (const std::string &filePath);
+
+	// Returns a scratch buffer of at least the given size, reused across chunks of the current transfer.
+	uint8_t *getCryptoBuffer (size_t size);
+	// Returns the buffer handed to the receive callbacks filled with the given chunk, reused across chunks of the current transfer.
+	LinphoneBuffer *getRecvBuffer (const uint8_t *data, size_t size);
 	belle_sip_body_handler_t *prepare_upload_body_handler(std::shared_ptr<ChatMessage> message);
 
 	std::weak_ptr<ChatMessage> chatMessage;
@@ -85,6 +108,15 @@ private:
 	belle_http_request_listener_t *httpListener = nullptr;
 	belle_http_provider_t *provider  = nullptr;
 
+	std::vector<uint8_t> cryptoBuffer;
+	LinphoneBuffer *recvBuffer = nullptr;
+
+	// Resumed download state: offset requested with the Range header and file the partial content is appended to.
+	size_t resumeOffset = 0;
+	bctbx_vfs_file_t *resumeFile = nullptr;
+	// Set when a chunk could not be appended, the partial file is then discarded at the end of the response.
+	bool resumeFailed = false;
+
 	BackgroundTask bgTask;
 };
 
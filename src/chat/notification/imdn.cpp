@@ -269,13 +269,14 @@ bool Imdn::aggregationEnabled () const {
 }
 
 LinphoneProxyConfig * Imdn::getRelatedProxyConfig(){
-	LinphoneAddress *addr = linphone_address_new(chatRoom->getLocalAddress().asString().c_str());
-	if (!addr) {
+	const IdentityAddress &localAddress = chatRoom->getLocalAddress();
+	if (!localAddress.isValid()) {
 		return NULL;
 	}
-	LinphoneProxyConfig *cfg = linphone_core_lookup_proxy_by_identity(chatRoom->getCore()->getCCore(), addr);
-	linphone_address_unref(addr);
-	return cfg;
+	// The local address never carries a port.
+	return linphone_core_lookup_proxy_by_identity_parts(
+		chatRoom->getCore()->getCCore(), localAddress.getUsername().c_str(), localAddress.getDomain().c_str(), 0
+	);
 }
 
 void Imdn::send () {
@@ -77,6 +77,12 @@ class LINPHONE_PUBLIC ConferenceParams : public bellesip::HybridObject<LinphoneC
 		void enableLocalParticipant (bool enable) { mLocalParticipantEnabled = enable; }
 		bool localParticipantEnabled() const { return mLocalParticipantEnabled; }
 
+		void setMaxMixedParticipants (int max) { mMaxMixedParticipants = max; }
+		int getMaxMixedParticipants () const { return mMaxMixedParticipants; }
+
+		void setAudioGatingThreshold (float threshold) { mAudioGatingThreshold = threshold; }
+		float getAudioGatingThreshold () const { return mAudioGatingThreshold; }
+
 		virtual void setConferenceAddress (const ConferenceAddress conferenceAddress) override { m_conferenceAddress = conferenceAddress; };
 		const ConferenceAddress & getConferenceAddress() const { return m_conferenceAddress; };
 
@@ -91,6 +97,8 @@ class LINPHONE_PUBLIC ConferenceParams : public bellesip::HybridObject<LinphoneC
 		bool m_enableAudio = false;
 		bool m_enableChat = false;
 		bool mLocalParticipantEnabled = true;
+		int mMaxMixedParticipants = 0;
+		float mAudioGatingThreshold = LINPHONE_VOLUME_DB_LOWEST;
 		ConferenceAddress m_conferenceAddress = ConferenceAddress();
 		//Address m_conferenceAddress = Address();
 		Address m_factoryAddress = Address();
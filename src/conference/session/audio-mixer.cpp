@@ -17,6 +17,9 @@
  * along with this program. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
+#include <vector>
+
 #include "streams.h"
 #include "mixers.h"
 
@@ -27,18 +30,115 @@
 
 LINPHONE_BEGIN_NAMESPACE
 
+/* A member stays mixed during this time after it went below the gating threshold, not to cut the end of words. */
+static const uint64_t gatingHangoverMs = 500;
+
+AudioEndpointSelector::AudioEndpointSelector(MSAudioConference *conference) : mConference(conference){
+}
+
+void AudioEndpointSelector::setMaxMixedEndpoints(int value){
+	mMaxMixedEndpoints = std::max(value, 0);
+}
+
+void AudioEndpointSelector::setGatingThreshold(float value){
+	mGatingThreshold = std::max(value, (float)LINPHONE_VOLUME_DB_LOWEST);
+}
+
+bool AudioEndpointSelector::enabled() const{
+	return mMaxMixedEndpoints > 0 || mGatingThreshold > LINPHONE_VOLUME_DB_LOWEST;
+}
+
+void AudioEndpointSelector::addEndpoint(MSAudioEndpoint *endpoint, AudioStream *stream, bool isRemote, bool muted){
+	Endpoint ep;
+	ep.endpoint = endpoint;
+	ep.stream = stream;
+	ep.isRemote = isRemote;
+	ep.muted = muted;
+	ep.mixed = !muted;
+	ep.selected = false;
+	ep.volume = LINPHONE_VOLUME_DB_LOWEST;
+	/* A newcomer is mixed until the next updates tell whether it speaks. */
+	ep.lastSpeakingTime = bctbx_get_cur_time_ms();
+	mEndpoints.push_back(ep);
+	ms_audio_conference_mute_member(mConference, endpoint, muted);
+}
+
+void AudioEndpointSelector::removeEndpoint(MSAudioEndpoint *endpoint){
+	mEndpoints.remove_if([endpoint](const Endpoint &ep){
+		return ep.endpoint == endpoint;
+	});
+}
+
+float AudioEndpointSelector::readVolume(const Endpoint &ep) const{
+	MSFilter *volume = ep.stream ? (ep.isRemote ? ep.stream->volrecv : ep.stream->volsend) : nullptr;
+	/* Without a volume meter there is no way to know whether the member speaks, it must not be gated. */
+	if (!volume) return 0;
+	float vol = LINPHONE_VOLUME_DB_LOWEST;
+	ms_filter_call_method(volume, MS_VOLUME_GET, &vol);
+	return vol;
+}
+
+void AudioEndpointSelector::setMixed(Endpoint &ep, bool mixed){
+	if (ep.mixed == mixed) return;
+	ep.mixed = mixed;
+	ms_audio_conference_mute_member(mConference, ep.endpoint, !mixed);
+}
+
+void AudioEndpointSelector::update(){
+	uint64_t now = bctbx_get_cur_time_ms();
+	bool gating = mGatingThreshold > LINPHONE_VOLUME_DB_LOWEST;
+	std::vector<Endpoint *> candidates;
+
+	for (auto &ep : mEndpoints){
+		ep.selected = false;
+		if (ep.muted) continue;
+		ep.volume = readVolume(ep);
+		if (ep.volume >= mGatingThreshold) ep.lastSpeakingTime = now;
+		if (!gating || now - ep.lastSpeakingTime < gatingHangoverMs) candidates.push_back(&ep);
+	}
+	size_t maxMixed = (size_t)mMaxMixedEndpoints;
+	if (maxMixed > 0 && candidates.size() > maxMixed){
+		/* Loudest first. On equal volumes the members already mixed are kept, to avoid switching back and forth. */
+		std::partial_sort(candidates.begin(), candidates.begin() + (ptrdiff_t)maxMixed, candidates.end(),
+			[](const Endpoint *a, const Endpoint *b){
+				if (a->volume != b->volume) return a->volume > b->volume;
+				return a->mixed && !b->mixed;
+			});
+		candidates.resize(maxMixed);
+	}
+	for (auto ep : candidates) ep->selected = true;
+	for (auto &ep : mEndpoints) setMixed(ep, ep.selected);
+}
+
+int AudioEndpointSelector::getMixedEndpointsCount() const{
+	return (int)std::count_if(mEndpoints.begin(), mEndpoints.end(), [](const Endpoint &ep){
+		return ep.mixed;
+	});
+}
+
+bool AudioEndpointSelector::isMixed(MSAudioEndpoint *endpoint) const{
+	auto it = std::find_if(mEndpoints.begin(), mEndpoints.end(), [endpoint](const Endpoint &ep){
+		return ep.endpoint == endpoint;
+	});
+	return it != mEndpoints.end() && it->mixed;
+}
+
 MS2AudioMixer::MS2AudioMixer(MixerSession &session) : StreamMixer(session){
 	MSAudioConferenceParams ms_conf_params;
 	ms_conf_params.samplerate = linphone_config_get_int(mSession.getCCore()->config, "sound", "conference_rate", 16000);
 	ms_conf_params.active_talker_callback = &MS2AudioMixer::sOnActiveTalkerChanged;
 	ms_conf_params.user_data = this;
 	mConference = ms_audio_conference_new(&ms_conf_params, mSession.getCCore()->factory);
+	mSelector.reset(new AudioEndpointSelector(mConference));
 }
 
 MS2AudioMixer::~MS2AudioMixer(){
 	if (mTimer){
 		mSession.getCore().destroyTimer(mTimer);
 	}
+	if (mSelectionTimer){
+		mSession.getCore().destroyTimer(mSelectionTimer);
+	}
 	if (mRecordEndpoint) {
 		stopRecording();
 	}
@@ -79,11 +179,14 @@ void MS2AudioMixer::onActiveTalkerChanged(MSAudioEndpoint *ep){
 void MS2AudioMixer::connectEndpoint(Stream *as, MSAudioEndpoint *endpoint, bool muted){
 	ms_audio_endpoint_set_user_data(endpoint, &as->getGroup());
 	ms_audio_conference_add_member(mConference, endpoint);
-	ms_audio_conference_mute_member(mConference, endpoint, muted);
+	MS2Stream *ms2s = dynamic_cast<MS2Stream*>(as);
+	AudioStream *st = ms2s ? (AudioStream*)ms2s->getMediaStream() : nullptr;
+	mSelector->addEndpoint(endpoint, st, true, muted);
 }
 
 void MS2AudioMixer::disconnectEndpoint(Stream *as, MSAudioEndpoint *endpoint){
 	ms_audio_endpoint_set_user_data(endpoint, nullptr);
+	mSelector->removeEndpoint(endpoint);
 	ms_audio_conference_remove_member(mConference, endpoint);
 }
 
@@ -151,6 +254,23 @@ void MS2AudioMixer::setRecordPath(const std::string &path){
 	mRecordPath = path;
 }
 
+void MS2AudioMixer::setMixingPolicy(int maxMixedEndpoints, float gatingThreshold){
+	mSelector->setMaxMixedEndpoints(maxMixedEndpoints);
+	mSelector->setGatingThreshold(gatingThreshold);
+	/* Also mixes back all the participants when the policy is disabled. */
+	mSelector->update();
+	if (mSelector->enabled() && mSelectionTimer == nullptr){
+		lInfo() << *this << ": mixing at most " << maxMixedEndpoints << " participants, gating threshold " << gatingThreshold << " dB";
+		mSelectionTimer = mSession.getCore().createTimer([this]() -> bool{
+				mSelector->update();
+				return true;
+			}, 100, "AudioConference mixing selection timer");
+	}else if (!mSelector->enabled() && mSelectionTimer){
+		mSession.getCore().destroyTimer(mSelectionTimer);
+		mSelectionTimer = nullptr;
+	}
+}
+
 void MS2AudioMixer::enableMic(bool value){
 	mLocalMicEnabled = value;
 	if (mLocalEndpoint)
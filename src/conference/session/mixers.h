@@ -25,6 +25,7 @@
 
 #include "mediastreamer2/msconference.h"
 
+#include <list>
 #include <map>
 
 LINPHONE_BEGIN_NAMESPACE
@@ -117,6 +118,62 @@ inline std::ostream & operator<<(std::ostream &str, const StreamMixer & mixer){
 	return str;
 }
 
+/**
+ * Chooses which members of a MSAudioConference are actually mixed, from the volume measured on each of them.
+ * With a gating threshold, the members whose volume stays below it are not mixed.
+ * With a maximum number of mixed members, only the loudest ones are.
+ * The other members are muted in the MSAudioConference, which then skips them while mixing.
+ */
+class LINPHONE_PUBLIC AudioEndpointSelector{
+public:
+	AudioEndpointSelector(MSAudioConference *conference);
+	/*
+	 * 0 means that there is no limit on the number of mixed members.
+	 */
+	void setMaxMixedEndpoints(int value);
+	int getMaxMixedEndpoints() const{
+		return mMaxMixedEndpoints;
+	}
+	/*
+	 * Threshold in dB, LINPHONE_VOLUME_DB_LOWEST disables the gating.
+	 */
+	void setGatingThreshold(float value);
+	float getGatingThreshold() const{
+		return mGatingThreshold;
+	}
+	bool enabled() const;
+	/**
+	 * Add an endpoint already member of the conference. The volume of a remote endpoint is the one received
+	 * from the network, the volume of a local endpoint is the captured one.
+	 * A muted endpoint is never mixed.
+	 */
+	void addEndpoint(MSAudioEndpoint *endpoint, AudioStream *stream, bool isRemote, bool muted);
+	void removeEndpoint(MSAudioEndpoint *endpoint);
+	/**
+	 * Read the volumes and update the set of mixed endpoints. To be called periodically.
+	 */
+	void update();
+	int getMixedEndpointsCount() const;
+	bool isMixed(MSAudioEndpoint *endpoint) const;
+private:
+	struct Endpoint{
+		MSAudioEndpoint *endpoint;
+		AudioStream *stream;
+		bool isRemote;
+		bool muted;
+		bool mixed;
+		bool selected;
+		float volume;
+		uint64_t lastSpeakingTime;
+	};
+	float readVolume(const Endpoint &ep) const;
+	void setMixed(Endpoint &ep, bool mixed);
+	MSAudioConference *mConference;
+	std::list<Endpoint> mEndpoints;
+	int mMaxMixedEndpoints = 0;
+	float mGatingThreshold = LINPHONE_VOLUME_DB_LOWEST;
+};
+
 /**
  * Implementation of a StreamMixer that uses mediastreamer2 to handle the mixing.
  * This StreamMixer also inherits from AudioControlInterface, to give control
@@ -130,6 +187,15 @@ public:
 	void disconnectEndpoint(Stream *as, MSAudioEndpoint *endpoint);
 	virtual void enableLocalParticipant(bool enabled) override;
 	void setRecordPath(const std::string &path);
+	/**
+	 * Mix only the maxMixedEndpoints loudest participants (0 for all of them) and skip the participants
+	 * whose volume is below gatingThreshold (LINPHONE_VOLUME_DB_LOWEST to disable).
+	 * The local participant is always mixed.
+	 */
+	void setMixingPolicy(int maxMixedEndpoints, float gatingThreshold);
+	const AudioEndpointSelector &getEndpointSelector() const{
+		return *mSelector;
+	}
 	
 	/* AudioControlInterface methods */
 	virtual void enableMic(bool value) override;
@@ -171,6 +237,8 @@ private:
 	RtpProfile *mLocalDummyProfile = nullptr;
 	std::string mRecordPath;
 	belle_sip_source_t *mTimer = nullptr;
+	std::unique_ptr<AudioEndpointSelector> mSelector;
+	belle_sip_source_t *mSelectionTimer = nullptr;
 	bool mLocalMicEnabled = true;
 };
 
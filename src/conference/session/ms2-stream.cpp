@@ -22,7 +22,7 @@
 #include "ms2-streams.h"
 #include "media-session.h"
 #include "media-session-p.h"
-#include "core/core.h"
+#include "core/core-p.h"
 #include "c-wrapper/c-wrapper.h"
 #include "call/call.h"
 #include "conference/participant.h"
@@ -880,6 +880,12 @@ void MS2Stream::notifyStatsUpdated () {
 				if (listener) {
 					listener->onRtcpUpdateForReporting(getMediaSession().getSharedFromThis(), getType());
 				}
+				if (_linphone_call_stats_get_updated(mStats) == LINPHONE_CALL_STATS_SENT_RTCP_UPDATE) {
+					// The report blocks we send describe how the remote stream is received.
+					MetricsRegistry &metrics = getCore().getPrivate()->metrics;
+					metrics.rtpLossRate.observe(linphone_call_stats_get_sender_loss_rate(mStats));
+					metrics.rtpJitter.observe(linphone_call_stats_get_sender_interarrival_jitter(mStats));
+				}
 				break;
 			default:
 				break;
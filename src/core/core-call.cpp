@@ -51,6 +51,8 @@ int CorePrivate::addCall (const shared_ptr<Call> &call) {
 		notifySoundcardUsage(true);
 	}
 	calls.push_back(call);
+	metrics.calls.increment();
+	metrics.activeCalls.setValue(int64_t(calls.size()));
 
 	linphone_core_notify_call_created(q->getCCore(), call->toC());
 	return 0;
@@ -115,6 +117,7 @@ int CorePrivate::removeCall (const shared_ptr<Call> &call) {
 	}
 
 	calls.erase(iter);
+	metrics.activeCalls.setValue(int64_t(calls.size()));
 	return 0;
 }
 
@@ -26,8 +26,10 @@
 
 #include "chat/chat-room/abstract-chat-room.h"
 #include "core.h"
+#include "core/metrics-registry.h"
 #include "db/main-db.h"
 #include "object/object-p.h"
+#include "object/object-pool.h"
 #include "sal/call-op.h"
 #include "auth-info/auth-stack.h"
 #include "conference/session/tone-manager.h"
@@ -150,6 +152,10 @@ public:
 	void doLater(const std::function<void ()> &something);
 	belle_sip_main_loop_t *getMainLoop();
 	bool basicToFlexisipChatroomMigrationEnabled()const;
+	// Declared before the database, which records the duration of its transactions in it.
+	MetricsRegistry metrics;
+	// Arena of the messages and events loaded by the database, it stays alive as long as some of them are.
+	std::unique_ptr<ObjectPool, ObjectPool::Releaser> objectPool{new ObjectPool()};
 	std::unique_ptr<MainDb> mainDb;
 #ifdef HAVE_ADVANCED_IM
 	std::unique_ptr<RemoteConferenceListEventHandler> remoteListEventHandler;
@@ -171,11 +177,22 @@ public:
 
 	void startPushReceivedBackgroundTask ();
 	void pushReceivedBackgroundTaskEnded ();
+
+	// Serves the metrics in the Prometheus text format on the unix socket set by [misc] metrics_socket, if any.
+	void startMetricsListener ();
+	void stopMetricsListener ();
+
+	// Local addresses to use as ICE host candidates. They are fetched again once the network changed, or after
+	// [net] local_addresses_cache_ttl seconds.
+	const std::list<std::string> &getLocalAddresses ();
+	void invalidateLocalAddresses ();
+	unsigned int getLocalAddressesFetchCount () const { return localAddressesFetchCount; }
 	
 	static const Utils::Version groupChatProtocolVersion;
 private:
 	bool isInBackground = false;
 	static int ephemeralMessageTimerExpired (void *data, unsigned int revents);
+	static int metricsListenerCb (void *data, unsigned int revents);
 
 	std::list<CoreListener *> listeners;
 
@@ -200,6 +217,14 @@ private:
 	belle_sip_source_t *pushTimer = nullptr;
 	unsigned long pushReceivedBackgroundTaskId;
 
+	belle_sip_source_t *metricsSource = nullptr;
+	int metricsFd = -1;
+	std::string metricsSocketPath;
+
+	std::list<std::string> localAddresses;
+	uint64_t localAddressesExpires = 0;
+	unsigned int localAddressesFetchCount = 0;
+
 	std::list<AudioDevice *> audioDevices;
 	L_DECLARE_PUBLIC(Core);
 };
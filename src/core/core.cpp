@@ -28,6 +28,14 @@
 #include <algorithm>
 #include <iterator>
 
+#ifndef _WIN32
+	#include <fcntl.h>
+	#include <sys/socket.h>
+	#include <sys/stat.h>
+	#include <sys/un.h>
+	#include <unistd.h>
+#endif
+
 #include <mediastreamer2/mscommon.h>
 
 #ifdef HAVE_ADVANCED_IM
@@ -47,9 +55,11 @@
 #endif
 #include "core/core-listener.h"
 #include "core/core-p.h"
+#include "db/main-db-p.h"
 #include "chat/chat-room/chat-room-p.h"
 #include "logger/logger.h"
 #include "paths/paths.h"
+#include "utils/if-addrs.h"
 #include "linphone/utils/utils.h"
 #include "linphone/utils/algorithm.h"
 #include "linphone/lpconfig.h"
@@ -81,6 +91,11 @@ void CorePrivate::init () {
 	L_Q();
 
 	mainDb.reset(new MainDb(q->getSharedFromThis()));
+#ifdef HAVE_DB_STORAGE
+	mainDb->getPrivate()->queryDurations = &metrics.dbQueryDuration;
+	mainDb->getPrivate()->objectPool = objectPool.get();
+#endif
+	startMetricsListener();
 #ifdef HAVE_ADVANCED_IM
 	remoteListEventHandler = makeUnique<RemoteConferenceListEventHandler>(q->getSharedFromThis());
 	localListEventHandler = makeUnique<LocalConferenceListEventHandler>(q->getSharedFromThis());
@@ -112,19 +127,34 @@ void CorePrivate::init () {
 			}
 			lInfo() << "Opening linphone database " << uri << " with backend " << backend;
 			uri = LinphonePrivate::Utils::localeToUtf8(uri);// `mainDb->connect` take a UTF8 string.
+			if (backend == MainDb::Sqlite3) {
+				list<string> pragmas;
+				bctbx_list_t *profilePragmas = _linphone_sqlite3_get_profile_pragmas(linphone_core_get_config(lc));
+				for (bctbx_list_t *it = profilePragmas; it; it = bctbx_list_next(it))
+					pragmas.push_back(static_cast<const char *>(bctbx_list_get_data(it)));
+				bctbx_list_free_with_data(profilePragmas, bctbx_free);
+				mainDb->setConnectionPragmas(pragmas);
+			}
 			auto startMs = bctbx_get_cur_time_ms();
+			mainDb->enableQueryCounting(!!lc->startup_recording);
+			linphone_core_startup_phase_begin(lc, "database");
 			if (!mainDb->connect(backend, uri)) {
 				ostringstream os;
 				os << "Unable to open linphone database with uri " << uri << " and backend " << backend;
 				throw DatabaseConnectionFailure(os.str());
 			}
+			linphone_core_startup_phase_end(lc, "database");
 			auto stopMs = bctbx_get_cur_time_ms();
 			auto duration = stopMs - startMs;
 			if (duration >= 1000){
 				lWarning() << "Opening database took " << duration << " ms !";
 			}
+			if (linphone_config_get_bool(linphone_core_get_config(lc), "storage", "async_queries", FALSE))
+				mainDb->enableAsyncQueries(true);
 
+			linphone_core_startup_phase_begin(lc, "chat rooms");
 			loadChatRooms();
+			linphone_core_startup_phase_end(lc, "chat rooms");
 		} else lWarning() << "Database explicitely not requested, this Core is built with no database support.";
 
 		if (lc->logs_db_file == NULL) {
@@ -282,8 +312,11 @@ void CorePrivate::uninit() {
 	localListEventHandler.reset();
 #endif
 
+	stopMetricsListener();
+
 	Address::clearSipAddressesCache();
 	if (mainDb != nullptr) {
+		mainDb->enableAsyncQueries(false);
 		mainDb->disconnect();
 	}
 }
@@ -309,6 +342,11 @@ void CorePrivate::notifyCallStateChanged (LinphoneCall *call, LinphoneCallState
 }
 
 void CorePrivate::notifyRegistrationStateChanged (LinphoneProxyConfig *cfg, LinphoneRegistrationState state, const string &message) {
+	if (state == LinphoneRegistrationOk)
+		metrics.registrationsOk.increment();
+	else if (state == LinphoneRegistrationFailed)
+		metrics.registrationsFailed.increment();
+
 	auto listenersCopy = listeners; // Allow removal of a listener in its own call
 	for (const auto &listener : listenersCopy)
 		listener->onRegistrationStateChanged(cfg, state, message);
@@ -427,6 +465,112 @@ void CorePrivate::startEphemeralMessageTimer (time_t expireTime) {
 	}
 }
 
+void CorePrivate::startMetricsListener () {
+#ifndef _WIN32
+	if (metricsSource)
+		return;
+
+	const char *path = linphone_config_get_string(linphone_core_get_config(getCCore()), "misc", "metrics_socket", nullptr);
+	if (!path || path[0] == '\0')
+		return;
+
+	struct sockaddr_un addr;
+	if (strlen(path) >= sizeof(addr.sun_path)) {
+		lError() << "Metrics socket path [" << path << "] is too long";
+		return;
+	}
+	memset(&addr, 0, sizeof(addr));
+	addr.sun_family = AF_UNIX;
+	strncpy(addr.sun_path, path, sizeof(addr.sun_path) - 1);
+
+	// Remove the socket left by a previous run, but never another kind of file.
+	struct stat st;
+	if (stat(path, &st) == 0 && S_ISSOCK(st.st_mode))
+		unlink(path);
+
+	int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (fd == -1) {
+		lError() << "Cannot create metrics socket: " << strerror(errno);
+		return;
+	}
+	if (bind(fd, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr)) == -1 || listen(fd, 8) == -1) {
+		lError() << "Cannot listen on metrics socket [" << path << "]: " << strerror(errno);
+		close(fd);
+		return;
+	}
+	fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+
+	metricsFd = fd;
+	metricsSocketPath = path;
+	metricsSource = belle_sip_fd_source_new(metricsListenerCb, this, fd, BELLE_SIP_EVENT_READ, (unsigned int)-1);
+	belle_sip_main_loop_add_source(getMainLoop(), metricsSource);
+	lInfo() << "Serving metrics on [" << path << "]";
+#endif
+}
+
+void CorePrivate::stopMetricsListener () {
+	if (!metricsSource)
+		return;
+
+	auto core = getPublic()->getCCore();
+	if (core && core->sal)
+		core->sal->cancelTimer(metricsSource);
+	belle_sip_object_unref(metricsSource);
+	metricsSource = nullptr;
+#ifndef _WIN32
+	close(metricsFd);
+	unlink(metricsSocketPath.c_str());
+#endif
+	metricsFd = -1;
+	metricsSocketPath.clear();
+}
+
+int CorePrivate::metricsListenerCb (void *data, unsigned int revents) {
+#ifndef _WIN32
+	CorePrivate *d = static_cast<CorePrivate *>(data);
+	int clientFd;
+	while ((clientFd = accept(d->metricsFd, nullptr, nullptr)) != -1) {
+#ifdef SO_NOSIGPIPE
+		int noSigPipe = 1;
+		setsockopt(clientFd, SOL_SOCKET, SO_NOSIGPIPE, &noSigPipe, sizeof(noSigPipe));
+#endif
+#ifdef MSG_NOSIGNAL
+		const int flags = MSG_DONTWAIT | MSG_NOSIGNAL;
+#else
+		const int flags = MSG_DONTWAIT;
+#endif
+		// A scrape fits in the socket buffer: a client that doesn't read is never waited for.
+		const string text = d->metrics.toPrometheusText();
+		size_t offset = 0;
+		while (offset < text.size()) {
+			ssize_t written = send(clientFd, text.c_str() + offset, text.size() - offset, flags);
+			if (written <= 0) {
+				lWarning() << "Cannot write metrics: " << strerror(errno);
+				break;
+			}
+			offset += size_t(written);
+		}
+		close(clientFd);
+	}
+#endif
+	return BELLE_SIP_CONTINUE;
+}
+
+const list<string> &CorePrivate::getLocalAddresses () {
+	uint64_t now = bctbx_get_cur_time_ms();
+	if (now >= localAddressesExpires) {
+		localAddresses = IfAddrs::fetchLocalAddresses();
+		localAddressesFetchCount++;
+		int ttl = linphone_config_get_int(linphone_core_get_config(getCCore()), "net", "local_addresses_cache_ttl", 30);
+		localAddressesExpires = now + uint64_t(max(ttl, 0)) * 1000;
+	}
+	return localAddresses;
+}
+
+void CorePrivate::invalidateLocalAddresses () {
+	localAddressesExpires = 0;
+}
+
 void CorePrivate::stopEphemeralMessageTimer () {
 	if (ephemeralTimer) {
 		auto core = getPublic()->getCCore();
@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2010-2019 Belledonne Communications SARL.
+ *
+ * This file is part of Liblinphone.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <locale>
+#include <sstream>
+
+#include "metrics-registry.h"
+
+// =============================================================================
+
+using namespace std;
+
+LINPHONE_BEGIN_NAMESPACE
+
+MetricsRegistry::Histogram::Histogram (initializer_list<double> bounds) :
+	mBounds(bounds),
+	mBuckets(new atomic<uint64_t>[bounds.size() + 1]) {
+	for (size_t i = 0; i <= mBounds.size(); i++)
+		mBuckets[i].store(0, memory_order_relaxed);
+}
+
+void MetricsRegistry::Histogram::observe (double value) {
+	size_t index = size_t(lower_bound(mBounds.cbegin(), mBounds.cend(), value) - mBounds.cbegin());
+	mBuckets[index].fetch_add(1, memory_order_relaxed);
+
+	double sum = mSum.load(memory_order_relaxed);
+	while (!mSum.compare_exchange_weak(sum, sum + value, memory_order_relaxed));
+}
+
+uint64_t MetricsRegistry::Histogram::getCount () const {
+	uint64_t count = 0;
+	for (size_t i = 0; i <= mBounds.size(); i++)
+		count += getBucketCount(i);
+	return count;
+}
+
+// -----------------------------------------------------------------------------
+
+namespace {
+	void writeHeader (ostream &os, const char *name, const char *type, const char *help) {
+		os << "# HELP " << name << " " << help << "\n";
+		os << "# TYPE " << name << " " << type << "\n";
+	}
+
+	template<typename T>
+	void writeSample (ostream &os, const char *name, const char *labels, T value) {
+		os << name;
+		if (labels)
+			os << "{" << labels << "}";
+		os << " " << value << "\n";
+	}
+
+	void writeHistogram (ostream &os, const char *name, const char *help, const MetricsRegistry::Histogram &histogram) {
+		writeHeader(os, name, "histogram", help);
+
+		// Counts are read once: the cumulated buckets stay consistent with the total even if observations
+		// are made meanwhile.
+		const vector<double> &bounds = histogram.getBounds();
+		uint64_t cumulativeCount = 0;
+		for (size_t i = 0; i < bounds.size(); i++) {
+			cumulativeCount += histogram.getBucketCount(i);
+			os << name << "_bucket{le=\"" << bounds[i] << "\"} " << cumulativeCount << "\n";
+		}
+		cumulativeCount += histogram.getBucketCount(bounds.size());
+		os << name << "_bucket{le=\"+Inf\"} " << cumulativeCount << "\n";
+		os << name << "_sum " << histogram.getSum() << "\n";
+		os << name << "_count " << cumulativeCount << "\n";
+	}
+}
+
+MetricsRegistry::MetricsRegistry () :
+	rtpLossRate({ 0.5, 1, 2, 5, 10, 20, 50 }),
+	rtpJitter({ 0.005, 0.01, 0.02, 0.03, 0.05, 0.1, 0.2, 0.5 }),
+	dbQueryDuration({ 0.0005, 0.001, 0.0025, 0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1, 2.5 }) {}
+
+string MetricsRegistry::toPrometheusText () const {
+	ostringstream os;
+	// Prometheus expects a dot as decimal separator whatever the locale of the application.
+	os.imbue(locale::classic());
+	os.precision(12);
+
+	writeHeader(os, "linphone_active_calls", "gauge", "Number of calls currently handled by the core.");
+	writeSample(os, "linphone_active_calls", nullptr, activeCalls.getValue());
+
+	writeHeader(os, "linphone_calls_total", "counter", "Number of calls handled by the core.");
+	writeSample(os, "linphone_calls_total", nullptr, calls.getValue());
+
+	writeHistogram(os, "linphone_rtp_loss_rate_percent", "Loss rate of the received RTP streams, per RTCP report.", rtpLossRate);
+	writeHistogram(os, "linphone_rtp_jitter_seconds", "Interarrival jitter of the received RTP streams, per RTCP report.", rtpJitter);
+
+	writeHeader(os, "linphone_registrations_total", "counter", "Number of registration outcomes, by state.");
+	writeSample(os, "linphone_registrations_total", "state=\"ok\"", registrationsOk.getValue());
+	writeSample(os, "linphone_registrations_total", "state=\"failed\"", registrationsFailed.getValue());
+
+	writeHeader(os, "linphone_chat_messages_sent_total", "counter", "Number of chat messages sent.");
+	writeSample(os, "linphone_chat_messages_sent_total", nullptr, chatMessagesSent.getValue());
+
+	writeHeader(os, "linphone_chat_messages_received_total", "counter", "Number of chat messages received.");
+	writeSample(os, "linphone_chat_messages_received_total", nullptr, chatMessagesReceived.getValue());
+
+	writeHistogram(os, "linphone_db_query_duration_seconds", "Duration of the main database transactions.", dbQueryDuration);
+
+	return os.str();
+}
+
+LINPHONE_END_NAMESPACE
@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2010-2019 Belledonne Communications SARL.
+ *
+ * This file is part of Liblinphone.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _L_METRICS_REGISTRY_H_
+#define _L_METRICS_REGISTRY_H_
+
+#include <atomic>
+#include <cstdint>
+#include <initializer_list>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "linphone/utils/general.h"
+
+// =============================================================================
+
+LINPHONE_BEGIN_NAMESPACE
+
+// Statistics of a core, exported in the Prometheus text format.
+// Metrics are only made of atomics: they may be updated from any thread (database worker, media threads...)
+// without taking a lock, and read at any time.
+class MetricsRegistry {
+public:
+	class Counter {
+	public:
+		void increment (uint64_t value = 1) {
+			mValue.fetch_add(value, std::memory_order_relaxed);
+		}
+
+		uint64_t getValue () const {
+			return mValue.load(std::memory_order_relaxed);
+		}
+
+	private:
+		std::atomic<uint64_t> mValue{0};
+	};
+
+	class Gauge {
+	public:
+		void increment () {
+			mValue.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		void decrement () {
+			mValue.fetch_sub(1, std::memory_order_relaxed);
+		}
+
+		void setValue (int64_t value) {
+			mValue.store(value, std::memory_order_relaxed);
+		}
+
+		int64_t getValue () const {
+			return mValue.load(std::memory_order_relaxed);
+		}
+
+	private:
+		std::atomic<int64_t> mValue{0};
+	};
+
+	// Observations are counted in the first bucket whose upper bound is greater or equal, the last bucket is +Inf.
+	class Histogram {
+	public:
+		explicit Histogram (std::initializer_list<double> bounds);
+
+		void observe (double value);
+
+		const std::vector<double> &getBounds () const {
+			return mBounds;
+		}
+
+		// Non cumulative count of a bucket, index getBounds().size() is the +Inf bucket.
+		uint64_t getBucketCount (size_t index) const {
+			return mBuckets[index].load(std::memory_order_relaxed);
+		}
+
+		uint64_t getCount () const;
+
+		double getSum () const {
+			return mSum.load(std::memory_order_relaxed);
+		}
+
+	private:
+		const std::vector<double> mBounds;
+		std::unique_ptr<std::atomic<uint64_t>[]> mBuckets;
+		std::atomic<double> mSum{0};
+
+		L_DISABLE_COPY(Histogram);
+	};
+
+	MetricsRegistry ();
+
+	std::string toPrometheusText () const;
+
+	Gauge activeCalls;
+	Counter calls;
+
+	// Loss rate in percents and interarrival jitter in seconds of the received RTP streams, from the RTCP reports we send.
+	Histogram rtpLossRate;
+	Histogram rtpJitter;
+
+	Counter registrationsOk;
+	Counter registrationsFailed;
+
+	Counter chatMessagesSent;
+	Counter chatMessagesReceived;
+
+	// Duration in seconds of the main database transactions.
+	Histogram dbQueryDuration;
+
+private:
+	L_DISABLE_COPY(MetricsRegistry);
+};
+
+LINPHONE_END_NAMESPACE
+
+#endif // ifndef _L_METRICS_REGISTRY_H_
@@ -67,6 +67,9 @@ public:
 	void onLinphoneCoreStart (bool monitoringEnabled) override;
 	void onLinphoneCoreStop () override;
 
+	// The core is iterated on the main thread by the application layer.
+	void startAutoIterate () override {}
+
 	void startAudioForEchoTestOrCalibration () override;
 	void stopAudioForEchoTestOrCalibration () override;
 
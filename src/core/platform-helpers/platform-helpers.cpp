@@ -17,6 +17,11 @@
  * along with this program. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#ifndef _WIN32
+	#include <fcntl.h>
+	#include <unistd.h>
+#endif
+
 #include "logger/logger.h"
 #include "platform-helpers.h"
 
@@ -34,6 +39,9 @@ GenericPlatformHelpers::GenericPlatformHelpers (std::shared_ptr<LinphonePrivate:
 }
 
 GenericPlatformHelpers::~GenericPlatformHelpers () {
+	stopAutoIterate();
+	if (mIterateThread.joinable())
+		mIterateThread.join();
 	if (mMonitorTimer) {
 		if (getCore()->getCCore() && getCore()->getCCore()->sal) getCore()->getCCore()->sal->cancelTimer(mMonitorTimer);
 		belle_sip_object_unref(mMonitorTimer);
@@ -146,7 +154,180 @@ void GenericPlatformHelpers::onLinphoneCoreStart (bool monitoringEnabled) {
 	monitorTimerExpired(this, 0);
 }
 
-void GenericPlatformHelpers::onLinphoneCoreStop () {}
+void GenericPlatformHelpers::onLinphoneCoreStop () {
+	stopAutoIterate();
+}
+
+// -----------------------------------------------------------------------------
+
+void GenericPlatformHelpers::startAutoIterate () {
+	if (mIterateThreadRunning)
+		return;
+
+	// A previous thread may have been stopped from itself, it is not running anymore.
+	if (mIterateThread.joinable())
+		mIterateThread.join();
+
+	LinphoneCore *lc = getCore()->getCCore();
+#ifndef _WIN32
+	if (!mWakeupSource) {
+		if (pipe(mWakeupFds) == 0) {
+			fcntl(mWakeupFds[0], F_SETFL, O_NONBLOCK);
+			fcntl(mWakeupFds[1], F_SETFL, O_NONBLOCK);
+			mWakeupSource = belle_sip_fd_source_new(
+				iterateWakeupCb, this, mWakeupFds[0], BELLE_SIP_EVENT_READ, (unsigned int)-1
+			);
+			belle_sip_main_loop_add_source(
+				belle_sip_stack_get_main_loop((belle_sip_stack_t *)lc->sal->getStackImpl()), mWakeupSource
+			);
+		} else {
+			mWakeupFds[0] = mWakeupFds[1] = -1;
+			lWarning() << "Cannot create auto iterate wakeup pipe: " << strerror(errno);
+		}
+	}
+#endif
+
+	mIterateThreadJoinPending = false;
+	mIterateThreadRunning = true;
+	mIterateThread = thread(&GenericPlatformHelpers::iterateThreadLoop, this);
+	lInfo() << "Core [" << lc << "] is now iterated by its own thread";
+}
+
+void GenericPlatformHelpers::stopAutoIterate () {
+	if (!mIterateThreadRunning)
+		return;
+
+	mIterateThreadRunning = false;
+	wakeupIterateThread();
+
+	// The iterate thread cannot join itself, and cannot be joined while it waits for the lock held by the caller:
+	// in both cases it is not touching the core anymore, it is joined later.
+	const thread::id currentThreadId = this_thread::get_id();
+	if (currentThreadId == mIterateThread.get_id())
+		lInfo() << "Auto iterate stopped from the iterate thread";
+	else if (currentThreadId == mCoreLockOwner)
+		mIterateThreadJoinPending = true;
+	else
+		mIterateThread.join();
+
+	removeWakeupSource();
+}
+
+void GenericPlatformHelpers::lockCore () {
+	if (!mIterateThreadRunning || this_thread::get_id() == mIterateThread.get_id())
+		return;
+
+	if (mCoreLockOwner == this_thread::get_id()) {
+		mCoreLockDepth++;
+		return;
+	}
+
+	{
+		lock_guard<mutex> lock(mLockRequestMutex);
+		mLockRequests++;
+	}
+	wakeupIterateThread();
+	mCoreMutex.lock();
+	mCoreLockOwner = this_thread::get_id();
+	mCoreLockDepth = 1;
+	{
+		lock_guard<mutex> lock(mLockRequestMutex);
+		mLockRequests--;
+	}
+	mLockRequestCond.notify_all();
+}
+
+void GenericPlatformHelpers::unlockCore () {
+	if (mCoreLockOwner != this_thread::get_id() || --mCoreLockDepth > 0)
+		return;
+
+	mCoreLockOwner = thread::id();
+	mCoreMutex.unlock();
+	if (mIterateThreadJoinPending) {
+		mIterateThreadJoinPending = false;
+		mIterateThread.join();
+	}
+}
+
+void GenericPlatformHelpers::iterateThreadLoop () {
+	LinphoneCore *lc = getCore()->getCCore();
+	belle_sip_main_loop_t *mainLoop = belle_sip_stack_get_main_loop((belle_sip_stack_t *)lc->sal->getStackImpl());
+
+	unique_lock<mutex> coreLock(mCoreMutex);
+	while (mIterateThreadRunning) {
+		linphone_core_iterate(lc);
+		mAutoIterateCount++;
+		if (!mIterateThreadRunning)
+			break;
+
+		bool lockRequested;
+		{
+			lock_guard<mutex> lock(mLockRequestMutex);
+			lockRequested = mLockRequests > 0;
+		}
+		if (!lockRequested)
+			belle_sip_main_loop_sleep(mainLoop, getAutoIterateInterval());
+
+		unique_lock<mutex> lock(mLockRequestMutex);
+		if (mLockRequests > 0) {
+			// Let the requesting threads take the core, then wait for them to release it.
+			coreLock.unlock();
+			mLockRequestCond.wait(lock, [this] { return mLockRequests == 0; });
+			lock.unlock();
+			coreLock.lock();
+		}
+	}
+}
+
+unsigned int GenericPlatformHelpers::getAutoIterateCount () const {
+	return mAutoIterateCount;
+}
+
+int GenericPlatformHelpers::getAutoIterateInterval () const {
+	// Media related events are not notified through the SIP main loop, keep polling them while they may happen.
+	// Registrations postponed by the register rate limit are also sent from iterate.
+	LinphoneCore *lc = getCore()->getCCore();
+	if (linphone_core_get_calls_nb(lc) > 0 || lc->ringstream || lc->ecc || lc->sip_conf.register_queue_depth > 0)
+		return linphone_config_get_int(lc->config, "misc", "auto_iterate_interval", 20);
+	return linphone_config_get_int(lc->config, "misc", "auto_iterate_idle_interval", 1000);
+}
+
+void GenericPlatformHelpers::wakeupIterateThread () {
+#ifndef _WIN32
+	if (mWakeupFds[1] != -1) {
+		const char c = 0;
+		if (write(mWakeupFds[1], &c, 1) == -1 && errno != EAGAIN)
+			lWarning() << "Cannot wake up auto iterate thread: " << strerror(errno);
+	}
+#endif
+}
+
+void GenericPlatformHelpers::removeWakeupSource () {
+	if (!mWakeupSource)
+		return;
+
+	LinphoneCore *lc = getCore()->getCCore();
+	if (lc && lc->sal)
+		lc->sal->cancelTimer(mWakeupSource);
+	belle_sip_object_unref(mWakeupSource);
+	mWakeupSource = nullptr;
+#ifndef _WIN32
+	close(mWakeupFds[0]);
+	close(mWakeupFds[1]);
+#endif
+	mWakeupFds[0] = mWakeupFds[1] = -1;
+}
+
+int GenericPlatformHelpers::iterateWakeupCb (void *data, unsigned int revents) {
+	GenericPlatformHelpers *helper = static_cast<GenericPlatformHelpers *>(data);
+#ifndef _WIN32
+	char buffer[32];
+	while (read(helper->mWakeupFds[0], buffer, sizeof(buffer)) > 0);
+#endif
+	LinphoneCore *lc = helper->getCore()->getCCore();
+	belle_sip_main_loop_quit(belle_sip_stack_get_main_loop((belle_sip_stack_t *)lc->sal->getStackImpl()));
+	return BELLE_SIP_CONTINUE;
+}
 
 void GenericPlatformHelpers::startAudioForEchoTestOrCalibration () { }
 
@@ -20,8 +20,12 @@
 #ifndef _L_PLATFORM_HELPERS_H_
 #define _L_PLATFORM_HELPERS_H_
 
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
 #include <string>
 #include <sstream>
+#include <thread>
 
 #include "linphone/utils/general.h"
 #include "core/core-accessor.h"
@@ -83,6 +87,15 @@ public:
 	virtual void onLinphoneCoreStart (bool monitoringEnabled) = 0;
 	virtual void onLinphoneCoreStop () = 0;
 
+	// Only meaningful where the core is iterated by a thread owned by the platform helpers.
+	virtual void startAutoIterate () {}
+	virtual void stopAutoIterate () {}
+	// The lock is reentrant: each lockCore() of a thread must be matched by an unlockCore().
+	virtual void lockCore () {}
+	virtual void unlockCore () {}
+	// Number of linphone_core_iterate() calls made by the core thread.
+	virtual unsigned int getAutoIterateCount () const { return 0; }
+
 	virtual std::shared_ptr<SharedCoreHelpers> getSharedCoreHelpers() = 0;
 	virtual void startAudioForEchoTestOrCalibration () = 0;
 	virtual void stopAudioForEchoTestOrCalibration () = 0;
@@ -137,6 +150,12 @@ public:
 	void onLinphoneCoreStart (bool monitoringEnabled) override;
 	void onLinphoneCoreStop () override;
 
+	void startAutoIterate () override;
+	void stopAutoIterate () override;
+	void lockCore () override;
+	void unlockCore () override;
+	unsigned int getAutoIterateCount () const override;
+
 	std::shared_ptr<SharedCoreHelpers> getSharedCoreHelpers() override;
 	void startAudioForEchoTestOrCalibration () override;
 	void stopAudioForEchoTestOrCalibration () override;
@@ -156,6 +175,29 @@ private:
 	static constexpr int DefaultMonitorTimeout = 5;
 	belle_sip_source_t *mMonitorTimer;
 	std::string getDownloadPath () override;
+
+	void iterateThreadLoop ();
+	int getAutoIterateInterval () const;
+	void wakeupIterateThread ();
+	void removeWakeupSource ();
+	static int iterateWakeupCb (void *data, unsigned int revents);
+
+	// Auto iterate: the core is iterated by mIterateThread, which owns mCoreMutex unless another thread asked for it
+	// with lockCore(). Between iterations it sleeps in the belle-sip main loop, so it wakes up on SIP sockets, timers
+	// and the wakeup pipe.
+	std::thread mIterateThread;
+	std::mutex mCoreMutex;
+	// Read by any thread to know whether it already holds mCoreMutex, mCoreLockDepth is only used by the owner.
+	std::atomic<std::thread::id> mCoreLockOwner{std::thread::id()};
+	int mCoreLockDepth = 0;
+	std::atomic<unsigned int> mAutoIterateCount{0};
+	std::mutex mLockRequestMutex;
+	std::condition_variable mLockRequestCond;
+	int mLockRequests = 0;
+	std::atomic<bool> mIterateThreadRunning{false};
+	bool mIterateThreadJoinPending = false;
+	int mWakeupFds[2] = { -1, -1 };
+	belle_sip_source_t *mWakeupSource = nullptr;
 };
 
 PlatformHelpers *createAndroidPlatformHelpers (std::shared_ptr<LinphonePrivate::Core> core, void *systemContext);
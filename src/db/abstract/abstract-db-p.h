@@ -38,13 +38,20 @@ class AbstractDbPrivate : public ObjectPrivate {
 public:
 #ifdef HAVE_DB_STORAGE
 	DbSession dbSession;
+
+	// Opens another connection to the database of dbSession, to be used from another thread.
+	DbSession openSession () const;
 #endif
 
 private:
 	void safeInit ();
+	void applyConnectionPragmas ();
 
 	AbstractDb::Backend backend;
+	std::string uri;
 	bool initialized = false;
+	std::list<std::string> connectionPragmas;
+	bool queryCounting = false;
 
 	L_DECLARE_PUBLIC(AbstractDb);
 };
@@ -55,6 +55,28 @@ void AbstractDbPrivate::safeInit () {
 #endif
 }
 
+void AbstractDbPrivate::applyConnectionPragmas () {
+#ifdef HAVE_DB_STORAGE
+	if (backend != AbstractDb::Sqlite3)
+		return;
+
+	soci::session *session = dbSession.getBackendSession();
+	for (const auto &pragma : connectionPragmas) {
+		try {
+			*session << pragma;
+		} catch (const exception &e) {
+			lWarning() << "Unable to apply `" << pragma << "`: " << e.what();
+		}
+	}
+#endif
+}
+
+#ifdef HAVE_DB_STORAGE
+DbSession AbstractDbPrivate::openSession () const {
+	return DbSession(uri);
+}
+#endif
+
 AbstractDb::AbstractDb (AbstractDbPrivate &p) : Object(p) {}
 
 bool AbstractDb::connect (Backend backend, const string &nameParams) {
@@ -73,12 +95,13 @@ bool AbstractDb::connect (Backend backend, const string &nameParams) {
 	#endif // if (TARGET_OS_IPHONE || defined(__ANDROID__))
 
 	d->backend = backend;
-	d->dbSession = DbSession(
-		(backend == Mysql ? "mysql://" : "sqlite3://") + nameParams
-	);
+	d->uri = (backend == Mysql ? "mysql://" : "sqlite3://") + nameParams;
+	d->dbSession = DbSession(d->uri);
+	d->dbSession.enableQueryCounting(d->queryCounting);
 
 	if (d->dbSession) {
 		try {
+			d->applyConnectionPragmas();
 			d->safeInit();
 		} catch (const exception &e) {
 			lError() << "Unable to init database: " << e.what();
@@ -117,6 +140,7 @@ bool AbstractDb::forceReconnect () {
 			try {
 				lInfo() << "Reconnect... Try: " << i;
 				d->dbSession.getBackendSession()->reconnect(); // Equivalent to close and connect.
+				d->applyConnectionPragmas();
 				d->safeInit();
 				lInfo() << "Database reconnection successful!";
 				return true;
@@ -135,6 +159,19 @@ bool AbstractDb::forceReconnect () {
 	return false;
 }
 
+void AbstractDb::setConnectionPragmas (const list<string> &pragmas) {
+	L_D();
+	d->connectionPragmas = pragmas;
+}
+
+void AbstractDb::enableQueryCounting (bool enable) {
+	L_D();
+	d->queryCounting = enable;
+#ifdef HAVE_DB_STORAGE
+	d->dbSession.enableQueryCounting(enable);
+#endif
+}
+
 AbstractDb::Backend AbstractDb::getBackend () const {
 	L_D();
 	return d->backend;
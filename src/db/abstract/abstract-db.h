@@ -20,6 +20,8 @@
 #ifndef _L_ABSTRACT_DB_H_
 #define _L_ABSTRACT_DB_H_
 
+#include <list>
+
 #include "object/object.h"
 #include "utils/general-internal.h"
 
@@ -51,6 +53,18 @@ public:
 
 	bool forceReconnect ();
 
+	/*
+	 * Statements executed on each (re)connection before the database init, typically the PRAGMA
+	 * of a sqlite3 storage profile. They are ignored with other backends.
+	 */
+	void setConnectionPragmas (const std::list<std::string> &pragmas);
+
+	/*
+	 * Counts the queries run on the database for the startup timeline of the core, including the ones of the
+	 * next connections.
+	 */
+	void enableQueryCounting (bool enable);
+
 	Backend getBackend () const;
 
 	virtual bool import (Backend backend, const std::string &parameters);
@@ -20,6 +20,8 @@
 #ifndef _L_DB_TRANSACTION_H_
 #define _L_DB_TRANSACTION_H_
 
+#include <chrono>
+
 #include "db/main-db-p.h"
 #include "logger/logger.h"
 
@@ -94,6 +96,7 @@ public:
 		MainDb *mainDb = info.mainDb;
 		const char *name = info.name;
 		soci::session *session = mainDb->getPrivate()->dbSession.getBackendSession();
+		DurationRecorder recorder(mainDb->getPrivate()->queryDurations);
 
 		try {
 			SmartTransaction tr(session, name);
@@ -127,6 +130,21 @@ public:
 	}
 
 private:
+	class DurationRecorder {
+	public:
+		DurationRecorder (MetricsRegistry::Histogram *histogram) :
+		mHistogram(histogram), mStart(std::chrono::steady_clock::now()) {}
+
+		~DurationRecorder () {
+			if (mHistogram)
+				mHistogram->observe(std::chrono::duration<double>(std::chrono::steady_clock::now() - mStart).count());
+		}
+
+	private:
+		MetricsRegistry::Histogram *mHistogram;
+		std::chrono::steady_clock::time_point mStart;
+	};
+
 	// Exec function with no return type.
 	template<typename T>
 	typename std::enable_if<std::is_same<T, void>::value, bool>::type exec (SmartTransaction &tr) const {
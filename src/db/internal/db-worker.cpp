@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2010-2019 Belledonne Communications SARL.
+ *
+ * This file is part of Liblinphone.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "db-worker.h"
+#include "logger/logger.h"
+
+// =============================================================================
+
+using namespace std;
+
+LINPHONE_BEGIN_NAMESPACE
+
+DbWorker::DbWorker () {
+	mThread = thread(&DbWorker::run, this);
+}
+
+DbWorker::~DbWorker () {
+	stop();
+
+	if (!mCompletions.empty())
+		lWarning() << "DbWorker destroyed with " << mCompletions.size() << " undelivered completion(s).";
+}
+
+void DbWorker::stop () {
+	{
+		lock_guard<mutex> lock(mMutex);
+		mStopping = true;
+	}
+	mCondition.notify_one();
+	if (mThread.joinable())
+		mThread.join();
+}
+
+void DbWorker::post (Task task) {
+	{
+		lock_guard<mutex> lock(mMutex);
+		if (mStopping) {
+			lWarning() << "DbWorker is stopped, dropping task.";
+			return;
+		}
+		mTasks.push_back(move(task));
+	}
+	mCondition.notify_one();
+}
+
+int DbWorker::processCompletions () {
+	deque<Completion> completions;
+	{
+		lock_guard<mutex> lock(mMutex);
+		if (mCompletions.empty())
+			return 0;
+		completions.swap(mCompletions);
+	}
+
+	for (const auto &completion : completions)
+		completion();
+	return int(completions.size());
+}
+
+size_t DbWorker::getPendingCount () const {
+	lock_guard<mutex> lock(mMutex);
+	return mTasks.size() + mRunningCount + mCompletions.size();
+}
+
+void DbWorker::run () {
+	unique_lock<mutex> lock(mMutex);
+	for (;;) {
+		mCondition.wait(lock, [this] { return mStopping || !mTasks.empty(); });
+		// Pending tasks are still executed on stop so that no caller waits forever on a lost query.
+		if (mTasks.empty())
+			break;
+
+		Task task = move(mTasks.front());
+		mTasks.pop_front();
+		++mRunningCount;
+		lock.unlock();
+
+		Completion completion;
+		try {
+			completion = task();
+		} catch (const exception &e) {
+			lError() << "Unhandled exception in database worker: `" << e.what() << "`.";
+		}
+
+		lock.lock();
+		--mRunningCount;
+		if (completion)
+			mCompletions.push_back(move(completion));
+	}
+}
+
+LINPHONE_END_NAMESPACE
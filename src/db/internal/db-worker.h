@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2010-2019 Belledonne Communications SARL.
+ *
+ * This file is part of Liblinphone.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _L_DB_WORKER_H_
+#define _L_DB_WORKER_H_
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+#include "linphone/utils/general.h"
+
+// =============================================================================
+
+LINPHONE_BEGIN_NAMESPACE
+
+// Runs database queries on a dedicated thread.
+// A task is executed on the worker thread and returns a completion which is run
+// on the core main loop by processCompletions(), so that objects bound to the core
+// are only ever created and notified from the main loop.
+class DbWorker {
+public:
+	using Completion = std::function<void ()>;
+	using Task = std::function<Completion ()>;
+
+	DbWorker ();
+	~DbWorker ();
+
+	void post (Task task);
+
+	// Waits for the queued tasks to be executed and stops the thread. Completions are kept until processed.
+	void stop ();
+
+	// Must be called from the main loop. Returns the number of completions that have been run.
+	int processCompletions ();
+
+	size_t getPendingCount () const;
+
+private:
+	void run ();
+
+	std::thread mThread;
+	mutable std::mutex mMutex;
+	std::condition_variable mCondition;
+	std::deque<Task> mTasks;
+	std::deque<Completion> mCompletions;
+	size_t mRunningCount = 0;
+	bool mStopping = false;
+
+	L_DISABLE_COPY(DbWorker);
+};
+
+LINPHONE_END_NAMESPACE
+
+#endif // ifndef _L_DB_WORKER_H_
@@ -21,12 +21,16 @@
 #define _L_MAIN_DB_P_H_
 
 #include <unordered_map>
+#include <vector>
 
 #include "linphone/utils/utils.h"
 
 #include "abstract/abstract-db-p.h"
-#include "containers/lru-cache.h"
+#include "core/metrics-registry.h"
 #include "event-log/event-log.h"
+#ifdef HAVE_DB_STORAGE
+#include "internal/db-worker.h"
+#endif
 #include "main-db.h"
 
 // =============================================================================
@@ -34,6 +38,7 @@
 LINPHONE_BEGIN_NAMESPACE
 
 class Content;
+class ObjectPool;
 
 class MainDbPrivate : public AbstractDbPrivate {
 public:
@@ -41,6 +46,14 @@ public:
 	mutable std::unordered_map<long long, std::weak_ptr<ChatMessage>> storageIdToChatMessage;
 	mutable std::unordered_map<long long, ConferenceId> storageIdToConferenceId;
 
+#ifdef HAVE_DB_STORAGE
+	// Where the duration of each transaction is recorded, if set.
+	MetricsRegistry::Histogram *queryDurations = nullptr;
+
+	// Arena of the core the messages and events loaded from history are allocated from, if set.
+	ObjectPool *objectPool = nullptr;
+#endif
+
 private:
 	// ---------------------------------------------------------------------------
 	// Misc helpers.
@@ -155,6 +168,12 @@ private:
 		EventLog::Type type,
 		const soci::row &row
 	) const;
+
+	// Builds the events of the given ids, newest first, as returned by the database worker.
+	std::list<std::shared_ptr<EventLog>> selectConferenceEvents (
+		const ConferenceId &conferenceId,
+		const std::vector<long long> &eventIds
+	) const;
 #endif
 
 	long long insertEvent (const std::shared_ptr<EventLog> &eventLog);
@@ -162,6 +181,7 @@ private:
 	long long insertConferenceCallEvent (const std::shared_ptr<EventLog> &eventLog);
 	long long insertConferenceChatMessageEvent (const std::shared_ptr<EventLog> &eventLog);
 	void updateConferenceChatMessageEvent(const std::shared_ptr<EventLog> &eventLog);
+	void updateChatRoomMessageCounters (long long chatRoomId = -1);
 	long long insertConferenceNotifiedEvent (const std::shared_ptr<EventLog> &eventLog, long long *chatRoomId = nullptr);
 	long long insertConferenceParticipantEvent (const std::shared_ptr<EventLog> &eventLog, long long *chatRoomId = nullptr, bool executeAction = true);
 	long long insertConferenceParticipantDeviceEvent (const std::shared_ptr<EventLog> &eventLog);
@@ -211,8 +231,16 @@ private:
 #endif
 
 	// ---------------------------------------------------------------------------
+	// Asynchronous queries.
+	// ---------------------------------------------------------------------------
 
-	mutable LruCache<ConferenceId, int> unreadChatMessageCountCache;
+#ifdef HAVE_DB_STORAGE
+	// Connection of the database worker, only used from its thread. It must outlive the worker.
+	DbSession workerSession;
+	std::unique_ptr<DbWorker> dbWorker;
+#endif
+
+	// ---------------------------------------------------------------------------
 
 	L_DECLARE_PUBLIC(MainDb);
 };
@@ -41,6 +41,7 @@
 #include "event-log/events.h"
 #include "main-db-key-p.h"
 #include "main-db-p.h"
+#include "object/object-pool.h"
 
 #ifdef HAVE_DB_STORAGE
 #include "internal/db-transaction.h"
@@ -62,7 +63,7 @@ LINPHONE_BEGIN_NAMESPACE
 
 #ifdef HAVE_DB_STORAGE
 namespace {
-	constexpr unsigned int ModuleVersionEvents = makeVersion(1, 0, 14);
+	constexpr unsigned int ModuleVersionEvents = makeVersion(1, 0, 15);
 	constexpr unsigned int ModuleVersionFriends = makeVersion(1, 0, 0);
 	constexpr unsigned int ModuleVersionLegacyFriendsImport = makeVersion(1, 0, 0);
 	constexpr unsigned int ModuleVersionLegacyHistoryImport = makeVersion(1, 0, 0);
@@ -94,6 +95,9 @@ namespace {
 	constexpr int LegacyMessageColContentId = 11;
 	constexpr int LegacyMessageColContentType = 13;
 	constexpr int LegacyMessageColIsSecured = 14;
+
+	// How long a sqlite3 connection waits for the locks of the other one while the database worker runs.
+	constexpr int AsyncQueriesBusyTimeout = 5000;
 }
 #endif
 
@@ -741,13 +745,16 @@ shared_ptr<EventLog> MainDbPrivate::selectConferenceChatMessageEvent (
 	EventLog::Type type,
 	const soci::row &row
 ) const {
+	// Messages of a loaded history are numerous: they are taken from the arena of the core with their events.
+	ObjectPool::Scope poolScope(objectPool);
 	long long eventId = getConferenceEventIdFromRow(row);
 	shared_ptr<ChatMessage> chatMessage = getChatMessageFromCache(eventId);
 	if (!chatMessage) {
+		// Their control blocks are pooled like the messages themselves.
 		chatMessage = shared_ptr<ChatMessage>(new ChatMessage(
 			chatRoom,
 			ChatMessage::Direction(row.get<int>(8))
-		));
+		), default_delete<ChatMessage>(), ObjectPoolAllocator<ChatMessage>());
 		chatMessage->setIsSecured(!!row.get<int>(9));
 
 		ChatMessagePrivate *dChatMessage = chatMessage->getPrivate();
@@ -784,7 +791,8 @@ shared_ptr<EventLog> MainDbPrivate::selectConferenceChatMessageEvent (
 		cache(chatMessage, eventId);
 	}
 
-	return make_shared<ConferenceChatMessageEvent>(
+	return allocate_shared<ConferenceChatMessageEvent>(
+		ObjectPoolAllocator<ConferenceChatMessageEvent>(),
 		getConferenceEventCreationTimeFromRow(row),
 		chatMessage
 	);
@@ -868,6 +876,55 @@ shared_ptr<EventLog> MainDbPrivate::selectConferenceSubjectEvent (
 	event->setNotifyId(getConferenceEventNotifyIdFromRow(row));
 	return event;
 }
+
+list<shared_ptr<EventLog>> MainDbPrivate::selectConferenceEvents (
+	const ConferenceId &conferenceId,
+	const vector<long long> &eventIds
+) const {
+	L_Q();
+
+	list<shared_ptr<EventLog>> events;
+	shared_ptr<AbstractChatRoom> chatRoom = findChatRoom(conferenceId);
+	if (!chatRoom || eventIds.empty())
+		return events;
+
+	// Events that are still alive are taken from the cache, only the missing ones are fetched.
+	unordered_map<long long, shared_ptr<EventLog>> eventsById;
+	string missingIds;
+	for (long long eventId : eventIds) {
+		shared_ptr<EventLog> eventLog = getEventFromCache(eventId);
+		if (eventLog) {
+			eventsById[eventId] = eventLog;
+			continue;
+		}
+		if (!missingIds.empty())
+			missingIds += ",";
+		missingIds += Utils::toString(eventId);
+	}
+
+	if (!missingIds.empty()) {
+		const string query = Statements::get(Statements::SelectConferenceEvents) +
+			string(" AND conference_event_view.id IN (") + missingIds + ")";
+
+		L_DB_TRANSACTION_C(q) {
+			const long long &dbChatRoomId = selectChatRoomId(conferenceId);
+			soci::rowset<soci::row> rows = (dbSession.getBackendSession()->prepare << query, soci::use(dbChatRoomId));
+			for (const auto &row : rows) {
+				shared_ptr<EventLog> eventLog = selectGenericConferenceEvent(chatRoom, row);
+				if (eventLog)
+					eventsById[getConferenceEventIdFromRow(row)] = eventLog;
+			}
+		};
+	}
+
+	for (long long eventId : eventIds) {
+		auto it = eventsById.find(eventId);
+		if (it != eventsById.end())
+			events.push_front(it->second);
+	}
+
+	return events;
+}
 #endif
 
 // -----------------------------------------------------------------------------
@@ -985,13 +1042,10 @@ long long MainDbPrivate::insertConferenceChatMessageEvent (const shared_ptr<Even
 	}
 
 	const long long &dbChatRoomId = selectChatRoomId(chatRoom->getConferenceId());
-	*dbSession.getBackendSession() << "UPDATE chat_room SET last_message_id = :1 WHERE id = :2", soci::use(eventId), soci::use(dbChatRoomId);
-
-	if (direction == int(ChatMessage::Direction::Incoming) && !markedAsRead) {
-		int *count = unreadChatMessageCountCache[chatRoom->getConferenceId()];
-		if (count)
-			++*count;
-	}
+	const int unreadIncrement = markedAsRead ? 0 : 1;
+	*dbSession.getBackendSession() << "UPDATE chat_room SET last_message_id = :1,"
+		" message_count = message_count + 1, unread_message_count = unread_message_count + :2"
+		" WHERE id = :3", soci::use(eventId), soci::use(unreadIncrement), soci::use(dbChatRoomId);
 
 	return eventId;
 #else
@@ -1024,12 +1078,11 @@ void MainDbPrivate::updateConferenceChatMessageEvent (const shared_ptr<EventLog>
 	// 2. Update unread chat message count if necessary.
 	const bool isOutgoing = chatMessage->getDirection() == ChatMessage::Direction::Outgoing;
 	shared_ptr<AbstractChatRoom> chatRoom(chatMessage->getChatRoom());
-	if (!isOutgoing && markedAsRead) {
-		int *count = unreadChatMessageCountCache[chatRoom->getConferenceId()];
-		if (count && !dbMarkedAsRead) {
-			L_ASSERT(*count > 0);
-			--*count;
-		}
+	if (markedAsRead != dbMarkedAsRead) {
+		const int unreadIncrement = markedAsRead ? -1 : 1;
+		const long long &dbChatRoomId = selectChatRoomId(chatRoom->getConferenceId());
+		*dbSession.getBackendSession() << "UPDATE chat_room SET unread_message_count = unread_message_count + :1 WHERE id = :2",
+			soci::use(unreadIncrement), soci::use(dbChatRoomId);
 	}
 
 	// 3. Update chat message event.
@@ -1063,6 +1116,30 @@ void MainDbPrivate::updateConferenceChatMessageEvent (const shared_ptr<EventLog>
 #endif
 }
 
+void MainDbPrivate::updateChatRoomMessageCounters (long long chatRoomId) {
+#ifdef HAVE_DB_STORAGE
+	// Recompute the counters from the events, for one chat room or for all of them if no id is given.
+	string query = "UPDATE chat_room SET"
+		"  message_count = ("
+		"    SELECT COUNT(*) FROM conference_event, conference_chat_message_event"
+		"    WHERE conference_event.chat_room_id = chat_room.id"
+		"    AND conference_chat_message_event.event_id = conference_event.event_id"
+		"  ),"
+		"  unread_message_count = ("
+		"    SELECT COUNT(*) FROM conference_event, conference_chat_message_event"
+		"    WHERE conference_event.chat_room_id = chat_room.id"
+		"    AND conference_chat_message_event.event_id = conference_event.event_id"
+		"    AND marked_as_read = 0"
+		"  )";
+
+	soci::session *session = dbSession.getBackendSession();
+	if (chatRoomId < 0)
+		*session << query;
+	else
+		*session << query + " WHERE id = :chatRoomId", soci::use(chatRoomId);
+#endif
+}
+
 long long MainDbPrivate::insertConferenceNotifiedEvent (const shared_ptr<EventLog> &eventLog, long long *chatRoomId) {
 #ifdef HAVE_DB_STORAGE
 	long long curChatRoomId;
@@ -1534,6 +1611,12 @@ void MainDbPrivate::updateSchema () {
 	if (version < makeVersion(1, 0, 14)) {
 		*session << "ALTER TABLE chat_message_content ADD COLUMN body_encoding_type TINYINT NOT NULL DEFAULT 0";// Older table contains Local encoding.
 	}
+	if (version < makeVersion(1, 0, 15)) {
+		// Maintained on each chat message insertion/update/deletion, so that chat lists do not have to count events.
+		*session << "ALTER TABLE chat_room ADD COLUMN message_count INT NOT NULL DEFAULT 0";
+		*session << "ALTER TABLE chat_room ADD COLUMN unread_message_count INT NOT NULL DEFAULT 0";
+		updateChatRoomMessageCounters();
+	}
 #endif
 }
 
@@ -1801,6 +1884,7 @@ void MainDbPrivate::importLegacyHistory (DbSession &inDbSession) {
 				"WHERE conference_chat_message_event.time=t AND conference_chat_message_event.event_id=conference_event.event_id AND conference_event.chat_room_id=c "
 				"AND conference_event.chat_room_id=chat_room.id "
 				"GROUP BY conference_event.chat_room_id),0))";// if there are no messages, the first is NULL. So put a 0 to the ID
+		updateChatRoomMessageCounters();
 		tr.commit();
 		lInfo() << "Successful import of legacy messages.";
 	};
@@ -2360,13 +2444,25 @@ bool MainDb::deleteEvent (const shared_ptr<const EventLog> &eventLog) {
 	return L_DB_TRANSACTION_C(&mainDb) {
 		MainDbPrivate *const d = mainDb.getPrivate();
 		soci::session *session = d->dbSession.getBackendSession();
+
+		const bool isChatMessage = eventLog->getType() == EventLog::Type::ConferenceChatMessage;
+		int unreadDecrement = 0;
+		if (isChatMessage) {
+			int markedAsRead = 1;
+			*session << "SELECT marked_as_read FROM conference_chat_message_event WHERE event_id = :eventId",
+				soci::into(markedAsRead), soci::use(dEventKey->storageId);
+			unreadDecrement = markedAsRead ? 0 : 1;
+		}
+
 		*session << "DELETE FROM event WHERE id = :id", soci::use(dEventKey->storageId);
 		
-		if (eventLog->getType() == EventLog::Type::ConferenceChatMessage) {
+		if (isChatMessage) {
 			shared_ptr<ChatMessage> chatMessage(static_pointer_cast<const ConferenceChatMessageEvent>(eventLog)->getChatMessage());
 			shared_ptr<AbstractChatRoom> chatRoom(chatMessage->getChatRoom());
 			const long long &dbChatRoomId = d->selectChatRoomId(chatRoom->getConferenceId());
-			*session << "UPDATE chat_room SET last_message_id = IFNULL((SELECT id FROM conference_event_simple_view WHERE chat_room_id = chat_room.id AND type = " << mapEventFilterToSql(ConferenceChatMessageFilter) << " ORDER BY id DESC LIMIT 1), 0) WHERE id = :1", soci::use(dbChatRoomId);
+			*session << "UPDATE chat_room SET last_message_id = IFNULL((SELECT id FROM conference_event_simple_view WHERE chat_room_id = chat_room.id AND type = " << mapEventFilterToSql(ConferenceChatMessageFilter) << " ORDER BY id DESC LIMIT 1), 0),"
+				" message_count = message_count - 1, unread_message_count = unread_message_count - :1"
+				" WHERE id = :2", soci::use(unreadDecrement), soci::use(dbChatRoomId);
 			// Delete chat message from cache as the event is deleted
 			ChatMessagePrivate *dChatMessage = chatMessage->getPrivate();
 			dChatMessage->resetStorageId();
@@ -2377,15 +2473,6 @@ bool MainDb::deleteEvent (const shared_ptr<const EventLog> &eventLog) {
 		// Reset storage ID as event is not valid anymore
 		const_cast<EventLogPrivate *>(dEventLog)->resetStorageId();
 
-		if (eventLog->getType() == EventLog::Type::ConferenceChatMessage) {
-			shared_ptr<ChatMessage> chatMessage(static_pointer_cast<const ConferenceChatMessageEvent>(eventLog)->getChatMessage());
-			if (chatMessage->getDirection() == ChatMessage::Direction::Incoming && !chatMessage->getPrivate()->isMarkedAsRead()) {
-				int *count = d->unreadChatMessageCountCache[chatMessage->getChatRoom()->getConferenceId()];
-				if (count)
-					--*count;
-			}
-		}
-
 		return true;
 	};
 #else
@@ -2508,20 +2595,15 @@ int MainDb::getChatMessageCount (const ConferenceId &conferenceId) const {
 	return L_DB_TRANSACTION {
 		L_D();
 
-		int count;
+		int count = 0;
 
 		soci::session *session = d->dbSession.getBackendSession();
 
-		string query = "SELECT COUNT(*) FROM conference_chat_message_event";
 		if (!conferenceId.isValid())
-			*session << query, soci::into(count);
+			*session << "SELECT COUNT(*) FROM conference_chat_message_event", soci::into(count);
 		else {
-			query += " WHERE event_id IN ("
-				"  SELECT event_id FROM conference_event WHERE chat_room_id = :chatRoomId"
-				")";
-
 			const long long &dbChatRoomId = d->selectChatRoomId(conferenceId);
-			*session << query, soci::use(dbChatRoomId), soci::into(count);
+			*session << "SELECT message_count FROM chat_room WHERE id = :chatRoomId", soci::use(dbChatRoomId), soci::into(count);
 		}
 
 		return count;
@@ -2535,19 +2617,9 @@ int MainDb::getUnreadChatMessageCount (const ConferenceId &conferenceId) const {
 #ifdef HAVE_DB_STORAGE
 	L_D();
 
-	if (conferenceId.isValid()) {
-		const int *count = d->unreadChatMessageCountCache[conferenceId];
-		if (count)
-			return *count;
-	}
-
-	string query = "SELECT COUNT(*) FROM conference_chat_message_event WHERE";
-	if (conferenceId.isValid())
-		query += " event_id IN ("
-			"  SELECT event_id FROM conference_event WHERE chat_room_id = :chatRoomId"
-			") AND";
-
-	query += " marked_as_read == 0 ";
+	const string query = conferenceId.isValid()
+		? "SELECT unread_message_count FROM chat_room WHERE id = :chatRoomId"
+		: "SELECT COUNT(*) FROM conference_chat_message_event WHERE marked_as_read = 0";
 
 	/*
 	DurationLogger durationLogger(
@@ -2568,7 +2640,6 @@ int MainDb::getUnreadChatMessageCount (const ConferenceId &conferenceId) const {
 			*session << query, soci::use(dbChatRoomId), soci::into(count);
 		}
 
-		d->unreadChatMessageCountCache.insert(conferenceId, count);
 		return count;
 	};
 #else
@@ -2600,9 +2671,9 @@ void MainDb::markChatMessagesAsRead (const ConferenceId &conferenceId) const {
 
 		const long long &dbChatRoomId = d->selectChatRoomId(conferenceId);
 		*d->dbSession.getBackendSession() << query, soci::use(dbChatRoomId);
+		*d->dbSession.getBackendSession() << "UPDATE chat_room SET unread_message_count = 0 WHERE id = :chatRoomId", soci::use(dbChatRoomId);
 
 		tr.commit();
-		d->unreadChatMessageCountCache.insert(conferenceId, 0);
 	};
 #endif
 }
@@ -3118,9 +3189,13 @@ int MainDb::getHistorySize (const ConferenceId &conferenceId, FilterMask mask) c
 	return L_DB_TRANSACTION {
 		L_D();
 
-		int count;
+		int count = 0;
 		const long long &dbChatRoomId = d->selectChatRoomId(conferenceId);
-		*d->dbSession.getBackendSession() << query, soci::into(count), soci::use(dbChatRoomId);
+		if (mask == ConferenceChatMessageFilter)
+			*d->dbSession.getBackendSession() << "SELECT message_count FROM chat_room WHERE id = :chatRoomId",
+				soci::into(count), soci::use(dbChatRoomId);
+		else
+			*d->dbSession.getBackendSession() << query, soci::into(count), soci::use(dbChatRoomId);
 
 		return count;
 	};
@@ -3155,11 +3230,191 @@ void MainDb::cleanHistory (const ConferenceId &conferenceId, FilterMask mask) {
 		d->invalidConferenceEventsFromQuery(query, dbChatRoomId);
 		*d->dbSession.getBackendSession() << "DELETE FROM event WHERE id IN (" + query + ")", soci::use(dbChatRoomId);
 		*d->dbSession.getBackendSession() << query2, soci::use(dbChatRoomId);
+		d->updateChatRoomMessageCounters(dbChatRoomId);
 		tr.commit();
+	};
+#endif
+}
+
+// -----------------------------------------------------------------------------
+
+bool MainDb::enableAsyncQueries (bool enable) {
+#ifdef HAVE_DB_STORAGE
+	L_D();
+
+	if (enable == !!d->dbWorker)
+		return true;
+
+	if (!enable) {
+		// Let the queries in progress finish and deliver them before going back to synchronous mode.
+		d->dbWorker->stop();
+		d->dbWorker->processCompletions();
+		d->dbWorker.reset();
+		d->workerSession = DbSession();
+		return true;
+	}
+
+	if (!d->dbSession) {
+		lWarning() << "Unable to enable asynchronous MainDb queries. Not a valid database session.";
+		return false;
+	}
+
+	// The worker never shares the session of the main loop: it gets a connection of its own, restricted to reads.
+	DbSession workerSession = d->openSession();
+	if (!workerSession) {
+		lWarning() << "Unable to enable asynchronous MainDb queries. Cannot open the worker connection.";
+		return false;
+	}
+
+	if (getBackend() == Sqlite3) {
+		try {
+			soci::session *session = d->dbSession.getBackendSession();
+
+			// A database in WAL is kept locked by the main connection, see the sqlite3 storage profiles.
+			string lockingMode;
+			*session << "PRAGMA locking_mode", soci::into(lockingMode);
+			if (Utils::stringToLower(lockingMode) == "exclusive") {
+				lWarning() << "Unable to enable asynchronous MainDb queries. The database is locked exclusively.";
+				return false;
+			}
+
+			*workerSession.getBackendSession() << "PRAGMA query_only = 1";
+			// The two connections wait for each other's locks instead of failing with SQLITE_BUSY.
+			*workerSession.getBackendSession() << "PRAGMA busy_timeout = " + Utils::toString(AsyncQueriesBusyTimeout);
+			*session << "PRAGMA busy_timeout = " + Utils::toString(AsyncQueriesBusyTimeout);
+		} catch (const exception &e) {
+			lWarning() << "Unable to enable asynchronous MainDb queries: `" << e.what() << "`.";
+			return false;
+		}
+	}
+
+	lInfo() << "Enabling asynchronous MainDb queries.";
+	d->workerSession = move(workerSession);
+	d->dbWorker = makeUnique<DbWorker>();
+	return true;
+#else
+	return false;
+#endif
+}
+
+bool MainDb::asyncQueriesEnabled () const {
+#ifdef HAVE_DB_STORAGE
+	L_D();
+	return !!d->dbWorker;
+#else
+	return false;
+#endif
+}
+
+void MainDb::getHistoryRangeAsync (
+	const ConferenceId &conferenceId,
+	int begin,
+	int end,
+	FilterMask mask,
+	const HistoryCallback &callback
+) const {
+#ifdef HAVE_DB_STORAGE
+	L_D();
+
+	if (!d->dbWorker) {
+		callback(getHistoryRange(conferenceId, begin, end, mask));
+		return;
+	}
+
+	if (begin < 0)
+		begin = 0;
+
+	if (end > 0 && begin > end) {
+		lWarning() << "Unable to get history. Invalid range.";
+		callback(list<shared_ptr<EventLog>>());
+		return;
+	}
+
+	// The worker only walks the (potentially large) history to find the ids of the range.
+	// The events themselves are built on the main loop, where the caches live.
+	string query = "SELECT id FROM conference_event_view WHERE chat_room_id = :1" + buildSqlEventFilter({
+		ConferenceCallFilter, ConferenceChatMessageFilter, ConferenceInfoFilter, ConferenceInfoNoDeviceFilter, ConferenceChatMessageSecurityFilter
+	}, mask, "AND");
+	query += " ORDER BY id DESC";
+
+	if (end > 0)
+		query += " LIMIT " + Utils::toString(end - begin);
+	else
+		query += " LIMIT " + d->dbSession.noLimitValue();
+
+	if (begin > 0)
+		query += " OFFSET " + Utils::toString(begin);
 
-		if (!mask || (mask & ConferenceChatMessageFilter))
-			d->unreadChatMessageCountCache.insert(conferenceId, 0);
+	const long long dbChatRoomId = L_DB_TRANSACTION {
+		L_D();
+		return d->selectChatRoomId(conferenceId);
 	};
+
+	d->dbWorker->post([d, query, dbChatRoomId, conferenceId, callback]() -> DbWorker::Completion {
+		vector<long long> eventIds;
+		try {
+			soci::rowset<soci::row> rows = (d->workerSession.getBackendSession()->prepare << query, soci::use(dbChatRoomId));
+			for (const auto &row : rows)
+				eventIds.push_back(d->workerSession.resolveId(row, 0));
+		} catch (const exception &e) {
+			lError() << "Unable to get history range asynchronously: `" << e.what() << "`.";
+			eventIds.clear();
+		}
+
+		return [d, conferenceId, eventIds, callback] {
+			callback(d->selectConferenceEvents(conferenceId, eventIds));
+		};
+	});
+#else
+	callback(list<shared_ptr<EventLog>>());
+#endif
+}
+
+void MainDb::getHistorySizeAsync (const ConferenceId &conferenceId, FilterMask mask, const CountCallback &callback) const {
+#ifdef HAVE_DB_STORAGE
+	L_D();
+
+	if (!d->dbWorker) {
+		callback(getHistorySize(conferenceId, mask));
+		return;
+	}
+
+	const string query = mask == ConferenceChatMessageFilter
+		? string("SELECT message_count FROM chat_room WHERE id = :chatRoomId")
+		: "SELECT COUNT(*) FROM event, conference_event"
+			"  WHERE chat_room_id = :chatRoomId"
+			"  AND event_id = event.id" + buildSqlEventFilter({
+				ConferenceCallFilter, ConferenceChatMessageFilter, ConferenceInfoFilter, ConferenceInfoNoDeviceFilter, ConferenceChatMessageSecurityFilter
+			}, mask, "AND");
+
+	const long long dbChatRoomId = L_DB_TRANSACTION {
+		L_D();
+		return d->selectChatRoomId(conferenceId);
+	};
+
+	d->dbWorker->post([d, query, dbChatRoomId, callback]() -> DbWorker::Completion {
+		int count = 0;
+		try {
+			*d->workerSession.getBackendSession() << query, soci::into(count), soci::use(dbChatRoomId);
+		} catch (const exception &e) {
+			lError() << "Unable to get history size asynchronously: `" << e.what() << "`.";
+			count = 0;
+		}
+
+		return [count, callback] {
+			callback(count);
+		};
+	});
+#else
+	callback(0);
+#endif
+}
+
+void MainDb::processAsyncQueriesResults () {
+#ifdef HAVE_DB_STORAGE
+	L_D();
+	if (d->dbWorker)
+		d->dbWorker->processCompletions();
 #endif
 }
 
@@ -3528,7 +3783,6 @@ void MainDb::deleteChatRoom (const ConferenceId &conferenceId) {
 		*d->dbSession.getBackendSession() << "DELETE FROM chat_room WHERE id = :chatRoomId", soci::use(dbChatRoomId);
 
 		tr.commit();
-		d->unreadChatMessageCountCache.insert(conferenceId, 0);
 	};
 #endif
 }
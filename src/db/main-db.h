@@ -159,6 +159,31 @@ public:
 
 	void cleanHistory (const ConferenceId &conferenceId, FilterMask mask = NoFilter);
 
+	// ---------------------------------------------------------------------------
+	// Asynchronous queries.
+	// ---------------------------------------------------------------------------
+
+	using HistoryCallback = std::function<void (const std::list<std::shared_ptr<EventLog>> &events)>;
+	using CountCallback = std::function<void (int count)>;
+
+	// When enabled, the heavy part of the queries below runs on a database thread with its own connection
+	// and the callbacks are invoked from the core main loop. Otherwise they are invoked synchronously.
+	// Returns false if the worker cannot be started, for example when the database is locked exclusively.
+	bool enableAsyncQueries (bool enable);
+	bool asyncQueriesEnabled () const;
+
+	void getHistoryRangeAsync (
+		const ConferenceId &conferenceId,
+		int begin,
+		int end,
+		FilterMask mask,
+		const HistoryCallback &callback
+	) const;
+	void getHistorySizeAsync (const ConferenceId &conferenceId, FilterMask mask, const CountCallback &callback) const;
+
+	// Invokes the callbacks of the asynchronous queries that are done. Called by the core main loop.
+	void processAsyncQueriesResults ();
+
 	// ---------------------------------------------------------------------------
 	// Chat messages.
 	// ---------------------------------------------------------------------------
@@ -22,6 +22,7 @@
 #include "sqlite3_bctbx_vfs.h"
 #include "db-session.h"
 #include "logger/logger.h"
+#include "private.h"
 
 // =============================================================================
 
@@ -29,6 +30,19 @@ using namespace std;
 
 LINPHONE_BEGIN_NAMESPACE
 
+// Counts the queries for the startup timeline of the cores.
+class QueryCounter : public soci::logger_impl {
+public:
+	void start_query (const string &) override {
+		_linphone_core_count_db_query();
+	}
+
+private:
+	soci::logger_impl *do_clone () const override {
+		return new QueryCounter;
+	}
+};
+
 class DbSessionPrivate {
 public:
 	enum class Backend {
@@ -38,6 +52,8 @@ public:
 	} backend = Backend::None;
 
 	std::unique_ptr<soci::session> backendSession;
+	// Logger of the backend session replaced by the query counter.
+	std::unique_ptr<soci::logger> previousLogger;
 };
 
 DbSession::DbSession () : mPrivate(new DbSessionPrivate) {}
@@ -92,6 +108,20 @@ soci::session *DbSession::getBackendSession () const {
 	return d->backendSession.get();
 }
 
+void DbSession::enableQueryCounting (bool enable) {
+	L_D();
+	if (!d->backendSession || enable == !!d->previousLogger)
+		return;
+
+	if (enable) {
+		d->previousLogger = makeUnique<soci::logger>(d->backendSession->get_logger());
+		d->backendSession->set_logger(soci::logger(new QueryCounter));
+	} else {
+		d->backendSession->set_logger(*d->previousLogger);
+		d->previousLogger.reset();
+	}
+}
+
 string DbSession::primaryKeyStr (const string &type) const {
 	L_D();
 
@@ -43,6 +43,9 @@ public:
 
 	soci::session *getBackendSession () const;
 
+	// Counts the queries for the startup timeline of the cores.
+	void enableQueryCounting (bool enable);
+
 	std::string primaryKeyStr (const std::string &type = "INT") const;
 	std::string primaryKeyRefStr (const std::string &type = "INT") const;
 	std::string varcharPrimaryKeyStr (int length) const;
@@ -17,7 +17,9 @@
  * along with this program. If not, see <http://www.gnu.org/licenses/>.
  */
 
-#include <cstring>
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
 
 #include "linphone/utils/utils.h"
 
@@ -325,6 +327,90 @@ bool DialPlan::isGeneric () const {
 	return country == MostCommon->getCountry();
 }
 
+// -----------------------------------------------------------------------------
+
+namespace {
+	// Lookup tables of the dial plans, built once at first use.
+	class DialPlanIndex {
+	public:
+		explicit DialPlanIndex (const list<shared_ptr<DialPlan>> &dialPlans) : nodes(1) {
+			for (const auto &dp : dialPlans) {
+				const string &ccc = dp->getCountryCallingCode();
+				// The first dial plan of the list wins if several share a code.
+				byCcc.emplace(ccc, dp);
+				byIso.emplace(dp->getIsoCountryCode(), dp);
+				addToTrie(ccc);
+			}
+		}
+
+		// A number belongs to the first country calling code that is the only one to match its leading digits.
+		int lookupCcc (const char *digits) const {
+			size_t node = 0;
+			for (const char *c = digits; *c != '\0'; c++) {
+				if (*c < '0' || *c > '9')
+					return -1;
+				int child = nodes[node].children[*c - '0'];
+				if (child < 0)
+					return -1;
+				node = size_t(child);
+				if (nodes[node].count == 1)
+					return nodes[node].ccc;
+			}
+			return -1;
+		}
+
+		shared_ptr<DialPlan> findByIso (const string &iso) const {
+			auto it = byIso.find(iso);
+			return it == byIso.cend() ? nullptr : it->second;
+		}
+
+		shared_ptr<DialPlan> findByCcc (const string &ccc) const {
+			auto it = byCcc.find(ccc);
+			return it == byCcc.cend() ? nullptr : it->second;
+		}
+
+	private:
+		struct Node {
+			Node () {
+				fill(begin(children), end(children), -1);
+			}
+
+			int children[10];
+			int count = 0; // Number of codes going through this node.
+			int ccc = -1; // Code of the last one, relevant when it is alone.
+		};
+
+		void addToTrie (const string &ccc) {
+			if (ccc.empty() || ccc.find_first_not_of("0123456789") != string::npos)
+				return;
+
+			int value = Utils::stoi(ccc);
+			size_t node = 0;
+			for (char c : ccc) {
+				int &child = nodes[node].children[c - '0'];
+				if (child < 0) {
+					child = int(nodes.size());
+					nodes.emplace_back();
+				}
+				node = size_t(child);
+				nodes[node].count++;
+				nodes[node].ccc = value;
+			}
+		}
+
+		vector<Node> nodes;
+		unordered_map<string, shared_ptr<DialPlan>> byCcc;
+		unordered_map<string, shared_ptr<DialPlan>> byIso;
+	};
+
+	const DialPlanIndex &getDialPlanIndex () {
+		static const DialPlanIndex index(DialPlan::getAllDialPlans());
+		return index;
+	}
+}
+
+// -----------------------------------------------------------------------------
+
 int DialPlan::lookupCccFromE164 (const string &e164) {
 	if (e164[0] != '+')
 		return -1; // Not an e164 number.
@@ -333,34 +419,12 @@ int DialPlan::lookupCccFromE164 (const string &e164) {
 	if (e164[1] == '1')
 		return 1;
 
-	shared_ptr<DialPlan> electedDialPlan;
-	unsigned int found;
-	unsigned int i = 0;
-
-	do {
-		found = 0;
-		i++;
-		for (const auto &dp : DialPlans) {
-			if (strncmp(dp->getCountryCallingCode().c_str(), &e164[1], i) == 0) {
-				electedDialPlan = dp;
-				found++;
-			}
-		}
-	} while ((found > 1 || found == 0) && i < e164.length() - 1);
-
-	if (found == 1)
-		return Utils::stoi(electedDialPlan->getCountryCallingCode());
-
-	return -1;
+	return getDialPlanIndex().lookupCcc(e164.c_str() + 1);
 }
 
 int DialPlan::lookupCccFromIso (const string &iso) {
-	for (const auto &dp : DialPlans) {
-		if (dp->getIsoCountryCode() == iso)
-			return Utils::stoi(dp->getCountryCallingCode());
-	}
-
-	return -1;
+	shared_ptr<DialPlan> dp = getDialPlanIndex().findByIso(iso);
+	return dp ? Utils::stoi(dp->getCountryCallingCode()) : -1;
 }
 
 shared_ptr<DialPlan> DialPlan::findByCcc (int ccc) {
@@ -371,13 +435,10 @@ shared_ptr<DialPlan> DialPlan::findByCcc (const string &ccc) {
 	if (ccc.empty())
 		return MostCommon;
 
-	for (const auto &dp : DialPlans) {
-		if (dp->getCountryCallingCode() == ccc)
-			return dp;
-	}
+	shared_ptr<DialPlan> dp = getDialPlanIndex().findByCcc(ccc);
 
-	// Return a generic "most common" dial plan.
-	return MostCommon;
+	// Return a generic "most common" dial plan if none matches.
+	return dp ? dp : MostCommon;
 }
 
 const list<shared_ptr<DialPlan>> &DialPlan::getAllDialPlans () {
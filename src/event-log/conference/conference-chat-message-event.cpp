@@ -21,6 +21,7 @@
 #include "chat/chat-room/chat-room.h"
 #include "conference-chat-message-event.h"
 #include "conference-event-p.h"
+#include "object/object-pool.h"
 
 // =============================================================================
 
@@ -37,6 +38,8 @@ static inline ConferenceId getSafeConferenceId (const shared_ptr<const AbstractC
 class ConferenceChatMessageEventPrivate : public ConferenceEventPrivate {
 public:
 	shared_ptr<ChatMessage> chatMessage;
+
+	L_USE_OBJECT_POOL
 };
 
 // -----------------------------------------------------------------------------
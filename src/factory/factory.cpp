@@ -127,7 +127,12 @@ LinphoneCore *Factory::_createCore (
 	bool_t automatically_start
 ) const {
 		bctbx_init_logger(FALSE);
-		LpConfig *config = linphone_config_new_with_factory(config_path, factory_config_path);
+		LpConfig *config;
+		if (mConfigSnapshotEnabled && config_path && config_path[0] != '\0') {
+			std::string snapshotPath = std::string(config_path) + ".snapshot";
+			config = linphone_config_new_with_snapshot(config_path, factory_config_path, snapshotPath.c_str());
+		} else
+			config = linphone_config_new_with_factory(config_path, factory_config_path);
 		LinphoneCore *lc = _linphone_core_new_with_config(cbs, config, user_data, system_context, automatically_start);
 		linphone_config_unref(config);
 		bctbx_uninit_logger();
@@ -469,6 +474,14 @@ void Factory::enableLogCollection(LinphoneLogCollectionState state) const {
 	linphone_core_enable_log_collection(state);
 }
 
+void Factory::enableConfigSnapshot(bool enable) {
+	mConfigSnapshotEnabled = enable;
+}
+
+bool_t Factory::isConfigSnapshotEnabled() const {
+	return mConfigSnapshotEnabled;
+}
+
 LinphoneTunnelConfig* Factory::createTunnelConfig() const {
 	return linphone_tunnel_config_new();
 }
@@ -202,6 +202,10 @@ public:
 
   void enableLogCollection(LinphoneLogCollectionState state) const;
 
+  void enableConfigSnapshot(bool enable);
+
+  bool_t isConfigSnapshotEnabled() const;
+
   LinphoneTunnelConfig *createTunnelConfig() const;
 
   LinphoneLoggingServiceCbs *createLoggingServiceCbs() const;
@@ -263,6 +267,7 @@ private:
   /* the EVFS encryption key */
   std::shared_ptr<std::vector<uint8_t>> mEvfsMasterKey; // use a shared_ptr as _LinphoneFactory is not really an object and vector destructor end up never being called otherwise
   void *mUserData;
+  bool mConfigSnapshotEnabled = false;
 };
 LINPHONE_END_NAMESPACE
 
@@ -23,7 +23,7 @@
 #include "c-wrapper/internal/c-tools.h"
 #include "conference/session/streams.h"
 #include "conference/session/media-session-p.h"
-#include "utils/if-addrs.h"
+#include "core/core-p.h"
 
 using namespace::std;
 
@@ -179,7 +179,7 @@ LinphoneCore *IceService::getCCore()const{
 }
 
 void IceService::gatherLocalCandidates(){
-	list<string> localAddrs = IfAddrs::fetchLocalAddresses();
+	const list<string> &localAddrs = mStreamsGroup.getCore().getPrivate()->getLocalAddresses();
 	bool ipv6Allowed = linphone_core_ipv6_enabled(getCCore());
 	
 	const auto & streams = mStreamsGroup.getStreams();
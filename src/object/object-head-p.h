@@ -30,6 +30,12 @@
 	void CLASS::setCBackPtr (void *cBackPtr) { \
 		L_D(); \
 		d->cBackPtr = cBackPtr; \
+	} \
+	void *CLASS::getCUserData () const { \
+		return mCUserData; \
+	} \
+	void CLASS::setCUserData (void *cUserData) { \
+		mCUserData = cUserData; \
 	}
 
 #define L_OBJECT_PRIVATE \
@@ -22,8 +22,12 @@
 
 // =============================================================================
 
+// The C user data is held by each public object, like its properties, not shared with its clones.
 #define L_OBJECT \
 	void *getCBackPtr () const; \
-	void setCBackPtr (void *cBackPtr);
+	void setCBackPtr (void *cBackPtr); \
+	void *getCUserData () const; \
+	void setCUserData (void *cUserData); \
+	void *mCUserData = nullptr;
 
 #endif // ifndef _L_OBJECT_HEAD_H_
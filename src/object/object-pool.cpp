@@ -0,0 +1,222 @@
+/*
+ * Copyright (c) 2010-2019 Belledonne Communications SARL.
+ *
+ * This file is part of Liblinphone.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <new>
+
+#include "object-pool.h"
+
+// =============================================================================
+
+using namespace std;
+
+LINPHONE_BEGIN_NAMESPACE
+
+namespace {
+	constexpr size_t BlocksPerChunk = 128;
+
+	atomic<bool> PoolsEnabled(true);
+
+	thread_local ObjectPool *CurrentPool = nullptr;
+
+	constexpr size_t getAlignedSize (size_t size) {
+		return (size + alignof(max_align_t) - 1) / alignof(max_align_t) * alignof(max_align_t);
+	}
+
+	// Every block starts with the chunk it belongs to, null for the blocks taken from the heap.
+	constexpr size_t BlockHeaderSize = getAlignedSize(sizeof(void *));
+
+	inline void *&getBlockOwner (void *block) {
+		return *static_cast<void **>(block);
+	}
+}
+
+// -----------------------------------------------------------------------------
+
+ObjectPool::Scope::Scope (ObjectPool *pool) : mPrevious(CurrentPool) {
+	CurrentPool = pool;
+}
+
+ObjectPool::Scope::~Scope () {
+	CurrentPool = mPrevious;
+}
+
+// -----------------------------------------------------------------------------
+
+ObjectPool::ObjectPool () {}
+
+ObjectPool::~ObjectPool () {
+	// No block is in use anymore: every chunk is in the list of available chunks of its size.
+	for (auto &entry : mSizeClasses) {
+		while (entry.second.available)
+			freeChunk(entry.second.available);
+	}
+}
+
+void ObjectPool::release () {
+	bool destroy;
+	{
+		lock_guard<mutex> lock(mMutex);
+		mReleased = true;
+		destroy = mUsedBlockCount == 0;
+	}
+	if (destroy)
+		delete this;
+}
+
+size_t ObjectPool::getUsedBlockCount () const {
+	lock_guard<mutex> lock(mMutex);
+	return mUsedBlockCount;
+}
+
+size_t ObjectPool::getChunkCount () const {
+	lock_guard<mutex> lock(mMutex);
+	return mChunkCount;
+}
+
+uint64_t ObjectPool::getAllocationCount () const {
+	lock_guard<mutex> lock(mMutex);
+	return mAllocationCount;
+}
+
+void *ObjectPool::allocate (size_t size) {
+	ObjectPool *pool = CurrentPool;
+	if (pool && PoolsEnabled)
+		return pool->allocateBlock(size);
+
+	void *block = ::operator new(BlockHeaderSize + size);
+	getBlockOwner(block) = nullptr;
+	return static_cast<char *>(block) + BlockHeaderSize;
+}
+
+void ObjectPool::deallocate (void *ptr) {
+	if (!ptr)
+		return;
+
+	void *block = static_cast<char *>(ptr) - BlockHeaderSize;
+	Chunk *chunk = static_cast<Chunk *>(getBlockOwner(block));
+	if (!chunk) {
+		::operator delete(block);
+		return;
+	}
+
+	ObjectPool *pool = chunk->sizeClass->pool;
+	if (pool->deallocateBlock(chunk, block))
+		delete pool;
+}
+
+bool ObjectPool::isEnabled () {
+	return PoolsEnabled;
+}
+
+void ObjectPool::setEnabled (bool enabled) {
+	PoolsEnabled = enabled;
+}
+
+// -----------------------------------------------------------------------------
+
+void *ObjectPool::allocateBlock (size_t size) {
+	lock_guard<mutex> lock(mMutex);
+
+	auto it = mSizeClasses.find(size);
+	if (it == mSizeClasses.end())
+		it = mSizeClasses.emplace(size, SizeClass{ this, BlockHeaderSize + getAlignedSize(max(size, sizeof(FreeBlock))), nullptr, 0 }).first;
+	SizeClass &sizeClass = it->second;
+	if (!sizeClass.available)
+		grow(sizeClass);
+
+	Chunk *chunk = sizeClass.available;
+	FreeBlock *block = chunk->freeBlocks;
+	chunk->freeBlocks = block->next;
+	if (chunk->usedBlocks++ == 0)
+		sizeClass.emptyChunks--;
+	if (!chunk->freeBlocks)
+		unlinkChunk(sizeClass, chunk);
+
+	mUsedBlockCount++;
+	mAllocationCount++;
+	getBlockOwner(block) = chunk;
+	return reinterpret_cast<char *>(block) + BlockHeaderSize;
+}
+
+bool ObjectPool::deallocateBlock (Chunk *chunk, void *block) {
+	lock_guard<mutex> lock(mMutex);
+
+	SizeClass &sizeClass = *chunk->sizeClass;
+	if (!chunk->freeBlocks)
+		linkChunk(sizeClass, chunk);
+	FreeBlock *freeBlock = static_cast<FreeBlock *>(block);
+	freeBlock->next = chunk->freeBlocks;
+	chunk->freeBlocks = freeBlock;
+	mUsedBlockCount--;
+
+	if (--chunk->usedBlocks == 0) {
+		// One empty chunk is kept so that a steady load does not allocate and free the same chunk again and again.
+		if (sizeClass.emptyChunks > 0 || mReleased)
+			freeChunk(chunk);
+		else
+			sizeClass.emptyChunks++;
+	}
+	return mReleased && mUsedBlockCount == 0;
+}
+
+void ObjectPool::grow (SizeClass &sizeClass) {
+	constexpr size_t chunkHeaderSize = getAlignedSize(sizeof(Chunk));
+	char *memory = static_cast<char *>(::operator new(chunkHeaderSize + sizeClass.blockSize * BlocksPerChunk));
+	Chunk *chunk = new (memory) Chunk{ &sizeClass, nullptr, 0, nullptr, nullptr };
+
+	// Thread the new blocks in address order.
+	for (size_t i = BlocksPerChunk; i > 0; i--) {
+		FreeBlock *block = reinterpret_cast<FreeBlock *>(memory + chunkHeaderSize + (i - 1) * sizeClass.blockSize);
+		block->next = chunk->freeBlocks;
+		chunk->freeBlocks = block;
+	}
+	linkChunk(sizeClass, chunk);
+	sizeClass.emptyChunks++;
+	mChunkCount++;
+}
+
+void ObjectPool::freeChunk (Chunk *chunk) {
+	SizeClass &sizeClass = *chunk->sizeClass;
+	unlinkChunk(sizeClass, chunk);
+	chunk->~Chunk();
+	::operator delete(chunk);
+	mChunkCount--;
+}
+
+void ObjectPool::linkChunk (SizeClass &sizeClass, Chunk *chunk) {
+	chunk->prev = nullptr;
+	chunk->next = sizeClass.available;
+	if (sizeClass.available)
+		sizeClass.available->prev = chunk;
+	sizeClass.available = chunk;
+}
+
+void ObjectPool::unlinkChunk (SizeClass &sizeClass, Chunk *chunk) {
+	if (chunk->prev)
+		chunk->prev->next = chunk->next;
+	else
+		sizeClass.available = chunk->next;
+	if (chunk->next)
+		chunk->next->prev = chunk->prev;
+	chunk->prev = chunk->next = nullptr;
+}
+
+LINPHONE_END_NAMESPACE
@@ -0,0 +1,163 @@
+/*
+ * Copyright (c) 2010-2019 Belledonne Communications SARL.
+ *
+ * This file is part of Liblinphone.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _L_OBJECT_POOL_H_
+#define _L_OBJECT_POOL_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+
+#include "linphone/utils/general.h"
+
+// =============================================================================
+
+LINPHONE_BEGIN_NAMESPACE
+
+// Arena of fixed size blocks owned by a core, for the objects it creates in large numbers (history loading).
+// Blocks are carved out of chunks, one list of chunks per block size. A chunk is given back to the system
+// once all its blocks are free, except the last free one of each size.
+// Objects may outlive their core: a released arena is only destroyed when its last block is freed.
+class LINPHONE_PUBLIC ObjectPool {
+public:
+	// Pooled objects created by the current thread are taken from the arena of the innermost scope.
+	class Scope {
+	public:
+		explicit Scope (ObjectPool *pool);
+		~Scope ();
+
+	private:
+		ObjectPool *mPrevious;
+
+		L_DISABLE_COPY(Scope);
+	};
+
+	// To own an arena with a std::unique_ptr.
+	struct Releaser {
+		void operator() (ObjectPool *pool) const {
+			pool->release();
+		}
+	};
+
+	ObjectPool ();
+
+	void release ();
+
+	std::size_t getUsedBlockCount () const;
+	std::size_t getChunkCount () const;
+	// Number of blocks handed out since the creation of the arena.
+	std::uint64_t getAllocationCount () const;
+
+	// Allocates from the arena of the current scope if any and if pools are enabled, from the heap otherwise.
+	static void *allocate (std::size_t size);
+	static void deallocate (void *ptr);
+
+	static bool isEnabled ();
+	static void setEnabled (bool enabled);
+
+private:
+	struct FreeBlock {
+		FreeBlock *next;
+	};
+
+	struct SizeClass;
+
+	struct Chunk {
+		SizeClass *sizeClass;
+		FreeBlock *freeBlocks;
+		std::size_t usedBlocks;
+		// Links of the chunks of the size class having free blocks.
+		Chunk *prev;
+		Chunk *next;
+	};
+
+	struct SizeClass {
+		ObjectPool *pool;
+		std::size_t blockSize;
+		Chunk *available;
+		std::size_t emptyChunks;
+	};
+
+	~ObjectPool ();
+
+	void *allocateBlock (std::size_t size);
+	// Returns true if the arena was released and this was its last block.
+	bool deallocateBlock (Chunk *chunk, void *block);
+
+	void grow (SizeClass &sizeClass);
+	void freeChunk (Chunk *chunk);
+
+	static void linkChunk (SizeClass &sizeClass, Chunk *chunk);
+	static void unlinkChunk (SizeClass &sizeClass, Chunk *chunk);
+
+	mutable std::mutex mMutex;
+	std::map<std::size_t, SizeClass> mSizeClasses;
+	std::size_t mUsedBlockCount = 0;
+	std::size_t mChunkCount = 0;
+	std::uint64_t mAllocationCount = 0;
+	bool mReleased = false;
+
+	L_DISABLE_COPY(ObjectPool);
+};
+
+// Allocator to give to std::allocate_shared, the control block is then taken from the current arena.
+template<typename T>
+class ObjectPoolAllocator {
+public:
+	using value_type = T;
+
+	ObjectPoolAllocator () = default;
+
+	template<typename U>
+	ObjectPoolAllocator (const ObjectPoolAllocator<U> &) {}
+
+	T *allocate (std::size_t n) {
+		static_assert(alignof(T) <= alignof(std::max_align_t), "Over-aligned types cannot be pooled.");
+		return static_cast<T *>(ObjectPool::allocate(n * sizeof(T)));
+	}
+
+	void deallocate (T *ptr, std::size_t) {
+		ObjectPool::deallocate(ptr);
+	}
+
+	template<typename U>
+	bool operator== (const ObjectPoolAllocator<U> &) const {
+		return true;
+	}
+
+	template<typename U>
+	bool operator!= (const ObjectPoolAllocator<U> &) const {
+		return false;
+	}
+};
+
+LINPHONE_END_NAMESPACE
+
+// Allocates the objects of a class from the current arena, to use in a public section. Every block records
+// where it comes from, so objects allocated out of any scope and objects of derived classes are freed correctly.
+#define L_USE_OBJECT_POOL \
+	static void *operator new (std::size_t size) { \
+		return LinphonePrivate::ObjectPool::allocate(size); \
+	} \
+	static void operator delete (void *ptr) { \
+		LinphonePrivate::ObjectPool::deallocate(ptr); \
+	}
+
+#endif // ifndef _L_OBJECT_POOL_H_
@@ -17,6 +17,8 @@
  * along with this program. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <cctype>
+
 #include "c-wrapper/internal/c-tools.h"
 #include "c-wrapper/internal/c-sal.h"
 #include "sal/sal_stream_bundle.h"
@@ -144,34 +146,83 @@ bool_t OfferAnswerEngine::onlyTelephoneEvent(const std::list<OrtpPayloadType*> &
 	return TRUE;
 }
 
-PayloadType * OfferAnswerEngine::genericMatch(const std::list<OrtpPayloadType*> & local_payloads, const PayloadType *refpt, const std::list<OrtpPayloadType*> & remote_payloads){
-	for (const auto & pt : local_payloads) {
-		
-		if ( pt->mime_type && refpt->mime_type 
-			&& strcasecmp(pt->mime_type, refpt->mime_type)==0
-			&& pt->clock_rate==refpt->clock_rate
-			&& pt->channels==refpt->channels)
-			return payload_type_clone(pt);
-	}
-	return NULL;
+/*
+ * Local payload types by mime type (case insensitive), clock rate and number of channels, in an open addressing table.
+ * Matching the remote payload types against it is then linear in the size of the remote list.
+ */
+class OfferAnswerEngine::PayloadTypeIndex {
+	public:
+		explicit PayloadTypeIndex(const std::list<OrtpPayloadType*> & payloads) {
+			size_t size = 8;
+			while (size < payloads.size() * 2)
+				size <<= 1;
+			mSlots.resize(size, nullptr);
+			mMask = size - 1;
+
+			for (const auto & pt : payloads) {
+				if (!pt->mime_type)
+					continue;
+				size_t i = hash(pt) & mMask;
+				while (mSlots[i] && !isSame(mSlots[i], pt))
+					i = (i + 1) & mMask;
+				/* As with a linear search, the first of the equivalent payload types wins. */
+				if (!mSlots[i])
+					mSlots[i] = pt;
+			}
+		}
+
+		OrtpPayloadType *find(const PayloadType *refpt) const {
+			if (!refpt->mime_type)
+				return nullptr;
+			for (size_t i = hash(refpt) & mMask; mSlots[i]; i = (i + 1) & mMask) {
+				if (isSame(mSlots[i], refpt))
+					return mSlots[i];
+			}
+			return nullptr;
+		}
+
+	private:
+		static size_t hash(const PayloadType *pt) {
+			/* FNV-1a over the lowercased mime type, then the clock rate and the number of channels. */
+			uint32_t h = 2166136261u;
+			for (const char *c = pt->mime_type; *c != '\0'; c++)
+				h = (h ^ (uint32_t)tolower((unsigned char)*c)) * 16777619u;
+			h = (h ^ (uint32_t)pt->clock_rate) * 16777619u;
+			h = (h ^ (uint32_t)pt->channels) * 16777619u;
+			return h;
+		}
+
+		static bool isSame(const PayloadType *pt1, const PayloadType *pt2) {
+			return pt1->clock_rate == pt2->clock_rate
+				&& pt1->channels == pt2->channels
+				&& strcasecmp(pt1->mime_type, pt2->mime_type) == 0;
+		}
+
+		std::vector<OrtpPayloadType*> mSlots;
+		size_t mMask;
+};
+
+PayloadType * OfferAnswerEngine::genericMatch(const PayloadTypeIndex & local_index, const PayloadType *refpt){
+	PayloadType *pt = local_index.find(refpt);
+	return pt ? payload_type_clone(pt) : NULL;
 }
 
 /*
  * Returns a PayloadType from the local list that matches a PayloadType offered or answered in the remote list
 */
-PayloadType * OfferAnswerEngine::findPayloadTypeBestMatch(MSFactory *factory, const std::list<OrtpPayloadType*> & local_payloads, const PayloadType *refpt,
-						  const std::list<OrtpPayloadType*> & remote_payloads, bool_t reading_response){
+PayloadType * OfferAnswerEngine::findPayloadTypeBestMatch(MSFactory *factory, const PayloadTypeIndex & local_index, const bctbx_list_t *local_payloads,
+						  const PayloadType *refpt, const bctbx_list_t *remote_payloads, bool_t reading_response){
 	PayloadType *ret = NULL;
 	MSOfferAnswerContext *ctx = NULL;
 
 	// When a stream is inactive, refpt->mime_type might be null
 	if (refpt->mime_type && (ctx = ms_factory_create_offer_answer_context(factory, refpt->mime_type))) {
 		ms_message("Doing offer/answer processing with specific provider for codec [%s]", refpt->mime_type); 
-		ret = ms_offer_answer_context_match_payload(ctx, Utils::listToBctbxList(local_payloads), refpt, Utils::listToBctbxList(remote_payloads), reading_response);
+		ret = ms_offer_answer_context_match_payload(ctx, local_payloads, refpt, remote_payloads, reading_response);
 		ms_offer_answer_context_destroy(ctx);
 		return ret;
 	}
-	return OfferAnswerEngine::genericMatch(local_payloads, refpt, remote_payloads);
+	return OfferAnswerEngine::genericMatch(local_index, refpt);
 }
 
 
@@ -179,9 +230,13 @@ std::list<OrtpPayloadType*> OfferAnswerEngine::matchPayloads(MSFactory *factory,
 	std::list<OrtpPayloadType*> res;
 	PayloadType *matched;
 	bool_t found_codec=FALSE;
+	const PayloadTypeIndex local_index(local);
+	/* For the codec specific providers. */
+	bctbx_list_t *local_list = Utils::listToBctbxList(local);
+	bctbx_list_t *remote_list = Utils::listToBctbxList(remote);
 
 	for (const auto & p2 : remote) {
-		matched=OfferAnswerEngine::findPayloadTypeBestMatch(factory, local, p2, remote, reading_response);
+		matched=OfferAnswerEngine::findPayloadTypeBestMatch(factory, local_index, local_list, p2, remote_list, reading_response);
 		if (matched){
 			int local_number=payload_type_get_number(matched);
 			int remote_number=payload_type_get_number(p2);
@@ -234,6 +289,8 @@ std::list<OrtpPayloadType*> OfferAnswerEngine::matchPayloads(MSFactory *factory,
 			else ms_message("No match for %s/%i",p2->mime_type,p2->clock_rate);
 		}
 	}
+	bctbx_list_free(local_list);
+	bctbx_list_free(remote_list);
 	if (reading_response){
 		/* add remaning local payload as CAN_RECV only so that if we are in front of a non-compliant equipment we are still able to decode the RTP stream*/
 		for (const auto & p1 : local) {
@@ -36,7 +36,7 @@ LINPHONE_BEGIN_NAMESPACE
 
 class SalMediaDescription;
 
-class OfferAnswerEngine {
+class LINPHONE_PUBLIC OfferAnswerEngine {
 
 	public:
 		/**
@@ -57,6 +57,7 @@ class OfferAnswerEngine {
 							std::shared_ptr<SalMediaDescription> result, bool_t one_matching_codec);
 
 	private:
+		class PayloadTypeIndex;
 
 		static bool_t onlyTelephoneEvent(const std::list<OrtpPayloadType*> & l);
 		static bool areProtoCompatibles(SalMediaProto localProto, SalMediaProto otherProto);
@@ -64,8 +65,8 @@ class OfferAnswerEngine {
 		static SalStreamDir computeDirOutgoing(SalStreamDir local, SalStreamDir answered);
 		static bool_t matchCryptoAlgo(const std::vector<SalSrtpCryptoAlgo> &local, const std::vector<SalSrtpCryptoAlgo> &remote, SalSrtpCryptoAlgo & result, unsigned int* choosen_local_tag, bool_t use_local_key);
 		static std::list<OrtpPayloadType*> matchPayloads(MSFactory *factory, const std::list<OrtpPayloadType*> & local, const std::list<OrtpPayloadType*> & remote, bool_t reading_response, bool_t one_matching_codec);
-		static PayloadType * genericMatch(const std::list<OrtpPayloadType*> & local_payloads, const PayloadType *refpt, const std::list<OrtpPayloadType*> & remote_payloads);
-		static PayloadType * findPayloadTypeBestMatch(MSFactory *factory, const std::list<OrtpPayloadType*> & local_payloads, const PayloadType *refpt, const std::list<OrtpPayloadType*> & remote_payloads, bool_t reading_response);
+		static PayloadType * genericMatch(const PayloadTypeIndex & local_index, const PayloadType *refpt);
+		static PayloadType * findPayloadTypeBestMatch(MSFactory *factory, const PayloadTypeIndex & local_index, const bctbx_list_t *local_payloads, const PayloadType *refpt, const bctbx_list_t *remote_payloads, bool_t reading_response);
 
 		static void initiateIncomingStream(MSFactory *factory, const SalStreamDescription & local_cap, const SalStreamDescription & remote_offer, SalStreamDescription & result, bool_t one_matching_codec, const char *bundle_owner_mid);
 
@@ -412,6 +412,15 @@ Sal::Sal (MSFactory *factory) : mFactory(factory) {
 }
 
 Sal::~Sal () {
+	for (auto &p : mDnsCache) {
+		DnsCacheEntry &entry = p.second;
+		if (entry.context) {
+			belle_sip_resolver_context_cancel(entry.context);
+			belle_sip_object_unref(entry.context);
+		}
+		if (entry.results)
+			belle_sip_object_unref(entry.results);
+	}
 	belle_sip_object_unref(mUserAgentHeader);
 	belle_sip_object_unref(mProvider);
 	belle_sip_object_unref(mStack);
@@ -812,10 +821,12 @@ void Sal::enableNatHelper (bool enable) {
 
 void Sal::setDnsServers (const bctbx_list_t *servers) {
 	belle_sip_stack_set_dns_servers(mStack, servers);
+	clearDnsCache();
 }
 
 void Sal::setDnsUserHostsFile (const string &value) {
 	belle_sip_stack_set_dns_user_hosts_file(mStack, value.c_str());
+	clearDnsCache();
 }
 
 const string &Sal::getDnsUserHostsFile () const {
@@ -823,12 +834,176 @@ const string &Sal::getDnsUserHostsFile () const {
 	return mDnsUserHostsFile;
 }
 
+static string getDnsCacheKey (const string &service, const string &transport, const string &name, int port, int family) {
+	return service + ":" + transport + ":" + name + ":" + to_string(port) + ":" + to_string(family);
+}
+
 belle_sip_resolver_context_t *Sal::resolveA (const string &name, int port, int family, belle_sip_resolver_callback_t cb, void *data) {
-	return belle_sip_stack_resolve_a(mStack, L_STRING_TO_C(name), port, family, cb, data);
+	if (!mDnsCacheEnabled)
+		return belle_sip_stack_resolve_a(mStack, L_STRING_TO_C(name), port, family, cb, data);
+
+	return resolveWithCache(
+		getDnsCacheKey("A", "", name, port, family),
+		[this, &name, port, family] (belle_sip_resolver_callback_t queryCb, void *queryData) {
+			return belle_sip_stack_resolve_a(mStack, L_STRING_TO_C(name), port, family, queryCb, queryData);
+		},
+		cb, data
+	);
 }
 
 belle_sip_resolver_context_t *Sal::resolve (const string &service, const string &transport, const string &name, int port, int family, belle_sip_resolver_callback_t cb, void *data) {
-	return belle_sip_stack_resolve(mStack, L_STRING_TO_C(service), L_STRING_TO_C(transport), L_STRING_TO_C(name), port, family, cb, data);
+	if (!mDnsCacheEnabled)
+		return belle_sip_stack_resolve(mStack, L_STRING_TO_C(service), L_STRING_TO_C(transport), L_STRING_TO_C(name), port, family, cb, data);
+
+	return resolveWithCache(
+		getDnsCacheKey(service, transport, name, port, family),
+		[this, &service, &transport, &name, port, family] (belle_sip_resolver_callback_t queryCb, void *queryData) {
+			return belle_sip_stack_resolve(mStack, L_STRING_TO_C(service), L_STRING_TO_C(transport), L_STRING_TO_C(name), port, family, queryCb, queryData);
+		},
+		cb, data
+	);
+}
+
+belle_sip_resolver_context_t *Sal::resolveWithCache (const string &key, const DnsQuery &query, belle_sip_resolver_callback_t cb, void *data) {
+	uint64_t now = bctbx_get_cur_time_ms();
+
+	auto it = mDnsCache.find(key);
+	if (it != mDnsCache.end()) {
+		DnsCacheEntry &entry = it->second;
+		if (entry.results && now < entry.expires) {
+			mDnsCacheHits++;
+			cb(data, entry.results);
+			return nullptr;
+		}
+		if (entry.context) {
+			mDnsCacheHits++;
+			entry.waiters.push_back({ cb, data });
+			return entry.context;
+		}
+	} else {
+		// Forget the expired entries before adding a new one. The successful answers are kept for getCachedResults()
+		// until they are too old to be used.
+		for (auto cacheIt = mDnsCache.begin(); cacheIt != mDnsCache.end();) {
+			DnsCacheEntry &entry = cacheIt->second;
+			if (!entry.context && now >= entry.expires && !isDnsCacheAnswerUsable(entry, now)) {
+				if (entry.results)
+					belle_sip_object_unref(entry.results);
+				cacheIt = mDnsCache.erase(cacheIt);
+			} else
+				++cacheIt;
+		}
+		it = mDnsCache.emplace(key, DnsCacheEntry()).first;
+		it->second.sal = this;
+	}
+
+	mDnsCacheMisses++;
+	DnsCacheEntry &entry = it->second;
+	entry.waiters.push_back({ cb, data });
+	// If the answer is known at once, the waiters have already been notified.
+	belle_sip_resolver_context_t *context = query(onDnsCacheQueryDone, &entry);
+	if (context)
+		entry.context = (belle_sip_resolver_context_t *)belle_sip_object_ref(context);
+	return context;
+}
+
+void Sal::onDnsCacheQueryDone (void *data, belle_sip_resolver_results_t *results) {
+	DnsCacheEntry *entry = static_cast<DnsCacheEntry *>(data);
+	Sal *sal = entry->sal;
+
+	bool succeeded = !!belle_sip_resolver_results_get_addrinfos(results);
+	// A previous answer is kept, expired, until a query succeeds or it gets too old.
+	if (succeeded || !sal->isDnsCacheAnswerUsable(*entry, bctbx_get_cur_time_ms())) {
+		if (entry->results)
+			belle_sip_object_unref(entry->results);
+		entry->results = nullptr;
+		entry->expires = 0;
+		int ttl = succeeded ? belle_sip_resolver_results_get_ttl(results) : sal->mDnsCacheNegativeTtl;
+		if (succeeded && ttl <= 0)
+			ttl = sal->mDnsCacheDefaultTtl;
+		if (ttl > 0) {
+			entry->results = (belle_sip_resolver_results_t *)belle_sip_object_ref(results);
+			entry->expires = bctbx_get_cur_time_ms() + uint64_t(ttl) * 1000;
+		}
+	}
+	if (entry->context) {
+		belle_sip_object_unref(entry->context);
+		entry->context = nullptr;
+	}
+
+	// The entry may be dropped by a callback starting a new lookup.
+	list<DnsCacheWaiter> waiters;
+	waiters.swap(entry->waiters);
+	belle_sip_object_ref(results);
+	for (const auto &waiter : waiters)
+		waiter.cb(waiter.data, results);
+	belle_sip_object_unref(results);
+}
+
+void Sal::cancelResolve (belle_sip_resolver_context_t *context, void *data) {
+	for (auto &p : mDnsCache) {
+		DnsCacheEntry &entry = p.second;
+		if (entry.context != context)
+			continue;
+
+		entry.waiters.remove_if([data] (const DnsCacheWaiter &waiter) { return waiter.data == data; });
+		// The query goes on as long as another lookup waits for it.
+		if (entry.waiters.empty()) {
+			belle_sip_resolver_context_cancel(entry.context);
+			belle_sip_object_unref(entry.context);
+			entry.context = nullptr;
+		}
+		return;
+	}
+	belle_sip_resolver_context_cancel(context);
+}
+
+bool Sal::isDnsCacheAnswerUsable (const DnsCacheEntry &entry, uint64_t now) const {
+	if (!entry.results || !belle_sip_resolver_results_get_addrinfos(entry.results))
+		return false;
+	return now < entry.expires + uint64_t(max(mDnsCacheMaxStale, 0)) * 1000;
+}
+
+belle_sip_resolver_results_t *Sal::findCachedResults (const string &key, bool *expired) const {
+	auto it = mDnsCache.find(key);
+	if (it == mDnsCache.end())
+		return nullptr;
+
+	const DnsCacheEntry &entry = it->second;
+	uint64_t now = bctbx_get_cur_time_ms();
+	if (!isDnsCacheAnswerUsable(entry, now))
+		return nullptr;
+	if (expired)
+		*expired = now >= entry.expires;
+	return entry.results;
+}
+
+belle_sip_resolver_results_t *Sal::getCachedResultsA (const string &name, int port, int family, bool *expired) const {
+	return findCachedResults(getDnsCacheKey("A", "", name, port, family), expired);
+}
+
+belle_sip_resolver_results_t *Sal::getCachedResults (const string &service, const string &transport, const string &name, int port, int family, bool *expired) const {
+	return findCachedResults(getDnsCacheKey(service, transport, name, port, family), expired);
+}
+
+void Sal::enableDnsCache (bool value) {
+	mDnsCacheEnabled = value;
+	if (!value)
+		clearDnsCache();
+}
+
+void Sal::clearDnsCache () {
+	// Queries in progress are kept, their waiters must still be notified.
+	for (auto it = mDnsCache.begin(); it != mDnsCache.end();) {
+		DnsCacheEntry &entry = it->second;
+		if (entry.results) {
+			belle_sip_object_unref(entry.results);
+			entry.results = nullptr;
+		}
+		if (entry.context)
+			++it;
+		else
+			it = mDnsCache.erase(it);
+	}
 }
 
 belle_sip_source_t *Sal::createTimer (const std::function<bool ()> &something, unsigned int milliseconds, const string &name) {
@@ -1077,6 +1252,34 @@ LINPHONE_PUBLIC belle_sip_resolver_context_t *sal_resolve_a (Sal *sal, const cha
 	return sal->resolveA(name, port, family, cb, data);
 }
 
+LINPHONE_PUBLIC void sal_cancel_resolve (Sal *sal, belle_sip_resolver_context_t *context, void *data) {
+	sal->cancelResolve(context, data);
+}
+
+LINPHONE_PUBLIC unsigned int sal_get_dns_cache_hits (const Sal *sal) {
+	return sal->getDnsCacheHits();
+}
+
+LINPHONE_PUBLIC unsigned int sal_get_dns_cache_misses (const Sal *sal) {
+	return sal->getDnsCacheMisses();
+}
+
+LINPHONE_PUBLIC void sal_enable_dns_cache (Sal *sal, bool_t value) {
+	sal->enableDnsCache(!!value);
+}
+
+LINPHONE_PUBLIC void sal_set_dns_cache_max_stale (Sal *sal, int value) {
+	sal->setDnsCacheMaxStale(value);
+}
+
+LINPHONE_PUBLIC bool_t sal_has_cached_results_a (const Sal *sal, const char *name, int port, int family, bool_t *expired) {
+	bool isExpired = false;
+	bool found = !!sal->getCachedResultsA(name, port, family, &isExpired);
+	if (expired)
+		*expired = isExpired;
+	return found;
+}
+
 LINPHONE_PUBLIC Sal *sal_op_get_sal (SalOp *op) {
 	return op->getSal();
 }
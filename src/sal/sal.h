@@ -21,6 +21,7 @@
 #define _L_SAL_H_
 
 #include <list>
+#include <unordered_map>
 #include <vector>
 
 #include "sal/sal_stream_description.h"
@@ -262,8 +263,35 @@ public:
 	void setDnsUserHostsFile (const std::string &value);
 	const std::string &getDnsUserHostsFile () const;
 
+	// Answers are cached as long as their TTL, and concurrent lookups of the same name share one query: the callback
+	// may be called before these functions return, in which case they return nullptr. The returned context may be
+	// shared by several lookups, it must be cancelled with cancelResolve().
 	belle_sip_resolver_context_t *resolveA (const std::string &name, int port, int family, belle_sip_resolver_callback_t cb, void *data);
 	belle_sip_resolver_context_t *resolve (const std::string &service, const std::string &transport, const std::string &name, int port, int family, belle_sip_resolver_callback_t cb, void *data);
+	void cancelResolve (belle_sip_resolver_context_t *context, void *data);
+
+	// Last successful answer to a lookup, nullptr if there is none. It is kept once expired, for at most the max stale
+	// duration, until a new query succeeds or the cache is cleared, so that a caller unable to wait may still use it.
+	belle_sip_resolver_results_t *getCachedResultsA (const std::string &name, int port, int family, bool *expired) const;
+	belle_sip_resolver_results_t *getCachedResults (const std::string &service, const std::string &transport, const std::string &name, int port, int family, bool *expired) const;
+
+	// When disabled, every lookup is a new query and nothing is cached.
+	void enableDnsCache (bool value);
+	bool dnsCacheEnabled () const { return mDnsCacheEnabled; }
+	// Duration in seconds during which an answer without TTL is kept.
+	void setDnsCacheDefaultTtl (int value) { mDnsCacheDefaultTtl = value; }
+	int getDnsCacheDefaultTtl () const { return mDnsCacheDefaultTtl; }
+	// Duration in seconds during which a failed resolution is remembered.
+	void setDnsCacheNegativeTtl (int value) { mDnsCacheNegativeTtl = value; }
+	int getDnsCacheNegativeTtl () const { return mDnsCacheNegativeTtl; }
+	// Duration in seconds during which an expired answer may still be returned by getCachedResults().
+	void setDnsCacheMaxStale (int value) { mDnsCacheMaxStale = value; }
+	int getDnsCacheMaxStale () const { return mDnsCacheMaxStale; }
+	void clearDnsCache ();
+
+	// Lookups answered without a new query (cached answer or query already in progress), and queries sent.
+	unsigned int getDnsCacheHits () const { return mDnsCacheHits; }
+	unsigned int getDnsCacheMisses () const { return mDnsCacheMisses; }
 
 
 	// ---------------------------------------------------------------------------
@@ -293,6 +321,13 @@ private:
 	void removePendingAuth (SalOp *op);
 	belle_sip_response_t *createResponseFromRequest (belle_sip_request_t *req, int code);
 
+	struct DnsCacheEntry;
+	using DnsQuery = std::function<belle_sip_resolver_context_t *(belle_sip_resolver_callback_t cb, void *data)>;
+	belle_sip_resolver_context_t *resolveWithCache (const std::string &key, const DnsQuery &query, belle_sip_resolver_callback_t cb, void *data);
+	belle_sip_resolver_results_t *findCachedResults (const std::string &key, bool *expired) const;
+	bool isDnsCacheAnswerUsable (const DnsCacheEntry &entry, uint64_t now) const;
+	static void onDnsCacheQueryDone (void *data, belle_sip_resolver_results_t *results);
+
 	static void unimplementedStub() { lWarning() << "Unimplemented SAL callback"; }
 	static void removeListeningPoint (belle_sip_listening_point_t *lp,belle_sip_provider_t *prov) {
 		belle_sip_provider_remove_listening_point(prov, lp);
@@ -348,6 +383,27 @@ private:
 	belle_tls_crypto_config_postcheck_callback_t mTlsPostcheckCb;
 	void *mTlsPostcheckCbData;
 
+	struct DnsCacheWaiter {
+		belle_sip_resolver_callback_t cb;
+		void *data;
+	};
+
+	struct DnsCacheEntry {
+		Sal *sal = nullptr;
+		belle_sip_resolver_results_t *results = nullptr;
+		uint64_t expires = 0; // In ms, as given by bctbx_get_cur_time_ms().
+		belle_sip_resolver_context_t *context = nullptr; // Query in progress, if any.
+		std::list<DnsCacheWaiter> waiters;
+	};
+
+	bool mDnsCacheEnabled = true;
+	int mDnsCacheDefaultTtl = 300;
+	int mDnsCacheNegativeTtl = 30;
+	int mDnsCacheMaxStale = 3600;
+	unsigned int mDnsCacheHits = 0;
+	unsigned int mDnsCacheMisses = 0;
+	std::unordered_map<std::string, DnsCacheEntry> mDnsCache;
+
 	// Cache values
 	mutable std::string mDnsUserHostsFile;
 	mutable std::string mHttpProxyHost;
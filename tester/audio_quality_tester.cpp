@@ -24,6 +24,8 @@
 #include "content/content.h"
 #include "content/file-content.h"
 #include "core/core.h"
+#include "conference/session/mixers.h"
+#include "conference_private.h"
 
 // TODO: Remove me later.
 #include "private.h"
@@ -31,8 +33,11 @@
 #include "liblinphone_tester.h"
 #include "tester_utils.h"
 
+#include <ctime>
 #include <vector>
 #include <map>
+
+#include "mediastreamer2/msfileplayer.h"
 // =============================================================================
 
 using namespace std;
@@ -299,6 +304,140 @@ static void audio_call_test_audio_diff() {
 	bc_free(stereo_file);
 }
 
+/* CPU time, in ms, spent by the whole process for each 10 ms frame mixed during durationMs. */
+static double audio_conference_cpu_per_frame(int durationMs, AudioEndpointSelector *selector) {
+	clock_t start = clock();
+	for (int elapsed = 0; elapsed < durationMs; elapsed += 100) {
+		if (selector) selector->update();
+		ms_usleep(100000);
+	}
+	return (double)(clock() - start) * 1000 / CLOCKS_PER_SEC / (durationMs / 10);
+}
+
+static void audio_conference_mixing_benchmark() {
+	const int endpointsCount = 100;
+	const int talkersCount = 10;
+	LinphoneCore *lc = linphone_factory_create_core_3(linphone_factory_get(), NULL, liblinphone_tester_get_empty_rc(), system_context);
+	MSFactory *factory = linphone_core_get_ms_factory(lc);
+	char *hello = bc_tester_res("sounds/hello8000.wav");
+	MSAudioConferenceParams confParams;
+	memset(&confParams, 0, sizeof(confParams));
+	confParams.samplerate = 16000;
+	MSAudioConference *conference = ms_audio_conference_new(&confParams, factory);
+	RtpProfile *profile = rtp_profile_new("benchmark");
+	PayloadType *pt = payload_type_clone(&payload_type_l16_mono);
+	pt->clock_rate = confParams.samplerate;
+	rtp_profile_set_payload(profile, 0, pt);
+	AudioEndpointSelector selector(conference);
+	std::vector<AudioStream *> streams;
+	std::vector<AudioStream *> senders;
+	std::vector<MSAudioEndpoint *> endpoints;
+
+	/*
+	 * Only a few participants talk, the file players of the others have no file and stay silent.
+	 * The even endpoints are local ones, whose volume is the captured one. The odd endpoints are remote ones,
+	 * whose volume is the one received from the network: their talkers are played by a sender stream.
+	 */
+	for (int i = 0; i < endpointsCount; i++) {
+		bool isRemote = (i % 2) == 1;
+		bool isTalker = i < talkersCount;
+		AudioStream *st = audio_stream_new(factory, -1, -1, FALSE);
+		audio_stream_start_full(st, profile, "127.0.0.1", 9, "127.0.0.1", 9, 0, 40, isTalker && !isRemote ? hello : NULL, NULL, NULL, NULL, FALSE);
+		if (isTalker && !isRemote) {
+			int pauseMs = 0;
+			ms_filter_call_method(st->soundread, MS_FILE_PLAYER_LOOP, &pauseMs);
+		}
+		if (isTalker && isRemote) {
+			int port = rtp_session_get_local_port(st->ms.sessions.rtp_session);
+			AudioStream *sender = audio_stream_new(factory, -1, -1, FALSE);
+			audio_stream_start_full(sender, profile, "127.0.0.1", port, "127.0.0.1", port + 1, 0, 40, hello, NULL, NULL, NULL, FALSE);
+			int pauseMs = 0;
+			ms_filter_call_method(sender->soundread, MS_FILE_PLAYER_LOOP, &pauseMs);
+			senders.push_back(sender);
+		}
+		MSAudioEndpoint *ep = ms_audio_endpoint_get_from_stream(st, isRemote);
+		ms_audio_conference_add_member(conference, ep);
+		selector.addEndpoint(ep, st, isRemote, false);
+		streams.push_back(st);
+		endpoints.push_back(ep);
+	}
+
+	double allMixed = audio_conference_cpu_per_frame(3000, NULL);
+	BC_ASSERT_EQUAL(selector.getMixedEndpointsCount(), endpointsCount, int, "%d");
+
+	/* Without a limit, gating alone must keep the talkers of both kinds and drop all the silent participants. */
+	selector.setGatingThreshold(-60);
+	audio_conference_cpu_per_frame(2000, &selector);
+	int mixedTalkers = 0;
+	bool remoteTalkerMixed = false;
+	for (int i = 0; i < endpointsCount; i++) {
+		if (!selector.isMixed(endpoints[(size_t)i])) continue;
+		BC_ASSERT_LOWER_STRICT(i, talkersCount, int, "%d");
+		if (i < talkersCount) mixedTalkers++;
+		if (i < talkersCount && i % 2 == 1) remoteTalkerMixed = true;
+	}
+	BC_ASSERT_GREATER(mixedTalkers, 1, int, "%d");
+	BC_ASSERT_TRUE(remoteTalkerMixed);
+
+	selector.setMaxMixedEndpoints(3);
+	double activeSpeakers = audio_conference_cpu_per_frame(3000, &selector);
+	BC_ASSERT_LOWER(selector.getMixedEndpointsCount(), 3, int, "%d");
+	for (int i = talkersCount; i < endpointsCount; i++) {
+		BC_ASSERT_FALSE(selector.isMixed(endpoints[(size_t)i]));
+	}
+
+	ms_message("Mixing %d endpoints: %f ms of CPU per frame when all are mixed, %f ms when only the %d loudest are (%d mixed at the end)",
+		endpointsCount, allMixed, activeSpeakers, selector.getMaxMixedEndpoints(), selector.getMixedEndpointsCount());
+
+	for (size_t i = 0; i < endpoints.size(); i++) {
+		selector.removeEndpoint(endpoints[i]);
+		ms_audio_conference_remove_member(conference, endpoints[i]);
+		ms_audio_endpoint_release_from_stream(endpoints[i]);
+		audio_stream_stop(streams[i]);
+	}
+	for (auto sender : senders) {
+		audio_stream_stop(sender);
+	}
+	ms_audio_conference_destroy(conference);
+	rtp_profile_destroy(profile);
+	bc_free(hello);
+	linphone_core_unref(lc);
+}
+
+static void audio_conference_mixing_params() {
+	LinphoneCoreManager *marie = linphone_core_manager_new("marie_rc");
+	LinphoneConferenceParams *params = linphone_core_create_conference_params(marie->lc);
+	linphone_conference_params_set_max_mixed_participants(params, 3);
+	linphone_conference_params_set_audio_gating_threshold(params, -50);
+	LinphoneConference *conf = linphone_core_create_conference_with_params(marie->lc, params);
+	BC_ASSERT_PTR_NOT_NULL(conf);
+	if (!conf) goto end;
+	{
+		auto localConf = dynamic_cast<MediaConference::LocalConference *>(MediaConference::Conference::toCpp(conf));
+		BC_ASSERT_PTR_NOT_NULL(localConf);
+		if (!localConf) goto end;
+		auto mixer = dynamic_cast<MS2AudioMixer *>(localConf->getMixerSession()->getMixerByType(SalAudio));
+		BC_ASSERT_PTR_NOT_NULL(mixer);
+		if (!mixer) goto end;
+		BC_ASSERT_EQUAL(mixer->getEndpointSelector().getMaxMixedEndpoints(), 3, int, "%d");
+		BC_ASSERT_EQUAL((int)mixer->getEndpointSelector().getGatingThreshold(), -50, int, "%d");
+		BC_ASSERT_TRUE(mixer->getEndpointSelector().enabled());
+
+		/* Disabling the policy through an update must reach the mixer too. */
+		linphone_conference_params_set_max_mixed_participants(params, 0);
+		linphone_conference_params_set_audio_gating_threshold(params, LINPHONE_VOLUME_DB_LOWEST);
+		linphone_conference_update_params(conf, params);
+		BC_ASSERT_EQUAL(mixer->getEndpointSelector().getMaxMixedEndpoints(), 0, int, "%d");
+		BC_ASSERT_FALSE(mixer->getEndpointSelector().enabled());
+	}
+	linphone_conference_terminate(conf);
+
+end:
+	if (conf) linphone_conference_unref(conf);
+	linphone_conference_params_unref(params);
+	linphone_core_manager_destroy(marie);
+}
+
 test_t audio_quality_tests[] = {
 	TEST_NO_TAG("Audio loss rate resilience opus", audio_call_loss_resilience_opus),
 	TEST_NO_TAG("Simple stereo call with L16", audio_stereo_call_l16),
@@ -306,6 +445,8 @@ test_t audio_quality_tests[] = {
 	TEST_NO_TAG("Simple mono call with opus", audio_mono_call_opus),
 	TEST_NO_TAG("Audio test diff", audio_call_test_diff),
 	TEST_NO_TAG("Audio test audio diff", audio_call_test_audio_diff),
+	TEST_NO_TAG("Audio conference mixing benchmark", audio_conference_mixing_benchmark),
+	TEST_NO_TAG("Audio conference mixing params", audio_conference_mixing_params),
 };
 
 test_suite_t 	audio_quality_test_suite = {
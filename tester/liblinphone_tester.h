@@ -26,6 +26,7 @@
 #include <bctoolbox/tester.h>
 #include "linphone/core.h"
 #include <mediastreamer2/msutils.h>
+#include <ortp/port.h>
 #ifdef HAVE_CONFIG_H
 #include "config.h"
 #endif
@@ -491,6 +492,28 @@ bool_t wait_for_list_interval(MSList* lcs,int* counter,int min,int max,int timeo
 bool_t wait_for_until(LinphoneCore* lc_1, LinphoneCore* lc_2,int* counter,int value,int timout_ms);
 bool_t wait_for_until_interval(LinphoneCore* lc_1, LinphoneCore* lc_2,int* counter,int min,int max,int timout_ms);
 
+/*
+ * Stand-in server on a loopback UDP port, for the tests needing a DNS, STUN or SIP peer they control. It is served
+ * from the test loop: the handler is given each datagram received, and returns the length of the answer it wrote
+ * in place in the buffer of the given size, 0 for no answer.
+ */
+struct sockaddr_in;
+typedef int (*LoopbackUdpHandler)(void *user_data, unsigned char *buffer, int len, int size, const struct sockaddr_in *from);
+
+typedef struct _LoopbackUdpStandIn {
+	ortp_socket_t sock;
+	int port;
+	int datagrams;
+	LoopbackUdpHandler handler;
+	void *user_data;
+} LoopbackUdpStandIn;
+
+bool_t loopback_udp_stand_in_start(LoopbackUdpStandIn *stand_in, LoopbackUdpHandler handler, void *user_data);
+void loopback_udp_stand_in_serve(LoopbackUdpStandIn *stand_in);
+/* Iterates the core and serves the stand-in until the counter reaches the value. */
+void loopback_udp_stand_in_wait(LinphoneCore *lc, LoopbackUdpStandIn *stand_in, const int *counter, int value, int timeout_ms);
+void loopback_udp_stand_in_stop(LoopbackUdpStandIn *stand_in);
+
 bool_t call_with_params(LinphoneCoreManager* caller_mgr
 						,LinphoneCoreManager* callee_mgr
 						, const LinphoneCallParams *caller_params
@@ -17,10 +17,17 @@
  * along with this program. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
+#include <cstdlib>
+
 #include "address/address.h"
+#include "c-wrapper/c-wrapper.h"
+#include "chat/chat-message/chat-message.h"
 #include "core/core-p.h"
 #include "db/main-db.h"
+#include "db/main-db-p.h"
 #include "event-log/events.h"
+#include "object/object-pool.h"
 
 // TODO: Remove me. <3
 #include "private.h"
@@ -36,16 +43,44 @@ using namespace LinphonePrivate;
 
 // -----------------------------------------------------------------------------
 
+// Heap allocations made by the current thread are counted while the flag is set. The operator new of the tester
+// also serves liblinphone, except on Windows where each module keeps its own.
+static thread_local bool countHeapAllocations = false;
+static unsigned long long heapAllocationCount = 0;
+
+#ifndef _WIN32
+void *operator new (size_t size) {
+	if (countHeapAllocations)
+		heapAllocationCount++;
+	void *ptr = malloc(size ? size : 1);
+	if (!ptr)
+		throw bad_alloc();
+	return ptr;
+}
+
+void operator delete (void *ptr) noexcept {
+	free(ptr);
+}
+
+void operator delete (void *ptr, size_t) noexcept {
+	free(ptr);
+}
+#endif
+
+// -----------------------------------------------------------------------------
+
 class MainDbProvider {
 public:
 	MainDbProvider () : MainDbProvider("db/linphone.db") { }
 
-	MainDbProvider (const char *db_file) {
+	MainDbProvider (const char *db_file, const char *sqliteProfile = nullptr) {
 		mCoreManager = linphone_core_manager_create("empty_rc");
 		char *roDbPath = bc_tester_res(db_file);
 		char *rwDbPath = bc_tester_file("linphone.db");
 		BC_ASSERT_FALSE(liblinphone_tester_copy_file(roDbPath, rwDbPath));
 		linphone_config_set_string(linphone_core_get_config(mCoreManager->lc), "storage", "uri", rwDbPath);
+		if (sqliteProfile)
+			linphone_config_set_string(linphone_core_get_config(mCoreManager->lc), "storage", "sqlite_profile", sqliteProfile);
 		bc_free(roDbPath);
 		bc_free(rwDbPath);
 		linphone_core_manager_start(mCoreManager, false);
@@ -59,6 +94,10 @@ public:
 		return *L_GET_PRIVATE(mCoreManager->lc->cppPtr)->mainDb;
 	}
 
+	LinphoneCore *getCore () {
+		return mCoreManager->lc;
+	}
+
 private:
 	LinphoneCoreManager *mCoreManager;
 };
@@ -140,6 +179,62 @@ static void get_history (void) {
 	);
 }
 
+static void get_history_async (void) {
+	MainDbProvider provider;
+	MainDb &mainDb = provider.getMainDb();
+	const ConferenceId conferenceId(IdentityAddress("sip:test-1@sip.linphone.org"), IdentityAddress("sip:test-1@sip.linphone.org"));
+
+	BC_ASSERT_TRUE(mainDb.enableAsyncQueries(true));
+	BC_ASSERT_TRUE(mainDb.asyncQueriesEnabled());
+
+	int done = 0;
+	list<shared_ptr<EventLog>> asyncEvents;
+	mainDb.getHistoryRangeAsync(conferenceId, 0, -1, MainDb::Filter::ConferenceChatMessageFilter,
+		[&done, &asyncEvents](const list<shared_ptr<EventLog>> &events) {
+			asyncEvents = events;
+			done++;
+		}
+	);
+	int historySize = -1;
+	mainDb.getHistorySizeAsync(conferenceId, MainDb::Filter::ConferenceChatMessageFilter, [&done, &historySize](int count) {
+		historySize = count;
+		done++;
+	});
+	// The main connection keeps writing while the worker connection reads.
+	mainDb.markChatMessagesAsRead(conferenceId);
+	BC_ASSERT_EQUAL(mainDb.getUnreadChatMessageCount(conferenceId), 0, int, "%d");
+
+	// Nothing is delivered outside of the main loop.
+	BC_ASSERT_EQUAL(done, 0, int, "%d");
+	BC_ASSERT_TRUE(wait_for_until(provider.getCore(), NULL, &done, 2, 5000));
+
+	BC_ASSERT_EQUAL(historySize, 804, int, "%d");
+	BC_ASSERT_EQUAL(asyncEvents.size(), 804, int, "%d");
+
+	// Same events, in the same order and sharing the same instances as the synchronous query.
+	list<shared_ptr<EventLog>> syncEvents = mainDb.getHistoryRange(conferenceId, 0, -1, MainDb::Filter::ConferenceChatMessageFilter);
+	BC_ASSERT_TRUE(syncEvents == asyncEvents);
+
+	BC_ASSERT_TRUE(mainDb.enableAsyncQueries(false));
+	BC_ASSERT_FALSE(mainDb.asyncQueriesEnabled());
+}
+
+static void get_history_async_with_wal (void) {
+	// In WAL, the main connection locks the database exclusively: the queries stay synchronous.
+	MainDbProvider provider("db/linphone.db", "performance");
+	MainDb &mainDb = provider.getMainDb();
+	const ConferenceId conferenceId(IdentityAddress("sip:test-1@sip.linphone.org"), IdentityAddress("sip:test-1@sip.linphone.org"));
+
+	BC_ASSERT_FALSE(mainDb.enableAsyncQueries(true));
+	BC_ASSERT_FALSE(mainDb.asyncQueriesEnabled());
+
+	int historySize = -1;
+	mainDb.getHistorySizeAsync(conferenceId, MainDb::Filter::ConferenceChatMessageFilter, [&historySize](int count) {
+		historySize = count;
+	});
+	BC_ASSERT_EQUAL(historySize, 804, int, "%d");
+}
+
 static void get_conference_notified_events (void) {
 	MainDbProvider provider;
 	const MainDb &mainDb = provider.getMainDb();
@@ -281,14 +376,269 @@ static void load_a_lot_of_chatrooms(void) {
 #endif
 }
 
+static int count_chat_messages (soci::session *session, const ConferenceId &conferenceId, bool unreadOnly) {
+	const string peerAddress = conferenceId.getPeerAddress().asString();
+	const string localAddress = conferenceId.getLocalAddress().asString();
+	int count = 0;
+	*session << string("SELECT COUNT(*) FROM conference_chat_message_event WHERE event_id IN ("
+		"  SELECT event_id FROM conference_event, chat_room, sip_address AS peer, sip_address AS local"
+		"  WHERE conference_event.chat_room_id = chat_room.id"
+		"  AND chat_room.peer_sip_address_id = peer.id AND peer.value = :peerAddress"
+		"  AND chat_room.local_sip_address_id = local.id AND local.value = :localAddress"
+		")") + (unreadOnly ? " AND marked_as_read = 0" : ""), soci::use(peerAddress), soci::use(localAddress), soci::into(count);
+	return count;
+}
+
+static void chat_room_message_counters (void) {
+	MainDbProvider provider;
+	MainDb &mainDb = provider.getMainDb();
+	soci::session *session = L_GET_PRIVATE(&mainDb)->dbSession.getBackendSession();
+
+	// Counters are computed when migrating the database, they must match the events.
+	shared_ptr<AbstractChatRoom> unreadChatRoom;
+	for (const auto &chatRoom : mainDb.getChatRooms()) {
+		const ConferenceId &conferenceId = chatRoom->getConferenceId();
+		const int unreadCount = mainDb.getUnreadChatMessageCount(conferenceId);
+		BC_ASSERT_EQUAL(unreadCount, count_chat_messages(session, conferenceId, true), int, "%d");
+		BC_ASSERT_EQUAL(mainDb.getChatMessageCount(conferenceId), count_chat_messages(session, conferenceId, false), int, "%d");
+		if (unreadCount > 0)
+			unreadChatRoom = chatRoom;
+	}
+
+	if (BC_ASSERT_TRUE(unreadChatRoom != nullptr)) {
+		const int unreadCount = mainDb.getUnreadChatMessageCount(unreadChatRoom->getConferenceId());
+		mainDb.markChatMessagesAsRead(unreadChatRoom->getConferenceId());
+		BC_ASSERT_EQUAL(mainDb.getUnreadChatMessageCount(unreadChatRoom->getConferenceId()), 0, int, "%d");
+		BC_ASSERT_EQUAL(mainDb.getUnreadChatMessageCount(), 2 - unreadCount, int, "%d");
+	}
+
+	const ConferenceId conferenceId(IdentityAddress("sip:test-1@sip.linphone.org"), IdentityAddress("sip:test-1@sip.linphone.org"));
+	list<shared_ptr<EventLog>> events = mainDb.getHistoryRange(conferenceId, 0, 1, MainDb::Filter::ConferenceChatMessageFilter);
+	if (BC_ASSERT_EQUAL(events.size(), 1, int, "%d")) {
+		BC_ASSERT_TRUE(MainDb::deleteEvent(events.front()));
+		BC_ASSERT_EQUAL(mainDb.getChatMessageCount(conferenceId), 803, int, "%d");
+		BC_ASSERT_EQUAL(mainDb.getHistorySize(conferenceId, MainDb::Filter::ConferenceChatMessageFilter), 803, int, "%d");
+		BC_ASSERT_EQUAL(count_chat_messages(session, conferenceId, false), 803, int, "%d");
+	}
+
+	mainDb.cleanHistory(conferenceId);
+	BC_ASSERT_EQUAL(mainDb.getChatMessageCount(conferenceId), 0, int, "%d");
+	BC_ASSERT_EQUAL(mainDb.getUnreadChatMessageCount(conferenceId), 0, int, "%d");
+	BC_ASSERT_EQUAL(mainDb.getHistorySize(conferenceId, MainDb::Filter::ConferenceChatMessageFilter), 0, int, "%d");
+}
+
+static void chat_room_message_counters_benchmark (void) {
+	constexpr int extraChatRoomCount = 5000;
+
+	MainDbProvider provider("db/chatrooms.db");
+	MainDb &mainDb = provider.getMainDb();
+	soci::session *session = L_GET_PRIVATE(&mainDb)->dbSession.getBackendSession();
+
+	list<ConferenceId> conferenceIds;
+	for (const auto &chatRoom : mainDb.getChatRooms())
+		conferenceIds.push_back(chatRoom->getConferenceId());
+	BC_ASSERT_EQUAL(conferenceIds.size(), 269, int, "%d");
+
+	// Add empty chat rooms to reach the size of a large chat list.
+	{
+		const string localAddress = "sip:bench-local@sip.example.org";
+		soci::transaction tr(*session);
+		*session << "INSERT INTO sip_address (value) VALUES (:value)", soci::use(localAddress);
+		long long localSipAddressId;
+		*session << "SELECT id FROM sip_address WHERE value = :value", soci::use(localAddress), soci::into(localSipAddressId);
+		for (int i = 0; i < extraChatRoomCount; ++i) {
+			const string peerAddress = "sip:bench-" + to_string(i) + "@sip.example.org";
+			*session << "INSERT INTO sip_address (value) VALUES (:value)", soci::use(peerAddress);
+			*session << "INSERT INTO chat_room (peer_sip_address_id, local_sip_address_id, creation_time, last_update_time, capabilities)"
+				" VALUES ((SELECT id FROM sip_address WHERE value = :peer), :local, datetime('now'), datetime('now'), 1)",
+				soci::use(peerAddress), soci::use(localSipAddressId);
+			conferenceIds.push_back(ConferenceId(IdentityAddress(peerAddress), IdentityAddress(localAddress)));
+		}
+		tr.commit();
+	}
+
+	// Counting the events of each chat room, as a chat list refresh did before the counters.
+	chrono::high_resolution_clock::time_point start = chrono::high_resolution_clock::now();
+	int countedMessages = 0;
+	for (const auto &conferenceId : conferenceIds)
+		countedMessages += count_chat_messages(session, conferenceId, true) + count_chat_messages(session, conferenceId, false);
+	long countMs = (long) chrono::duration_cast<chrono::milliseconds>(chrono::high_resolution_clock::now() - start).count();
+
+	start = chrono::high_resolution_clock::now();
+	int storedMessages = 0;
+	for (const auto &conferenceId : conferenceIds)
+		storedMessages += mainDb.getUnreadChatMessageCount(conferenceId) + mainDb.getChatMessageCount(conferenceId);
+	long counterMs = (long) chrono::duration_cast<chrono::milliseconds>(chrono::high_resolution_clock::now() - start).count();
+
+	BC_ASSERT_EQUAL(storedMessages, countedMessages, int, "%d");
+	ms_message("Message counts of %d chat rooms: %li ms with event counting, %li ms with stored counters",
+		(int)conferenceIds.size(), countMs, counterMs);
+}
+
+static void chat_message_user_data_benchmark (void) {
+	constexpr int resolutionCount = 1000000;
+
+	MainDbProvider provider;
+	const MainDb &mainDb = provider.getMainDb();
+	list<shared_ptr<ChatMessage>> chatMessages;
+	for (const auto &event : mainDb.getHistoryRange(
+		ConferenceId(IdentityAddress("sip:test-1@sip.linphone.org"), IdentityAddress("sip:test-1@sip.linphone.org")),
+		0, -1, MainDb::Filter::ConferenceChatMessageFilter
+	))
+		chatMessages.push_back(static_pointer_cast<ConferenceChatMessageEvent>(event)->getChatMessage());
+	BC_ASSERT_EQUAL(chatMessages.size(), 804, int, "%d");
+	if (chatMessages.empty())
+		return;
+
+	// Stores and reads back the user data of the history messages through their C pointers.
+	chrono::high_resolution_clock::time_point start = chrono::high_resolution_clock::now();
+	int matches = 0;
+	for (int i = 0; i < resolutionCount;) {
+		for (const auto &chatMessage : chatMessages) {
+			LinphoneChatMessage *cChatMessage = L_GET_C_BACK_PTR(chatMessage);
+			linphone_chat_message_set_user_data(cChatMessage, cChatMessage);
+			if (linphone_chat_message_get_user_data(cChatMessage) == cChatMessage)
+				matches++;
+			if (++i == resolutionCount)
+				break;
+		}
+	}
+	long slotMs = (long) chrono::duration_cast<chrono::milliseconds>(chrono::high_resolution_clock::now() - start).count();
+	BC_ASSERT_EQUAL(matches, resolutionCount, int, "%d");
+
+	// The slot must not go through the property map at all.
+	int userDataProperties = 0;
+	for (const auto &chatMessage : chatMessages) {
+		if (chatMessage->getProperty("LinphonePrivate::Wrapper::userData").isValid())
+			userDataProperties++;
+	}
+	BC_ASSERT_EQUAL(userDataProperties, 0, int, "%d");
+
+	// Same work with the user data kept as a named property, as it was before the dedicated slot.
+	start = chrono::high_resolution_clock::now();
+	matches = 0;
+	for (int i = 0; i < resolutionCount;) {
+		for (const auto &chatMessage : chatMessages) {
+			LinphoneChatMessage *cChatMessage = L_GET_C_BACK_PTR(chatMessage);
+			const shared_ptr<ChatMessage> &cppChatMessage = L_GET_CPP_PTR_FROM_C_OBJECT(cChatMessage);
+			cppChatMessage->setProperty("LinphonePrivate::Wrapper::userData", static_cast<void *>(cChatMessage));
+			if (cppChatMessage->getProperty("LinphonePrivate::Wrapper::userData").getValue<void *>() == cChatMessage)
+				matches++;
+			if (++i == resolutionCount)
+				break;
+		}
+	}
+	long propertyMs = (long) chrono::duration_cast<chrono::milliseconds>(chrono::high_resolution_clock::now() - start).count();
+	BC_ASSERT_EQUAL(matches, resolutionCount, int, "%d");
+
+	ms_message("User data of %d chat messages: %li ms with the dedicated slot, %li ms with a property",
+		resolutionCount, slotMs, propertyMs);
+}
+
+static void sqlite_storage_profiles (void) {
+	const ConferenceId conferenceId(IdentityAddress("sip:test-1@sip.linphone.org"), IdentityAddress("sip:test-1@sip.linphone.org"));
+	for (const string profile : { "safe", "default", "performance" }) {
+		chrono::high_resolution_clock::time_point start = chrono::high_resolution_clock::now();
+		MainDbProvider provider("db/linphone.db", profile.c_str());
+		MainDb &mainDb = provider.getMainDb();
+		BC_ASSERT_EQUAL(mainDb.getEventCount(), 5175, int, "%d");
+		BC_ASSERT_EQUAL(mainDb.getHistoryRange(conferenceId, 0, -1, MainDb::Filter::ConferenceChatMessageFilter).size(), 804, int, "%d");
+		mainDb.markChatMessagesAsRead(conferenceId);
+		BC_ASSERT_EQUAL(mainDb.getUnreadChatMessageCount(conferenceId), 0, int, "%d");
+
+		string journalMode;
+		*L_GET_PRIVATE(&mainDb)->dbSession.getBackendSession() << "PRAGMA journal_mode", soci::into(journalMode);
+		// The default profile leaves the journal mode of the fixture, which is in rollback journal mode.
+		if (profile == "performance")
+			BC_ASSERT_STRING_EQUAL(journalMode.c_str(), "wal");
+		else
+			BC_ASSERT_STRING_EQUAL(journalMode.c_str(), "delete");
+
+		chrono::high_resolution_clock::time_point end = chrono::high_resolution_clock::now();
+		ms_message("Sqlite profile [%s] (journal mode %s): %li ms", profile.c_str(), journalMode.c_str(),
+			(long) chrono::duration_cast<chrono::milliseconds>(end - start).count());
+	}
+}
+
+static size_t load_history (const MainDb &mainDb, const ConferenceId &conferenceId, int loadCount, ObjectPool *pool, size_t &peakChunkCount, unsigned long long &heapAllocations) {
+	size_t eventCount = 0;
+	heapAllocationCount = 0;
+	countHeapAllocations = true;
+	for (int i = 0; i < loadCount; ++i) {
+		list<shared_ptr<EventLog>> events = mainDb.getHistoryRange(conferenceId, 0, -1, MainDb::Filter::ConferenceChatMessageFilter);
+		eventCount += events.size();
+		peakChunkCount = max(peakChunkCount, pool->getChunkCount());
+	}
+	countHeapAllocations = false;
+	heapAllocations = heapAllocationCount;
+	return eventCount;
+}
+
+static void history_allocations_benchmark (void) {
+	// The 804 messages of the chat room are loaded again and again to go through about 100k events.
+	constexpr int loadCount = 125;
+
+	MainDbProvider provider;
+	const MainDb &mainDb = provider.getMainDb();
+	ObjectPool *pool = L_GET_PRIVATE(provider.getCore()->cppPtr)->objectPool.get();
+	const ConferenceId conferenceId(IdentityAddress("sip:test-1@sip.linphone.org"), IdentityAddress("sip:test-1@sip.linphone.org"));
+	const bool poolsEnabled = ObjectPool::isEnabled();
+	const size_t usedBlocks = pool->getUsedBlockCount();
+	const size_t chunkCount = pool->getChunkCount();
+	size_t peakChunkCount = 0;
+
+	ObjectPool::setEnabled(false);
+	unsigned long long heapAllocations = 0;
+	uint64_t start = bctbx_get_cur_time_ms();
+	size_t eventCount = load_history(mainDb, conferenceId, loadCount, pool, peakChunkCount, heapAllocations);
+	uint64_t heapDuration = bctbx_get_cur_time_ms() - start;
+	BC_ASSERT_EQUAL(eventCount, 804 * loadCount, size_t, "%zu");
+
+	ObjectPool::setEnabled(true);
+	uint64_t allocationCount = pool->getAllocationCount();
+	unsigned long long pooledHeapAllocations = 0;
+	start = bctbx_get_cur_time_ms();
+	eventCount = load_history(mainDb, conferenceId, loadCount, pool, peakChunkCount, pooledHeapAllocations);
+	uint64_t pooledDuration = bctbx_get_cur_time_ms() - start;
+	uint64_t pooledAllocations = pool->getAllocationCount() - allocationCount;
+	ObjectPool::setEnabled(poolsEnabled);
+	BC_ASSERT_EQUAL(eventCount, 804 * loadCount, size_t, "%zu");
+
+	if (eventCount == 0)
+		return;
+
+	ms_message("Loading %zu history events: %.2f heap allocations per event in %llu ms without pools, "
+		"%.2f heap allocations and %.2f pooled blocks per event in %llu ms with pools, peak of %zu chunks",
+		eventCount, (double)heapAllocations / eventCount, (unsigned long long)heapDuration,
+		(double)pooledHeapAllocations / eventCount, (double)pooledAllocations / eventCount, (unsigned long long)pooledDuration,
+		peakChunkCount);
+#ifndef _WIN32
+	// The blocks taken from the arena are as many heap allocations saved, less the chunks.
+	BC_ASSERT_LOWER_STRICT(pooledHeapAllocations / eventCount, heapAllocations / eventCount, unsigned long long, "%llu");
+#endif
+	// At least the message, its control block and the event of each row come from the arena of the core.
+	BC_ASSERT_GREATER((unsigned long long)pooledAllocations, 3ULL * eventCount, unsigned long long, "%llu");
+	// Everything loaded was freed, and the arena gave its chunks back except one per block size.
+	BC_ASSERT_EQUAL(pool->getUsedBlockCount(), usedBlocks, size_t, "%zu");
+	BC_ASSERT_LOWER(pool->getChunkCount(), chunkCount + 5, size_t, "%zu");
+	BC_ASSERT_GREATER(peakChunkCount, pool->getChunkCount() + 1, size_t, "%zu");
+}
+
 test_t main_db_tests[] = {
 	TEST_NO_TAG("Get events count", get_events_count),
 	TEST_NO_TAG("Get messages count", get_messages_count),
 	TEST_NO_TAG("Get unread messages count", get_unread_messages_count),
 	TEST_NO_TAG("Get history", get_history),
+	TEST_NO_TAG("Get history asynchronously", get_history_async),
+	TEST_NO_TAG("Get history asynchronously with WAL", get_history_async_with_wal),
 	TEST_NO_TAG("Get conference events", get_conference_notified_events),
 	TEST_NO_TAG("Get chat rooms", get_chat_rooms),
-	TEST_NO_TAG("Load a lot of chatrooms", load_a_lot_of_chatrooms)
+	TEST_NO_TAG("Load a lot of chatrooms", load_a_lot_of_chatrooms),
+	TEST_NO_TAG("Sqlite storage profiles", sqlite_storage_profiles),
+	TEST_NO_TAG("Chat room message counters", chat_room_message_counters),
+	TEST_NO_TAG("Chat room message counters benchmark", chat_room_message_counters_benchmark),
+	TEST_NO_TAG("Chat message user data benchmark", chat_message_user_data_benchmark),
+	TEST_NO_TAG("History allocations benchmark", history_allocations_benchmark)
 };
 
 test_suite_t main_db_test_suite = {
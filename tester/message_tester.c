@@ -34,6 +34,13 @@
 #pragma warning(disable : 4996)
 #endif
 
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
 
 /* sql cache creation string, contains 3 string to be inserted : selfuri/selfuri/peeruri */
 static const char *marie_zid_sqlcache = "BEGIN TRANSACTION; CREATE TABLE IF NOT EXISTS ziduri (zuid          INTEGER PRIMARY KEY AUTOINCREMENT NOT NULL,zid		BLOB NOT NULL DEFAULT '000000000000',selfuri	 TEXT NOT NULL DEFAULT 'unset',peeruri	 TEXT NOT NULL DEFAULT 'unset'); INSERT INTO `ziduri` (zuid,zid,selfuri,peeruri) VALUES (1,X'4ddc8042bee500ad0366bf93','%s','self'), (2,X'bcb4028bf55e1b7ac4c4edee','%s','%s'); CREATE TABLE IF NOT EXISTS zrtp (zuid		INTEGER NOT NULL DEFAULT 0 UNIQUE,rs1		BLOB DEFAULT NULL,rs2		BLOB DEFAULT NULL,aux		BLOB DEFAULT NULL,pbx		BLOB DEFAULT NULL,pvs		BLOB DEFAULT NULL,FOREIGN KEY(zuid) REFERENCES ziduri(zuid) ON UPDATE CASCADE ON DELETE CASCADE); INSERT INTO `zrtp` (zuid,rs1,rs2,aux,pbx,pvs) VALUES (2,X'f0e0ad4d3d4217ba4048d1553e5ab26fae0b386cdac603f29a66d5f4258e14ef',NULL,NULL,NULL,X'01'); CREATE TABLE IF NOT EXISTS lime (zuid		INTEGER NOT NULL DEFAULT 0 UNIQUE,sndKey		BLOB DEFAULT NULL,rcvKey		BLOB DEFAULT NULL,sndSId		BLOB DEFAULT NULL,rcvSId		BLOB DEFAULT NULL,sndIndex	BLOB DEFAULT NULL,rcvIndex	BLOB DEFAULT NULL,valid		BLOB DEFAULT NULL,FOREIGN KEY(zuid) REFERENCES ziduri(zuid) ON UPDATE CASCADE ON DELETE CASCADE); INSERT INTO `lime` (zuid,sndKey,rcvKey,sndSId,rcvSId,sndIndex,rcvIndex,valid) VALUES (2,X'97c75a5a92a041b415296beec268efc3373ef4aa8b3d5f301ac7522a7fb4e332',x'3b74b709b961e5ebccb1db6b850ea8c1f490546d6adee2f66b5def7093cead3d',X'e2ebca22ad33071bc37631393bf25fc0a9badeea7bf6dcbcb5d480be7ff8c5ea',X'a2086d195344ec2997bf3de7441d261041cda5d90ed0a0411ab2032e5860ea48',X'33376935',X'7ce32d86',X'0000000000000000'); COMMIT;";
@@ -254,6 +261,85 @@ static void text_message(void) {
 	linphone_core_manager_destroy(pauline);
 }
 
+#ifndef _WIN32
+/* The core serves its metrics from its main loop: it is iterated until it closes the connection. */
+static char *scrape_metrics_socket(LinphoneCore *lc, const char *path) {
+	struct sockaddr_un addr;
+	char buffer[1024];
+	char *text = NULL;
+	size_t size = 0;
+	ssize_t nread = -1;
+	uint64_t start;
+	int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+
+	if (!BC_ASSERT_NOT_EQUAL(fd, -1, int, "%d")) return NULL;
+	memset(&addr, 0, sizeof(addr));
+	addr.sun_family = AF_UNIX;
+	strncpy(addr.sun_path, path, sizeof(addr.sun_path) - 1);
+	if (!BC_ASSERT_EQUAL(connect(fd, (struct sockaddr *)&addr, sizeof(addr)), 0, int, "%d")) {
+		close(fd);
+		return NULL;
+	}
+	fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+
+	start = bctbx_get_cur_time_ms();
+	while (bctbx_get_cur_time_ms() - start < 5000) {
+		linphone_core_iterate(lc);
+		nread = read(fd, buffer, sizeof(buffer));
+		if (nread > 0) {
+			text = (char *)bctbx_realloc(text, size + (size_t)nread + 1);
+			memcpy(text + size, buffer, (size_t)nread);
+			size += (size_t)nread;
+			text[size] = '\0';
+		} else if (nread == 0 || (errno != EAGAIN && errno != EWOULDBLOCK)) {
+			break;
+		} else {
+			ms_usleep(10000);
+		}
+	}
+	BC_ASSERT_EQUAL((int)nread, 0, int, "%d");
+	close(fd);
+	return text;
+}
+
+static void text_message_with_metrics(void) {
+	LinphoneCoreManager* marie = linphone_core_manager_create("marie_rc");
+	LinphoneCoreManager* pauline = linphone_core_manager_new("pauline_tcp_rc");
+	char *socket_path = bc_tester_file("marie_metrics.sock");
+	char *metrics, *registrations;
+
+	linphone_config_set_string(linphone_core_get_config(marie->lc), "misc", "metrics_socket", socket_path);
+	linphone_core_manager_start(marie, TRUE);
+
+	text_message_base(marie, pauline);
+
+	metrics = scrape_metrics_socket(marie->lc, socket_path);
+	if (BC_ASSERT_PTR_NOT_NULL(metrics)) {
+		registrations = bctbx_strdup_printf("linphone_registrations_total{state=\"ok\"} %d\n", marie->stat.number_of_LinphoneRegistrationOk);
+		BC_ASSERT_PTR_NOT_NULL(strstr(metrics, "# TYPE linphone_registrations_total counter\n"));
+		BC_ASSERT_PTR_NOT_NULL(strstr(metrics, registrations));
+		BC_ASSERT_PTR_NOT_NULL(strstr(metrics, "linphone_registrations_total{state=\"failed\"} 0\n"));
+		BC_ASSERT_PTR_NOT_NULL(strstr(metrics, "linphone_chat_messages_received_total 1\n"));
+		BC_ASSERT_PTR_NOT_NULL(strstr(metrics, "linphone_active_calls 0\n"));
+		BC_ASSERT_PTR_NOT_NULL(strstr(metrics, "# TYPE linphone_db_query_duration_seconds histogram\n"));
+		ms_message("Metrics of marie:\n%s", metrics);
+		bctbx_free(registrations);
+		bctbx_free(metrics);
+	}
+
+	/* The same text is available from the API. */
+	metrics = linphone_core_get_metrics(pauline->lc);
+	BC_ASSERT_PTR_NOT_NULL(strstr(metrics, "linphone_chat_messages_sent_total 1\n"));
+	bctbx_free(metrics);
+
+	linphone_core_manager_destroy(marie);
+	/* The socket is removed when the core stops. */
+	BC_ASSERT_NOT_EQUAL(access(socket_path, F_OK), 0, int, "%d");
+	linphone_core_manager_destroy(pauline);
+	bctbx_free(socket_path);
+}
+#endif
+
 static void text_forward_message(void) {
 	LinphoneCoreManager* marie = linphone_core_manager_new("marie_rc");
 	LinphoneCoreManager* pauline = linphone_core_manager_new( "pauline_tcp_rc");
@@ -1162,6 +1248,217 @@ static void transfer_message_download_cancelled(void) {
 	linphone_core_manager_destroy(pauline);
 }
 
+/* Size of the body of the first response seen by the progress indication: the missing part only if a Range was sent. */
+static size_t resumed_download_body_size = 0;
+
+static long get_file_size_on_disk(const char *path) {
+	long size = -1;
+	FILE *file = fopen(path, "rb");
+	if (file) {
+		fseek(file, 0, SEEK_END);
+		size = ftell(file);
+		fclose(file);
+	}
+	return size;
+}
+
+static void file_transfer_progress_record_body_size(LinphoneChatMessage *msg, LinphoneContent* content, size_t offset, size_t total) {
+	if (resumed_download_body_size == 0) resumed_download_body_size = total;
+	file_transfer_progress_indication(msg, content, offset, total);
+}
+
+static void transfer_message_download_resumed(void) {
+	LinphoneChatRoom* chat_room;
+	LinphoneChatMessage* msg;
+	LinphoneCoreManager* marie = linphone_core_manager_new( "marie_rc");
+	LinphoneCoreManager* pauline = linphone_core_manager_new( "pauline_tcp_rc");
+	char *send_filepath = bc_tester_res("sounds/sintel_trailer_opus_h264.mkv");
+	char *receive_filepath = bc_tester_file("receive_file_resumed.dump");
+
+	remove(receive_filepath);
+	/* Globally configure an http file transfer server. */
+	linphone_core_set_file_transfer_server(pauline->lc, file_transfer_url);
+
+	/* create a chatroom on pauline's side */
+	chat_room = linphone_core_get_chat_room(pauline->lc,marie->identity);
+	msg = create_message_from_sintel_trailer(chat_room);
+	linphone_chat_message_send(msg);
+
+	/* wait for marie to receive pauline's msg */
+	BC_ASSERT_TRUE(wait_for_until(pauline->lc,marie->lc,&marie->stat.number_of_LinphoneMessageReceivedWithFile,1, 60000));
+
+	if (marie->stat.last_received_chat_message) {
+		LinphoneChatMessage *recv_msg = marie->stat.last_received_chat_message;
+		LinphoneChatMessageCbs *cbs = linphone_chat_message_get_callbacks(recv_msg);
+		linphone_chat_message_cbs_set_msg_state_changed(cbs, liblinphone_tester_chat_message_msg_state_changed);
+		linphone_chat_message_cbs_set_file_transfer_progress_indication(cbs, file_transfer_progress_indication);
+		linphone_chat_message_set_file_transfer_filepath(recv_msg, receive_filepath);
+		linphone_chat_message_download_file(recv_msg);
+
+		/* wait for file to be 50% downloaded and simulate a network error, the partial file stays on disk */
+		BC_ASSERT_TRUE(wait_for(pauline->lc,marie->lc,&marie->stat.progress_of_LinphoneFileTransfer, 50));
+		belle_http_provider_set_recv_error(linphone_core_get_http_provider(marie->lc), -1);
+		BC_ASSERT_TRUE(wait_for_until(marie->lc, pauline->lc, &marie->stat.number_of_LinphoneMessageNotDelivered,1, 10000));
+		belle_http_provider_set_recv_error(linphone_core_get_http_provider(marie->lc), 0);
+		BC_ASSERT_EQUAL(marie->stat.number_of_LinphoneFileTransferDownloadSuccessful, 0, int, "%d");
+		long partial_size = get_file_size_on_disk(receive_filepath);
+		BC_ASSERT_GREATER(partial_size, 0, long, "%ld");
+
+		/* download again, only the missing part is requested */
+		resumed_download_body_size = 0;
+		linphone_chat_message_cbs_set_file_transfer_progress_indication(cbs, file_transfer_progress_record_body_size);
+		linphone_chat_message_download_file(recv_msg);
+		if (BC_ASSERT_TRUE(wait_for_until(pauline->lc,marie->lc,&marie->stat.number_of_LinphoneFileTransferDownloadSuccessful,1,55000))) {
+			compare_files(send_filepath, receive_filepath);
+		}
+		/* the server answered the Range header with the end of the file, not the whole file */
+		BC_ASSERT_EQUAL((long)resumed_download_body_size, get_file_size_on_disk(send_filepath) - partial_size, long, "%ld");
+	}
+
+	remove(receive_filepath);
+	bc_free(receive_filepath);
+	bc_free(send_filepath);
+	linphone_chat_message_unref(msg);
+	linphone_core_manager_destroy(marie);
+	linphone_core_manager_destroy(pauline);
+}
+
+static void append_junk_to_file(const char *path, size_t size) {
+	FILE *file = fopen(path, "ab");
+	if (BC_ASSERT_PTR_NOT_NULL(file)) {
+		size_t i;
+		for (i = 0; i < size; i++) fputc('x', file);
+		fclose(file);
+	}
+}
+
+static void transfer_message_download_not_resumed_onto_other_file(void) {
+	LinphoneChatRoom* chat_room;
+	LinphoneChatMessage* msg;
+	LinphoneCoreManager* marie = linphone_core_manager_new( "marie_rc");
+	LinphoneCoreManager* pauline = linphone_core_manager_new( "pauline_tcp_rc");
+	char *send_filepath = bc_tester_res("sounds/sintel_trailer_opus_h264.mkv");
+	char *receive_filepath = bc_tester_file("receive_file_not_resumed.dump");
+	long file_size = get_file_size_on_disk(send_filepath);
+
+	/* a file smaller than the one to download is already there, but no download of this message was interrupted */
+	remove(receive_filepath);
+	append_junk_to_file(receive_filepath, 1000);
+	/* Globally configure an http file transfer server. */
+	linphone_core_set_file_transfer_server(pauline->lc, file_transfer_url);
+
+	/* create a chatroom on pauline's side */
+	chat_room = linphone_core_get_chat_room(pauline->lc,marie->identity);
+	msg = create_message_from_sintel_trailer(chat_room);
+	linphone_chat_message_send(msg);
+
+	/* wait for marie to receive pauline's msg */
+	BC_ASSERT_TRUE(wait_for_until(pauline->lc,marie->lc,&marie->stat.number_of_LinphoneMessageReceivedWithFile,1, 60000));
+
+	if (marie->stat.last_received_chat_message) {
+		LinphoneChatMessage *recv_msg = marie->stat.last_received_chat_message;
+		LinphoneChatMessageCbs *cbs = linphone_chat_message_get_callbacks(recv_msg);
+		linphone_chat_message_cbs_set_msg_state_changed(cbs, liblinphone_tester_chat_message_msg_state_changed);
+		linphone_chat_message_cbs_set_file_transfer_progress_indication(cbs, file_transfer_progress_record_body_size);
+		linphone_chat_message_set_file_transfer_filepath(recv_msg, receive_filepath);
+		resumed_download_body_size = 0;
+		linphone_chat_message_download_file(recv_msg);
+
+		/* the whole file is requested, interrupt it halfway */
+		BC_ASSERT_TRUE(wait_for(pauline->lc,marie->lc,&marie->stat.progress_of_LinphoneFileTransfer, 50));
+		BC_ASSERT_EQUAL((long)resumed_download_body_size, file_size, long, "%ld");
+		belle_http_provider_set_recv_error(linphone_core_get_http_provider(marie->lc), -1);
+		BC_ASSERT_TRUE(wait_for_until(marie->lc, pauline->lc, &marie->stat.number_of_LinphoneMessageNotDelivered,1, 10000));
+		belle_http_provider_set_recv_error(linphone_core_get_http_provider(marie->lc), 0);
+		BC_ASSERT_EQUAL(marie->stat.number_of_LinphoneFileTransferDownloadSuccessful, 0, int, "%d");
+
+		/* the partial file changed since the download was interrupted, it must be downloaded again from scratch */
+		append_junk_to_file(receive_filepath, 10);
+		resumed_download_body_size = 0;
+		linphone_chat_message_download_file(recv_msg);
+		if (BC_ASSERT_TRUE(wait_for_until(pauline->lc,marie->lc,&marie->stat.number_of_LinphoneFileTransferDownloadSuccessful,1,55000))) {
+			compare_files(send_filepath, receive_filepath);
+		}
+		BC_ASSERT_EQUAL((long)resumed_download_body_size, file_size, long, "%ld");
+	}
+
+	remove(receive_filepath);
+	bc_free(receive_filepath);
+	bc_free(send_filepath);
+	linphone_chat_message_unref(msg);
+	linphone_core_manager_destroy(marie);
+	linphone_core_manager_destroy(pauline);
+}
+
+static LinphoneBuffer *held_recv_buffer = NULL;
+static uint8_t *held_recv_content = NULL;
+static size_t held_recv_size = 0;
+
+/* Keeps every other chunk buffer until the next chunk, to check it is not overwritten by the following one. */
+static void file_transfer_received_holding_buffers(LinphoneChatMessage *msg, LinphoneContent* content, const LinphoneBuffer *buffer) {
+	if (held_recv_buffer) {
+		BC_ASSERT_EQUAL(linphone_buffer_get_size(held_recv_buffer), held_recv_size, size_t, "%zu");
+		BC_ASSERT_EQUAL(memcmp(linphone_buffer_get_content(held_recv_buffer), held_recv_content, held_recv_size), 0, int, "%d");
+		linphone_buffer_unref(held_recv_buffer);
+		ms_free(held_recv_content);
+		held_recv_buffer = NULL;
+		held_recv_content = NULL;
+	} else if (!linphone_buffer_is_empty(buffer)) {
+		held_recv_buffer = linphone_buffer_ref((LinphoneBuffer *)buffer);
+		held_recv_size = linphone_buffer_get_size(buffer);
+		held_recv_content = ms_malloc(held_recv_size);
+		memcpy(held_recv_content, linphone_buffer_get_content(buffer), held_recv_size);
+	}
+	file_transfer_received(msg, content, buffer);
+}
+
+static void transfer_message_download_to_buffers(void) {
+	LinphoneChatRoom* chat_room;
+	LinphoneChatMessage* msg;
+	LinphoneCoreManager* marie = linphone_core_manager_new( "marie_rc");
+	LinphoneCoreManager* pauline = linphone_core_manager_new( "pauline_tcp_rc");
+	char *send_filepath = bc_tester_res("sounds/sintel_trailer_opus_h264.mkv");
+
+	/* Globally configure an http file transfer server. */
+	linphone_core_set_file_transfer_server(pauline->lc, file_transfer_url);
+
+	/* create a chatroom on pauline's side */
+	chat_room = linphone_core_get_chat_room(pauline->lc,marie->identity);
+	msg = create_message_from_sintel_trailer(chat_room);
+	linphone_chat_message_send(msg);
+
+	/* wait for marie to receive pauline's msg */
+	BC_ASSERT_TRUE(wait_for_until(pauline->lc,marie->lc,&marie->stat.number_of_LinphoneMessageReceivedWithFile,1, 60000));
+
+	if (marie->stat.last_received_chat_message) {
+		LinphoneChatMessage *recv_msg = marie->stat.last_received_chat_message;
+		LinphoneChatMessageCbs *cbs = linphone_chat_message_get_callbacks(recv_msg);
+		linphone_chat_message_cbs_set_msg_state_changed(cbs, liblinphone_tester_chat_message_msg_state_changed);
+		/* no file path is set, every chunk is handed to the application in a buffer */
+		linphone_chat_message_cbs_set_file_transfer_recv(cbs, file_transfer_received_holding_buffers);
+		linphone_chat_message_cbs_set_file_transfer_progress_indication(cbs, file_transfer_progress_indication);
+		linphone_chat_message_download_file(recv_msg);
+
+		if (BC_ASSERT_TRUE(wait_for_until(pauline->lc,marie->lc,&marie->stat.number_of_LinphoneFileTransferDownloadSuccessful,1,55000))) {
+			/* file_transfer_received stored the chunks in the file set as file_transfer_filepath */
+			const char *receive_filepath = linphone_chat_message_get_file_transfer_filepath(recv_msg);
+			compare_files(send_filepath, receive_filepath);
+			remove(receive_filepath);
+		}
+	}
+	if (held_recv_buffer) {
+		linphone_buffer_unref(held_recv_buffer);
+		ms_free(held_recv_content);
+		held_recv_buffer = NULL;
+		held_recv_content = NULL;
+	}
+
+	bc_free(send_filepath);
+	linphone_chat_message_unref(msg);
+	linphone_core_manager_destroy(marie);
+	linphone_core_manager_destroy(pauline);
+}
+
 static void transfer_message_auto_download_aborted(void) {
 	LinphoneCoreManager* marie = linphone_core_manager_new("marie_rc");
 	LinphoneCoreManager* pauline = linphone_core_manager_new("pauline_tcp_rc");
@@ -3437,6 +3734,9 @@ static void migration_from_messages_db (void) {
 
 test_t message_tests[] = {
 	TEST_NO_TAG("Text message", text_message),
+#ifndef _WIN32
+	TEST_NO_TAG("Text message with metrics", text_message_with_metrics),
+#endif
 	TEST_NO_TAG("Transfer forward message", text_forward_message),
 	TEST_NO_TAG("Text message UTF8", text_message_with_utf8),
 	TEST_NO_TAG("Text message with credentials from auth callback", text_message_with_credential_from_auth_callback),
@@ -3464,6 +3764,9 @@ test_t message_tests[] = {
 	TEST_NO_TAG("Transfer message upload cancelled", transfer_message_upload_cancelled),
 	TEST_NO_TAG("Transfer message upload finished during stop", transfer_message_upload_finished_during_stop),
 	TEST_NO_TAG("Transfer message download cancelled", transfer_message_download_cancelled),
+	TEST_NO_TAG("Transfer message download resumed", transfer_message_download_resumed),
+	TEST_NO_TAG("Transfer message download not resumed onto another file", transfer_message_download_not_resumed_onto_other_file),
+	TEST_NO_TAG("Transfer message download to buffers", transfer_message_download_to_buffers),
 	TEST_NO_TAG("Transfer message auto download aborted", transfer_message_auto_download_aborted),
 	TEST_NO_TAG("Transfer message core stopped async 1", transfer_message_core_stopped_async_1),
 	TEST_NO_TAG("Transfer message core stopped async 2", transfer_message_core_stopped_async_2),
@@ -26,6 +26,7 @@
 #include "tester_utils.h"
 #include "sal/sal_media_description.h"
 #include "sal/sal_stream_description.h"
+#include "sal/offeranswer.h"
 
 using namespace LinphonePrivate;
 
@@ -793,8 +794,66 @@ end:
 }
 #endif
 
+static std::shared_ptr<SalMediaDescription> create_audio_media_description(int codecs, bool uppercase, int rtp_port) {
+	auto md = std::make_shared<SalMediaDescription>();
+	SalStreamDescription stream;
+	stream.type = SalAudio;
+	stream.proto = SalProtoRtpAvp;
+	stream.dir = SalStreamSendRecv;
+	stream.rtp_addr = "127.0.0.1";
+	stream.rtp_port = rtp_port;
+	stream.rtcp_port = rtp_port + 1;
+	for (int i = 0; i < codecs; i++) {
+		/* The remote side lists the codecs in the reverse order, with its own numbering. */
+		int index = uppercase ? codecs - 1 - i : i;
+		PayloadType *pt = payload_type_new();
+		pt->type = PAYLOAD_AUDIO_PACKETIZED;
+		pt->mime_type = ms_strdup_printf(uppercase ? "X-CODEC-%d" : "x-codec-%d", index);
+		pt->clock_rate = (index % 3 == 0) ? 48000 : (index % 3 == 1) ? 16000 : 8000;
+		pt->channels = 1 + index % 2;
+		payload_type_set_number(pt, 96 + (uppercase ? i : index));
+		stream.payloads.push_back(pt);
+	}
+	md->streams.push_back(stream);
+	return md;
+}
+
+static void offer_answer_payload_matching_benchmark(void) {
+	const int codecs = 30;
+	const int offers = 10000;
+	LinphoneCore *lc = linphone_factory_create_core_3(linphone_factory_get(), NULL, liblinphone_tester_get_empty_rc(), system_context);
+	MSFactory *factory = linphone_core_get_ms_factory(lc);
+	auto local = create_audio_media_description(codecs, false, 7078);
+	auto remote = create_audio_media_description(codecs, true, 9078);
+	uint64_t start = bctbx_get_cur_time_ms();
+	uint64_t elapsed;
+	int matched = 0;
+
+	for (int i = 0; i < offers; i++) {
+		auto result = std::make_shared<SalMediaDescription>();
+		OfferAnswerEngine::initiateIncoming(factory, local, remote, result, FALSE);
+		if (result->streams.size() == 1 && result->streams[0].payloads.size() == (size_t)codecs)
+			matched++;
+		if (i == 0 && BC_ASSERT_EQUAL((int)result->streams.size(), 1, int, "%d")) {
+			/* The answer follows the order and the numbering of the offer, with the local mime types. */
+			const PayloadType *pt = result->streams[0].payloads.front();
+			BC_ASSERT_STRING_EQUAL(pt->mime_type, "x-codec-29");
+			BC_ASSERT_EQUAL(payload_type_get_number(pt), 96, int, "%d");
+		}
+	}
+	elapsed = bctbx_get_cur_time_ms() - start;
+	BC_ASSERT_EQUAL(matched, offers, int, "%d");
+	ms_message("Offer/answer of %d offers of %d codecs against %d local codecs: %llu ms, %.2f us per offer",
+		offers, codecs, codecs, (unsigned long long)elapsed, (double)elapsed * 1000 / offers);
+	/* Matching budget, in milliseconds. */
+	BC_ASSERT_LOWER((int)elapsed, 5000, int, "%d");
+
+	linphone_core_unref(lc);
+}
+
 static test_t offeranswer_tests[] = {
 	TEST_NO_TAG("Start with no config", start_with_no_config),
+	TEST_NO_TAG("Payload matching benchmark", offer_answer_payload_matching_benchmark),
 	TEST_NO_TAG("Call failed because of codecs", call_failed_because_of_codecs),
 	TEST_NO_TAG("Simple call with different codec mappings", simple_call_with_different_codec_mappings),
 	TEST_NO_TAG("Simple call with fmtps", simple_call_with_fmtps),
@@ -409,6 +409,43 @@ static void simple_subscribe_with_friend_from_rc(void) {
 	linphone_core_manager_destroy(pauline);
 }
 
+static void subscribe_large_friend_list_in_batches(void) {
+	LinphoneCoreManager *marie = linphone_core_manager_new("empty_rc");
+	LinphoneFriendList *lfl = linphone_core_get_default_friend_list(marie->lc);
+	int i;
+
+	linphone_config_set_int(linphone_core_get_config(marie->lc), "sip", "friend_subscribes_per_iteration", 50);
+	linphone_friend_list_enable_subscriptions(lfl, FALSE);
+	for (i = 0; i < 120; i++) {
+		char *uri = bctbx_strdup_printf("sip:friend%i@sip.example.org", i);
+		LinphoneFriend *lf = linphone_core_create_friend_with_address(marie->lc, uri);
+		linphone_friend_enable_subscribes(lf, TRUE);
+		linphone_friend_list_add_friend(lfl, lf);
+		linphone_friend_unref(lf);
+		bctbx_free(uri);
+	}
+
+	/* A list of more than friend_subscribes_per_iteration friends without RLS is subscribed 50 friends per iteration. */
+	linphone_friend_list_enable_subscriptions(lfl, TRUE);
+	BC_ASSERT_EQUAL(linphone_core_get_friends_to_subscribe_count(marie->lc), 120, int, "%d");
+	/* Friends already queued are not queued twice. */
+	linphone_friend_list_update_subscriptions(lfl);
+	BC_ASSERT_EQUAL(linphone_core_get_friends_to_subscribe_count(marie->lc), 120, int, "%d");
+	linphone_core_iterate(marie->lc);
+	BC_ASSERT_EQUAL(linphone_core_get_friends_to_subscribe_count(marie->lc), 70, int, "%d");
+	linphone_core_iterate(marie->lc);
+	BC_ASSERT_EQUAL(linphone_core_get_friends_to_subscribe_count(marie->lc), 20, int, "%d");
+	linphone_core_iterate(marie->lc);
+	BC_ASSERT_EQUAL(linphone_core_get_friends_to_subscribe_count(marie->lc), 0, int, "%d");
+
+	/* Smaller lists are still subscribed at once. */
+	linphone_config_set_int(linphone_core_get_config(marie->lc), "sip", "friend_subscribes_per_iteration", 200);
+	linphone_friend_list_update_subscriptions(lfl);
+	BC_ASSERT_EQUAL(linphone_core_get_friends_to_subscribe_count(marie->lc), 0, int, "%d");
+
+	linphone_core_manager_destroy(marie);
+}
+
 test_t presence_tests[] = {
 	TEST_ONE_TAG("Simple Subscribe", simple_subscribe,"presence"),
 	TEST_ONE_TAG("Simple Subscribe with early NOTIFY", simple_subscribe_with_early_notify,"presence"),
@@ -419,6 +456,7 @@ test_t presence_tests[] = {
 	TEST_ONE_TAG("App managed presence failure", subscribe_failure_handle_by_app,"presence"),
 	TEST_NO_TAG("Presence SUBSCRIBE forked", subscribe_presence_forked),
 	TEST_NO_TAG("Presence SUBSCRIBE expired", subscribe_presence_expired),
+	TEST_NO_TAG("Subscribe large friend list in batches", subscribe_large_friend_list_in_batches),
 };
 
 test_suite_t presence_test_suite = {"Presence", NULL, NULL, liblinphone_tester_before_each, liblinphone_tester_after_each,
@@ -936,6 +936,149 @@ static void proxy_config_push_notification_params_two_proxies_both_push_3(void)
 	proxy_config_push_notification_scenario_3(FALSE, TRUE, TRUE);
 }
 
+static void proxy_config_lookup_with_many_accounts(void) {
+	LinphoneCoreManager *manager = linphone_core_manager_new(NULL);
+	LinphoneCore *lc = manager->lc;
+	const int account_count = 5000;
+	const int lookup_count = 20000;
+	LinphoneProxyConfig **proxies = ms_new0(LinphoneProxyConfig *, account_count);
+	LinphoneAddress **identities = ms_new0(LinphoneAddress *, account_count);
+	LinphoneAddress **destinations = ms_new0(LinphoneAddress *, account_count);
+	uint64_t start, elapsed;
+	int i, wrong = 0;
+
+	start = bctbx_get_cur_time_ms();
+	for (i = 0; i < account_count; i++) {
+		char *identity = bctbx_strdup_printf("sip:account%i@domain%i.example.org", i, i);
+		char *server = bctbx_strdup_printf("sip:domain%i.example.org", i);
+		char *destination = bctbx_strdup_printf("sip:someone@domain%i.example.org", i);
+		LinphoneProxyConfig *cfg = linphone_core_create_proxy_config(lc);
+		identities[i] = linphone_address_new(identity);
+		destinations[i] = linphone_address_new(destination);
+		linphone_proxy_config_set_identity_address(cfg, identities[i]);
+		linphone_proxy_config_set_server_addr(cfg, server);
+		linphone_proxy_config_enable_register(cfg, FALSE);
+		linphone_core_add_proxy_config(lc, cfg);
+		proxies[i] = cfg;
+		bctbx_free(identity);
+		bctbx_free(server);
+		bctbx_free(destination);
+	}
+	ms_message("Added %i proxy configs in %llu ms", account_count, (unsigned long long)(bctbx_get_cur_time_ms() - start));
+
+	start = bctbx_get_cur_time_ms();
+	for (i = 0; i < lookup_count; i++) {
+		int index = (i * 7919) % account_count;
+		if (linphone_core_lookup_known_proxy(lc, destinations[index]) != proxies[index]) wrong++;
+		if (linphone_core_lookup_proxy_by_identity(lc, identities[index]) != proxies[index]) wrong++;
+	}
+	elapsed = bctbx_get_cur_time_ms() - start;
+	BC_ASSERT_EQUAL(wrong, 0, int, "%d");
+	ms_message("Routing lookups with %i accounts: %.2f us per message", account_count, (double)elapsed * 1000 / lookup_count);
+
+	start = bctbx_get_cur_time_ms();
+	for (i = 0; i < 100; i++) linphone_core_iterate(lc);
+	ms_message("Iterate with %i idle accounts: %.2f ms", account_count, (double)(bctbx_get_cur_time_ms() - start) / 100);
+
+	/* Indexes follow removals and identity changes. */
+	linphone_core_remove_proxy_config(lc, proxies[42]);
+	BC_ASSERT_TRUE(linphone_core_lookup_proxy_by_identity(lc, identities[42]) != proxies[42]);
+	linphone_proxy_config_edit(proxies[43]);
+	linphone_proxy_config_set_identity_address(proxies[43], identities[42]);
+	linphone_proxy_config_done(proxies[43]);
+	BC_ASSERT_PTR_EQUAL(linphone_core_lookup_proxy_by_identity(lc, identities[42]), proxies[43]);
+	BC_ASSERT_PTR_EQUAL(linphone_core_lookup_known_proxy(lc, destinations[42]), proxies[43]);
+
+	for (i = 0; i < account_count; i++) {
+		linphone_proxy_config_unref(proxies[i]);
+		linphone_address_unref(identities[i]);
+		linphone_address_unref(destinations[i]);
+	}
+	ms_free(proxies);
+	ms_free(identities);
+	ms_free(destinations);
+	linphone_core_manager_destroy(manager);
+}
+
+/* Lookup of the country calling code as it was done before the dial plan index, one scan of the table per digit. */
+static int linear_lookup_ccc_from_e164(const bctbx_list_t *dial_plans, const char *e164) {
+	const LinphoneDialPlan *elected = NULL;
+	unsigned int found;
+	unsigned int i = 0;
+
+	if (e164[0] != '+') return -1;
+	if (e164[1] == '1') return 1;
+	do {
+		const bctbx_list_t *it;
+		found = 0;
+		i++;
+		for (it = dial_plans; it != NULL; it = it->next) {
+			if (strncmp(linphone_dial_plan_get_country_calling_code((LinphoneDialPlan *)it->data), &e164[1], i) == 0) {
+				elected = (LinphoneDialPlan *)it->data;
+				found++;
+			}
+		}
+	} while ((found > 1 || found == 0) && i < strlen(e164) - 1);
+	return found == 1 ? (int)strtol(linphone_dial_plan_get_country_calling_code(elected), NULL, 10) : -1;
+}
+
+static void phone_normalization_benchmark(void) {
+	const int number_count = 100000;
+	bctbx_list_t *dial_plans = linphone_dial_plan_get_all_list();
+	int dial_plan_count = (int)bctbx_list_size(dial_plans);
+	char **numbers = ms_new0(char *, number_count);
+	LinphoneProxyConfig *proxy = linphone_core_create_proxy_config(NULL);
+	uint64_t start, indexed_ms, linear_ms;
+	int i, expected, wrong = 0, normalized = 0;
+	int *cccs = ms_new0(int, number_count);
+
+	/* A phone book import: numbers of every country, plus a few with a prefix that matches no country. */
+	for (i = 0; i < number_count; i++) {
+		const LinphoneDialPlan *dial_plan = (LinphoneDialPlan *)bctbx_list_nth_data(dial_plans, i % dial_plan_count);
+		belle_sip_object_remove_from_leak_detector((void *)dial_plan);
+		if (i % 100 == 99) {
+			numbers[i] = ms_strdup_printf("+999%08i", i);
+		} else {
+			numbers[i] = generate_random_e164_phone_from_dial_plan(dial_plan);
+		}
+	}
+
+	start = bctbx_get_cur_time_ms();
+	for (i = 0; i < number_count; i++)
+		cccs[i] = linphone_dial_plan_lookup_ccc_from_e164(numbers[i]);
+	indexed_ms = bctbx_get_cur_time_ms() - start;
+
+	start = bctbx_get_cur_time_ms();
+	for (i = 0; i < number_count; i++) {
+		expected = linear_lookup_ccc_from_e164(dial_plans, numbers[i]);
+		if (cccs[i] != expected) {
+			if (wrong++ == 0) ms_error("Country calling code of [%s] is %i instead of %i", numbers[i], cccs[i], expected);
+		}
+	}
+	linear_ms = bctbx_get_cur_time_ms() - start;
+	BC_ASSERT_EQUAL(wrong, 0, int, "%d");
+
+	start = bctbx_get_cur_time_ms();
+	for (i = 0; i < number_count; i++) {
+		char *result = linphone_proxy_config_normalize_phone_number(proxy, numbers[i]);
+		if (result) {
+			normalized++;
+			ms_free(result);
+		}
+	}
+	ms_message("Country calling codes of %i numbers with %i dial plans: %llu ms with the index, %llu ms with table scans",
+		number_count, dial_plan_count, (unsigned long long)indexed_ms, (unsigned long long)linear_ms);
+	ms_message("Normalized %i phone numbers in %llu ms", normalized, (unsigned long long)(bctbx_get_cur_time_ms() - start));
+	BC_ASSERT_EQUAL(normalized, number_count, int, "%d");
+	BC_ASSERT_LOWER(indexed_ms, linear_ms, unsigned long long, "%llu");
+
+	for (i = 0; i < number_count; i++) ms_free(numbers[i]);
+	ms_free(numbers);
+	ms_free(cccs);
+	linphone_proxy_config_unref(proxy);
+	bctbx_list_free_with_data(dial_plans, (bctbx_list_free_func)linphone_dial_plan_unref);
+}
+
 test_t proxy_config_tests[] = {
 	TEST_NO_TAG("Phone normalization without proxy", phone_normalization_without_proxy),
 	TEST_NO_TAG("Phone normalization with proxy", phone_normalization_with_proxy),
@@ -947,6 +1090,8 @@ test_t proxy_config_tests[] = {
 	TEST_NO_TAG("Dependent proxy dependency register", proxy_config_dependent_register),
 	TEST_NO_TAG("Dependent proxy state changed", proxy_config_dependent_register_state_changed),
 	TEST_NO_TAG("Dependent proxy dependency removal", dependent_proxy_dependency_removal),
+	TEST_NO_TAG("Proxy lookup with many accounts", proxy_config_lookup_with_many_accounts),
+	TEST_NO_TAG("Phone normalization benchmark", phone_normalization_benchmark),
 	TEST_ONE_TAG("Dependent proxy dependency with core reloaded", dependent_proxy_dependency_with_core_reloaded, "LeaksMemory"),
 	TEST_ONE_TAG("Push notification params", proxy_config_push_notification_params, "Push Notification"),
 	TEST_ONE_TAG("Push notification params 2", proxy_config_push_notification_params_2, "Push Notification"),
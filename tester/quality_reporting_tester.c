@@ -17,6 +17,9 @@
  * along with this program. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <math.h>
+#include <time.h>
+
 #include "linphone/core.h"
 #include "liblinphone_tester.h"
 #include "tester_utils.h"
@@ -491,6 +494,263 @@ static void video_bandwidth_estimation (void) {
 	linphone_core_manager_destroy(pauline);
 }
 
+/* Serialization of the reports as it was done with printf, kept as a reference for the direct formatting. */
+static char *legacy_one_decimal_string(float f) {
+	float rounded_f = floorf(f * 10 + .5f) / 10;
+	int floor_part = (int) rounded_f;
+	int one_decimal_part = (int)floorf(10 * (rounded_f - (float)floor_part) + .5f);
+	return ms_strdup_printf("%d.%d", floor_part, one_decimal_part);
+}
+
+static char *legacy_timestamp_string(time_t timestamp) {
+	char str[32];
+	strftime(str, sizeof(str), "%Y-%m-%dT%H:%M:%SZ", gmtime(&timestamp));
+	return ms_strdup(str);
+}
+
+#define LEGACY_APPEND_IF_NOT_NULL_STR(buffer, fmt, arg) if (arg != NULL) buffer = ms_strcat_printf(buffer, fmt, arg)
+#define LEGACY_APPEND_IF_NUM_IN_RANGE(buffer, fmt, arg, inf, sup) if (inf <= arg && arg <= sup) buffer = ms_strcat_printf(buffer, fmt, arg)
+#define LEGACY_APPEND_IF(buffer, fmt, arg, cond) if (cond) buffer = ms_strcat_printf(buffer, fmt, arg)
+
+#define LEGACY_IN_RANGE(num, inf, sup) (inf <= (num) && (num) <= sup)
+
+enum { LegacySessionDescription = 1, LegacyJitterBuffer = 2, LegacyDelay = 4, LegacySignal = 8, LegacyQualityEstimates = 16 };
+
+static int legacy_available_metrics(const reporting_content_metrics_t *rm) {
+	int rtcp_count = rm->rtcp_sr_count + rm->rtcp_xr_count;
+	int ret = 0;
+
+	if (rm->session_description.payload_type != -1 || rm->session_description.payload_desc != NULL
+		|| rm->session_description.sample_rate != -1 || rm->session_description.fmtp != NULL)
+		ret |= LegacySessionDescription;
+	if (LEGACY_IN_RANGE(rm->jitter_buffer.adaptive, 0, 3) || LEGACY_IN_RANGE(rm->jitter_buffer.abs_max, 0, 65535)
+		|| (rm->rtcp_xr_count > 0 && LEGACY_IN_RANGE(rm->jitter_buffer.nominal / rm->rtcp_xr_count, 0, 65535))
+		|| (rm->rtcp_xr_count > 0 && LEGACY_IN_RANGE(rm->jitter_buffer.max / rm->rtcp_xr_count, 0, 65535)))
+		ret |= LegacyJitterBuffer;
+	if (LEGACY_IN_RANGE(rm->delay.end_system_delay, 0, 65535) || LEGACY_IN_RANGE(rm->delay.interarrival_jitter, 0, 65535)
+		|| LEGACY_IN_RANGE(rm->delay.mean_abs_jitter, 0, 65535)
+		|| (rtcp_count > 0 && LEGACY_IN_RANGE(rm->delay.round_trip_delay / rtcp_count, 0, 65535)))
+		ret |= LegacyDelay;
+	if (rm->signal.level != 127 || rm->signal.noise_level != 127)
+		ret |= LegacySignal;
+	if (LEGACY_IN_RANGE(rm->quality_estimates.moslq, 1, 5) || LEGACY_IN_RANGE(rm->quality_estimates.moscq, 1, 5))
+		ret |= LegacyQualityEstimates;
+	return ret;
+}
+
+/* Packet loss rates are only written with the jitter buffer but are enough for the remote metrics to be sent. */
+static bool_t legacy_metrics_filled(const reporting_content_metrics_t *rm) {
+	return legacy_available_metrics(rm) != 0
+		|| LEGACY_IN_RANGE(rm->packet_loss.network_packet_loss_rate, 0, 255)
+		|| LEGACY_IN_RANGE(rm->packet_loss.jitter_buffer_discard_rate, 0, 255);
+}
+
+static char *legacy_append_metrics(char *buffer, const reporting_content_metrics_t *rm) {
+	char *start_str = rm->timestamps.start > 0 ? legacy_timestamp_string(rm->timestamps.start) : NULL;
+	char *stop_str = rm->timestamps.stop > 0 ? legacy_timestamp_string(rm->timestamps.stop) : NULL;
+	char *nlr_str = NULL, *jdr_str = NULL, *moslq_str = NULL, *moscq_str = NULL;
+	int available_metrics = legacy_available_metrics(rm);
+
+	buffer = ms_strcat_printf(buffer, "Timestamps:");
+	LEGACY_APPEND_IF_NOT_NULL_STR(buffer, " START=%s", start_str);
+	LEGACY_APPEND_IF_NOT_NULL_STR(buffer, " STOP=%s", stop_str);
+	if (available_metrics & LegacySessionDescription) {
+		buffer = ms_strcat_printf(buffer, "\r\nSessionDesc:");
+		LEGACY_APPEND_IF(buffer, " PT=%d", rm->session_description.payload_type, rm->session_description.payload_type != -1);
+		LEGACY_APPEND_IF_NOT_NULL_STR(buffer, " PD=%s", rm->session_description.payload_desc);
+		LEGACY_APPEND_IF(buffer, " SR=%d", rm->session_description.sample_rate, rm->session_description.sample_rate != -1);
+		LEGACY_APPEND_IF(buffer, " FD=%d", rm->session_description.frame_duration, rm->session_description.frame_duration != -1);
+		LEGACY_APPEND_IF_NOT_NULL_STR(buffer, " FMTP=\"%s\"", rm->session_description.fmtp);
+		LEGACY_APPEND_IF(buffer, " PLC=%d", rm->session_description.packet_loss_concealment, rm->session_description.packet_loss_concealment != -1);
+	}
+	if (available_metrics & LegacyJitterBuffer) {
+		buffer = ms_strcat_printf(buffer, "\r\nJitterBuffer:");
+		LEGACY_APPEND_IF_NUM_IN_RANGE(buffer, " JBA=%d", rm->jitter_buffer.adaptive, 0, 3);
+		if (rm->rtcp_xr_count) {
+			LEGACY_APPEND_IF_NUM_IN_RANGE(buffer, " JBN=%d", rm->jitter_buffer.nominal / rm->rtcp_xr_count, 0, 65535);
+			LEGACY_APPEND_IF_NUM_IN_RANGE(buffer, " JBM=%d", rm->jitter_buffer.max / rm->rtcp_xr_count, 0, 65535);
+		}
+		LEGACY_APPEND_IF_NUM_IN_RANGE(buffer, " JBX=%d", rm->jitter_buffer.abs_max, 0, 65535);
+		buffer = ms_strcat_printf(buffer, "\r\nPacketLoss:");
+		if (LEGACY_IN_RANGE(rm->packet_loss.network_packet_loss_rate, 0, 255))
+			nlr_str = legacy_one_decimal_string(rm->packet_loss.network_packet_loss_rate / 256);
+		if (LEGACY_IN_RANGE(rm->packet_loss.jitter_buffer_discard_rate, 0, 255))
+			jdr_str = legacy_one_decimal_string(rm->packet_loss.jitter_buffer_discard_rate / 256);
+		LEGACY_APPEND_IF_NOT_NULL_STR(buffer, " NLR=%s", nlr_str);
+		LEGACY_APPEND_IF_NOT_NULL_STR(buffer, " JDR=%s", jdr_str);
+	}
+	if (available_metrics & LegacyDelay) {
+		buffer = ms_strcat_printf(buffer, "\r\nDelay:");
+		if (rm->rtcp_xr_count + rm->rtcp_sr_count) {
+			LEGACY_APPEND_IF_NUM_IN_RANGE(buffer, " RTD=%d", rm->delay.round_trip_delay / (rm->rtcp_xr_count + rm->rtcp_sr_count), 0, 65535);
+		}
+		LEGACY_APPEND_IF_NUM_IN_RANGE(buffer, " ESD=%d", rm->delay.end_system_delay, 0, 65535);
+		LEGACY_APPEND_IF_NUM_IN_RANGE(buffer, " IAJ=%d", rm->delay.interarrival_jitter, 0, 65535);
+		LEGACY_APPEND_IF_NUM_IN_RANGE(buffer, " MAJ=%d", rm->delay.mean_abs_jitter, 0, 65535);
+	}
+	if (available_metrics & LegacySignal) {
+		buffer = ms_strcat_printf(buffer, "\r\nSignal:");
+		LEGACY_APPEND_IF(buffer, " SL=%d", rm->signal.level, rm->signal.level != 127);
+		LEGACY_APPEND_IF(buffer, " NL=%d", rm->signal.noise_level, rm->signal.noise_level != 127);
+	}
+	if (available_metrics & LegacyQualityEstimates) {
+		if (LEGACY_IN_RANGE(rm->quality_estimates.moslq, 1, 5))
+			moslq_str = legacy_one_decimal_string(rm->quality_estimates.moslq);
+		if (LEGACY_IN_RANGE(rm->quality_estimates.moscq, 1, 5))
+			moscq_str = legacy_one_decimal_string(rm->quality_estimates.moscq);
+		buffer = ms_strcat_printf(buffer, "\r\nQualityEst:");
+		LEGACY_APPEND_IF_NOT_NULL_STR(buffer, " MOSLQ=%s", moslq_str);
+		LEGACY_APPEND_IF_NOT_NULL_STR(buffer, " MOSCQ=%s", moscq_str);
+	}
+	if (rm->user_agent != NULL) {
+		buffer = ms_strcat_printf(buffer, "\r\nLinphoneExt:");
+		LEGACY_APPEND_IF_NOT_NULL_STR(buffer, " UA=\"%s\"", rm->user_agent);
+	}
+	buffer = ms_strcat_printf(buffer, "\r\n");
+
+	if (start_str) ms_free(start_str);
+	if (stop_str) ms_free(stop_str);
+	if (nlr_str) ms_free(nlr_str);
+	if (jdr_str) ms_free(jdr_str);
+	if (moslq_str) ms_free(moslq_str);
+	if (moscq_str) ms_free(moscq_str);
+	return buffer;
+}
+
+static char *legacy_serialize_report(const reporting_session_report_t *report, const char *report_event) {
+	char *buffer = ms_strdup_printf("%s\r\n", report_event);
+	buffer = ms_strcat_printf(buffer, "CallID: %s\r\n", report->info.call_id);
+	buffer = ms_strcat_printf(buffer, "LocalID: %s\r\n", report->info.local_addr.id);
+	buffer = ms_strcat_printf(buffer, "RemoteID: %s\r\n", report->info.remote_addr.id);
+	buffer = ms_strcat_printf(buffer, "OrigID: %s\r\n", report->info.orig_id);
+	LEGACY_APPEND_IF_NOT_NULL_STR(buffer, "LocalGroup: %s\r\n", report->info.local_addr.group);
+	LEGACY_APPEND_IF_NOT_NULL_STR(buffer, "RemoteGroup: %s\r\n", report->info.remote_addr.group);
+	buffer = ms_strcat_printf(buffer, "LocalAddr: IP=%s PORT=%d SSRC=%u\r\n", report->info.local_addr.ip, report->info.local_addr.port, report->info.local_addr.ssrc);
+	LEGACY_APPEND_IF_NOT_NULL_STR(buffer, "LocalMAC: %s\r\n", report->info.local_addr.mac);
+	buffer = ms_strcat_printf(buffer, "RemoteAddr: IP=%s PORT=%d SSRC=%u\r\n", report->info.remote_addr.ip, report->info.remote_addr.port, report->info.remote_addr.ssrc);
+	LEGACY_APPEND_IF_NOT_NULL_STR(buffer, "RemoteMAC: %s\r\n", report->info.remote_addr.mac);
+	buffer = ms_strcat_printf(buffer, "LocalMetrics:\r\n");
+	buffer = legacy_append_metrics(buffer, &report->local_metrics);
+	if (legacy_metrics_filled(&report->remote_metrics)) {
+		buffer = ms_strcat_printf(buffer, "RemoteMetrics:\r\n");
+		buffer = legacy_append_metrics(buffer, &report->remote_metrics);
+	}
+	LEGACY_APPEND_IF_NOT_NULL_STR(buffer, "DialogID: %s\r\n", report->dialog_id);
+	if (report->qos_analyzer.timestamp != NULL) {
+		buffer = ms_strcat_printf(buffer, "AdaptiveAlg:");
+		LEGACY_APPEND_IF_NOT_NULL_STR(buffer, " NAME=\"%s\"", report->qos_analyzer.name);
+		LEGACY_APPEND_IF_NOT_NULL_STR(buffer, " TS=\"%s\"", report->qos_analyzer.timestamp);
+		LEGACY_APPEND_IF_NOT_NULL_STR(buffer, " IN_LEG=\"%s\"", report->qos_analyzer.input_leg);
+		LEGACY_APPEND_IF_NOT_NULL_STR(buffer, " IN=\"%s\"", report->qos_analyzer.input);
+		LEGACY_APPEND_IF_NOT_NULL_STR(buffer, " OUT_LEG=\"%s\"", report->qos_analyzer.output_leg);
+		LEGACY_APPEND_IF_NOT_NULL_STR(buffer, " OUT=\"%s\"", report->qos_analyzer.output);
+		buffer = ms_strcat_printf(buffer, "\r\n");
+	}
+	return buffer;
+}
+
+static unsigned int synthetic_report_seed = 1;
+
+static int synthetic_value(int min, int max) {
+	synthetic_report_seed = synthetic_report_seed * 1103515245 + 12345;
+	return min + (int)((synthetic_report_seed >> 8) % (unsigned int)(max - min + 1));
+}
+
+static char *synthetic_string(char *value) {
+	return synthetic_value(0, 4) == 0 ? NULL : value;
+}
+
+static void fill_synthetic_metrics(reporting_content_metrics_t *rm) {
+	static char *payloads[] = { (char *)"opus", (char *)"PCMU", (char *)"speex", (char *)"VP8" };
+
+	memset(rm, 0, sizeof(*rm));
+	rm->timestamps.start = synthetic_value(0, 1) ? (time_t)synthetic_value(1000000000, 2000000000) : 0;
+	rm->timestamps.stop = synthetic_value(0, 1) ? rm->timestamps.start + synthetic_value(0, 7200) : 0;
+	rm->session_description.payload_type = synthetic_value(-1, 127);
+	rm->session_description.payload_desc = synthetic_string(payloads[synthetic_value(0, 3)]);
+	rm->session_description.sample_rate = synthetic_value(0, 1) ? -1 : synthetic_value(8000, 48000);
+	rm->session_description.frame_duration = synthetic_value(-1, 60);
+	rm->session_description.fmtp = synthetic_string((char *)"useinbandfec=1; stereo=0");
+	rm->session_description.packet_loss_concealment = synthetic_value(-1, 3);
+	rm->jitter_buffer.adaptive = synthetic_value(-1, 4);
+	rm->jitter_buffer.nominal = synthetic_value(-100, 200000);
+	rm->jitter_buffer.max = synthetic_value(-100, 200000);
+	rm->jitter_buffer.abs_max = synthetic_value(-100, 70000);
+	rm->packet_loss.network_packet_loss_rate = (float)synthetic_value(-10, 300) + (float)synthetic_value(0, 99) / 100;
+	rm->packet_loss.jitter_buffer_discard_rate = (float)synthetic_value(-10, 300) + (float)synthetic_value(0, 99) / 100;
+	rm->delay.round_trip_delay = synthetic_value(-10, 140000);
+	rm->delay.end_system_delay = synthetic_value(-10, 70000);
+	rm->delay.interarrival_jitter = synthetic_value(-10, 70000);
+	rm->delay.mean_abs_jitter = synthetic_value(-10, 70000);
+	rm->signal.level = synthetic_value(0, 1) ? 127 : synthetic_value(-120, 0);
+	rm->signal.noise_level = synthetic_value(0, 1) ? 127 : synthetic_value(-120, 0);
+	rm->quality_estimates.moslq = (float)synthetic_value(0, 600) / 100;
+	rm->quality_estimates.moscq = (float)synthetic_value(0, 600) / 100;
+	rm->user_agent = synthetic_string((char *)"Linphone/4.5.0 (belle-sip/4.5.0)");
+	rm->rtcp_xr_count = (uint8_t)synthetic_value(0, 3);
+	rm->rtcp_sr_count = (uint8_t)synthetic_value(0, 2);
+}
+
+static void fill_synthetic_report(reporting_session_report_t *report) {
+	memset(report, 0, sizeof(*report));
+	report->info.call_id = synthetic_string((char *)"2ZAqPg7hHL");
+	report->info.orig_id = (char *)"sip:marie@sip.example.org";
+	report->info.local_addr.id = (char *)"sip:marie@sip.example.org";
+	report->info.local_addr.ip = (char *)"192.168.1.10";
+	report->info.local_addr.port = synthetic_value(1024, 65535);
+	report->info.local_addr.ssrc = (uint32_t)synthetic_value(0, 0x3fffffff) * 4u + (uint32_t)synthetic_value(0, 3);
+	report->info.local_addr.group = synthetic_string((char *)"2ZAqPg7hHL-marie");
+	report->info.local_addr.mac = synthetic_string((char *)"00:1b:63:84:45:e6");
+	report->info.remote_addr.id = (char *)"sip:pauline@sip.example.org";
+	report->info.remote_addr.ip = (char *)"2001:db8::1";
+	report->info.remote_addr.port = synthetic_value(1024, 65535);
+	report->info.remote_addr.ssrc = (uint32_t)synthetic_value(0, 0x3fffffff);
+	report->info.remote_addr.group = synthetic_string((char *)"2ZAqPg7hHL-pauline");
+	report->info.remote_addr.mac = synthetic_string((char *)"00:1b:63:84:45:e7");
+	fill_synthetic_metrics(&report->local_metrics);
+	fill_synthetic_metrics(&report->remote_metrics);
+	report->dialog_id = synthetic_string((char *)"2ZAqPg7hHL;to-tag=123;from-tag=456");
+	if (synthetic_value(0, 1)) {
+		report->qos_analyzer.name = synthetic_string((char *)"Stateful");
+		report->qos_analyzer.timestamp = (char *)"1.0;2.5;4.0";
+		report->qos_analyzer.input_leg = synthetic_string((char *)"time loss_rate rtt");
+		report->qos_analyzer.input = synthetic_string((char *)"1.0 0.5 0.1;2.5 1.0 0.2");
+		report->qos_analyzer.output_leg = synthetic_string((char *)"time bandwidth");
+		report->qos_analyzer.output = synthetic_string((char *)"1.0 64;2.5 32");
+	}
+}
+
+static void quality_reporting_serialization(void) {
+	const int report_count = 10000;
+	static const char *events[] = { "VQIntervalReport", "VQSessionReport", "VQSessionReport: CallTerm" };
+	LinphoneCoreManager *marie = linphone_core_manager_new(NULL);
+	reporting_session_report_t report;
+	uint64_t start, legacy_ms = 0, direct_ms = 0;
+	int i, mismatches = 0;
+
+	for (i = 0; i < report_count; i++) {
+		const char *event = events[i % 3];
+		const char *body;
+		char *legacy_body;
+
+		fill_synthetic_report(&report);
+		start = bctbx_get_cur_time_ms();
+		legacy_body = legacy_serialize_report(&report, event);
+		legacy_ms += bctbx_get_cur_time_ms() - start;
+		start = bctbx_get_cur_time_ms();
+		body = linphone_reporting_serialize_report(marie->lc, &report, event);
+		direct_ms += bctbx_get_cur_time_ms() - start;
+		if (strcmp(body, legacy_body) != 0 && mismatches++ == 0)
+			ms_error("Report %d differs:\n%s\ninstead of:\n%s", i, body, legacy_body);
+		ms_free(legacy_body);
+	}
+	BC_ASSERT_EQUAL(mismatches, 0, int, "%d");
+	ms_message("Serialized %d reports: %llu ms with printf, %llu ms with direct formatting", report_count,
+		(unsigned long long)legacy_ms, (unsigned long long)direct_ms);
+
+	linphone_core_manager_destroy(marie);
+}
+
 test_t quality_reporting_tests[] = {
 	TEST_NO_TAG("Not used if no config", quality_reporting_not_used_without_config),
 	TEST_NO_TAG("Call term session report not sent if call did not start", quality_reporting_not_sent_if_call_not_started),
@@ -503,7 +763,8 @@ test_t quality_reporting_tests[] = {
 		TEST_NO_TAG("Session report sent if video stopped during call", quality_reporting_session_report_if_video_stopped),
 	#endif // ifdef VIDEO_ENABLED
 	TEST_NO_TAG("Sent using custom route", quality_reporting_sent_using_custom_route),
-	TEST_NO_TAG("Video bandwidth estimation", video_bandwidth_estimation)
+	TEST_NO_TAG("Video bandwidth estimation", video_bandwidth_estimation),
+	TEST_NO_TAG("Serialization", quality_reporting_serialization)
 };
 
 test_suite_t quality_reporting_test_suite = {
@@ -209,6 +209,268 @@ static void simple_register(void){
 	linphone_core_manager_destroy(lcm);
 }
 
+static int wait_for_auto_iterated(int *counter, int value, int timeout_ms) {
+	uint64_t start = bctbx_get_cur_time_ms();
+	while (*counter < value && bctbx_get_cur_time_ms() - start < (uint64_t)timeout_ms)
+		ms_usleep(1000);
+	return *counter >= value;
+}
+
+static void register_with_auto_iterate(void) {
+#if !defined(__ANDROID__) && !TARGET_OS_IPHONE
+	LinphoneCoreManager *marie = linphone_core_manager_create("marie_rc");
+	uint64_t start;
+	uint64_t auto_latency, polled_latency;
+	clock_t cpu_start;
+	double auto_idle_cpu, polled_idle_cpu;
+	unsigned int idle_iterations;
+	int i;
+
+	linphone_core_set_auto_iterate_enabled(marie->lc, TRUE);
+	linphone_core_start(marie->lc);
+	/* Nobody iterates the core from this thread. */
+	BC_ASSERT_TRUE(wait_for_auto_iterated(&marie->stat.number_of_LinphoneRegistrationOk, 1, 20000));
+
+	/* The lock can be nested, the core thread only resumes after the outermost unlock. */
+	start = bctbx_get_cur_time_ms();
+	linphone_core_lock(marie->lc);
+	linphone_core_lock(marie->lc);
+	linphone_core_refresh_registers(marie->lc);
+	linphone_core_unlock(marie->lc);
+	ms_usleep(200000);
+	BC_ASSERT_EQUAL(marie->stat.number_of_LinphoneRegistrationOk, 1, int, "%d");
+	linphone_core_unlock(marie->lc);
+	BC_ASSERT_TRUE(wait_for_auto_iterated(&marie->stat.number_of_LinphoneRegistrationOk, 2, 10000));
+	auto_latency = bctbx_get_cur_time_ms() - start;
+
+	/* Idle, the core thread sleeps up to auto_iterate_idle_interval (1s) instead of iterating every 20ms. */
+	idle_iterations = linphone_core_get_auto_iterate_count(marie->lc);
+	cpu_start = clock();
+	ms_sleep(2);
+	auto_idle_cpu = (double)(clock() - cpu_start) * 1000 / CLOCKS_PER_SEC;
+	idle_iterations = linphone_core_get_auto_iterate_count(marie->lc) - idle_iterations;
+	BC_ASSERT_LOWER(idle_iterations, 10, unsigned int, "%u");
+
+	/* Same measures when the application polls linphone_core_iterate(). */
+	linphone_core_set_auto_iterate_enabled(marie->lc, FALSE);
+	start = bctbx_get_cur_time_ms();
+	linphone_core_refresh_registers(marie->lc);
+	BC_ASSERT_TRUE(wait_for(marie->lc, NULL, &marie->stat.number_of_LinphoneRegistrationOk, 3));
+	polled_latency = bctbx_get_cur_time_ms() - start;
+
+	cpu_start = clock();
+	for (i = 0; i < 100; i++) {
+		linphone_core_iterate(marie->lc);
+		ms_usleep(20000);
+	}
+	polled_idle_cpu = (double)(clock() - cpu_start) * 1000 / CLOCKS_PER_SEC;
+
+	ms_message("Registration refresh: %llu ms with auto iterate, %llu ms when polled",
+		(unsigned long long)auto_latency, (unsigned long long)polled_latency);
+	ms_message("Idle CPU time over 2s: %.1f ms with auto iterate (%u iterations), %.1f ms when polled every 20ms (100 iterations)",
+		auto_idle_cpu, idle_iterations, polled_idle_cpu);
+
+	linphone_core_manager_destroy(marie);
+#endif
+}
+
+static void register_storm_with_rate_limit(void) {
+	LinphoneCoreManager *manager = linphone_core_manager_create(NULL);
+	LinphoneCore *lc = manager->lc;
+	LinphoneProxyConfig *default_cfg = NULL;
+	const int account_count = 5000;
+	const int rate = 2000;
+	uint64_t start, elapsed;
+	int i;
+
+	linphone_config_set_int(linphone_core_get_config(lc), "sip", "register_rate_limit", rate);
+	linphone_config_set_int(linphone_core_get_config(lc), "sip", "register_expires_jitter", 10);
+	linphone_core_manager_start(manager, FALSE);
+
+	/* Nobody answers on this port, like an overloaded registrar: REGISTERs are sent and stay in progress. */
+	for (i = 0; i < account_count; i++) {
+		char *identity = bctbx_strdup_printf("sip:account%i@127.0.0.1", i);
+		LinphoneProxyConfig *cfg = linphone_core_create_proxy_config(lc);
+		LinphoneAddress *identity_address = linphone_address_new(identity);
+		linphone_proxy_config_set_identity_address(cfg, identity_address);
+		linphone_proxy_config_set_server_addr(cfg, "sip:127.0.0.1:5099;transport=udp");
+		linphone_proxy_config_enable_register(cfg, TRUE);
+		linphone_core_add_proxy_config(lc, cfg);
+		if (i == account_count - 1) default_cfg = cfg;
+		linphone_proxy_config_unref(cfg);
+		linphone_address_unref(identity_address);
+		bctbx_free(identity);
+	}
+	linphone_core_set_default_proxy_config(lc, default_cfg);
+
+	/* All accounts want to register when the network comes back. */
+	start = bctbx_get_cur_time_ms();
+	linphone_core_set_network_reachable(lc, TRUE);
+	linphone_core_iterate(lc);
+	BC_ASSERT_LOWER(manager->stat.number_of_LinphoneRegistrationProgress, rate, int, "%d");
+	BC_ASSERT_GREATER(linphone_core_get_register_queue_depth(lc), account_count - rate - 1, int, "%d");
+	BC_ASSERT_EQUAL(linphone_proxy_config_get_state(default_cfg), LinphoneRegistrationProgress, int, "%d");
+
+	BC_ASSERT_TRUE(wait_for_until(lc, NULL, &manager->stat.number_of_LinphoneRegistrationProgress, account_count, 10000));
+	elapsed = bctbx_get_cur_time_ms() - start;
+	BC_ASSERT_GREATER((int)elapsed, 1000, int, "%d");
+	BC_ASSERT_EQUAL(linphone_core_get_register_queue_depth(lc), 0, int, "%d");
+	ms_message("%i accounts registered in %llu ms at %i REGISTER/s, max queue depth %i", account_count,
+		(unsigned long long)elapsed, rate, linphone_core_get_register_queue_max_depth(lc));
+
+	linphone_core_set_network_reachable(lc, FALSE);
+	linphone_core_manager_destroy(manager);
+}
+
+static void many_auth_infos(void) {
+	LinphoneCoreManager *manager = linphone_core_manager_new(NULL);
+	LinphoneCore *lc = manager->lc;
+	LinphoneConfig *config = linphone_core_get_config(lc);
+	const int count = 10000;
+	uint64_t start;
+	int i, wrong = 0;
+
+	start = bctbx_get_cur_time_ms();
+	for (i = 0; i < count; i++) {
+		char *username = bctbx_strdup_printf("user%i", i);
+		LinphoneAuthInfo *info = linphone_auth_info_new(username, NULL, "secret", NULL, NULL, "example.org");
+		linphone_core_add_auth_info(lc, info);
+		linphone_auth_info_unref(info);
+		bctbx_free(username);
+	}
+	ms_message("Added %i auth infos in %llu ms", count, (unsigned long long)(bctbx_get_cur_time_ms() - start));
+	BC_ASSERT_EQUAL((int)bctbx_list_size(linphone_core_get_auth_info_list(lc)), count, int, "%d");
+
+	start = bctbx_get_cur_time_ms();
+	for (i = 0; i < count; i++) {
+		char *username = bctbx_strdup_printf("user%i", (i * 7919) % count);
+		const LinphoneAuthInfo *info = linphone_core_find_auth_info(lc, NULL, username, "example.org");
+		if (!info || strcmp(linphone_auth_info_get_username(info), username) != 0) wrong++;
+		bctbx_free(username);
+	}
+	BC_ASSERT_EQUAL(wrong, 0, int, "%d");
+	ms_message("Found %i auth infos in %llu ms", count, (unsigned long long)(bctbx_get_cur_time_ms() - start));
+	BC_ASSERT_PTR_NULL(linphone_core_find_auth_info(lc, NULL, "nobody", "example.org"));
+
+	/* Updating and removing keep the list, the index and the config consistent. */
+	LinphoneAuthInfo *updated = linphone_auth_info_new("user10", NULL, "other secret", NULL, NULL, "example.org");
+	linphone_core_add_auth_info(lc, updated);
+	linphone_auth_info_unref(updated);
+	BC_ASSERT_EQUAL((int)bctbx_list_size(linphone_core_get_auth_info_list(lc)), count, int, "%d");
+	BC_ASSERT_STRING_EQUAL(linphone_auth_info_get_password(linphone_core_find_auth_info(lc, NULL, "user10", "example.org")), "other secret");
+	/* the update is written in the section of the auth info it replaces */
+	BC_ASSERT_STRING_EQUAL(linphone_config_get_string(config, "auth_info_10", "username", NULL), "user10");
+	BC_ASSERT_STRING_EQUAL(linphone_config_get_string(config, "auth_info_11", "username", NULL), "user11");
+	BC_ASSERT_STRING_EQUAL(linphone_config_get_string(config, "auth_info_9999", "username", NULL), "user9999");
+
+	linphone_core_remove_auth_info(lc, linphone_core_find_auth_info(lc, NULL, "user20", "example.org"));
+	BC_ASSERT_PTR_NULL(linphone_core_find_auth_info(lc, NULL, "user20", "example.org"));
+	BC_ASSERT_FALSE(linphone_config_has_section(config, "auth_info_9999"));
+	BC_ASSERT_STRING_EQUAL(linphone_config_get_string(config, "auth_info_9998", "username", NULL), "user9999");
+	BC_ASSERT_STRING_EQUAL(linphone_config_get_string(config, "auth_info_10", "username", NULL), "user10");
+
+	/* Parsed client certificates are reused. */
+	{
+		char *cert = bc_tester_res("certificates/client/cert.pem");
+		char *key = bc_tester_res("certificates/client/key.pem");
+		belle_sip_certificates_chain_t *chain1, *chain2;
+		belle_sip_signing_key_t *key1, *key2;
+		BC_ASSERT_TRUE(_linphone_core_get_tls_credentials(lc, cert, key, TRUE, &chain1, &key1));
+		BC_ASSERT_TRUE(_linphone_core_get_tls_credentials(lc, cert, key, TRUE, &chain2, &key2));
+		BC_ASSERT_PTR_EQUAL(chain1, chain2);
+		BC_ASSERT_PTR_EQUAL(key1, key2);
+		bctbx_free(cert);
+		bctbx_free(key);
+	}
+
+	linphone_core_clear_all_auth_info(lc);
+	linphone_core_manager_destroy(manager);
+}
+
+/* Registrar stand-in that never answers, counting the first REGISTER of each account per second since its start. */
+typedef struct _RegistrarStandIn {
+	uint64_t start;
+	unsigned char *seen;
+	int account_count;
+	int registers;
+	int per_second[16];
+} RegistrarStandIn;
+
+static int registrar_stand_in_handler(void *user_data, unsigned char *buffer, int len, int size, const struct sockaddr_in *from) {
+	RegistrarStandIn *registrar = (RegistrarStandIn *)user_data;
+	const char *account;
+	int index;
+	int second;
+
+	if (len >= size || strncmp((const char *)buffer, "REGISTER ", 9) != 0) return 0;
+	buffer[len] = '\0';
+	/* Unanswered REGISTERs are retransmitted, only the first one of each account is counted. */
+	account = strstr((const char *)buffer, "sip:account");
+	if (!account) return 0;
+	index = atoi(account + 11);
+	if (index < 0 || index >= registrar->account_count || registrar->seen[index]) return 0;
+	registrar->seen[index] = 1;
+	registrar->registers++;
+	second = (int)((bctbx_get_cur_time_ms() - registrar->start) / 1000);
+	if (second < (int)(sizeof(registrar->per_second) / sizeof(registrar->per_second[0])))
+		registrar->per_second[second]++;
+	return 0;
+}
+
+static void register_rate_limit_at_registrar(void) {
+	LinphoneCoreManager *manager = linphone_core_manager_create(NULL);
+	LinphoneCore *lc = manager->lc;
+	LoopbackUdpStandIn stand_in;
+	RegistrarStandIn registrar = {0};
+	const int account_count = 250;
+	const int rate = 50;
+	char server[64];
+	int i;
+
+	registrar.account_count = account_count;
+	registrar.seen = bctbx_new0(unsigned char, account_count);
+	if (!BC_ASSERT_TRUE(loopback_udp_stand_in_start(&stand_in, registrar_stand_in_handler, &registrar))) {
+		bctbx_free(registrar.seen);
+		linphone_core_manager_destroy(manager);
+		return;
+	}
+	linphone_config_set_int(linphone_core_get_config(lc), "sip", "register_rate_limit", rate);
+	linphone_core_manager_start(manager, FALSE);
+
+	snprintf(server, sizeof(server), "sip:127.0.0.1:%d;transport=udp", stand_in.port);
+	for (i = 0; i < account_count; i++) {
+		char *identity = bctbx_strdup_printf("sip:account%i@127.0.0.1", i);
+		LinphoneProxyConfig *cfg = linphone_core_create_proxy_config(lc);
+		LinphoneAddress *identity_address = linphone_address_new(identity);
+		linphone_proxy_config_set_identity_address(cfg, identity_address);
+		linphone_proxy_config_set_server_addr(cfg, server);
+		linphone_proxy_config_enable_register(cfg, TRUE);
+		linphone_core_add_proxy_config(lc, cfg);
+		linphone_proxy_config_unref(cfg);
+		linphone_address_unref(identity_address);
+		bctbx_free(identity);
+	}
+
+	registrar.start = bctbx_get_cur_time_ms();
+	linphone_core_set_network_reachable(lc, TRUE);
+	loopback_udp_stand_in_wait(lc, &stand_in, &registrar.registers, account_count, 10000);
+	BC_ASSERT_EQUAL(registrar.registers, account_count, int, "%d");
+
+	/* A burst of one second worth of REGISTERs, then the rate limit. A 10% margin is given for the scheduling of the test loop. */
+	for (i = 0; i < (int)(sizeof(registrar.per_second) / sizeof(registrar.per_second[0])); i++) {
+		if (registrar.per_second[i] == 0) continue;
+		ms_message("%i REGISTERs received by the registrar during second %i", registrar.per_second[i], i);
+		BC_ASSERT_LOWER(registrar.per_second[i], (i == 0 ? 2 * rate : rate) + rate / 10, int, "%d");
+	}
+	/* 250 accounts at 50 REGISTER/s after a burst of 50 take 4 seconds. */
+	BC_ASSERT_GREATER(registrar.per_second[3], 1, int, "%d");
+
+	linphone_core_set_network_reachable(lc, FALSE);
+	linphone_core_manager_destroy(manager);
+	loopback_udp_stand_in_stop(&stand_in);
+	bctbx_free(registrar.seen);
+}
+
 static void register_with_custom_headers(void){
 	LinphoneCoreManager *marie=linphone_core_manager_new("marie_rc");
 	LinphoneProxyConfig *cfg=linphone_core_get_default_proxy_config(marie->lc);
@@ -1494,6 +1756,10 @@ test_t register_tests[] = {
 	TEST_NO_TAG("Simple register unregister", simple_unregister),
 	TEST_NO_TAG("TCP register", simple_tcp_register),
 	TEST_NO_TAG("Register with custom headers", register_with_custom_headers),
+	TEST_NO_TAG("Register with auto iterate", register_with_auto_iterate),
+	TEST_NO_TAG("Register storm with rate limit", register_storm_with_rate_limit),
+	TEST_NO_TAG("Register rate limit at registrar", register_rate_limit_at_registrar),
+	TEST_NO_TAG("Many auth infos", many_auth_infos),
 	TEST_NO_TAG("TCP register compatibility mode", simple_tcp_register_compatibility_mode),
 	TEST_NO_TAG("TLS register", simple_tls_register),
 	TEST_NO_TAG("TLS register with alt. name certificate", tls_alt_name_register),
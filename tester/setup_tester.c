@@ -26,6 +26,7 @@
 #include "linphone/friend.h"
 #include "linphone/api/c-magic-search.h"
 #include "tester_utils.h"
+#include "ortp/port.h"
 
 #ifdef __APPLE__
 #include "TargetConditionals.h"
@@ -337,6 +338,368 @@ static void linphone_lpconfig_from_file_zerolen_value(void){
 	linphone_config_destroy(conf);
 }
 
+static void linphone_lpconfig_lazy_sync(void) {
+	const char *value = "a value long enough to make the configuration file weigh a few hundred kilobytes";
+	char *rc_path = bc_tester_file("lazy_sync_rc");
+	char section[32];
+	char key[32];
+	LpConfig *conf;
+	LpConfig *other;
+	uint64_t start, sync_time, background_time;
+	int i, j;
+
+	unlink(rc_path);
+	conf = linphone_config_new(rc_path);
+	for (i = 0; i < 2000; i++) {
+		snprintf(section, sizeof(section), "section_%i", i);
+		for (j = 0; j < 10; j++) {
+			snprintf(key, sizeof(key), "key_%i", j);
+			linphone_config_set_string(conf, section, key, value);
+		}
+	}
+	start = bctbx_get_cur_time_ms();
+	BC_ASSERT_EQUAL(linphone_config_sync(conf), 0, int, "%d");
+	sync_time = bctbx_get_cur_time_ms() - start;
+	BC_ASSERT_FALSE(linphone_config_needs_commit(conf));
+
+	/* Setting a value to what it already is does not modify the config. */
+	linphone_config_set_string(conf, "section_0", "key_0", value);
+	linphone_config_clean_entry(conf, "section_0", "unknown");
+	linphone_config_clean_section(conf, "unknown");
+	BC_ASSERT_FALSE(linphone_config_needs_commit(conf));
+
+	/* A content identical to the one on disk is not written again. */
+	linphone_config_set_string(conf, "section_0", "key_0", "other");
+	linphone_config_set_string(conf, "section_0", "key_0", value);
+	BC_ASSERT_TRUE(linphone_config_needs_commit(conf));
+	BC_ASSERT_FALSE(linphone_config_sync_if_needed(conf));
+	BC_ASSERT_FALSE(linphone_config_needs_commit(conf));
+
+	/* Modifications are coalesced during the sync delay. */
+	linphone_config_set_sync_delay(conf, 200);
+	linphone_config_set_int(conf, "section_1", "key_0", 1);
+	BC_ASSERT_FALSE(linphone_config_sync_if_needed(conf));
+	linphone_config_set_int(conf, "section_1", "key_1", 2);
+	BC_ASSERT_FALSE(linphone_config_sync_if_needed(conf));
+	ms_usleep(250000);
+	BC_ASSERT_TRUE(linphone_config_sync_if_needed(conf));
+	BC_ASSERT_FALSE(linphone_config_needs_commit(conf));
+
+	/* With background sync, the caller only pays for the serialization. */
+	linphone_config_set_sync_delay(conf, 0);
+	linphone_config_enable_background_sync(conf, TRUE);
+	BC_ASSERT_TRUE(linphone_config_background_sync_enabled(conf));
+	linphone_config_set_int(conf, "section_2", "key_0", 3);
+	start = bctbx_get_cur_time_ms();
+	BC_ASSERT_TRUE(linphone_config_sync_if_needed(conf));
+	background_time = bctbx_get_cur_time_ms() - start;
+	ms_message("Writing the config took %llu ms, a background write blocked the caller for %llu ms",
+		(unsigned long long)sync_time, (unsigned long long)background_time);
+	linphone_config_set_int(conf, "section_3", "key_0", 4);
+	BC_ASSERT_TRUE(linphone_config_sync_if_needed(conf));
+	linphone_config_destroy(conf); /* waits for the pending write */
+
+	conf = linphone_config_new(rc_path);
+	BC_ASSERT_EQUAL(linphone_config_get_int(conf, "section_1", "key_1", 0), 2, int, "%d");
+	BC_ASSERT_EQUAL(linphone_config_get_int(conf, "section_2", "key_0", 0), 3, int, "%d");
+	BC_ASSERT_EQUAL(linphone_config_get_int(conf, "section_3", "key_0", 0), 4, int, "%d");
+	BC_ASSERT_STRING_EQUAL(linphone_config_get_string(conf, "section_1999", "key_9", ""), value);
+
+	/* Once reloaded, the content written last is not the one on disk anymore, and is written again. */
+	other = linphone_config_new(rc_path);
+	linphone_config_set_int(conf, "reload", "key", 1);
+	BC_ASSERT_EQUAL(linphone_config_sync(conf), 0, int, "%d");
+	linphone_config_reload(other);
+	linphone_config_set_int(other, "reload", "key", 2);
+	BC_ASSERT_EQUAL(linphone_config_sync(other), 0, int, "%d");
+	linphone_config_reload(conf);
+	BC_ASSERT_EQUAL(linphone_config_get_int(conf, "reload", "key", 0), 2, int, "%d");
+	linphone_config_set_int(conf, "reload", "key", 1);
+	BC_ASSERT_EQUAL(linphone_config_sync(conf), 0, int, "%d");
+	linphone_config_reload(other);
+	BC_ASSERT_EQUAL(linphone_config_get_int(other, "reload", "key", 0), 1, int, "%d");
+	linphone_config_destroy(other);
+	linphone_config_destroy(conf);
+
+	unlink(rc_path);
+	bc_free(rc_path);
+}
+
+static void linphone_lpconfig_snapshot(void) {
+	const char *value = "a value long enough to make the configuration file weigh a few hundred kilobytes";
+	char *rc_path = bc_tester_file("snapshot_rc");
+	char *snapshot_path = bc_tester_file("snapshot_rc.snapshot");
+	char *factory_path = bc_tester_res("rcfiles/zero_length_params_rc");
+	char section[32];
+	char key[32];
+	LpConfig *conf;
+	LinphoneCore *lc;
+	uint64_t start, parse_time, snapshot_time;
+	int i, j;
+
+	unlink(rc_path);
+	unlink(snapshot_path);
+	conf = linphone_config_new(rc_path);
+	for (i = 0; i < 2000; i++) {
+		snprintf(section, sizeof(section), "section_%i", i);
+		for (j = 0; j < 10; j++) {
+			snprintf(key, sizeof(key), "key_%i", j);
+			linphone_config_set_string(conf, section, key, value);
+		}
+	}
+	linphone_config_sync(conf);
+	linphone_config_destroy(conf);
+
+	/* The first instantiation parses the files and builds the snapshot. */
+	start = bctbx_get_cur_time_ms();
+	conf = linphone_config_new_with_snapshot(rc_path, factory_path, snapshot_path);
+	parse_time = bctbx_get_cur_time_ms() - start;
+	BC_ASSERT_PTR_NOT_NULL(conf);
+	BC_ASSERT_EQUAL(ortp_file_exist(snapshot_path), 0, int, "%d");
+	linphone_config_destroy(conf);
+
+	/* The second one loads the snapshot, with the same result. */
+	start = bctbx_get_cur_time_ms();
+	conf = linphone_config_new_with_snapshot(rc_path, factory_path, snapshot_path);
+	snapshot_time = bctbx_get_cur_time_ms() - start;
+	ms_message("Parsing the config took %llu ms, loading its snapshot took %llu ms",
+		(unsigned long long)parse_time, (unsigned long long)snapshot_time);
+	BC_ASSERT_STRING_EQUAL(linphone_config_get_string(conf, "section_1999", "key_9", ""), value);
+	BC_ASSERT_STRING_EQUAL(linphone_config_get_string(conf, "test", "non_zero_len", ""), "test");
+	BC_ASSERT_STRING_EQUAL(linphone_config_get_string(conf, "test", "zero_len", "LOL"), "LOL");
+	BC_ASSERT_FALSE(linphone_config_needs_commit(conf));
+	linphone_config_destroy(conf);
+
+	/* Using another factory config file makes the snapshot stale. */
+	conf = linphone_config_new_with_snapshot(rc_path, NULL, snapshot_path);
+	BC_ASSERT_FALSE(linphone_config_has_section(conf, "test"));
+	BC_ASSERT_STRING_EQUAL(linphone_config_get_string(conf, "section_1999", "key_9", ""), value);
+
+	/* So does modifying the config file. */
+	linphone_config_set_string(conf, "section_0", "key_0", "changed");
+	linphone_config_sync(conf);
+	linphone_config_destroy(conf);
+	conf = linphone_config_new_with_snapshot(rc_path, NULL, snapshot_path);
+	BC_ASSERT_STRING_EQUAL(linphone_config_get_string(conf, "section_0", "key_0", ""), "changed");
+	linphone_config_destroy(conf);
+
+	/* Once enabled, the factory creates the cores with a snapshot stored next to their config file, at the same path as above. */
+	unlink(snapshot_path);
+	linphone_factory_enable_config_snapshot(linphone_factory_get(), TRUE);
+	lc = linphone_factory_create_core_3(linphone_factory_get(), rc_path, NULL, system_context);
+	linphone_factory_enable_config_snapshot(linphone_factory_get(), FALSE);
+	if (BC_ASSERT_PTR_NOT_NULL(lc)) {
+		BC_ASSERT_STRING_EQUAL(linphone_config_get_string(linphone_core_get_config(lc), "section_0", "key_0", ""), "changed");
+		linphone_core_unref(lc);
+	}
+	BC_ASSERT_EQUAL(ortp_file_exist(snapshot_path), 0, int, "%d");
+
+	unlink(rc_path);
+	unlink(snapshot_path);
+	bc_free(rc_path);
+	bc_free(snapshot_path);
+	bc_free(factory_path);
+}
+
+static void startup_timeline(void) {
+	LinphoneCoreManager *manager = linphone_core_manager_create("empty_rc");
+	LinphoneCore *lc = manager->lc;
+	char *src_db = bc_tester_res("db/chatrooms.db");
+	char *tmp_db = bc_tester_file("startup_timeline.db");
+	bool_t core_start_found = FALSE, chat_rooms_found = FALSE;
+	int64_t total = 0;
+	char *json;
+	int i, count;
+
+	/* A database populated with chat rooms and messages. */
+	BC_ASSERT_EQUAL(liblinphone_tester_copy_file(src_db, tmp_db), 0, int, "%d");
+	linphone_config_set_string(linphone_core_get_config(lc), "storage", "uri", tmp_db);
+	linphone_core_manager_start(manager, FALSE);
+
+	count = linphone_core_get_startup_phases_count(lc);
+	BC_ASSERT_GREATER(count, 0, int, "%d");
+	for (i = 0; i < count; i++) {
+		const char *name = linphone_core_get_startup_phase_name(lc, i);
+		int64_t start = linphone_core_get_startup_phase_start(lc, i);
+		int64_t duration = linphone_core_get_startup_phase_duration(lc, i);
+		BC_ASSERT_TRUE(start >= 0);
+		BC_ASSERT_TRUE(duration >= 0);
+		if (start + duration > total) total = start + duration;
+		if (strcmp(name, "core start") == 0) core_start_found = TRUE;
+		if (strcmp(name, "chat rooms") == 0) {
+			chat_rooms_found = TRUE;
+			BC_ASSERT_GREATER(linphone_core_get_startup_phase_db_queries(lc, i), 0, int, "%d");
+		}
+	}
+	BC_ASSERT_TRUE(core_start_found);
+	if (linphone_factory_is_database_storage_available(linphone_factory_get()))
+		BC_ASSERT_TRUE(chat_rooms_found);
+	BC_ASSERT_PTR_NULL(linphone_core_get_startup_phase_name(lc, count));
+
+	/* Startup budget, in milliseconds. */
+	BC_ASSERT_LOWER((int)(total / 1000), 5000, int, "%d");
+
+	json = linphone_core_get_startup_timeline_json(lc);
+	BC_ASSERT_PTR_NOT_NULL(strstr(json, "{\"traceEvents\":["));
+	BC_ASSERT_PTR_NOT_NULL(strstr(json, "\"name\":\"core start\""));
+	ms_message("Startup timeline: %s", json);
+	bctbx_free(json);
+
+	linphone_core_manager_destroy(manager);
+	remove(tmp_db);
+	bctbx_free(src_db);
+	bctbx_free(tmp_db);
+}
+
+/*
+ * Minimal DNS server answering the A queries with 127.0.0.1, and NXDOMAIN for the names starting with "unknown.".
+ * The answers for the names starting with "short." have a TTL of 1 second, the other ones 300 seconds.
+ * The user data is the number of queries received.
+ */
+static int dns_stub_answer(void *user_data, unsigned char *buffer, int len, int size, const struct sockaddr_in *from) {
+	static const unsigned char answer[] = {
+		0xC0, 0x0C, /* pointer to the name of the question */
+		0x00, 0x01, 0x00, 0x01, /* A, IN */
+		0x00, 0x00, 0x01, 0x2C, /* TTL of 300 seconds */
+		0x00, 0x04, 127, 0, 0, 1
+	};
+	int *queries = (int *)user_data;
+	int offset = 12;
+	bool_t known;
+	bool_t type_a;
+
+	if (len < 12) return 0;
+	/* Skip the name of the question, then its type and class. */
+	while (offset < len && buffer[offset] != 0 && buffer[offset] < 64) offset += buffer[offset] + 1;
+	if (offset + 5 > len || buffer[offset] != 0) return 0;
+	offset += 5;
+	(*queries)++;
+
+	known = !(buffer[12] == 7 && memcmp(buffer + 13, "unknown", 7) == 0);
+	type_a = buffer[offset - 4] == 0x00 && buffer[offset - 3] == 0x01;
+
+	/* Response with the question only, then the answer if any. */
+	buffer[2] = (unsigned char)(0x84 | (buffer[2] & 0x01));
+	buffer[3] = (unsigned char)(known ? 0x80 : 0x83);
+	buffer[6] = 0;
+	buffer[7] = (known && type_a) ? 1 : 0;
+	memset(buffer + 8, 0, 4);
+	if (buffer[7] == 1 && offset + (int)sizeof(answer) <= size) {
+		memcpy(buffer + offset, answer, sizeof(answer));
+		if (buffer[12] == 5 && memcmp(buffer + 13, "short", 5) == 0) {
+			buffer[offset + 8] = 0x00;
+			buffer[offset + 9] = 0x01;
+		}
+		offset += (int)sizeof(answer);
+	}
+	return offset;
+}
+
+typedef struct _DnsLookups {
+	int done;
+	int found;
+} DnsLookups;
+
+static void dns_lookup_done(void *data, belle_sip_resolver_results_t *results) {
+	DnsLookups *lookups = (DnsLookups *)data;
+	lookups->done++;
+	if (belle_sip_resolver_results_get_addrinfos(results)) lookups->found++;
+}
+
+static void dns_answer_cache(void) {
+	const int lookups_count = 1000;
+	LoopbackUdpStandIn stub;
+	int queries = 0;
+	LinphoneCoreManager *manager;
+	Sal *sal;
+	bctbx_list_t *servers;
+	char server[64];
+	DnsLookups lookups = {0};
+	DnsLookups first = {0}, second = {0};
+	belle_sip_resolver_context_t *context;
+	unsigned int hits, misses;
+	bool_t expired = FALSE;
+	int i;
+
+	if (!BC_ASSERT_TRUE(loopback_udp_stand_in_start(&stub, dns_stub_answer, &queries))) return;
+
+	manager = linphone_core_manager_new2("empty_rc", FALSE);
+	sal = linphone_core_get_sal(manager->lc);
+	snprintf(server, sizeof(server), "[127.0.0.1]:%d", stub.port);
+	servers = bctbx_list_append(NULL, server);
+	linphone_core_set_dns_servers(manager->lc, servers);
+	bctbx_list_free(servers);
+	/* Otherwise the failed lookups are retried with the search domains of the host. */
+	linphone_core_enable_dns_search(manager->lc, FALSE);
+	hits = sal_get_dns_cache_hits(sal);
+	misses = sal_get_dns_cache_misses(sal);
+
+	/* Concurrent lookups of one name share the same query. */
+	for (i = 0; i < lookups_count; i++)
+		sal_resolve_a(sal, "dns-cache.example.org", 5060, AF_INET, dns_lookup_done, &lookups);
+	loopback_udp_stand_in_wait(manager->lc, &stub, &lookups.done, lookups_count, 5000);
+	BC_ASSERT_EQUAL(lookups.done, lookups_count, int, "%d");
+	BC_ASSERT_EQUAL(lookups.found, lookups_count, int, "%d");
+	BC_ASSERT_EQUAL(queries, 1, int, "%d");
+	BC_ASSERT_EQUAL(sal_get_dns_cache_misses(sal) - misses, 1, unsigned int, "%u");
+	BC_ASSERT_EQUAL(sal_get_dns_cache_hits(sal) - hits, (unsigned int)lookups_count - 1, unsigned int, "%u");
+
+	/* The answer is then given at once, as long as its TTL. */
+	BC_ASSERT_PTR_NULL(sal_resolve_a(sal, "dns-cache.example.org", 5060, AF_INET, dns_lookup_done, &lookups));
+	BC_ASSERT_EQUAL(lookups.done, lookups_count + 1, int, "%d");
+	BC_ASSERT_EQUAL(queries, 1, int, "%d");
+
+	/* Failures are remembered too. */
+	for (i = 0; i < 10; i++)
+		sal_resolve_a(sal, "unknown.example.org", 5060, AF_INET, dns_lookup_done, &lookups);
+	loopback_udp_stand_in_wait(manager->lc, &stub, &lookups.done, lookups_count + 11, 5000);
+	BC_ASSERT_EQUAL(lookups.done, lookups_count + 11, int, "%d");
+	BC_ASSERT_EQUAL(lookups.found, lookups_count + 1, int, "%d");
+	BC_ASSERT_EQUAL(queries, 2, int, "%d");
+	BC_ASSERT_PTR_NULL(sal_resolve_a(sal, "unknown.example.org", 5060, AF_INET, dns_lookup_done, &lookups));
+	BC_ASSERT_EQUAL(lookups.done, lookups_count + 12, int, "%d");
+	BC_ASSERT_EQUAL(queries, 2, int, "%d");
+
+	/* Cancelling one of the lookups sharing a query does not cancel the others. */
+	context = sal_resolve_a(sal, "shared.example.org", 5060, AF_INET, dns_lookup_done, &first);
+	BC_ASSERT_PTR_NOT_NULL(context);
+	BC_ASSERT_PTR_EQUAL(sal_resolve_a(sal, "shared.example.org", 5060, AF_INET, dns_lookup_done, &second), context);
+	if (context) sal_cancel_resolve(sal, context, &first);
+	loopback_udp_stand_in_wait(manager->lc, &stub, &second.done, 1, 5000);
+	BC_ASSERT_EQUAL(first.done, 0, int, "%d");
+	BC_ASSERT_EQUAL(second.found, 1, int, "%d");
+	BC_ASSERT_EQUAL(queries, 3, int, "%d");
+
+	/* An expired answer stays available to the callers unable to wait, but only for the max stale duration. */
+	sal_set_dns_cache_max_stale(sal, 1);
+	lookups.done = 0;
+	sal_resolve_a(sal, "short.example.org", 5060, AF_INET, dns_lookup_done, &lookups);
+	loopback_udp_stand_in_wait(manager->lc, &stub, &lookups.done, 1, 5000);
+	BC_ASSERT_EQUAL(queries, 4, int, "%d");
+	BC_ASSERT_TRUE(sal_has_cached_results_a(sal, "short.example.org", 5060, AF_INET, &expired));
+	BC_ASSERT_FALSE(expired);
+	ms_usleep(1200000);
+	BC_ASSERT_TRUE(sal_has_cached_results_a(sal, "short.example.org", 5060, AF_INET, &expired));
+	BC_ASSERT_TRUE(expired);
+	ms_usleep(1200000);
+	BC_ASSERT_FALSE(sal_has_cached_results_a(sal, "short.example.org", 5060, AF_INET, &expired));
+
+	/* Without the cache, every lookup is a query of its own. */
+	sal_enable_dns_cache(sal, FALSE);
+	misses = sal_get_dns_cache_misses(sal);
+	lookups.done = 0;
+	sal_resolve_a(sal, "dns-cache.example.org", 5060, AF_INET, dns_lookup_done, &lookups);
+	sal_resolve_a(sal, "dns-cache.example.org", 5060, AF_INET, dns_lookup_done, &lookups);
+	loopback_udp_stand_in_wait(manager->lc, &stub, &lookups.done, 2, 5000);
+	BC_ASSERT_EQUAL(lookups.done, 2, int, "%d");
+	BC_ASSERT_EQUAL(queries, 6, int, "%d");
+	BC_ASSERT_EQUAL(sal_get_dns_cache_misses(sal), misses, unsigned int, "%u");
+	BC_ASSERT_FALSE(sal_has_cached_results_a(sal, "dns-cache.example.org", 5060, AF_INET, &expired));
+
+	linphone_core_manager_destroy(manager);
+	loopback_udp_stand_in_stop(&stub);
+}
+
 void linphone_lpconfig_invalid_friend(void) {
 	LinphoneCoreManager* mgr = linphone_core_manager_new2("invalid_friends_rc",FALSE);
 	LinphoneFriendList *friendList = linphone_core_get_default_friend_list(mgr->lc);
@@ -2141,6 +2504,10 @@ test_t setup_tests[] = {
 	TEST_NO_TAG("LPConfig zero_len value from buffer", linphone_lpconfig_from_buffer_zerolen_value),
 	TEST_NO_TAG("LPConfig zero_len value from file", linphone_lpconfig_from_file_zerolen_value),
 	TEST_NO_TAG("LPConfig zero_len value from XML", linphone_lpconfig_from_xml_zerolen_value),
+	TEST_NO_TAG("LPConfig lazy sync", linphone_lpconfig_lazy_sync),
+	TEST_NO_TAG("LPConfig snapshot", linphone_lpconfig_snapshot),
+	TEST_NO_TAG("Startup timeline", startup_timeline),
+	TEST_ONE_TAG("DNS answer cache", dns_answer_cache, "DNS"),
 	TEST_NO_TAG("LPConfig invalid friend", linphone_lpconfig_invalid_friend),
 	TEST_NO_TAG("LPConfig invalid friend remote provisoning", linphone_lpconfig_invalid_friend_remote_provisioning),
 	TEST_NO_TAG("Chat room", chat_room_test),
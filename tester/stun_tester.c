@@ -321,10 +321,131 @@ static void relayed_ice_turn_tls_to_ice_with_srtp(void){
 	ice_turn_call_base(FALSE, TRUE, TRUE, FALSE, TRUE, FALSE, FALSE, TRUE, LinphoneMediaEncryptionSRTP);
 }
 
+/*
+ * Minimal STUN server answering binding requests with the mapped address of the client.
+ * The user data is the number of requests received.
+ */
+static int stun_stand_in_answer(void *user_data, unsigned char *buffer, int len, int size, const struct sockaddr_in *from) {
+	int *requests = (int *)user_data;
+	uint16_t port;
+	uint32_t ip;
+
+	/* Binding request with the RFC 5389 magic cookie. */
+	if (len < 20 || size < 32 || buffer[0] != 0x00 || buffer[1] != 0x01
+		|| buffer[4] != 0x21 || buffer[5] != 0x12 || buffer[6] != 0xA4 || buffer[7] != 0x42)
+		return 0;
+	(*requests)++;
+
+	/* Binding success response, same transaction id, with a single XOR-MAPPED-ADDRESS attribute. */
+	buffer[1] = 0x01;
+	buffer[2] = 0x00;
+	buffer[3] = 12;
+	buffer[20] = 0x00;
+	buffer[21] = 0x20;
+	buffer[22] = 0x00;
+	buffer[23] = 8;
+	buffer[24] = 0x00;
+	buffer[25] = 0x01;
+	port = (uint16_t)(ntohs(from->sin_port) ^ 0x2112);
+	buffer[26] = (unsigned char)(port >> 8);
+	buffer[27] = (unsigned char)(port & 0xFF);
+	ip = ntohl(from->sin_addr.s_addr) ^ 0x2112A442;
+	buffer[28] = (unsigned char)(ip >> 24);
+	buffer[29] = (unsigned char)((ip >> 16) & 0xFF);
+	buffer[30] = (unsigned char)((ip >> 8) & 0xFF);
+	buffer[31] = (unsigned char)(ip & 0xFF);
+	return 32;
+}
+
+static void ice_gathering_with_cached_stun_server(void) {
+	const int calls = 200;
+	LoopbackUdpStandIn server;
+	int requests = 0;
+	LinphoneCoreManager *marie;
+	LinphoneCoreManager *pauline;
+	LinphoneNatPolicy *nat_policy;
+	LinphoneAddress *pauline_dest;
+	LinphoneSipTransports pauline_transports;
+	char stun_server[64];
+	uint64_t first_gathering = 0, other_gatherings = 0;
+	unsigned int dns_queries, local_addresses_fetches;
+	int i;
+
+	if (!BC_ASSERT_TRUE(loopback_udp_stand_in_start(&server, stun_stand_in_answer, &requests))) return;
+
+	marie = linphone_core_manager_new2("marie_rc", FALSE);
+	pauline = linphone_core_manager_new2("pauline_tcp_rc", FALSE);
+	linphone_core_enable_ipv6(marie->lc, FALSE);
+	linphone_core_enable_ipv6(pauline->lc, FALSE);
+	linphone_core_set_default_proxy_config(marie->lc, NULL);
+	linphone_core_set_default_proxy_config(pauline->lc, NULL);
+	/* The interfaces must not be fetched again because the calls last longer than the default cache duration. */
+	linphone_config_set_int(linphone_core_get_config(marie->lc), "net", "local_addresses_cache_ttl", 3600);
+	dns_queries = sal_get_dns_cache_misses(linphone_core_get_sal(marie->lc));
+	local_addresses_fetches = linphone_core_get_local_addresses_fetch_count(marie->lc);
+
+	/* The stand-in is reached through the tester hosts file, so that its name goes through the resolver. */
+	snprintf(stun_server, sizeof(stun_server), "stun-standin.example.org:%d", server.port);
+	nat_policy = linphone_core_create_nat_policy(marie->lc);
+	linphone_nat_policy_enable_ice(nat_policy, TRUE);
+	linphone_nat_policy_enable_stun(nat_policy, TRUE);
+	linphone_nat_policy_set_stun_server(nat_policy, stun_server);
+	linphone_core_set_nat_policy(marie->lc, nat_policy);
+	linphone_nat_policy_unref(nat_policy);
+
+	pauline_dest = linphone_address_new("sip:127.0.0.1;transport=tcp");
+	linphone_core_get_sip_transports_used(pauline->lc, &pauline_transports);
+	linphone_address_set_port(pauline_dest, pauline_transports.tcp_port);
+
+	for (i = 0; i < calls; i++) {
+		uint64_t start = bctbx_get_cur_time_ms();
+		uint64_t elapsed;
+		LinphoneCall *call;
+
+		linphone_core_invite_address(marie->lc, pauline_dest);
+		/* The INVITE is only sent once the ICE candidates are gathered. */
+		while (marie->stat.number_of_LinphoneCallOutgoingProgress == i && bctbx_get_cur_time_ms() - start < 5000) {
+			linphone_core_iterate(marie->lc);
+			linphone_core_iterate(pauline->lc);
+			loopback_udp_stand_in_serve(&server);
+			ms_usleep(1000);
+		}
+		elapsed = bctbx_get_cur_time_ms() - start;
+		if (!BC_ASSERT_EQUAL(marie->stat.number_of_LinphoneCallOutgoingProgress, i + 1, int, "%d")) break;
+		if (i == 0) first_gathering = elapsed;
+		else other_gatherings += elapsed;
+
+		if (!BC_ASSERT_TRUE(wait_for(marie->lc, pauline->lc, &pauline->stat.number_of_LinphoneCallIncomingReceived, i + 1))) break;
+		call = linphone_core_get_current_call(pauline->lc);
+		if (!BC_ASSERT_PTR_NOT_NULL(call)) break;
+		linphone_call_decline(call, LinphoneReasonDeclined);
+		BC_ASSERT_TRUE(wait_for(marie->lc, pauline->lc, &marie->stat.number_of_LinphoneCallReleased, i + 1));
+		BC_ASSERT_TRUE(wait_for(marie->lc, pauline->lc, &pauline->stat.number_of_LinphoneCallReleased, i + 1));
+	}
+
+	if (i == calls) {
+		uint64_t average = other_gatherings / (uint64_t)(calls - 1);
+		ms_message("ICE gathering: %llu ms for the first call, %llu ms on average for the %d next ones",
+			(unsigned long long)first_gathering, (unsigned long long)average, calls - 1);
+		/* Every call gathered a server reflexive candidate from the stand-in. */
+		BC_ASSERT_GREATER(requests, calls, int, "%d");
+		/* Neither the server name nor the local interfaces are looked up again once cached. */
+		BC_ASSERT_EQUAL(sal_get_dns_cache_misses(linphone_core_get_sal(marie->lc)) - dns_queries, 1, unsigned int, "%u");
+		BC_ASSERT_EQUAL(linphone_core_get_local_addresses_fetch_count(marie->lc) - local_addresses_fetches, 1, unsigned int, "%u");
+		BC_ASSERT_LOWER((int)average, 500, int, "%d");
+	}
+
+	linphone_address_unref(pauline_dest);
+	linphone_core_manager_destroy(marie);
+	linphone_core_manager_destroy(pauline);
+	loopback_udp_stand_in_stop(&server);
+}
+
 
 test_t stun_tests[] = {
 	TEST_ONE_TAG("Basic Stun test (Ping/public IP)", linphone_stun_test_grab_ip, "STUN"),
 	TEST_ONE_TAG("STUN encode", linphone_stun_test_encode, "STUN"),
+	TEST_TWO_TAGS("ICE gathering with cached STUN server", ice_gathering_with_cached_stun_server, "ICE", "STUN"),
 	TEST_TWO_TAGS("Basic ICE+TURN call", basic_ice_turn_call, "ICE", "TURN"),
 	TEST_TWO_TAGS("Basic IPv6 ICE+TURN call", basic_ipv6_ice_turn_call, "ICE", "TURN"),
 	TEST_TWO_TAGS("Basic ICE+TURN call with TCP", basic_ice_turn_call_tcp, "ICE", "TURN"),
@@ -293,6 +293,63 @@ bool_t wait_for_list(bctbx_list_t* lcs,int* counter,int value,int timeout_ms) {
 	else return TRUE;
 }
 
+bool_t loopback_udp_stand_in_start(LoopbackUdpStandIn *stand_in, LoopbackUdpHandler handler, void *user_data) {
+	struct sockaddr_in addr;
+	socklen_t addrlen = sizeof(addr);
+	int rcvbuf = 1 << 20;
+
+	memset(stand_in, 0, sizeof(*stand_in));
+	stand_in->handler = handler;
+	stand_in->user_data = user_data;
+	stand_in->sock = socket(AF_INET, SOCK_DGRAM, 0);
+	if (stand_in->sock == (ortp_socket_t)-1) return FALSE;
+
+	memset(&addr, 0, sizeof(addr));
+	addr.sin_family = AF_INET;
+	addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	if (bind(stand_in->sock, (struct sockaddr *)&addr, sizeof(addr)) != 0
+		|| getsockname(stand_in->sock, (struct sockaddr *)&addr, &addrlen) != 0) {
+		close_socket(stand_in->sock);
+		return FALSE;
+	}
+	/* Datagrams sent in bursts between two calls to loopback_udp_stand_in_serve() must not be dropped. */
+	setsockopt(stand_in->sock, SOL_SOCKET, SO_RCVBUF, (const char *)&rcvbuf, sizeof(rcvbuf));
+	set_non_blocking_socket(stand_in->sock);
+	stand_in->port = ntohs(addr.sin_port);
+	return TRUE;
+}
+
+void loopback_udp_stand_in_serve(LoopbackUdpStandIn *stand_in) {
+	unsigned char buffer[2048];
+	struct sockaddr_in from;
+	socklen_t fromlen = sizeof(from);
+	int len;
+
+	while ((len = (int)recvfrom(stand_in->sock, (char *)buffer, sizeof(buffer), 0, (struct sockaddr *)&from, &fromlen)) > 0) {
+		int answer_len;
+		stand_in->datagrams++;
+		answer_len = stand_in->handler(stand_in->user_data, buffer, len, (int)sizeof(buffer), &from);
+		if (answer_len > 0)
+			sendto(stand_in->sock, (const char *)buffer, answer_len, 0, (struct sockaddr *)&from, fromlen);
+		fromlen = sizeof(from);
+	}
+}
+
+void loopback_udp_stand_in_wait(LinphoneCore *lc, LoopbackUdpStandIn *stand_in, const int *counter, int value, int timeout_ms) {
+	MSTimeSpec start;
+
+	liblinphone_tester_clock_start(&start);
+	while (*counter < value && !liblinphone_tester_clock_elapsed(&start, timeout_ms)) {
+		linphone_core_iterate(lc);
+		loopback_udp_stand_in_serve(stand_in);
+		ms_usleep(1000);
+	}
+}
+
+void loopback_udp_stand_in_stop(LoopbackUdpStandIn *stand_in) {
+	close_socket(stand_in->sock);
+}
+
 bool_t wait_for_stun_resolution(LinphoneCoreManager *m) {
 	MSTimeSpec start;
 	int timeout_ms = 10000;
@@ -17,8 +17,12 @@
  * along with this program. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <chrono>
+
 #include "linphone/utils/utils.h"
 
+#include "c-wrapper/internal/c-tools.h"
+
 #include "liblinphone_tester.h"
 #include "tester_utils.h"
 
@@ -95,11 +99,49 @@ static void parse_capabilities(void){
 	BC_ASSERT_TRUE(caps["ephemeral"] == Version(1, 0));
 }
 
+// Best of a few runs, in microseconds.
+static long long time_c_list_conversion (const list<string> &cppList) {
+	long long best = -1;
+	for (int run = 0; run < 3; run++) {
+		auto start = chrono::steady_clock::now();
+		bctbx_list_t *cList = Wrapper::getCListFromCppList(cppList);
+		auto elapsed = chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start).count();
+		BC_ASSERT_EQUAL(bctbx_list_size(cList), cppList.size(), size_t, "%zu");
+		bctbx_list_free_with_data(cList, bctbx_free);
+		if (best < 0 || elapsed < best)
+			best = elapsed;
+	}
+	return best;
+}
+
+static void c_list_conversions () {
+	list<string> cppList;
+	long long times[3];
+	size_t sizes[3] = { 1000, 10000, 100000 };
+
+	for (int i = 0; i < 3; i++) {
+		while (cppList.size() < sizes[i])
+			cppList.push_back("element" + to_string(cppList.size()));
+		times[i] = time_c_list_conversion(cppList);
+		ms_message("Converted %zu elements to a C list in %lld us", sizes[i], times[i]);
+	}
+
+	bctbx_list_t *cList = Wrapper::getCListFromCppList(cppList);
+	BC_ASSERT_STRING_EQUAL((const char *)bctbx_list_get_data(cList), "element0");
+	BC_ASSERT_STRING_EQUAL((const char *)bctbx_list_get_data(bctbx_list_last_elem(cList)), "element99999");
+	BC_ASSERT_PTR_EQUAL(bctbx_list_last_elem(cList)->prev->next, bctbx_list_last_elem(cList));
+	bctbx_list_free_with_data(cList, bctbx_free);
+
+	// Ten times more elements, quadratic conversions take a hundred times longer.
+	BC_ASSERT_LOWER(times[2], 30 * max(times[1], 100LL), long long, "%lld");
+}
+
 test_t utils_tests[] = {
 	TEST_NO_TAG("split", split),
 	TEST_NO_TAG("trim", trim),
 	TEST_NO_TAG("Version comparisons", version_comparisons),
-	TEST_NO_TAG("Parse capabilities", parse_capabilities)
+	TEST_NO_TAG("Parse capabilities", parse_capabilities),
+	TEST_NO_TAG("C list conversions", c_list_conversions)
 };
 
 test_suite_t utils_test_suite = {
@@ -430,6 +430,115 @@ static void friends_sqlite_store_lot_of_friends(void) {
 	linphone_core_unref(lc);
 }
 
+static uint64_t load_friends_database(LinphoneCore *lc, const char *path, bool_t lazy) {
+	uint64_t start;
+	linphone_config_set_int(linphone_core_get_config(lc), "misc", "lazy_friends_loading", lazy);
+	start = ms_get_cur_time_ms();
+	linphone_core_set_friends_database_path(lc, path);
+	return ms_get_cur_time_ms() - start;
+}
+
+static void friends_sqlite_lazy_load_lot_of_friends(void) {
+	LinphoneCoreManager *manager;
+	LinphoneFriendList *lfl;
+	LinphoneFriend *lf;
+	sqlite3 *db;
+	int i;
+	char *errmsg = NULL;
+	int ret;
+	char *buf;
+	uint64_t lazy_time, eager_time;
+	unsigned int parsed;
+	const int count = 50000;
+	char *friends_db = bc_tester_file("friends_lazy.db");
+
+	unlink(friends_db);
+	ret = sqlite3_open(friends_db, &db);
+	BC_ASSERT_TRUE(ret == SQLITE_OK);
+	ret = sqlite3_exec(db,
+					   "PRAGMA user_version = 3100;"
+					   "CREATE TABLE friends ("
+					   "id                INTEGER PRIMARY KEY AUTOINCREMENT,"
+					   "friend_list_id    INTEGER,"
+					   "sip_uri           TEXT,"
+					   "subscribe_policy  INTEGER,"
+					   "send_subscribe    INTEGER,"
+					   "ref_key           TEXT,"
+					   "vCard             TEXT,"
+					   "vCard_etag        TEXT,"
+					   "vCard_url         TEXT,"
+					   "presence_received INTEGER"
+					   ");"
+					   "CREATE TABLE friends_lists ("
+					   "id                INTEGER PRIMARY KEY AUTOINCREMENT,"
+					   "display_name      TEXT,"
+					   "rls_uri           TEXT,"
+					   "uri               TEXT,"
+					   "revision          INTEGER"
+					   ");"
+					   "INSERT INTO friends_lists VALUES(1,'Lot of friends',NULL,NULL,0);", 0, 0, &errmsg);
+	BC_ASSERT_TRUE(ret == SQLITE_OK);
+
+	ret = sqlite3_exec(db, "BEGIN", 0, 0, &errmsg);
+	BC_ASSERT_TRUE(ret == SQLITE_OK);
+	for (i = 0; i < count; i++) {
+		char *vcard = bctbx_strdup_printf("BEGIN:VCARD\r\nVERSION:4.0\r\nFN:Friend %i\r\n"
+			"IMPP:sip:friend%i@sip.example.org\r\nIMPP:sip:friend%i@other.example.org\r\nEND:VCARD\r\n", i, i, i);
+		buf = sqlite3_mprintf("INSERT INTO friends VALUES(NULL,1,'sip:friend%i@sip.example.org',%i,0,'key_%i',%Q,NULL,NULL,0);",
+			i, LinphoneSPAccept, i, vcard);
+		ret = sqlite3_exec(db, buf, 0, 0, &errmsg);
+		BC_ASSERT_TRUE(ret == SQLITE_OK);
+		sqlite3_free(buf);
+		bctbx_free(vcard);
+	}
+	ret = sqlite3_exec(db, "END", 0, 0, &errmsg);
+	BC_ASSERT_TRUE(ret == SQLITE_OK);
+	sqlite3_close(db);
+
+	manager = linphone_core_manager_new2("empty_rc", FALSE);
+
+	parsed = linphone_vcard_context_get_parsed_vcards_count(linphone_core_get_vcard_context(manager->lc));
+	lazy_time = load_friends_database(manager->lc, friends_db, TRUE);
+	lfl = linphone_core_get_default_friend_list(manager->lc);
+	BC_ASSERT_EQUAL((int)bctbx_list_size(linphone_friend_list_get_friends(lfl)), count, int, "%d");
+	BC_ASSERT_EQUAL(linphone_friend_list_get_pending_vcards(lfl), count, int, "%d");
+
+	/* Main address and ref key lookups don't need the vCard. */
+	lf = linphone_friend_list_find_friend_by_uri(lfl, "sip:friend4242@sip.example.org");
+	BC_ASSERT_PTR_NOT_NULL(lf);
+	BC_ASSERT_PTR_EQUAL(linphone_friend_list_find_friend_by_ref_key(lfl, "key_4242"), lf);
+	BC_ASSERT_EQUAL(linphone_friend_list_get_pending_vcards(lfl), count, int, "%d");
+	if (lf) BC_ASSERT_STRING_EQUAL(linphone_friend_get_name(lf), "Friend 4242");
+	BC_ASSERT_EQUAL(linphone_friend_list_get_pending_vcards(lfl), count - 1, int, "%d");
+
+	/* Secondary addresses are indexed at load time too. */
+	lf = linphone_friend_list_find_friend_by_uri(lfl, "sip:friend777@other.example.org");
+	BC_ASSERT_PTR_NOT_NULL(lf);
+	BC_ASSERT_EQUAL(linphone_friend_list_get_pending_vcards(lfl), count - 1, int, "%d");
+	if (lf) BC_ASSERT_STRING_EQUAL(linphone_friend_get_name(lf), "Friend 777");
+	BC_ASSERT_EQUAL(linphone_friend_list_get_pending_vcards(lfl), count - 2, int, "%d");
+
+	/* A miss parses nothing. */
+	BC_ASSERT_PTR_NULL(linphone_friend_list_find_friend_by_uri(lfl, "sip:stranger@sip.example.org"));
+	BC_ASSERT_PTR_NULL(linphone_friend_list_find_friends_by_uri(lfl, "sip:stranger@sip.example.org"));
+	BC_ASSERT_EQUAL(linphone_friend_list_get_pending_vcards(lfl), count - 2, int, "%d");
+	/* Only the two friends whose name was asked were parsed. */
+	BC_ASSERT_EQUAL(linphone_vcard_context_get_parsed_vcards_count(linphone_core_get_vcard_context(manager->lc)) - parsed, 2, unsigned int, "%u");
+
+	parsed = linphone_vcard_context_get_parsed_vcards_count(linphone_core_get_vcard_context(manager->lc));
+	eager_time = load_friends_database(manager->lc, friends_db, FALSE);
+	lfl = linphone_core_get_default_friend_list(manager->lc);
+	BC_ASSERT_EQUAL((int)bctbx_list_size(linphone_friend_list_get_friends(lfl)), count, int, "%d");
+	BC_ASSERT_EQUAL(linphone_friend_list_get_pending_vcards(lfl), 0, int, "%d");
+	BC_ASSERT_EQUAL(linphone_vcard_context_get_parsed_vcards_count(linphone_core_get_vcard_context(manager->lc)) - parsed, (unsigned int)count, unsigned int, "%u");
+
+	ms_message("Loading %i friends took %llu ms lazily, %llu ms eagerly", count, (unsigned long long)lazy_time, (unsigned long long)eager_time);
+
+	linphone_core_manager_destroy(manager);
+	unlink(friends_db);
+	bc_free(friends_db);
+}
+
 static void friends_sqlite_find_friend_in_lot_of_friends(void) {
 	LinphoneCore* lc = linphone_factory_create_core_2(linphone_factory_get(), NULL, NULL, liblinphone_tester_get_empty_rc(), NULL, system_context);
 	sqlite3 *db;
@@ -1027,6 +1136,7 @@ test_t vcard_tests[] = {
 	TEST_NO_TAG("Friends storage in sqlite database", friends_sqlite_storage),
 	TEST_NO_TAG("20000 Friends storage in sqlite database", friends_sqlite_store_lot_of_friends),
 	TEST_NO_TAG("Find friend in database of 20000 objects", friends_sqlite_find_friend_in_lot_of_friends),
+	TEST_NO_TAG("Lazy load of 50000 friends from database", friends_sqlite_lazy_load_lot_of_friends),
 	TEST_NO_TAG("CardDAV clean", carddav_clean), // This is to ensure the content of the test addressbook is in the correct state for the following tests
 	TEST_NO_TAG("CardDAV synchronization", carddav_sync),
 	TEST_NO_TAG("CardDAV synchronization 2", carddav_sync_2),